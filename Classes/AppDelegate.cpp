@@ -1,5 +1,8 @@
 #include "AppDelegate.h"
 #include "LoadingScene.h"
+#include "SaveManager.h"
+#include "InputManager.h"
+#include "GameFonts.h"
 
 // #define USE_AUDIO_ENGINE 1  //Ƶ棬ʹʱ⿪
 // #define USE_SIMPLE_AUDIO_ENGINE 1  //Ƶ棬ʹʱ⿪
@@ -98,6 +101,32 @@ bool AppDelegate::applicationDidFinishLaunching() {
 
     register_all_packages();  //עеİ׿ãҪ
 
+    // Դtools/pack_resources.py ɣʱԴڴӳİﰴϣȡ
+    // ·ɢļûдʱճ Resources µɢļ
+    if (FileUtils::getInstance()->addResourceArchive("res.pak"))
+    {
+        CCLOG("AppDelegate: mounted res.pak");
+    }
+
+    // ȡ浵ļֻмֽڣʱͬȡ
+    SaveManager::getInstance()->load();
+
+    // ͳһ룺ȫּ/ֱÿ֡ɶ
+    InputManager::getInstance()->init();
+
+    // עԤ決 SDF ͼֺŹһţǩʱֳդ
+    GameFonts::registerBakedFonts();
+
+    // Դظʽ RGB565Ѫ//Ч RGBA4444 textures.plist
+    // ת .pvr ʱֱϴ PNG/JPEG ͸ʽת
+    TextureFormatPolicy::getInstance()->loadManifest("textures.plist");
+
+    // ԴԤ㣺л󣬳Ԥʱʹ̭ûõ
+    // ߹é˹ʮ·Ʒ䷿бͶ֡һֱԴ
+    // LoadingScene ԤصĽɫ/Boss ֡Լ 80MB "Preload" ±סԤҲᱻ̭
+    director->getTextureCache()->setMemoryBudget(64 * 1024 * 1024);
+    director->getTextureCache()->setOwnerTag("Global");
+
     // create a scene. it's an autorelease object   һһԶͷŶ
     auto scene = LoadingScene::createScene();
 
@@ -2,6 +2,9 @@
 #include "CharmManager.h"
 #include "SimpleAudioEngine.h"
 #include "SettingsPanel.h"
+#include "SoundBank.h"  // Ч
+#include "InputManager.h"  // ͳһ
+#include "PlatformCollision.h"  // solid ͼײƽ̨
 
 USING_NS_CC;
 using namespace CocosDenshion;
@@ -16,6 +19,21 @@ bool BossScene::init()
     if (!Scene::init())
         return false;
 
+    // ص "HornetBoss" £̨ texture residency ͳԴ棩
+    Director::getInstance()->getTextureCache()->setOwnerTag("HornetBoss");
+
+    // עܸ NextScene ͬã볡ǰۼƵײѯ
+    auto frameStats = FrameStats::getInstance();
+    _monsterCounter = frameStats->registerCounter("monsters");
+    _collisionQueryCounter = frameStats->registerCounter("collision queries");
+    _combatPairCounter = frameStats->registerCounter("combat pairs");
+    // ٹΣ NextScene ͬã
+    _combatZone = frameStats->registerZone("combat");
+    TheKnight::takeCollisionQueryCount();
+
+    // ԤرЧսвٽ룩
+    SoundBank::getInstance()->loadBank({ SoundGroup::UI, SoundGroup::KNIGHT, SoundGroup::HORNET });
+
     // ȡĻߴ
     Size visibleSize = Director::getInstance()->getVisibleSize();
     Vec2 origin = Director::getInstance()->getVisibleOrigin();
@@ -40,6 +58,7 @@ bool BossScene::init()
 
     // ײ
     parseCollisionLayer();
+    PlatformCollision::addSolidTilePlatforms(_map, scale, Vec2::ZERO, _platforms);
 
     // ȡʼλ
     auto objectGroup = _map->getObjectGroup("Objects");
@@ -131,28 +150,7 @@ bool BossScene::init()
     _knightAttackCooldown = 0.0f;
     _spellAttackCooldown = 0.0f;
 
-    // Ӽ¼ (Q򿪻)
-    auto keyboardListener = EventListenerKeyboard::create();
-    keyboardListener->onKeyPressed = [this](EventKeyboard::KeyCode keyCode, Event* event) {
-        if (keyCode == EventKeyboard::KeyCode::KEY_Q)
-        {
-            auto charmManager = CharmManager::getInstance();
-            if (charmManager->isPanelOpen())
-            {
-                charmManager->hideCharmPanel();
-                // رͬ״̬
-                if (_knight)
-                {
-                    charmManager->syncToKnight(_knight);
-                }
-            }
-            else
-            {
-                charmManager->showCharmPanel(this);
-            }
-        }
-    };
-    _eventDispatcher->addEventListenerWithSceneGraphPriority(keyboardListener, this);
+    // ޸ġ尴Ϊ update ѯ InputManager Ķ
 
     // ֱƳڲ
     if (blackLayer && blackLayer->getParent()) {
@@ -424,9 +422,12 @@ void BossScene::updateCamera()
 
 void BossScene::checkCombatCollisions()
 {
+    FrameStats::ScopedZone combatZone(_combatZone);  // 
     if (!_knight || !_hornet) return;
     if (_knight->isDead()) return;
     
+    int combatPairs = 0;  // ֡жľζܸ㣩
+    
     // ========== 1. HornetTheKnight˺ ==========
     if (!_knight->isInvincible() && !_knight->isStunned())
     {
@@ -434,6 +435,7 @@ void BossScene::checkCombatCollisions()
         bool knightHit = false;
         
         Rect bossRect = _hornet->getBossHitRect();
+        ++combatPairs;
         if (knightRect.intersectsRect(bossRect))
         {
             knightHit = true;
@@ -442,18 +444,20 @@ void BossScene::checkCombatCollisions()
         if (!knightHit)
         {
             Rect weaponRect = _hornet->getWeaponRect();
-            if (weaponRect.size.width > 0 && knightRect.intersectsRect(weaponRect))
+            if (weaponRect.size.width > 0)
             {
-                knightHit = true;
+                ++combatPairs;
+                knightHit = knightRect.intersectsRect(weaponRect);
             }
         }
         
         if (!knightHit)
         {
             Rect attack4Rect = _hornet->getAttack4Rect();
-            if (attack4Rect.size.width > 0 && knightRect.intersectsRect(attack4Rect))
+            if (attack4Rect.size.width > 0)
             {
-                knightHit = true;
+                ++combatPairs;
+                knightHit = knightRect.intersectsRect(attack4Rect);
             }
         }
         
@@ -483,6 +487,7 @@ void BossScene::checkCombatCollisions()
         Rect slashRect;
         if (_knight->getSlashEffectBoundingBox(slashRect))
         {
+            ++combatPairs;
             if (slashRect.intersectsRect(bossHurtRect))
             {
                 _hornet->onDamaged();
@@ -513,6 +518,7 @@ void BossScene::checkCombatCollisions()
                            effectSize.width,
                            effectSize.height);
             
+            ++combatPairs;
             if (spellRect.intersectsRect(bossHurtRect))
             {
                 _hornet->onDamaged();
@@ -525,15 +531,41 @@ void BossScene::checkCombatCollisions()
             }
         }
     }
+    
+    FrameStats::getInstance()->addCounter(_combatPairCounter, combatPairs);
 }
 
 void BossScene::update(float dt)
 {
     updateCamera();
     updateHPAndSoulUI(dt);
+
+    // ޸ġ忪
+    if (InputManager::getInstance()->isPressed(InputAction::CHARM))
+    {
+        auto charmManager = CharmManager::getInstance();
+        if (charmManager->isPanelOpen())
+        {
+            charmManager->hideCharmPanel();
+            // رͬ״̬
+            if (_knight)
+            {
+                charmManager->syncToKnight(_knight);
+            }
+        }
+        else
+        {
+            charmManager->showCharmPanel(this);
+        }
+    }
     
     // ײ
     checkCombatCollisions();
+    
+    // ܸ㣺Boss һ֡ Knight ƽ̨ײѯ
+    auto frameStats = FrameStats::getInstance();
+    frameStats->addCounter(_monsterCounter, _hornet ? 1 : 0);
+    frameStats->addCounter(_collisionQueryCounter, TheKnight::takeCollisionQueryCount());
 }
 
 void BossScene::menuCloseCallback(Ref* pSender)
@@ -21,6 +21,7 @@ public:
 private:
     // ӵͼײƽ̨
     void parseCollisionLayer();
+
     
     // 
     void updateCamera();
@@ -66,6 +67,12 @@ private:
     float _knightAttackCooldown = 0.0f;
     float _spellAttackCooldown = 0.0f;
     
+    // ܸFrameStats ļ id init עᣩ
+    int _monsterCounter = -1;
+    int _collisionQueryCounter = -1;
+    int _combatPairCounter = -1;
+    int _combatZone = -1;  // սжʱٹ
+    
     // ͣ˵
     PauseMenu* _pauseMenu = nullptr;
 };
@@ -1,5 +1,6 @@
 #include "CharmManager.h"
 #include "TheKnight.h"
+#include "InputManager.h"  // ͳһ
 
 USING_NS_CC;
 
@@ -35,7 +36,6 @@ CharmManager::CharmManager()
     , _equippedGap(100)
     , _selectedCharmIndex(0)
     , _selectFrameSprite(nullptr)
-    , _keyboardListener(nullptr)
     , _canEquip(false)
     , _hintLabel(nullptr)
 {
@@ -369,62 +369,45 @@ void CharmManager::createCharmUI(Node* layer, const Size& visibleSize)
     // ʾʼѡеĻϢ
     updateInfoPanel(_selectedCharmIndex, true);
     
-    // Ӽ̼
-    _keyboardListener = EventListenerKeyboard::create();
-    _keyboardListener->onKeyPressed = CC_CALLBACK_2(CharmManager::onKeyPressed, this);
-    Director::getInstance()->getEventDispatcher()->addEventListenerWithSceneGraphPriority(_keyboardListener, layer);
+    // ޸ġΪÿ֡ѯ InputManagerƳԶֹͣ
+    layer->schedule([this](float dt) {
+        handlePanelInput();
+    }, "charm_panel_input");
 }
 
-void CharmManager::onKeyPressed(EventKeyboard::KeyCode keyCode, Event* event)
+void CharmManager::handlePanelInput()
 {
     if (!_isPanelOpen || _charms.empty()) return;
     
+    auto input = InputManager::getInstance();
     int charmCount = (int)_charms.size();
     
-    switch (keyCode) {
-        case EventKeyboard::KeyCode::KEY_A:
-        case EventKeyboard::KeyCode::KEY_LEFT_ARROW:
-            // ѡ
-            _selectedCharmIndex--;
-            if (_selectedCharmIndex < 0) {
-                _selectedCharmIndex = charmCount - 1;
-            }
-            updateSelectFrame();
-            updateInfoPanel(_selectedCharmIndex, true);
-            break;
-            
-        case EventKeyboard::KeyCode::KEY_D:
-        case EventKeyboard::KeyCode::KEY_RIGHT_ARROW:
-            // ѡ
-            _selectedCharmIndex++;
-            if (_selectedCharmIndex >= charmCount) {
-                _selectedCharmIndex = 0;
-            }
-            updateSelectFrame();
-            updateInfoPanel(_selectedCharmIndex, true);
-            break;
-            
-        case EventKeyboard::KeyCode::KEY_W:
-        case EventKeyboard::KeyCode::KEY_UP_ARROW:
-            // ѡʱΪֻһл
-            break;
-            
-        case EventKeyboard::KeyCode::KEY_S:
-        case EventKeyboard::KeyCode::KEY_DOWN_ARROW:
-            // ѡʱΪֻһл
-            break;
-            
-        case EventKeyboard::KeyCode::KEY_K:
-            // װ/жػֻʱװж
-            if (_canEquip) {
-                toggleEquipCharm();
-            } else {
-                CCLOG("ֻϲװж");
-            }
-            break;
-            
-        default:
-            break;
+    if (input->isPressed(InputAction::LEFT)) {
+        // ѡ
+        _selectedCharmIndex--;
+        if (_selectedCharmIndex < 0) {
+            _selectedCharmIndex = charmCount - 1;
+        }
+        updateSelectFrame();
+        updateInfoPanel(_selectedCharmIndex, true);
+    }
+    else if (input->isPressed(InputAction::RIGHT)) {
+        // ѡ
+        _selectedCharmIndex++;
+        if (_selectedCharmIndex >= charmCount) {
+            _selectedCharmIndex = 0;
+        }
+        updateSelectFrame();
+        updateInfoPanel(_selectedCharmIndex, true);
+    }
+    // ѡʱΪֻһл
+    else if (input->isPressed(InputAction::JUMP)) {
+        // װ/жػֻʱװж
+        if (_canEquip) {
+            toggleEquipCharm();
+        } else {
+            CCLOG("ֻϲװж");
+        }
     }
 }
 
@@ -510,12 +493,6 @@ void CharmManager::hideCharmPanel()
 {
     if (!_isPanelOpen || !_parentNode) return;
     
-    // Ƴ̼
-    if (_keyboardListener) {
-        Director::getInstance()->getEventDispatcher()->removeEventListener(_keyboardListener);
-        _keyboardListener = nullptr;
-    }
-    
     auto panel = _parentNode->getChildByName("CharmPanel");
     if (panel)
     {
@@ -88,8 +88,8 @@ private:
     // ѡпʾ
     void updateSelectFrame();
     
-    // ¼
-    void onKeyPressed(EventKeyboard::KeyCode keyCode, Event* event);
+    // ޸ġ尴ѯ InputManager Ķգ
+    void handlePanelInput();
     
 private:
     static CharmManager* _instance;
@@ -123,9 +123,6 @@ private:
     // ʾ
     Label* _hintLabel;
     
-    // ̼
-    EventListenerKeyboard* _keyboardListener;
-    
     // ϢԪ
     Sprite* _infoCharmIcon;
     Label* _infoCharmName;
@@ -1,4 +1,6 @@
 #include "CorniferNPC.h"
+#include "SaveManager.h"  // ͼ浵
+#include "InputManager.h"  // ͳһ
 
 USING_NS_CC;
 
@@ -149,9 +151,7 @@ bool CorniferNPC::init() {
     mouseListener->onMouseDown = CC_CALLBACK_1(CorniferNPC::onMouseDown, this);
     _eventDispatcher->addEventListenerWithSceneGraphPriority(mouseListener, this);
 
-    auto keyListener = EventListenerKeyboard::create();
-    keyListener->onKeyPressed = CC_CALLBACK_2(CorniferNPC::onKeyPressed, this);
-    _eventDispatcher->addEventListenerWithSceneGraphPriority(keyListener, this);
+    // ޸ġٵ update ѯ InputManager handleInput
 
     this->scheduleUpdate();
 
@@ -199,6 +199,7 @@ void CorniferNPC::initAnimations() {
 
 void CorniferNPC::update(float dt) {
     checkPlayerDistance();
+    handleInput();  // 
 
     bool shouldShowPrompt = _isPlayerNearby && !_isDialogueActive;
 
@@ -380,14 +381,15 @@ void CorniferNPC::onMouseDown(Event* event) {
     }
 }
 
-void CorniferNPC::onKeyPressed(EventKeyboard::KeyCode keyCode, Event* event) {
+// ޸ġɼ̻صΪÿ֡ѯ
+void CorniferNPC::handleInput() {
     if (_isDialogueActive) {
         if (_dialogueWindow->getNumberOfRunningActions() > 0) return;
-        handleDialogueInput(keyCode);
+        handleDialogueInput();
     }
     
-    else if ((keyCode == EventKeyboard::KeyCode::KEY_W || keyCode == EventKeyboard::KeyCode::KEY_CAPITAL_W) && _isPlayerNearby) {
-        CCLOG("[Cornifer] Ұ W 򿪶Ի");
+    else if (InputManager::getInstance()->isPressed(InputAction::UP) && _isPlayerNearby) {
+        CCLOG("[Cornifer] Ұ½򿪶Ի");
         showDialogue();
     }
 }
@@ -456,21 +458,22 @@ void CorniferNPC::closeDialogue() {
     CCLOG("[Cornifer] Իѹر");
 }
 
-void CorniferNPC::handleDialogueInput(EventKeyboard::KeyCode keyCode) {
+void CorniferNPC::handleDialogueInput() {
+    auto input = InputManager::getInstance();
     if (_isChoiceActive) {
-        // ʹ Y ѡ""
-        if (keyCode == EventKeyboard::KeyCode::KEY_Y || keyCode == EventKeyboard::KeyCode::KEY_CAPITAL_Y) {
+        // ȷϼĬ Yѡ""
+        if (input->isPressed(InputAction::CONFIRM)) {
             selectChoice(0);
             _hasShownMapPrompt = true;
         }
-        // ʹ N ѡ""
-        else if (keyCode == EventKeyboard::KeyCode::KEY_N || keyCode == EventKeyboard::KeyCode::KEY_CAPITAL_N) {
+        // ȡĬ Nѡ""
+        else if (input->isPressed(InputAction::CANCEL)) {
             selectChoice(1);
         }
     }
     else {
-        // ޸ġ E Ϊ W ƽԻ
-        if (keyCode == EventKeyboard::KeyCode::KEY_W || keyCode == EventKeyboard::KeyCode::KEY_CAPITAL_W) {
+        // ޸ġ E Ϊ W ƽԻΪ UP 
+        if (input->isPressed(InputAction::UP)) {
             advanceDialogue();
         }
     }
@@ -479,6 +482,7 @@ void CorniferNPC::handleDialogueInput(EventKeyboard::KeyCode keyCode) {
 void CorniferNPC::selectChoice(int choiceIndex) {
     if (choiceIndex == 0) {
         _showPurchaseSuccess = true;
+        SaveManager::getInstance()->setHasCrossroadsMap(true);  // 
         _dialogueIndex = 0;
         _isChoiceActive = false;
         fadeToUpdateContent();
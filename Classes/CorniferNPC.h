@@ -31,13 +31,13 @@ private:
     void updateDialogueContent();
     void fadeToUpdateContent();
     void updateChoiceUI();
-    void handleDialogueInput(cocos2d::EventKeyboard::KeyCode keyCode);
+    void handleDialogueInput();
     void selectChoice(int choiceIndex);
 
     // ص
     void onMouseMove(cocos2d::Event* event);
     void onMouseDown(cocos2d::Event* event);
-    void onKeyPressed(cocos2d::EventKeyboard::KeyCode keyCode, cocos2d::Event* event);
+    void handleInput();  // ޸ġѯ InputManager̻ص
 
     cocos2d::Sprite* _corniferSprite;
     cocos2d::Vec2 _playerPos;
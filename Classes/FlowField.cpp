@@ -0,0 +1,235 @@
+﻿#include "FlowField.h"
+
+USING_NS_CC;
+
+namespace
+{
+    // 8 邻域方向表，索引 8 表示无方向
+    const int DIR_X[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+    const int DIR_Y[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+    const uint8_t DIR_NONE = 8;
+    const uint16_t DIST_UNREACHABLE = 0xFFFF;
+
+    // 方向索引取反（从邻居指回当前格子）
+    const uint8_t DIR_OPPOSITE[8] = { 1, 0, 3, 2, 7, 6, 5, 4 };
+
+    const Vec2 DIR_VEC[8] = {
+        Vec2(1.0f, 0.0f), Vec2(-1.0f, 0.0f), Vec2(0.0f, 1.0f), Vec2(0.0f, -1.0f),
+        Vec2(0.70710678f, 0.70710678f), Vec2(0.70710678f, -0.70710678f),
+        Vec2(-0.70710678f, 0.70710678f), Vec2(-0.70710678f, -0.70710678f)
+    };
+}
+
+FlowField::FlowField()
+: _origin(Vec2::ZERO)
+, _cellSize(64.0f)
+, _cols(0)
+, _rows(0)
+, _maxSearchSteps(64)
+, _targetCell(-1)
+, _targetPos(Vec2::ZERO)
+{
+}
+
+void FlowField::build(const std::vector<Platform>& platforms, float cellSize, float margin)
+{
+    _blocked.clear();
+    _distance.clear();
+    _direction.clear();
+    _targetCell = -1;
+    _cols = 0;
+    _rows = 0;
+
+    if (platforms.empty() || cellSize <= 0.0f)
+    {
+        return;
+    }
+
+    // 1. 计算所有平台的包围盒作为网格范围
+    Rect bounds = platforms.front().rect;
+    for (const auto& platform : platforms)
+    {
+        bounds.merge(platform.rect);
+    }
+
+    _cellSize = cellSize;
+    _origin = Vec2(bounds.getMinX() - margin, bounds.getMinY() - margin);
+    _cols = (int)std::ceil((bounds.size.width + margin * 2) / cellSize);
+    _rows = (int)std::ceil((bounds.size.height + margin * 2) / cellSize);
+
+    size_t cellCount = (size_t)_cols * _rows;
+    _blocked.assign(cellCount, 0);
+    _distance.assign(cellCount, DIST_UNREACHABLE);
+    _direction.assign(cellCount, DIR_NONE);
+    _queue.reserve(cellCount);
+
+    // 2. 平台覆盖的格子标记为阻挡（只遍历平台自身覆盖的格子范围）
+    for (const auto& platform : platforms)
+    {
+        const Rect& r = platform.rect;
+        int minCol = std::max(0, (int)std::floor((r.getMinX() - _origin.x) / cellSize));
+        int maxCol = std::min(_cols - 1, (int)std::ceil((r.getMaxX() - _origin.x) / cellSize) - 1);
+        int minRow = std::max(0, (int)std::floor((r.getMinY() - _origin.y) / cellSize));
+        int maxRow = std::min(_rows - 1, (int)std::ceil((r.getMaxY() - _origin.y) / cellSize) - 1);
+
+        for (int row = minRow; row <= maxRow; row++)
+        {
+            for (int col = minCol; col <= maxCol; col++)
+            {
+                _blocked[row * _cols + col] = 1;
+            }
+        }
+    }
+
+    CCLOG("FlowField: 导航网格 %d x %d, 格子 %.0f px", _cols, _rows, cellSize);
+}
+
+int FlowField::cellIndexAt(const Vec2& worldPos) const
+{
+    if (_cols == 0) return -1;
+
+    int col = (int)std::floor((worldPos.x - _origin.x) / _cellSize);
+    int row = (int)std::floor((worldPos.y - _origin.y) / _cellSize);
+    if (col < 0 || col >= _cols || row < 0 || row >= _rows)
+    {
+        return -1;
+    }
+    return row * _cols + col;
+}
+
+bool FlowField::updateTarget(const Vec2& targetPos)
+{
+    _targetPos = targetPos;
+
+    int cell = cellIndexAt(targetPos);
+    if (cell < 0)
+    {
+        _targetCell = -1;
+        return false;
+    }
+
+    // 玩家脚下的格子通常和地面重叠，向上/周围找一个可通行的格子作为目标
+    if (_blocked[cell])
+    {
+        int col = cell % _cols;
+        int row = cell / _cols;
+        int found = -1;
+        for (int radius = 1; radius <= 2 && found < 0; radius++)
+        {
+            if (row + radius < _rows && !_blocked[(row + radius) * _cols + col])
+            {
+                found = (row + radius) * _cols + col;
+                break;
+            }
+            for (int d = 0; d < 8; d++)
+            {
+                int nc = col + DIR_X[d] * radius;
+                int nr = row + DIR_Y[d] * radius;
+                if (nc >= 0 && nc < _cols && nr >= 0 && nr < _rows && !_blocked[nr * _cols + nc])
+                {
+                    found = nr * _cols + nc;
+                    break;
+                }
+            }
+        }
+        if (found < 0)
+        {
+            _targetCell = -1;
+            return false;
+        }
+        cell = found;
+    }
+
+    // 只有换格子才重算
+    if (cell == _targetCell)
+    {
+        return false;
+    }
+
+    recompute(cell);
+    return true;
+}
+
+void FlowField::recompute(int targetCell)
+{
+    // 只清理上次 BFS 访问过的格子，而不是整张网格
+    for (int index : _queue)
+    {
+        _distance[index] = DIST_UNREACHABLE;
+        _direction[index] = DIR_NONE;
+    }
+    _queue.clear();
+
+    _targetCell = targetCell;
+    _distance[targetCell] = 0;
+    _queue.push_back(targetCell);
+
+    size_t head = 0;
+    while (head < _queue.size())
+    {
+        int current = _queue[head++];
+        uint16_t dist = _distance[current];
+        if (dist >= _maxSearchSteps)
+        {
+            continue;
+        }
+
+        int col = current % _cols;
+        int row = current / _cols;
+
+        for (int d = 0; d < 8; d++)
+        {
+            int nc = col + DIR_X[d];
+            int nr = row + DIR_Y[d];
+            if (nc < 0 || nc >= _cols || nr < 0 || nr >= _rows)
+            {
+                continue;
+            }
+
+            int next = nr * _cols + nc;
+            if (_blocked[next] || _distance[next] != DIST_UNREACHABLE)
+            {
+                continue;
+            }
+
+            // 斜向移动不允许穿过墙角
+            if (d >= 4 && (_blocked[row * _cols + nc] || _blocked[nr * _cols + col]))
+            {
+                continue;
+            }
+
+            _distance[next] = dist + 1;
+            _direction[next] = DIR_OPPOSITE[d];
+            _queue.push_back(next);
+        }
+    }
+}
+
+Vec2 FlowField::sampleDirection(const Vec2& worldPos) const
+{
+    Vec2 direct = _targetPos - worldPos;
+    if (direct.x != 0.0f || direct.y != 0.0f)
+    {
+        direct.normalize();
+    }
+
+    if (_targetCell < 0)
+    {
+        return direct;
+    }
+
+    int cell = cellIndexAt(worldPos);
+    if (cell < 0 || _blocked[cell])
+    {
+        return direct;
+    }
+
+    // 已经在目标附近或不可达时直线追击
+    uint16_t dist = _distance[cell];
+    if (dist <= 1 || dist == DIST_UNREACHABLE)
+    {
+        return direct;
+    }
+
+    return DIR_VEC[_direction[cell]];
+}
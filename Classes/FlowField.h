@@ -0,0 +1,63 @@
+#ifndef __FLOW_FIELD_H__
+#define __FLOW_FIELD_H__
+
+#include "cocos2d.h"
+#include "TheKnight.h"  // Platform 
+
+/**
+ * Ѱ·
+ *
+ * ɹؿײƽ̨ɶάڸΪĿһ BFS
+ * ÿӼ¼Ŀһ׷ֻ O(1) 
+ * һʱ¼㣬׷ٶ࿪Ҳ䡣
+ */
+class FlowField
+{
+public:
+    FlowField();
+
+    /**
+     * ײƽ̨ɵ
+     * @param platforms ײƽ̨꣩
+     * @param cellSize  ӱ߳أ
+     * @param margin    ߽ƽ̨Χľ
+     */
+    void build(const std::vector<Platform>& platforms, float cellSize = 64.0f, float margin = 256.0f);
+
+    //  BFS չΧĸΪɴ׷˻ֱ׷
+    void setMaxSearchSteps(int steps) { _maxSearchSteps = steps; }
+
+    /**
+     * ĿλãֻĿ껻ʱ¼
+     * @return Ƿ¼
+     */
+    bool updateTarget(const cocos2d::Vec2& targetPos);
+
+    /**
+     * ĳλóĿƶ򣨵λ
+     * ⡢ӱ赲򲻿ɴʱֱ߷
+     */
+    cocos2d::Vec2 sampleDirection(const cocos2d::Vec2& worldPos) const;
+
+    bool isReady() const { return !_blocked.empty(); }
+
+private:
+    int cellIndexAt(const cocos2d::Vec2& worldPos) const;
+    void recompute(int targetCell);
+
+    cocos2d::Vec2 _origin;             // ½ǣ꣩
+    float _cellSize;
+    int _cols;
+    int _rows;
+    int _maxSearchSteps;
+
+    std::vector<uint8_t> _blocked;     // Ƿƽ̨ռ
+    std::vector<uint16_t> _distance;   // ĿĲ0xFFFF Ϊɴ
+    std::vector<uint8_t> _direction;   // һ FlowField.cpp еķ
+    std::vector<int> _queue;           // BFS Уñÿη
+
+    int _targetCell;
+    cocos2d::Vec2 _targetPos;
+};
+
+#endif // __FLOW_FIELD_H__
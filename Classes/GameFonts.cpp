@@ -0,0 +1,105 @@
+#include "GameFonts.h"
+#include "2d/CCFontAtlasCache.h"
+
+USING_NS_CC;
+
+namespace GameFonts
+{
+    const char* const CJK_FONT = "fonts/NotoSerifCJKsc-Regular.otf";
+
+    // 決ַ
+    static const char* const CJK_BAKED_FNT = "fonts/NotoSerifCJKsc-Regular-sdf.fnt";
+    static const char* const CJK_GLYPH_LIST = "fonts/NotoSerifCJKsc-glyphs.txt";
+
+    // 決ֺţϷı 95 ţ48 ŵľ볡ŴԵȻ
+    static const float BAKE_FONT_SIZE = 48.0f;
+
+    // ļȱʧʱ˻صϵͳ
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+    static const char* const CJK_SYSTEM_FONT = "Microsoft YaHei";
+#else
+    static const char* const CJK_SYSTEM_FONT = "Noto Serif CJK SC";
+#endif
+
+    // ļǷڣֻһΣȱʧʱÿδǩȳԼ TTF
+    static bool hasCjkFont()
+    {
+        static const bool exists = FileUtils::getInstance()->isFileExist(CJK_FONT);
+        return exists;
+    }
+
+    bool registerBakedFonts()
+    {
+        if (!hasCjkFont())
+        {
+            CCLOG("GameFonts: %s not found (tools/fetch_cjk_font.py), labels use the system font", CJK_FONT);
+            return false;
+        }
+
+        bool registered = FontAtlasCache::registerBakedFontAtlas(CJK_FONT, CJK_BAKED_FNT);
+        if (!registered)
+        {
+            CCLOG("GameFonts: %s not found (cmake --build . --target bake_fonts), labels rasterize glyphs at runtime", CJK_BAKED_FNT);
+        }
+        return registered;
+    }
+
+    Label* createLabel(const std::string& text, float fontSize)
+    {
+        Label* label = nullptr;
+        if (hasCjkFont())
+        {
+            label = Label::createWithTTF(text, CJK_FONT, fontSize);
+        }
+        if (!label)
+        {
+            label = Label::createWithSystemFont(text, CJK_SYSTEM_FONT, fontSize);
+        }
+        return label;
+    }
+
+    bool bakeFonts(const std::string& outputDir)
+    {
+        auto fileUtils = FileUtils::getInstance();
+        if (!hasCjkFont())
+        {
+            log("GameFonts: %s not found, run tools/fetch_cjk_font.py first", CJK_FONT);
+            return false;
+        }
+
+        std::u32string glyphs;
+        StringUtils::UTF8ToUTF32(fileUtils->getStringFromFile(CJK_GLYPH_LIST), glyphs);
+        if (glyphs.empty())
+        {
+            log("GameFonts: %s is empty, run tools/collect_font_glyphs.py first", CJK_GLYPH_LIST);
+            return false;
+        }
+        // ASCII ɴӡַǴϣ֡Ӣʾ
+        for (char32_t code = 0x20; code <= 0x7e; ++code)
+        {
+            glyphs.push_back(code);
+        }
+
+        std::string fntName = CJK_BAKED_FNT;
+        fntName = fntName.substr(fntName.find_last_of('/') + 1);
+        std::string fntPath;
+        if (outputDir.empty())
+        {
+            std::string fontPath = fileUtils->fullPathForFilename(CJK_FONT);
+            fntPath = fontPath.substr(0, fontPath.find_last_of('/') + 1) + fntName;
+        }
+        else
+        {
+            fntPath = outputDir;
+            if (fntPath.back() != '/')
+            {
+                fntPath += '/';
+            }
+            fntPath += fntName;
+        }
+
+        bool baked = FontAtlasCache::bakeDistanceFieldFont(CJK_FONT, glyphs, BAKE_FONT_SIZE, fntPath);
+        log("GameFonts: %s %s", baked ? "baked" : "failed to bake", fntPath.c_str());
+        return baked;
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#ifndef __GAME_FONTS_H__
+#define __GAME_FONTS_H__
+
+#include <string>
+#include "cocos2d.h"
+
+// Ϸ壺·Ԥ決 SDF ͼעߺ決
+namespace GameFonts
+{
+    // Ϸıǩʹõ
+    extern const char* const CJK_FONT;
+
+    // עԤ決 SDF ͼfonts/NotoSerifCJKsc-Regular-sdf.fntʱһ
+    // עͬһֺŹһͼǩ״λƶٹդ
+    bool registerBakedFonts();
+
+    // ıǩ TTFԤ決ͼļȱʧʱֱϵͳ壨ֻһļ
+    cocos2d::Label* createLabel(const std::string& text, float fontSize);
+
+    // ߺ決ȡ fonts/NotoSerifCJKsc-glyphs.txt tools/collect_font_glyphs.py ɣ
+    // ͬ ASCII ɴӡַһ決 SDF ͼд outputDirΪʱдĿ¼
+    // ͨ HollowKnight --bake-fonts  CMake  bake_fonts ĿУ OfflineTools tools/fetch_cjk_font.py ȡ
+    bool bakeFonts(const std::string& outputDir);
+}
+
+#endif // __GAME_FONTS_H__
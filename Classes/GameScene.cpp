@@ -1,11 +1,16 @@
 ﻿#include "GameScene.h"
 #include "TheKnight.h"
+#include "PlatformCollision.h"  // 【新增】solid 图块碰撞平台
 #include "NextScene.h"
 #include <BossScene.h>
 #include "CharmManager.h"
 #include "Monster/CrawlidMonster.h"
 #include "SimpleAudioEngine.h"
 #include "PauseMenu.h"
+#include "SaveManager.h"  // 【新增】存档
+#include "SoundBank.h"  // 【新增】场景音效库
+#include "InputManager.h"  // 【新增】统一输入
+#include "GameFonts.h"  // 【新增】中文字体/预烘焙图集
 
 USING_NS_CC;
 
@@ -55,6 +60,12 @@ bool GameScene::init()
     if (!Scene::init())
         return false;
 
+    // 【新增】本场景加载的纹理记在 "Dirtmouth" 名下（控制台 texture residency 按场景统计显存）
+    Director::getInstance()->getTextureCache()->setOwnerTag("Dirtmouth");
+
+    // 【新增】预加载本场景音效（战斗中不再解码）
+    SoundBank::getInstance()->loadBank({ SoundGroup::UI, SoundGroup::KNIGHT, SoundGroup::ENEMY });
+
     Size visibleSize = Director::getInstance()->getVisibleSize();
     Vec2 origin = Director::getInstance()->getVisibleOrigin();
 
@@ -96,6 +107,7 @@ bool GameScene::init()
         maxMapHeight = std::max(maxMapHeight, mapTop);
 
         createCollisionFromTMX(map, "Collision", scale, mapPos);
+        PlatformCollision::addSolidTilePlatforms(map, scale, mapPos, _platforms);
         loadInteractiveObjects(map, scale, mapPos);  // 确保这个在 Knight 创建前调用
         loadForegroundObjects(map, scale, mapPos);
     }
@@ -122,16 +134,26 @@ bool GameScene::init()
         
         CharmManager::getInstance()->syncToKnight(_knight);
         
+        // 【新增】读档后首次进入时恢复 HP/Soul
+        SaveManager::getInstance()->applyToKnight(_knight);
+        SaveManager::getInstance()->markSceneVisited(SaveScene::DIRTMOUTH);
+        
         // 【修改】检查是否从 NextScene 死亡返回，需要坐在椅子上
         if (s_hasCustomSpawn && !s_spawnDoJump)
         {
             // 从 NextScene 死亡返回，让 Knight 坐在椅子上
             CCLOG("Knight died in NextScene, respawning on chair in GameScene");
             
-            // 查找椅子位置
+            // 【修改】优先使用存档记录的休息位置，没有记录时再查找椅子位置
             Vec2 chairPos = Vec2::ZERO;
+            const auto& saveData = SaveManager::getInstance()->getData();
+            if (saveData.benchScene == SaveScene::DIRTMOUTH)
+            {
+                chairPos = saveData.respawnPosition;
+            }
             for (const auto& obj : _interactiveObjects)
             {
+                if (chairPos != Vec2::ZERO) break;
                 if (obj.name == "Chair")
                 {
                     chairPos = obj.position;
@@ -187,7 +209,7 @@ bool GameScene::init()
         }
     }
 
-    _interactionLabel = Label::createWithSystemFont(u8"休息", "fonts/NotoSerifCJKsc-Regular.otf", 24);
+    _interactionLabel = GameFonts::createLabel(u8"休息", 24);  // 【修改】走 TTF/预烘焙 SDF 图集，不再现场光栅化
     _interactionLabel->setTextColor(Color4B::WHITE);
     _interactionLabel->setVisible(false);
     this->addChild(_interactionLabel, 100, "InteractionLabel");
@@ -207,12 +229,12 @@ bool GameScene::init()
         Vec2 centerLocal = Vec2(vs.width * 0.5f, vs.height * 0.5f);
 
         // 主标题
-        auto sceneTitle = Label::createWithSystemFont(u8"德特茅斯", "fonts/NotoSerifCJKsc-Regular.otf", 95);
+        auto sceneTitle = GameFonts::createLabel(u8"德特茅斯", 95);  // 【修改】走 TTF/预烘焙 SDF 图集，不再现场光栅化
         sceneTitle->setTextColor(Color4B::WHITE);
         sceneTitle->setAnchorPoint(Vec2(0.5f, 0.5f));
 
         // 副标题（小字）
-        auto sceneSubtitle = Label::createWithSystemFont(u8"衰败的小镇", "fonts/NotoSerifCJKsc-Regular.otf", 45);
+        auto sceneSubtitle = GameFonts::createLabel(u8"衰败的小镇", 45);  // 【修改】走 TTF/预烘焙 SDF 图集，不再现场光栅化
         sceneSubtitle->setTextColor(Color4B::WHITE);
         sceneSubtitle->setAnchorPoint(Vec2(0.5f, 0.5f));
 
@@ -278,60 +300,22 @@ bool GameScene::init()
     _targetCameraOffsetY = 0.0f;
     _wasSitting = false;
 
-    auto keyboardListener = EventListenerKeyboard::create();
-    keyboardListener->onKeyPressed = [this](EventKeyboard::KeyCode keyCode, Event* event) {
-        // 【新增】ESC 键打开/关闭暂停菜单
-        if (keyCode == EventKeyboard::KeyCode::KEY_ESCAPE)
+    // 【修改】按键改由 InputManager 统一采集：暂停键走即时事件（暂停后调度器停止，无法轮询），
+    // 其他交互（护符面板、坐椅子）在 update 中轮询动作快照
+    auto pauseListener = EventListenerCustom::create(InputManager::EVENT_PAUSE_PRESSED, [this](EventCustom* event) {
+        if (_pauseMenu)
         {
-            if (_pauseMenu)
+            if (_pauseMenu->isVisible())
             {
-                if (_pauseMenu->isVisible())
-                {
-                    _pauseMenu->hide();
-                }
-                else
-                {
-                    _pauseMenu->show();
-                }
-            }
-            return;
-        }
-        
-        // 【新增】暂停时不处理其他按键
-        if (_pauseMenu && _pauseMenu->isVisible())
-        {
-            return;
-        }
-        
-        if (keyCode == EventKeyboard::KeyCode::KEY_Q)
-        {
-            auto charmManager = CharmManager::getInstance();
-            if (charmManager->isPanelOpen())
-            {
-                charmManager->hideCharmPanel();
-                if (_knight)
-                {
-                    charmManager->syncToKnight(_knight);
-                }
+                _pauseMenu->hide();
             }
             else
             {
-                bool canEquip = _knight && _knight->isSitting();
-                charmManager->showCharmPanel(this, canEquip);
+                _pauseMenu->show();
             }
-            return;
         }
-        
-        if (_knight && _knight->isNearChair() && !_knight->isSitting())
-        {
-            if (keyCode == EventKeyboard::KeyCode::KEY_W || 
-                keyCode == EventKeyboard::KeyCode::KEY_CAPITAL_W)
-            {
-                _knight->startSitting();
-            }
-        }
-    };
-    _eventDispatcher->addEventListenerWithSceneGraphPriority(keyboardListener, this);
+    });
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(pauseListener, this);
 
     this->scheduleUpdate();
 
@@ -343,7 +327,7 @@ bool GameScene::init()
     CCLOG("共加载 %zu 个交互对象", _interactiveObjects.size());
 
     // 播放 Dirtmouth 背景音乐（循环）
-    CocosDenshion::SimpleAudioEngine::getInstance()->stopBackgroundMusic();
+    // 【修改】不再先 stop，切换区域时与上一首交叉淡入淡出（Linux 下长音乐流式播放）
     CocosDenshion::SimpleAudioEngine::getInstance()->playBackgroundMusic("Music/Dirtmouth.wav", true);
 
     return true;
@@ -697,6 +681,9 @@ void GameScene::checkInteractions()
                 // 进入出口，切换到 NextScene
                 _isTransitioning = true;
 
+                // 【新增】切换场景前自动存档（IO 线程写盘，不卡过场）
+                SaveManager::getInstance()->autosave(_knight, SaveScene::DIRTMOUTH);
+
                 auto blackLayer = LayerColor::create(Color4B(0, 0, 0, 0));
                 this->addChild(blackLayer, 1000);
 
@@ -766,8 +753,47 @@ void GameScene::updateCamera()
     camera->setPosition(Vec2(newX, newY));
 }
 
+// 【新增】轮询本帧的交互动作
+void GameScene::handleInput()
+{
+    // 暂停时不处理其他按键
+    if (_pauseMenu && _pauseMenu->isVisible())
+    {
+        return;
+    }
+
+    auto input = InputManager::getInstance();
+
+    if (input->isPressed(InputAction::CHARM))
+    {
+        auto charmManager = CharmManager::getInstance();
+        if (charmManager->isPanelOpen())
+        {
+            charmManager->hideCharmPanel();
+            if (_knight)
+            {
+                charmManager->syncToKnight(_knight);
+            }
+        }
+        else
+        {
+            bool canEquip = _knight && _knight->isSitting();
+            charmManager->showCharmPanel(this, canEquip);
+        }
+        return;
+    }
+
+    if (input->isPressed(InputAction::UP) && _knight && _knight->isNearChair() && !_knight->isSitting())
+    {
+        _knight->startSitting();
+    }
+}
+
 void GameScene::update(float dt)
 {
+    // 【新增】处理交互按键
+    handleInput();
+
     // 更新摄像机
     updateCamera();
     
@@ -783,6 +809,12 @@ void GameScene::update(float dt)
         if (isSitting && !_wasSitting)
         {
             startHPRecoveryAnimation();
+
+            // 【新增】坐上椅子：记录重生点、普通敌人复活、自动存档
+            auto saveManager = SaveManager::getInstance();
+            saveManager->setBench(SaveScene::DIRTMOUTH, _knight->getPosition());
+            saveManager->clearDefeatedEnemies();
+            saveManager->autosave(_knight, SaveScene::DIRTMOUTH);
         }
         
         _wasSitting = isSitting;
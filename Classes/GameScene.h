@@ -24,6 +24,7 @@ private:
                                  const std::string& layerName, 
                                  float scale, 
                                  const cocos2d::Vec2& mapOffset);
+
     
     void loadInteractiveObjects(cocos2d::TMXTiledMap* map, 
                                 float scale, 
@@ -32,6 +33,9 @@ private:
         float scale,
         const cocos2d::Vec2& mapOffset);
     void checkInteractions();
+
+    // ѯ塢ӣ
+    void handleInput();
     
     // 
     void updateCamera();
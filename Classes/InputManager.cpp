@@ -0,0 +1,402 @@
+﻿#include "InputManager.h"
+
+USING_NS_CC;
+
+namespace
+{
+    typedef EventKeyboard::KeyCode KeyCode;
+
+    // 摇杆超过该值视为按下方向
+    const float STICK_DEADZONE = 0.5f;
+
+    const int KEY_COUNT = static_cast<int>(KeyCode::KEY_PLAY) + 1;
+
+    // 保存键位用的 UserDefault 键名（与 InputAction 顺序一致）
+    const char* const ACTION_SAVE_KEYS[] = {
+        "input_left", "input_right", "input_up", "input_down",
+        "input_attack", "input_jump", "input_dash", "input_spell",
+        "input_map", "input_charm", "input_pause", "input_confirm", "input_cancel"
+    };
+    static_assert(sizeof(ACTION_SAVE_KEYS) / sizeof(ACTION_SAVE_KEYS[0]) == static_cast<int>(InputAction::COUNT),
+                  "ACTION_SAVE_KEYS must match InputAction");
+
+    // 第 slot 个键位的存档键名：主键位沿用旧键名（兼容已有存档），其余加 "_2"、"_3" 后缀
+    std::string bindingSaveKey(int action, int slot)
+    {
+        std::string name = ACTION_SAVE_KEYS[action];
+        if (slot > 0)
+        {
+            name += "_" + std::to_string(slot + 1);
+        }
+        return name;
+    }
+}
+
+const char* InputManager::EVENT_PAUSE_PRESSED = "input_pause_pressed";
+
+InputManager* InputManager::_instance = nullptr;
+
+InputManager* InputManager::getInstance()
+{
+    if (_instance == nullptr)
+    {
+        _instance = new InputManager();
+    }
+    return _instance;
+}
+
+InputManager::InputManager()
+    : _initialized(false)
+    , _keyDown(KEY_COUNT, false)
+    , _stickX(0.0f)
+    , _stickY(0.0f)
+    , _rebindAction(InputAction::COUNT)
+{
+    setDefaultBindings();
+}
+
+void InputManager::init()
+{
+    if (_initialized) return;
+    _initialized = true;
+
+    loadBindings();
+
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+
+    // 全局固定优先级监听，不依赖任何场景节点
+    auto keyboardListener = EventListenerKeyboard::create();
+    keyboardListener->onKeyPressed = [this](EventKeyboard::KeyCode keyCode, Event* event) {
+        onKeyPressed(keyCode);
+    };
+    keyboardListener->onKeyReleased = [this](EventKeyboard::KeyCode keyCode, Event* event) {
+        onKeyReleased(keyCode);
+    };
+    dispatcher->addEventListenerWithFixedPriority(keyboardListener, 1);
+
+    auto controllerListener = EventListenerController::create();
+    controllerListener->onKeyDown = [this](Controller* controller, int keyCode, Event* event) {
+        if (!Director::getInstance()->isPaused())
+        {
+            _pendingEvents.push_back({ RawEvent::Type::BUTTON, keyCode, 1.0f });
+        }
+        for (int i = 0; i < MAX_BINDINGS; i++)
+        {
+            if (_bindings[index(InputAction::PAUSE)].buttons[i] == keyCode)
+            {
+                EventCustom pauseEvent(EVENT_PAUSE_PRESSED);
+                Director::getInstance()->getEventDispatcher()->dispatchEvent(&pauseEvent);
+                break;
+            }
+        }
+    };
+    controllerListener->onKeyUp = [this](Controller* controller, int keyCode, Event* event) {
+        _pendingEvents.push_back({ RawEvent::Type::BUTTON, keyCode, 0.0f });
+    };
+    controllerListener->onAxisEvent = [this](Controller* controller, int keyCode, Event* event) {
+        float value = controller->getKeyStatus(keyCode).value;
+        _pendingEvents.push_back({ RawEvent::Type::AXIS, keyCode, value });
+    };
+    dispatcher->addEventListenerWithFixedPriority(controllerListener, 1);
+    Controller::startDiscoveryController();
+
+    // 在所有节点 update（优先级 0）之前整理快照
+    Director::getInstance()->getScheduler()->scheduleUpdate(this, Scheduler::PRIORITY_SYSTEM + 1, false);
+}
+
+EventKeyboard::KeyCode InputManager::normalizeKey(EventKeyboard::KeyCode key)
+{
+    int code = static_cast<int>(key);
+    if (code >= static_cast<int>(KeyCode::KEY_CAPITAL_A) && code <= static_cast<int>(KeyCode::KEY_CAPITAL_Z))
+    {
+        return static_cast<KeyCode>(code - static_cast<int>(KeyCode::KEY_CAPITAL_A) + static_cast<int>(KeyCode::KEY_A));
+    }
+    return key;
+}
+
+void InputManager::onKeyPressed(EventKeyboard::KeyCode key)
+{
+    key = normalizeKey(key);
+
+    // 改键模式：这次按键只用于绑定，不进入快照
+    if (isRebinding())
+    {
+        InputAction action = _rebindAction;
+        auto callback = _rebindCallback;
+        _rebindAction = InputAction::COUNT;
+        _rebindCallback = nullptr;
+
+        // 【修改】F3 留给性能浮层，不能绑定
+        bool success = key != KeyCode::KEY_ESCAPE && key != KeyCode::KEY_F3;
+        if (success)
+        {
+            rebindKey(action, key);
+        }
+        if (callback)
+        {
+            callback(success);
+        }
+        return;
+    }
+
+    // 【新增】F3 开关性能浮层（调试用，不属于可改键的动作，暂停时也能切换）
+    if (key == KeyCode::KEY_F3)
+    {
+        auto director = Director::getInstance();
+        director->setDisplayFrameStats(!director->isDisplayFrameStats());
+        return;
+    }
+
+    // 暂停期间调度器不走，按下事件不入队，避免恢复后把菜单里的按键当成游戏操作（松开事件照常入队）
+    if (!Director::getInstance()->isPaused())
+    {
+        _pendingEvents.push_back({ RawEvent::Type::KEY, static_cast<int>(key), 1.0f });
+    }
+
+    for (int i = 0; i < MAX_BINDINGS; i++)
+    {
+        if (_bindings[index(InputAction::PAUSE)].keys[i] == key)
+        {
+            EventCustom pauseEvent(EVENT_PAUSE_PRESSED);
+            Director::getInstance()->getEventDispatcher()->dispatchEvent(&pauseEvent);
+            break;
+        }
+    }
+}
+
+void InputManager::onKeyReleased(EventKeyboard::KeyCode key)
+{
+    key = normalizeKey(key);
+    _pendingEvents.push_back({ RawEvent::Type::KEY, static_cast<int>(key), 0.0f });
+}
+
+bool InputManager::isActionDown(int actionIndex) const
+{
+    const Binding& binding = _bindings[actionIndex];
+    for (int i = 0; i < MAX_BINDINGS; i++)
+    {
+        int key = static_cast<int>(binding.keys[i]);
+        if (key > 0 && key < KEY_COUNT && _keyDown[key])
+        {
+            return true;
+        }
+
+        int button = binding.buttons[i];
+        if (button != Controller::KEY_NONE)
+        {
+            auto it = _buttonDown.find(button);
+            if (it != _buttonDown.end() && it->second)
+            {
+                return true;
+            }
+        }
+    }
+
+    // 左摇杆等同于方向键
+    switch (static_cast<InputAction>(actionIndex))
+    {
+        case InputAction::LEFT:  return _stickX < -STICK_DEADZONE;
+        case InputAction::RIGHT: return _stickX > STICK_DEADZONE;
+        case InputAction::UP:    return _stickY < -STICK_DEADZONE;   // 手柄 Y 轴向上为负
+        case InputAction::DOWN:  return _stickY > STICK_DEADZONE;
+        default:                 return false;
+    }
+}
+
+void InputManager::update(float dt)
+{
+    const int actionCount = static_cast<int>(InputAction::COUNT);
+
+    for (int i = 0; i < actionCount; i++)
+    {
+        _states[i].pressed = false;
+        _states[i].released = false;
+    }
+
+    // 按顺序回放本帧的原始事件，同一帧内按下又松开也能得到 pressed 和 released
+    for (const auto& event : _pendingEvents)
+    {
+        switch (event.type)
+        {
+            case RawEvent::Type::KEY:
+                if (event.code > 0 && event.code < KEY_COUNT)
+                {
+                    _keyDown[event.code] = event.value > 0.0f;
+                }
+                break;
+            case RawEvent::Type::BUTTON:
+                _buttonDown[event.code] = event.value > 0.0f;
+                break;
+            case RawEvent::Type::AXIS:
+                if (event.code == Controller::JOYSTICK_LEFT_X) _stickX = event.value;
+                else if (event.code == Controller::JOYSTICK_LEFT_Y) _stickY = event.value;
+                else _buttonDown[event.code] = event.value > STICK_DEADZONE;  // 扳机按键当作按钮
+                break;
+        }
+
+        for (int i = 0; i < actionCount; i++)
+        {
+            bool down = isActionDown(i);
+            if (down && !_states[i].held)
+            {
+                _states[i].pressed = true;
+                _states[i].holdTime = 0.0f;
+            }
+            else if (!down && _states[i].held)
+            {
+                _states[i].released = true;
+            }
+            _states[i].held = down;
+        }
+    }
+    _pendingEvents.clear();
+
+    for (int i = 0; i < actionCount; i++)
+    {
+        if (_states[i].held)
+        {
+            _states[i].holdTime += dt;
+        }
+    }
+}
+
+void InputManager::setDefaultBindings()
+{
+    auto bind = [this](InputAction action, KeyCode key1, KeyCode key2, int button1, int button2) {
+        Binding& binding = _bindings[index(action)];
+        binding.keys[0] = key1;
+        binding.keys[1] = key2;
+        binding.buttons[0] = button1;
+        binding.buttons[1] = button2;
+    };
+
+    bind(InputAction::LEFT,    KeyCode::KEY_A,      KeyCode::KEY_LEFT_ARROW,  Controller::BUTTON_DPAD_LEFT,  Controller::KEY_NONE);
+    bind(InputAction::RIGHT,   KeyCode::KEY_D,      KeyCode::KEY_RIGHT_ARROW, Controller::BUTTON_DPAD_RIGHT, Controller::KEY_NONE);
+    bind(InputAction::UP,      KeyCode::KEY_W,      KeyCode::KEY_UP_ARROW,    Controller::BUTTON_DPAD_UP,    Controller::KEY_NONE);
+    bind(InputAction::DOWN,    KeyCode::KEY_S,      KeyCode::KEY_DOWN_ARROW,  Controller::BUTTON_DPAD_DOWN,  Controller::KEY_NONE);
+    bind(InputAction::ATTACK,  KeyCode::KEY_J,      KeyCode::KEY_NONE,        Controller::BUTTON_X,          Controller::KEY_NONE);
+    bind(InputAction::JUMP,    KeyCode::KEY_K,      KeyCode::KEY_NONE,        Controller::BUTTON_A,          Controller::KEY_NONE);
+    bind(InputAction::DASH,    KeyCode::KEY_L,      KeyCode::KEY_NONE,        Controller::BUTTON_RIGHT_SHOULDER, Controller::AXIS_RIGHT_TRIGGER);
+    bind(InputAction::SPELL,   KeyCode::KEY_SPACE,  KeyCode::KEY_NONE,        Controller::BUTTON_B,          Controller::KEY_NONE);
+    bind(InputAction::MAP,     KeyCode::KEY_TAB,    KeyCode::KEY_NONE,        Controller::BUTTON_SELECT,     Controller::KEY_NONE);
+    bind(InputAction::CHARM,   KeyCode::KEY_Q,      KeyCode::KEY_NONE,        Controller::BUTTON_LEFT_SHOULDER, Controller::KEY_NONE);
+    bind(InputAction::PAUSE,   KeyCode::KEY_ESCAPE, KeyCode::KEY_NONE,        Controller::BUTTON_START,      Controller::KEY_NONE);
+    bind(InputAction::CONFIRM, KeyCode::KEY_Y,      KeyCode::KEY_NONE,        Controller::BUTTON_Y,          Controller::KEY_NONE);
+    bind(InputAction::CANCEL,  KeyCode::KEY_N,      KeyCode::KEY_NONE,        Controller::BUTTON_RIGHT_THUMBSTICK, Controller::KEY_NONE);
+}
+
+void InputManager::loadBindings()
+{
+    auto userDefault = UserDefault::getInstance();
+    for (int i = 0; i < static_cast<int>(InputAction::COUNT); i++)
+    {
+        // 【修改】主键位和副键位都读取；没存过的保持默认，副键位存 0 表示已清空
+        for (int k = 0; k < MAX_BINDINGS; k++)
+        {
+            int key = userDefault->getIntegerForKey(bindingSaveKey(i, k).c_str(), -1);
+            bool valid = k == 0 ? (key > 0 && key < KEY_COUNT) : (key >= 0 && key < KEY_COUNT);
+            if (valid)
+            {
+                _bindings[i].keys[k] = static_cast<KeyCode>(key);
+            }
+        }
+    }
+}
+
+void InputManager::saveBindings()
+{
+    auto userDefault = UserDefault::getInstance();
+    for (int i = 0; i < static_cast<int>(InputAction::COUNT); i++)
+    {
+        // 【修改】换键时副键位也可能被交换或清空，全部保存
+        for (int k = 0; k < MAX_BINDINGS; k++)
+        {
+            userDefault->setIntegerForKey(bindingSaveKey(i, k).c_str(), static_cast<int>(_bindings[i].keys[k]));
+        }
+    }
+    userDefault->flush();
+}
+
+void InputManager::rebindKey(InputAction action, EventKeyboard::KeyCode key)
+{
+    key = normalizeKey(key);
+    Binding& target = _bindings[index(action)];
+    KeyCode oldKey = target.keys[0];
+    if (oldKey == key) return;
+
+    // 其他动作占用了这个键：把本动作原来的主键位换给它
+    for (int i = 0; i < static_cast<int>(InputAction::COUNT); i++)
+    {
+        if (i == index(action)) continue;
+        for (int k = 0; k < MAX_BINDINGS; k++)
+        {
+            if (_bindings[i].keys[k] == key)
+            {
+                _bindings[i].keys[k] = oldKey;
+            }
+        }
+    }
+    if (target.keys[1] == key)
+    {
+        target.keys[1] = KeyCode::KEY_NONE;
+    }
+    target.keys[0] = key;
+
+    saveBindings();
+    CCLOG("InputManager: 动作 %d 绑定到 %s", index(action), getKeyName(key).c_str());
+}
+
+void InputManager::beginRebind(InputAction action, const std::function<void(bool)>& callback)
+{
+    _rebindAction = action;
+    _rebindCallback = callback;
+}
+
+void InputManager::cancelRebind()
+{
+    _rebindAction = InputAction::COUNT;
+    _rebindCallback = nullptr;
+}
+
+void InputManager::resetBindings()
+{
+    setDefaultBindings();
+    saveBindings();
+}
+
+std::string InputManager::getKeyName(EventKeyboard::KeyCode key)
+{
+    int code = static_cast<int>(key);
+    if (code >= static_cast<int>(KeyCode::KEY_A) && code <= static_cast<int>(KeyCode::KEY_Z))
+    {
+        return std::string(1, (char)('A' + code - static_cast<int>(KeyCode::KEY_A)));
+    }
+    if (code >= static_cast<int>(KeyCode::KEY_0) && code <= static_cast<int>(KeyCode::KEY_9))
+    {
+        return std::string(1, (char)('0' + code - static_cast<int>(KeyCode::KEY_0)));
+    }
+    if (code >= static_cast<int>(KeyCode::KEY_F1) && code <= static_cast<int>(KeyCode::KEY_F12))
+    {
+        return StringUtils::format("F%d", code - static_cast<int>(KeyCode::KEY_F1) + 1);
+    }
+
+    switch (key)
+    {
+        case KeyCode::KEY_NONE:        return "-";
+        case KeyCode::KEY_SPACE:       return "Space";
+        case KeyCode::KEY_TAB:         return "Tab";
+        case KeyCode::KEY_ESCAPE:      return "ESC";
+        case KeyCode::KEY_ENTER:       return "Enter";
+        case KeyCode::KEY_SHIFT:       return "Shift";
+        case KeyCode::KEY_RIGHT_SHIFT: return "Right Shift";
+        case KeyCode::KEY_CTRL:        return "Ctrl";
+        case KeyCode::KEY_RIGHT_CTRL:  return "Right Ctrl";
+        case KeyCode::KEY_ALT:         return "Alt";
+        case KeyCode::KEY_RIGHT_ALT:   return "Right Alt";
+        case KeyCode::KEY_LEFT_ARROW:  return u8"←";
+        case KeyCode::KEY_RIGHT_ARROW: return u8"→";
+        case KeyCode::KEY_UP_ARROW:    return u8"↑";
+        case KeyCode::KEY_DOWN_ARROW:  return u8"↓";
+        default:                       return StringUtils::format("Key %d", code);
+    }
+}
@@ -0,0 +1,139 @@
+#ifndef __INPUT_MANAGER_H__
+#define __INPUT_MANAGER_H__
+
+#include "cocos2d.h"
+
+// Ϸλֱӳ䵽ϣ
+enum class InputAction
+{
+    LEFT,       //  / ѡ
+    RIGHT,      //  / ѡ
+    UP,         // Ͽ / ӡڡNPC
+    DOWN,       // ¿
+    ATTACK,     // 
+    JUMP,       // Ծ / װж
+    DASH,       // 
+    SPELL,      // ۼ / 
+    MAP,        // ͼ
+    CHARM,      // 
+    PAUSE,      // ͣ˵
+    CONFIRM,    // Իѡ""
+    CANCEL,     // Իѡ""
+    COUNT
+};
+
+/**
+ * 
+ *
+ * ֱ̺¼ֻһΣȷŽУÿ֡ʼʱнڵ update ֮ǰ
+ * ͳһɶգ֡¡ס֡ɿסʱ
+ * Ϸ߼ update ѯգٸע̼Ƚԭʼ KeyCode
+ *
+ * ͣ˵ Director::pause() ͣ PAUSE ʱ
+ * ɷ EVENT_PAUSE_PRESSED Զ¼ͣ״̬Ӧ
+ */
+class InputManager
+{
+public:
+    static InputManager* getInstance();
+
+    // PAUSE ʱɷԶ¼
+    static const char* EVENT_PAUSE_PRESSED;
+
+    // ÿ󶨵ļ̰ / ֱ
+    static const int MAX_BINDINGS = 2;
+
+    // עʼɨֱȡѱļλAppDelegate ʱһΣ
+    void init();
+
+    // ɵÿ֡ʼã֡
+    void update(float dt);
+
+    // ղѯ
+    bool isPressed(InputAction action) const { return _states[index(action)].pressed; }
+    bool isHeld(InputAction action) const { return _states[index(action)].held; }
+    bool isReleased(InputAction action) const { return _states[index(action)].released; }
+    float getHoldTime(InputAction action) const { return _states[index(action)].holdTime; }
+
+    // λذ󶨣λͻʱ
+    void rebindKey(InputAction action, cocos2d::EventKeyboard::KeyCode key);
+    cocos2d::EventKeyboard::KeyCode getPrimaryKey(InputAction action) const { return _bindings[index(action)].keys[0]; }
+
+    /**
+     * ļģʽһµļ󶨵 action ϣESC ȡ
+     * @param callback ɺصΪǷɹļ
+     */
+    void beginRebind(InputAction action, const std::function<void(bool)>& callback);
+    bool isRebinding() const { return _rebindAction != InputAction::COUNT; }
+
+    // ļصڽرʱ
+    void cancelRebind();
+
+    // ָĬϼλ
+    void resetBindings();
+
+    // λʾýã
+    static std::string getKeyName(cocos2d::EventKeyboard::KeyCode key);
+
+private:
+    struct ActionState
+    {
+        bool pressed = false;
+        bool held = false;
+        bool released = false;
+        float holdTime = 0.0f;
+    };
+
+    struct Binding
+    {
+        cocos2d::EventKeyboard::KeyCode keys[MAX_BINDINGS];
+        int buttons[MAX_BINDINGS];   // cocos2d::Controller::Key
+    };
+
+    // ԭʼ¼¼صӣÿ֡ͳһ
+    struct RawEvent
+    {
+        enum class Type { KEY, BUTTON, AXIS } type;
+        int code;
+        float value;
+    };
+
+    InputManager();
+
+    static int index(InputAction action) { return static_cast<int>(action); }
+
+    // дĸͳһΪСдĸ
+    static cocos2d::EventKeyboard::KeyCode normalizeKey(cocos2d::EventKeyboard::KeyCode key);
+
+    void setDefaultBindings();
+    void loadBindings();
+    void saveBindings();
+
+    void onKeyPressed(cocos2d::EventKeyboard::KeyCode key);
+    void onKeyReleased(cocos2d::EventKeyboard::KeyCode key);
+
+    // ݵǰԭʼ״̬ж϶Ƿס
+    bool isActionDown(int actionIndex) const;
+
+private:
+    static InputManager* _instance;
+
+    bool _initialized;
+
+    Binding _bindings[static_cast<int>(InputAction::COUNT)];
+    ActionState _states[static_cast<int>(InputAction::COUNT)];
+
+    std::vector<RawEvent> _pendingEvents;
+
+    // ԭʼ״̬
+    std::vector<bool> _keyDown;
+    std::unordered_map<int, bool> _buttonDown;
+    float _stickX;
+    float _stickY;
+
+    // ļģʽ
+    InputAction _rebindAction;
+    std::function<void(bool)> _rebindCallback;
+};
+
+#endif // __INPUT_MANAGER_H__
@@ -13,6 +13,9 @@ bool LoadingScene::init()
     if (!Scene::init())
         return false;
 
+    // ص "Loading" £̨ texture residency ͳԴ棩
+    Director::getInstance()->getTextureCache()->setOwnerTag("Loading");
+
     auto visibleSize = Director::getInstance()->getVisibleSize();
     auto origin = Director::getInstance()->getVisibleOrigin();
 
@@ -41,11 +44,64 @@ bool LoadingScene::init()
     auto animate = RepeatForever::create(Animate::create(animation));
     hero->runAction(animate);
 
-    // ģ 3 ˵
+    // ޸ġֻǹ̶ȴ 3 룺ں̨̳߳زнɫ Boss Ķ֡
+    // ֮󳡾ͬ addImage ֱ档
+    // ʾ 3 Ž˵
+    _preloadDone = false;
+    _minTimeElapsed = false;
+
+    std::vector<std::string> paths;
+    auto fileUtils = FileUtils::getInstance();
+    const char* preloadDirs[] = { "TheKnight/", "shadow/", "Cornifer/", "Hornet/" };
+    for (const auto& dir : preloadDirs)
+    {
+        for (const auto& searchPath : fileUtils->getSearchPaths())
+        {
+            std::string fullDir = searchPath + dir;
+            if (!fileUtils->isDirectoryExist(fullDir))
+                continue;
+
+            std::vector<std::string> files;
+            fileUtils->listFilesRecursively(fullDir, &files);
+            for (const auto& file : files)
+            {
+                if (file.size() > 4 && file.compare(file.size() - 4, 4, ".png") == 0)
+                    paths.push_back(file);
+            }
+            break;
+        }
+    }
+
+    // Ŀ¼޷оٵƽ̨ Android  apk Դpaths Ϊգص
+    CCLOG("LoadingScene: Ԥ %zu ͼƬ߳ %u ",
+          paths.size(), TextureCache::getDecodeThreadCount());
+    // Ԥص֡ "Preload" ²סгʱԴԤ̭
+    // Ҳռ 64MB Ԥ㣨˵ĵһ̭ͻص Knight ֡
+    auto textureCache = Director::getInstance()->getTextureCache();
+    textureCache->setOwnerPinned("Preload", true);
+    textureCache->setOwnerTag("Preload");
+    textureCache->addImages(paths, [this](const std::vector<Texture2D*>&) {
+        _preloadDone = true;
+        onLoadingFinished();
+    });
+
     this->scheduleOnce([this](float) {
-        auto scene = MainMenuScene::createScene();
-        Director::getInstance()->replaceScene(TransitionFade::create(0.5f, scene));
+        _minTimeElapsed = true;
+        onLoadingFinished();
         }, 3.0f, "loading_finished");
 
     return true;
 }
+
+// ԤҴﵽʾʱ˵
+void LoadingScene::onLoadingFinished()
+{
+    if (!_preloadDone || !_minTimeElapsed)
+        return;
+
+    // ֮صָ "Global" £Ԥ̭
+    Director::getInstance()->getTextureCache()->setOwnerTag("Global");
+
+    auto scene = MainMenuScene::createScene();
+    Director::getInstance()->replaceScene(TransitionFade::create(0.5f, scene));
+}
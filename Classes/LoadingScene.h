@@ -12,6 +12,9 @@ public:
 
 private:
     void onLoadingFinished();
+
+    bool _preloadDone = false;      // ֡Ƿȫϴ
+    bool _minTimeElapsed = false;   // Ƿʾʱ
 };
 
 #endif // __LOADING_SCENE_H__
@@ -4,6 +4,7 @@
 #include <BossScene.h>
 #include "audio/include/SimpleAudioEngine.h"
 #include "SettingsPanel.h"
+#include "SaveManager.h"  // 【新增】存档
 
 USING_NS_CC;
 using namespace CocosDenshion;
@@ -18,6 +19,9 @@ bool MainMenuScene::init()
     if (!Scene::init())
         return false;
 
+    // 【新增】本场景加载的纹理记在 "MainMenu" 名下（控制台 texture residency 按场景统计显存）
+    Director::getInstance()->getTextureCache()->setOwnerTag("MainMenu");
+
     auto visibleSize = Director::getInstance()->getVisibleSize();
     auto origin = Director::getInstance()->getVisibleOrigin();
 
@@ -193,9 +197,8 @@ void MainMenuScene::startGame(Ref* sender)
     bg2->setOpacity(225);
     layer->addChild(bg2);
 
-    auto normalLabel = Label::createWithTTF(u8"普通模式", "fonts/NotoSerifCJKsc-Regular.otf", 50);
-    normalLabel->setColor(Color3B::WHITE);
-    auto normalItem = MenuItemLabel::create(normalLabel, [=](Ref*) {
+    // 【修改】进入普通模式：newGame 为 true 时删除存档从头开始，否则有存档时继续
+    auto enterNormalMode = [](bool newGame) {
         SimpleAudioEngine::getInstance()->playEffect("Music/click.wav");
         // 在进入游戏前停止菜单音乐
         SimpleAudioEngine::getInstance()->stopBackgroundMusic(true);
@@ -211,15 +214,49 @@ void MainMenuScene::startGame(Ref* sender)
         // 延迟后创建并进入游戏场景
         blackLayer->runAction(Sequence::create(
             DelayTime::create(1.0f),
-            CallFunc::create([]() {
-                auto scene = GameScene::createScene();
+            CallFunc::create([newGame]() {
+                auto saveManager = SaveManager::getInstance();
+                if (newGame)
+                {
+                    saveManager->resetSave();
+                }
+
+                // 恢复护符/Shade（新游戏时恢复成初始状态）
+                saveManager->applyToGame();
+
+                // 坐过椅子就从存档的椅子继续，否则从出生点开始
+                Scene* scene = nullptr;
+                if (saveManager->hasSave() && saveManager->getData().benchScene == SaveScene::DIRTMOUTH)
+                {
+                    scene = GameScene::createSceneForRespawn();
+                }
+                else
+                {
+                    scene = GameScene::createScene();
+                }
                 Director::getInstance()->replaceScene(TransitionFade::create(0.5f, scene));
             }),
             nullptr
         ));
+    };
+
+    // 【修改】有存档时显示“继续游戏”和“新游戏”两个入口
+    bool hasSave = SaveManager::getInstance()->hasSave();
+    auto normalLabel = Label::createWithTTF(hasSave ? u8"继续游戏" : u8"普通模式", "fonts/NotoSerifCJKsc-Regular.otf", 50);
+    normalLabel->setColor(Color3B::WHITE);
+    auto normalItem = MenuItemLabel::create(normalLabel, [=](Ref*) {
+        enterNormalMode(false);
     });
     normalItem->setPosition(Vec2(visibleSize.width / 2, visibleSize.height / 2));
 
+    auto newGameLabel = Label::createWithTTF(u8"新游戏", "fonts/NotoSerifCJKsc-Regular.otf", 36);
+    newGameLabel->setColor(Color3B::WHITE);
+    auto newGameItem = MenuItemLabel::create(newGameLabel, [=](Ref*) {
+        enterNormalMode(true);
+    });
+    newGameItem->setPosition(Vec2(visibleSize.width / 2, visibleSize.height / 2 - 130));
+    newGameItem->setVisible(hasSave);
+
     // Boss模式按钮
     auto bg4 = Sprite::create("Menu/Area_Green_Path.png");
     bg4->setPosition(Vec2(visibleSize.width / 2, visibleSize.height / 2 - 300));
@@ -254,7 +291,7 @@ void MainMenuScene::startGame(Ref* sender)
     });
     hardItem->setPosition(Vec2(visibleSize.width / 2, visibleSize.height / 2 - 300));
 
-    auto menu = Menu::create(normalItem, hardItem, nullptr);
+    auto menu = Menu::create(normalItem, newGameItem, hardItem, nullptr);
     menu->setPosition(Vec2::ZERO);
     layer->addChild(menu);
 }
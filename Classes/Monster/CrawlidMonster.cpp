@@ -1,7 +1,8 @@
 // CrawlidMonster.cpp (ǿЧ)
 
 #include "CrawlidMonster.h"
-#include "SimpleAudioEngine.h"
+#include "SoundBank.h"  // ޸ġЧ SoundBank
+#include "SaveManager.h"  // ܼ¼
 
 USING_NS_CC;
 
@@ -179,7 +180,7 @@ void CrawlidMonster::takeDamage(int damage, float knockbackPower, int knockbackD
     _isStunned = true;
 
     // ܻЧ
-    CocosDenshion::SimpleAudioEngine::getInstance()->playEffect("Music/enemy_damage.wav");
+    SoundBank::getInstance()->play("Music/enemy_damage.wav");
 
     // 1. ֹͣѲ
     this->stopActionByTag((int)CrawlidMonsterActionTag::PATROL_ACTION_TAG);
@@ -271,12 +272,14 @@ void CrawlidMonster::resumePatrol()
 // === ǿŵЧ ===
 void CrawlidMonster::die(float knockbackPower, int knockbackDirection)
 {
+    SaveManager::getInstance()->markEnemyDefeated(getName());  // 浵
+
     this->stopAllActions();
 
     _isStunned = true;
 
     // Ч
-    CocosDenshion::SimpleAudioEngine::getInstance()->playEffect("Music/enemy_death.wav");
+    SoundBank::getInstance()->play("Music/enemy_death.wav");
 
     CCLOG("Crawlid Monster Died! Starting death animation.");
 
@@ -1,7 +1,8 @@
 ﻿#include "GruzzerMonster.h"
 #include "NextScene.h"
 #include "TheKnight.h"
-#include "SimpleAudioEngine.h"  // 添加音效头文件
+#include "SoundBank.h"  // 【修改】音效走 SoundBank
+#include "SaveManager.h"  // 【新增】击败记录
 
 USING_NS_CC;
 
@@ -179,7 +180,7 @@ void GruzzerMonster::takeDamage(int damage, float knockbackPower, int knockbackD
     _health -= damage;
 
     // 播放受击音效
-    CocosDenshion::SimpleAudioEngine::getInstance()->playEffect("Music/enemy_damage.wav");
+    SoundBank::getInstance()->play("Music/enemy_damage.wav");
 
     if (_health <= 0) {
         // 死亡
@@ -225,13 +226,14 @@ void GruzzerMonster::takeDamage(int damage, float knockbackPower, int knockbackD
 
 // 【修改】死亡函数 - 参考 Crawlid/Tiktik 的死亡逻辑
 void GruzzerMonster::die(float knockbackPower, int knockbackDirection) {
+    SaveManager::getInstance()->markEnemyDefeated(getName());  // 【新增】记入存档
     _state = State::DEAD;
     _isStunned = false;
     this->stopAllActions();
     this->unscheduleUpdate();
 
     // 播放死亡音效
-    CocosDenshion::SimpleAudioEngine::getInstance()->playEffect("Music/enemy_death.wav");
+    SoundBank::getInstance()->play("Music/enemy_death.wav");
 
     // 播放死亡动画
     if (_deathAnim) {
@@ -4,6 +4,7 @@
 #include "GruzzerMonster.h"
 #include "VengeflyMonster.h"
 #include "CorniferNPC.h"  // 【新增】包含 Cornifer NPC 头文件
+#include "SaveManager.h"  // 【新增】跳过已击败的怪物
 
 USING_NS_CC;
 
@@ -38,6 +39,12 @@ int MonsterSpawner::spawnAllCrawlidsInNextScene(cocos2d::Node* parentNode)
     for (size_t i = 0; i < crawlidSpawns.size(); i++)
     {
         auto& spawnData = crawlidSpawns[i];
+        
+        // 【新增】存档中已击败的怪物不再生成（椅子休息后复活）
+        if (SaveManager::getInstance()->isEnemyDefeated(spawnData.name)) {
+            CCLOG("[跳过] %s 已被击败", spawnData.name.c_str());
+            continue;
+        }
         auto crawlid = CrawlidMonster::createAndSpawn(
             parentNode, 
             spawnData.position, 
@@ -90,6 +97,12 @@ int MonsterSpawner::spawnAllCrawlidsInNextScene(cocos2d::Node* parentNode)
     {
         auto& spawnData = tiktikSpawns[i];
         
+        // 【新增】存档中已击败的怪物不再生成（椅子休息后复活）
+        if (SaveManager::getInstance()->isEnemyDefeated(spawnData.name)) {
+            CCLOG("[跳过] %s 已被击败", spawnData.name.c_str());
+            continue;
+        }
+        
         CCLOG("  生成 %s:", spawnData.name.c_str());
         CCLOG("    岩石中心: (%.1f, %.1f)", spawnData.rockCenter.x, spawnData.rockCenter.y);
         CCLOG("    半宽: %.1f, 半高: %.1f", spawnData.rockHalfWidth, spawnData.rockHalfHeight);
@@ -150,6 +163,12 @@ int MonsterSpawner::spawnAllCrawlidsInNextScene(cocos2d::Node* parentNode)
     {
         auto& spawnData = gruzzerSpawns[i];
         
+        // 【新增】存档中已击败的怪物不再生成（椅子休息后复活）
+        if (SaveManager::getInstance()->isEnemyDefeated(spawnData.name)) {
+            CCLOG("[跳过] %s 已被击败", spawnData.name.c_str());
+            continue;
+        }
+        
         CCLOG("  生成 %s:", spawnData.name.c_str());
         CCLOG("    初始位置: (%.1f, %.1f)", spawnData.startPos.x, spawnData.startPos.y);
         CCLOG("    飞行速度: %.1f", spawnData.speed);
@@ -207,6 +226,12 @@ int MonsterSpawner::spawnAllCrawlidsInNextScene(cocos2d::Node* parentNode)
     {
         auto& spawnData = vengeflySpawns[i];
         
+        // 【新增】存档中已击败的怪物不再生成（椅子休息后复活）
+        if (SaveManager::getInstance()->isEnemyDefeated(spawnData.name)) {
+            CCLOG("[跳过] %s 已被击败", spawnData.name.c_str());
+            continue;
+        }
+        
         CCLOG("  生成 %s:", spawnData.name.c_str());
         CCLOG("    位置: (%.1f, %.1f)", spawnData.position.x, spawnData.position.y);
         CCLOG("    巡逻半径: %.1f", spawnData.patrolRadius);
@@ -1,7 +1,8 @@
 ﻿// TiktikMonster.cpp
 
 #include "TiktikMonster.h"
-#include "SimpleAudioEngine.h"
+#include "SoundBank.h"  // 【修改】音效走 SoundBank
+#include "SaveManager.h"  // 【新增】击败记录
 
 USING_NS_CC;
 
@@ -303,7 +304,7 @@ void TiktikMonster::takeDamage(int damage, float knockbackPower, int knockbackDi
     _health -= damage;
 
     // 播放受击音效
-    CocosDenshion::SimpleAudioEngine::getInstance()->playEffect("Music/enemy_damage.wav");
+    SoundBank::getInstance()->play("Music/enemy_damage.wav");
 
     if (_health <= 0)
     {
@@ -341,12 +342,14 @@ void TiktikMonster::die(float knockbackPower, int knockbackDirection)
 {
     if (_isStunned) return;
 
+    SaveManager::getInstance()->markEnemyDefeated(getName());  // 【新增】记入存档
+
     _isStunned = true;
     _isPatrolling = false;
     this->stopAllActions();
 
     // 播放死亡音效
-    CocosDenshion::SimpleAudioEngine::getInstance()->playEffect("Music/enemy_death.wav");
+    SoundBank::getInstance()->play("Music/enemy_death.wav");
 
     float flyHeight = 150.0f;
     float jumpDuration = 0.8f;
@@ -1,7 +1,9 @@
 ﻿#include "VengeflyMonster.h"
-#include "SimpleAudioEngine.h"
+#include "SoundBank.h"  // 【修改】音效走 SoundBank
 #include "NextScene.h"  // 用于获取平台数据
 #include "TheKnight.h"  // 获取 Platform 定义
+#include "FlowField.h"  // 【新增】共享流场寻路
+#include "SaveManager.h"  // 【新增】击败记录
 
 USING_NS_CC;
 
@@ -168,7 +170,13 @@ void VengeflyMonster::update(float dt)
             return;
         }
 
-        direction.normalize();
+        // 【修改】优先沿共享流场绕开墙体，流场不可用时直线追击
+        if (_flowField) {
+            direction = _flowField->sampleDirection(currentPos);
+        }
+        else {
+            direction.normalize();
+        }
         _velocity = direction * _chaseSpeed;
         Vec2 movement = _velocity * dt;
         Vec2 nextPos = currentPos + movement;
@@ -353,7 +361,7 @@ void VengeflyMonster::takeDamage(int damage, float knockbackPower, int knockback
     _health -= damage;
 
     // 播放受击音效
-    CocosDenshion::SimpleAudioEngine::getInstance()->playEffect("Music/enemy_damage.wav");
+    SoundBank::getInstance()->play("Music/enemy_damage.wav");
 
     if (_health <= 0)
     {
@@ -405,10 +413,12 @@ void VengeflyMonster::takeDamage(int damage, float knockbackPower, int knockback
 
 void VengeflyMonster::deathSequence(float knockbackPower, int knockbackDirection)
 {
+    SaveManager::getInstance()->markEnemyDefeated(getName());  // 【新增】记入存档
+
     this->unscheduleUpdate();
 
     // 播放死亡音效
-    CocosDenshion::SimpleAudioEngine::getInstance()->playEffect("Music/enemy_death.wav");
+    SoundBank::getInstance()->play("Music/enemy_death.wav");
 
     Size size = this->getContentSize();
 
@@ -478,6 +488,7 @@ VengeflyMonster* VengeflyMonster::createAndSpawn(cocos2d::Node* parent, const co
         auto nextScene = dynamic_cast<NextScene*>(parent);
         if (nextScene) {
             vengefly->_platforms = nextScene->getPlatforms();
+            vengefly->setFlowField(nextScene->getFlowField());
             CCLOG("Vengefly 获取到 %zu 个碰撞平台", vengefly->_platforms.size());
         }
 
@@ -7,6 +7,8 @@
 #include "TheKnight.h"  // ޸ġǰ
 #include <random>
 
+class FlowField;
+
 // Vengefly ״̬ö
 enum class VengeflyState
 {
@@ -55,6 +57,9 @@ public:
     // λ (ھ)
     void setPlayerPosition(const cocos2d::Vec2& playerPos);
 
+    // ù׷ʱƿǽ壬Ϊʱֱ׷
+    void setFlowField(const FlowField* flowField) { _flowField = flowField; }
+
     // ܻӿ -  Gruzzer һ
     void takeDamage(int damage, float knockbackPower, int knockbackDirection);
 
@@ -96,6 +101,9 @@ private:
     // зΧƣο Gruzzer  _limitRange
     cocos2d::Rect _flyRange;
     cocos2d::Vec2 _velocity;  // ǰٶ
+
+    //  NextScene У
+    const FlowField* _flowField = nullptr;
 };
 
 #endif // __VENGEFLY_MONSTER_H__
\ No newline at end of file
@@ -1,5 +1,6 @@
 ﻿#include "NextScene.h"
 #include "TheKnight.h"
+#include "PlatformCollision.h"  // 【新增】solid 图块碰撞平台
 #include "GameScene.h"
 #include "CharmManager.h"
 #include "Monster/MonsterSpawner.h"
@@ -8,6 +9,10 @@
 #include "Monster/GruzzerMonster.h" // 【新增】添加 GruzzerMonster 头文件
 #include "Monster/VengeflyMonster.h" // 【新增】添加 VengeflyMonster 头文件
 #include "SimpleAudioEngine.h"
+#include "SaveManager.h"  // 【新增】存档
+#include "SoundBank.h"  // 【新增】场景音效库
+#include "InputManager.h"  // 【新增】统一输入
+#include "GameFonts.h"  // 【新增】中文字体/预烘焙图集
 
 USING_NS_CC;
 using namespace CocosDenshion;
@@ -71,6 +76,22 @@ bool NextScene::init()
     if (!Layer::init())
         return false;
 
+    // 【新增】本场景加载的纹理记在 "Crossroads" 名下（控制台 texture residency 按场景统计显存）
+    Director::getInstance()->getTextureCache()->setOwnerTag("Crossroads");
+
+    // 【新增】注册性能浮层计数器（与 BossScene 同名共用），并丢弃进入场景前累计的碰撞查询
+    auto frameStats = FrameStats::getInstance();
+    _monsterCounter = frameStats->registerCounter("monsters");
+    _collisionQueryCounter = frameStats->registerCounter("collision queries");
+    _combatPairCounter = frameStats->registerCounter("combat pairs");
+    // 【新增】卡顿归因区段：控制台 perf 的 hitch 记录会列出本帧耗时的区段
+    _combatZone = frameStats->registerZone("combat");
+    _flowFieldZone = frameStats->registerZone("flow field");
+    TheKnight::takeCollisionQueryCount();
+
+    // 【新增】预加载本场景音效（战斗中不再解码）
+    SoundBank::getInstance()->loadBank({ SoundGroup::UI, SoundGroup::KNIGHT, SoundGroup::ENEMY });
+
     // 【新增】调试日志
     CCLOG("====== NextScene::init ======");
     CCLOG("  s_isRespawning: %s", s_isRespawning ? "TRUE" : "FALSE");
@@ -86,7 +107,7 @@ bool NextScene::init()
         Vec2 centerLocal = Vec2(vs.width * 0.5f, vs.height * 0.5f);
 
         // 主标题
-        auto sceneTitle = Label::createWithSystemFont(u8"遗忘十字路", "fonts/NotoSerifCJKsc-Regular.otf", 95);
+        auto sceneTitle = GameFonts::createLabel(u8"遗忘十字路", 95);  // 【修改】走 TTF/预烘焙 SDF 图集，不再现场光栅化
         sceneTitle->setTextColor(Color4B::WHITE);
         sceneTitle->setAnchorPoint(Vec2(0.5f, 0.5f));
 
@@ -185,6 +206,15 @@ bool NextScene::init()
         {"Maps/Forgotten Crossroads4.tmx", Vec2(120 * 16, 105 * 16)}
     };
 
+    // 【新增】地图块、陷阱和前景都是静态内容，放进空间容器后镜头外的部分不再逐帧遍历
+    _worldBack = SpatialNode::create();
+    this->addChild(_worldBack, 0, "WorldBack");
+    // 陷阱和原来一样在 z = 1，画在 z = 0 的怪物之上
+    _worldTraps = SpatialNode::create();
+    this->addChild(_worldTraps, 1, "WorldTraps");
+    _worldFront = SpatialNode::create();
+    this->addChild(_worldFront, 10, "WorldFront");
+
     for (const auto& chunk : chunks) {
         auto map = TMXTiledMap::create(chunk.file);
         CCASSERT(map != nullptr, ("地图加载失败: " + chunk.file).c_str());
@@ -194,9 +224,10 @@ bool NextScene::init()
         Vec2 mapPos = Vec2(origin.x + chunk.position.x * scale, 
                            origin.y + chunk.position.y * scale);
         map->setPosition(mapPos);
-        this->addChild(map, 0);
+        _worldBack->addChild(map, 0);  // 【修改】加入空间容器
 
         createCollisionFromTMX(map, "Collision", scale, mapPos);
+        PlatformCollision::addSolidTilePlatforms(map, scale, mapPos, _platforms);
         loadForegroundObjects(map, scale, mapPos);
         
         if (chunk.file == "Maps/Forgotten Crossroads1.tmx") {
@@ -209,6 +240,9 @@ bool NextScene::init()
         }
     }
 
+    // 【新增】所有地图块加载完后，用碰撞平台生成导航网格
+    _flowField.build(_platforms);
+
     auto fourthMap = TMXTiledMap::create("Maps/Forgotten Crossroads4.tmx");
     auto objectGroup = fourthMap->getObjectGroup("Objects");
     CCASSERT(objectGroup != nullptr, "地图缺少对象层 Objects");
@@ -258,6 +292,10 @@ bool NextScene::init()
         
         CharmManager::getInstance()->syncToKnight(knight);
         
+        // 【新增】读档后首次进入时恢复 HP/Soul
+        SaveManager::getInstance()->applyToKnight(knight);
+        SaveManager::getInstance()->markSceneVisited(SaveScene::CROSSROADS);
+        
         // 【修改】重生逻辑：延迟生成 Shade，确保 _player 已经设置
         if (s_isRespawning)
         {
@@ -321,7 +359,7 @@ bool NextScene::init()
     this->addChild(_exitContainer, 100, "ExitContainer");
     _exitContainer->setVisible(false);
     
-    _exitLabel = Label::createWithSystemFont(u8"按 W 上升", "fonts/NotoSerifCJKsc-Regular.otf", 36);
+    _exitLabel = GameFonts::createLabel(u8"按 W 上升", 36);  // 【修改】走 TTF/预烘焙 SDF 图集，不再现场光栅化
     _exitLabel->setTextColor(Color4B::WHITE);
     _exitLabel->setPosition(Vec2::ZERO);
     _exitContainer->addChild(_exitLabel, 1);
@@ -344,92 +382,28 @@ bool NextScene::init()
         _exitContainer->addChild(_exitBottomImg, 0);
     }
 
-    // 修改键盘监听器，添加 ESC 键处理
-    auto keyboardListener = EventListenerKeyboard::create();
-    keyboardListener->onKeyPressed = [this](EventKeyboard::KeyCode keyCode, Event* event) {
-        // 【新增】ESC 键打开/关闭暂停菜单
-        if (keyCode == EventKeyboard::KeyCode::KEY_ESCAPE)
-        {
-            if (_pauseMenu)
-            {
-                if (_pauseMenu->isVisible())
-                {
-                    _pauseMenu->hide();
-                }
-                else
-                {
-                    _pauseMenu->show();
-                }
-            }
-            return;
-        }
-        
-        // 【新增】暂停时不处理其他按键
-        if (_pauseMenu && _pauseMenu->isVisible())
-        {
-            return;
-        }
-        
-        if (keyCode == EventKeyboard::KeyCode::KEY_W || keyCode == EventKeyboard::KeyCode::KEY_CAPITAL_W)
+    // 【修改】按键改由 InputManager 统一采集：暂停键走即时事件（暂停后调度器停止，无法轮询），
+    // 其他交互（出口、护符面板）在 update 中轮询动作快照
+    auto pauseListener = EventListenerCustom::create(InputManager::EVENT_PAUSE_PRESSED, [this](EventCustom* event) {
+        if (_pauseMenu)
         {
-            if (_isNearExit && !_isTransitioning)
+            if (_pauseMenu->isVisible())
             {
-                _isTransitioning = true;
-                
-                auto knight = dynamic_cast<TheKnight*>(this->getChildByName("Player"));
-                bool facingRight = true;
-                if (knight)
-                {
-                    facingRight = knight->getScaleX() > 0;
-                }
-                
-                Vec2 spawnPos(12479.7f, 435.0f);
-                
-                auto blackScene = Scene::create();
-                auto blackLayer = LayerColor::create(Color4B(0, 0, 0, 255));
-                blackScene->addChild(blackLayer);
-
-                Director::getInstance()->replaceScene(TransitionFade::create(0.5f, blackScene));
-
-                blackLayer->runAction(Sequence::create(
-                    DelayTime::create(1.0f),
-                    CallFunc::create([spawnPos, facingRight]() {
-                        auto gameScene = GameScene::createSceneWithSpawn(spawnPos, facingRight);
-                        Director::getInstance()->replaceScene(TransitionFade::create(0.5f, gameScene));
-                    }),
-                    nullptr
-                ));
-                return;
+                _pauseMenu->hide();
             }
-        }
-        
-        if (keyCode == EventKeyboard::KeyCode::KEY_Q)
-        {
-            auto charmManager = CharmManager::getInstance();
-            auto scene = this->getScene();
-            if (!scene) return;
-            
-            if (charmManager->isPanelOpen())
+            else
             {
-                charmManager->hideCharmPanel();
-                auto knight = dynamic_cast<TheKnight*>(this->getChildByName("Player"));
-                if (knight)
-                {
-                    charmManager->syncToKnight(knight);
-                }
-                return;
+                _pauseMenu->show();
             }
-            
-            charmManager->showCharmPanel(scene);
         }
-    };
-    _eventDispatcher->addEventListenerWithSceneGraphPriority(keyboardListener, this);
+    });
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(pauseListener, this);
 
     // 启用 update
     this->scheduleUpdate();
 
     // 播放 Crossroads 背景音乐（循环）
-    CocosDenshion::SimpleAudioEngine::getInstance()->stopBackgroundMusic();
+    // 【修改】不再先 stop，切换区域时与上一首交叉淡入淡出（Linux 下长音乐流式播放）
     CocosDenshion::SimpleAudioEngine::getInstance()->playBackgroundMusic("Music/Crossroads.wav", true);
 
     return true;
@@ -800,6 +774,7 @@ void NextScene::shakeScreen(float duration, float intensity)
 // === 修正：参考BossScene的战斗碰撞检测方法 ===
 void NextScene::checkCombatCollisions()
 {
+    FrameStats::ScopedZone combatZone(_combatZone);  // 【新增】
     auto knight = dynamic_cast<TheKnight*>(this->getChildByName("Player"));
     if (!knight || knight->isDead()) return;
     
@@ -848,6 +823,11 @@ void NextScene::checkCombatCollisions()
         }
     }
     
+    // 【新增】性能浮层：存活怪物数与本帧判定的矩形对数
+    auto frameStats = FrameStats::getInstance();
+    frameStats->addCounter(_monsterCounter, crawlids.size() + tiktiks.size() + gruzzers.size() + vengeflies.size());
+    int combatPairs = 0;
+    
     // ========== 处理 Crawlid ==========
     for (auto crawlid : crawlids)
     {
@@ -860,6 +840,7 @@ void NextScene::checkCombatCollisions()
             Rect slashRect;
             if (knight->getSlashEffectBoundingBox(slashRect))
             {
+                ++combatPairs;
                 if (slashRect.intersectsRect(crawlidBox) && !crawlid->_isStunned)
                 {
                     CCLOG("Knight Slash 命中 %s!", crawlid->getName().c_str());
@@ -893,6 +874,7 @@ void NextScene::checkCombatCollisions()
                                effectSize.width,
                                effectSize.height);
                 
+                ++combatPairs;
                 if (spellRect.intersectsRect(crawlidBox))
                 {
                     CCLOG("Knight Vengeful Spirit 命中 %s!", crawlid->getName().c_str());
@@ -967,6 +949,7 @@ void NextScene::checkCombatCollisions()
             {
                 Rect knightBox = knight->getBoundingBox();
                 
+                ++combatPairs;
                 if (knightBox.intersectsRect(crawlidBox))
                 {
                     CCLOG("%s 接触伤害命中 Knight!", crawlid->getName().c_str());
@@ -992,6 +975,7 @@ void NextScene::checkCombatCollisions()
             Rect slashRect;
             if (knight->getSlashEffectBoundingBox(slashRect))
             {
+                ++combatPairs;
                 if (slashRect.intersectsRect(tiktikBox) && !tiktik->_isStunned)
                 {
                     CCLOG("Knight Slash 命中 %s!", tiktik->getName().c_str());
@@ -1025,6 +1009,7 @@ void NextScene::checkCombatCollisions()
                                effectSize.width,
                                effectSize.height);
                 
+                ++combatPairs;
                 if (spellRect.intersectsRect(tiktikBox))
                 {
                     CCLOG("Knight Vengeful Spirit 命中 %s!", tiktik->getName().c_str());
@@ -1099,6 +1084,7 @@ void NextScene::checkCombatCollisions()
             {
                 Rect knightBox = knight->getBoundingBox();
                 
+                ++combatPairs;
                 if (knightBox.intersectsRect(tiktikBox))
                 {
                     CCLOG("%s 接触伤害命中 Knight!", tiktik->getName().c_str());
@@ -1124,6 +1110,7 @@ void NextScene::checkCombatCollisions()
             Rect slashRect;
             if (knight->getSlashEffectBoundingBox(slashRect))
             {
+                ++combatPairs;
                 if (slashRect.intersectsRect(gruzzerBox) && !gruzzer->_isStunned)
                 {
                     CCLOG("Knight Slash 命中 %s!", gruzzer->getName().c_str());
@@ -1157,6 +1144,7 @@ void NextScene::checkCombatCollisions()
                                effectSize.width,
                                effectSize.height);
                 
+                ++combatPairs;
                 if (spellRect.intersectsRect(gruzzerBox))
                 {
                     CCLOG("Knight Vengeful Spirit 命中 %s!", gruzzer->getName().c_str());
@@ -1231,6 +1219,7 @@ void NextScene::checkCombatCollisions()
             {
                 Rect knightBox = knight->getBoundingBox();
                 
+                ++combatPairs;
                 if (knightBox.intersectsRect(gruzzerBox))
                 {
                     CCLOG("%s 接触伤害命中 Knight!", gruzzer->getName().c_str());
@@ -1259,6 +1248,7 @@ void NextScene::checkCombatCollisions()
             Rect slashRect;
             if (knight->getSlashEffectBoundingBox(slashRect))
             {
+                ++combatPairs;
                 if (slashRect.intersectsRect(vengeflyBox) && !vengefly->_isStunned)
                 {
                     CCLOG("Knight Slash 命中 %s!", vengefly->getName().c_str());
@@ -1292,6 +1282,7 @@ void NextScene::checkCombatCollisions()
                            effectSize.width,
                            effectSize.height);
                 
+                ++combatPairs;
                 if (spellRect.intersectsRect(vengeflyBox))
                 {
                     CCLOG("Knight Vengeful Spirit 命中 %s!", vengefly->getName().c_str());
@@ -1366,6 +1357,7 @@ void NextScene::checkCombatCollisions()
             {
                 Rect knightBox = knight->getBoundingBox();
                 
+                ++combatPairs;
                 if (knightBox.intersectsRect(vengeflyBox))
                 {
                     CCLOG("%s 接触伤害命中 Knight!", vengefly->getName().c_str());
@@ -1378,10 +1370,83 @@ void NextScene::checkCombatCollisions()
             }
         }
     }
+
+    frameStats->addCounter(_combatPairCounter, combatPairs);
+}
+
+// 【新增】轮询本帧的交互动作
+void NextScene::handleInput()
+{
+    // 暂停时不处理其他按键
+    if (_pauseMenu && _pauseMenu->isVisible())
+    {
+        return;
+    }
+
+    auto input = InputManager::getInstance();
+
+    if (input->isPressed(InputAction::UP) && _isNearExit && !_isTransitioning)
+    {
+        _isTransitioning = true;
+
+        auto knight = dynamic_cast<TheKnight*>(this->getChildByName("Player"));
+        bool facingRight = true;
+        if (knight)
+        {
+            facingRight = knight->getScaleX() > 0;
+        }
+
+        Vec2 spawnPos(12479.7f, 435.0f);
+
+        // 【新增】切换场景前自动存档
+        SaveManager::getInstance()->autosave(knight, SaveScene::CROSSROADS);
+
+        auto blackScene = Scene::create();
+        auto blackLayer = LayerColor::create(Color4B(0, 0, 0, 255));
+        blackScene->addChild(blackLayer);
+
+        Director::getInstance()->replaceScene(TransitionFade::create(0.5f, blackScene));
+
+        blackLayer->runAction(Sequence::create(
+            DelayTime::create(1.0f),
+            CallFunc::create([spawnPos, facingRight]() {
+                auto gameScene = GameScene::createSceneWithSpawn(spawnPos, facingRight);
+                Director::getInstance()->replaceScene(TransitionFade::create(0.5f, gameScene));
+            }),
+            nullptr
+        ));
+        return;
+    }
+
+    if (input->isPressed(InputAction::CHARM))
+    {
+        auto charmManager = CharmManager::getInstance();
+        auto scene = this->getScene();
+        if (!scene) return;
+
+        if (charmManager->isPanelOpen())
+        {
+            charmManager->hideCharmPanel();
+            auto knight = dynamic_cast<TheKnight*>(this->getChildByName("Player"));
+            if (knight)
+            {
+                charmManager->syncToKnight(knight);
+            }
+            return;
+        }
+
+        charmManager->showCharmPanel(scene);
+    }
 }
 
 void NextScene::update(float dt)
 {
+    // 【新增】处理交互按键
+    handleInput();
+
+    // 【新增】性能浮层：上一帧 Knight 的平台碰撞查询次数
+    FrameStats::getInstance()->addCounter(_collisionQueryCounter, TheKnight::takeCollisionQueryCount());
+
     auto knight = dynamic_cast<TheKnight*>(this->getChildByName("Player"));
     if (!knight) return;
 
@@ -1472,6 +1537,12 @@ void NextScene::update(float dt)
             }
         }
         
+        // 【新增】更新共享流场目标（Knight 换格子时才重算）
+        {
+            FrameStats::ScopedZone flowFieldZone(_flowFieldZone);
+            _flowField.updateTarget(knightPos);
+        }
+
         // === 使用新的战斗碰撞检测方法(参考BossScene) ===
         checkCombatCollisions();
         
@@ -1662,7 +1733,7 @@ void NextScene::loadForegroundObjects(TMXTiledMap* map, float scale, const Vec2&
             fgSprite->setScale(scale);
             
             // 修复：确保前景对象在 Knight 上面
-            this->addChild(fgSprite, 10);  // 移除注释，z-order = 10
+            _worldFront->addChild(fgSprite);  // 【修改】前景容器本身 z-order = 10，在 Knight 上面
             
             CCLOG("加载前景对象: %s at (%.1f, %.1f), z-order=10", imagePath.c_str(), worldX, worldY);
         }
@@ -1684,6 +1755,9 @@ void NextScene::onKnightDeath(const Vec2& deathPos)
     // 移除现有的 Shade（如果有）
     removeShade();
     
+    // 【新增】死亡时存档（记录 Shade 位置，HP 不存，重生时回满）
+    SaveManager::getInstance()->autosave(nullptr, SaveScene::CROSSROADS);
+    
     // 【修改】死亡后切换到 GameScene 并坐在椅子上
     auto blackLayer = LayerColor::create(Color4B(0, 0, 0, 0));
     this->addChild(blackLayer, 2000);
@@ -1720,6 +1794,7 @@ void NextScene::spawnShade(const Vec2& position)
         if (_player)
         {
             _shade->setTarget(_player);
+            _shade->setFlowField(getFlowField());
             CCLOG("  Shade target set to _player");
         }
         else
@@ -1792,7 +1867,7 @@ void NextScene::createTrapSprites(TMXTiledMap* map, const std::string& layerName
                 sprite->setScaleX(width / originalSize.width);
                 sprite->setScaleY(height / originalSize.height);
                 sprite->setPosition(Vec2(x + width / 2, y + height / 2));
-                this->addChild(sprite, 1);
+                _worldTraps->addChild(sprite);  // 【修改】加入空间容器
                 
                 CCLOG("创建陷阱精灵: x=%.1f, y=%.1f, w=%.1f, h=%.1f", x, y, width, height);
             }
@@ -6,6 +6,7 @@
 #include "CorniferNPC.h"
 #include "ShadowEnemy.h"
 #include "PauseMenu.h"  // 
+#include "FlowField.h"  // Ѱ·
 
 // ޸ġExitObject ṹ -  NextScene.cpp ʹ÷ʽ
 struct ExitObject {
@@ -45,12 +46,20 @@ public:
     
     // ޸ġȡײƽ̨ݣʹ TheKnight.h е Platform 壩
     const std::vector<Platform>& getPlatforms() const { return _platforms; }
+
+    // ȡ Knight Ĺ׷߲ã
+    const FlowField* getFlowField() const { return _flowField.isReady() ? &_flowField : nullptr; }
+
+    // Shade λôȡ浵ãZERO ʾû Shade
+    static const cocos2d::Vec2& getSavedShadePosition() { return s_shadePosition; }
+    static void setSavedShadePosition(const cocos2d::Vec2& pos) { s_shadePosition = pos; }
     
 private:
     void createCollisionFromTMX(cocos2d::TMXTiledMap* map, 
                                  const std::string& layerName, 
                                  float scale, 
                                  const cocos2d::Vec2& mapOffset);
+
     
     // 屳
     void createTrapSprites(cocos2d::TMXTiledMap* map,
@@ -71,6 +80,9 @@ private:
     
     // ⽻
     void checkInteractions();
+
+    // ѯڡ壩
+    void handleInput();
     
     // 
     void startSpikeDeath(TheKnight* knight);
@@ -90,6 +102,11 @@ private:
     bool onContactBegin(cocos2d::PhysicsContact& contact);
     
     std::vector<Platform> _platforms;         // ײƽ̨бʹ TheKnight.h е Platform
+    FlowField _flowField;                     // ײƽ̨ɵĵ
+    // ̬Χзָֻͷڵӽڵ
+    cocos2d::SpatialNode* _worldBack = nullptr;   // ͼ飨֮£
+    cocos2d::SpatialNode* _worldTraps = nullptr;  // 壨֮ϡʿ֮£
+    cocos2d::SpatialNode* _worldFront = nullptr;  // ǰװΣʿ֮ϣ
     std::vector<ExitObject> _exitObjects;     // ڶб
     std::vector<ThornObject> _thornObjects;   // ̶б
     
@@ -119,6 +136,13 @@ private:
     float _knightAttackCooldown = 0.0f;  // Knightͨȴ
     float _spellAttackCooldown = 0.0f;   // Knightȴ
     
+    // ܸFrameStats ļ id init עᣩ
+    int _monsterCounter = -1;            // 
+    int _collisionQueryCounter = -1;     // ֡ƽ̨ײѯ
+    int _combatPairCounter = -1;         // ֡սжľζ
+    int _combatZone = -1;                // սжʱٹ
+    int _flowFieldZone = -1;             // ʱٹ
+    
     // HPSoul UI
     cocos2d::Node* _uiLayer = nullptr;
     cocos2d::Sprite* _hpBg = nullptr;
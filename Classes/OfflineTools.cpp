@@ -0,0 +1,47 @@
+﻿#include "OfflineTools.h"
+#include "GameFonts.h"
+#include "cocos2d.h"
+
+#include <string.h>
+#include <string>
+
+USING_NS_CC;
+
+namespace OfflineTools
+{
+
+bool run(int argc, char** argv, int* exitCode)
+{
+    if (argc < 2)
+    {
+        return false;
+    }
+
+    // 烘焙中文 SDF 字体图集，产物写到 outputDir（默认写到字体所在目录）
+    if (strcmp(argv[1], "--bake-fonts") == 0)
+    {
+        *exitCode = GameFonts::bakeFonts(argc > 2 ? argv[2] : "") ? 0 : 1;
+        return true;
+    }
+
+    // 按 textures.plist 转码图片，运行时直接加载 .pvr，跳过 PNG/JPG 解码
+    if (strcmp(argv[1], "--transcode-textures") == 0)
+    {
+        auto fileUtils = FileUtils::getInstance();
+        std::string resourceDir = argc > 2 ? argv[2] : fileUtils->getDefaultResourceRootPath();
+        fileUtils->addSearchPath(resourceDir, true);
+
+        auto policy = TextureFormatPolicy::getInstance();
+        if (!policy->loadManifest("textures.plist"))
+        {
+            *exitCode = 1;
+            return true;
+        }
+        *exitCode = policy->transcodeDirectory(fileUtils->getSearchPaths().front()) >= 0 ? 0 : 1;
+        return true;
+    }
+
+    return false;
+}
+
+}
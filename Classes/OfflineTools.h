@@ -0,0 +1,21 @@
+#ifndef __OFFLINE_TOOLS_H__
+#define __OFFLINE_TOOLS_H__
+
+/**
+ * ԴڣLinux / Win32  main ã
+ *
+ *   HollowKnight --bake-fonts [Ŀ¼]    決 SDF ͼGameFonts::bakeFonts
+ *   HollowKnight --transcode-textures [ԴĿ¼]
+ *                                          textures.plist ͼƬת .pvrдԭͼԱ
+ */
+namespace OfflineTools
+{
+    /**
+     * ߲в
+     * @param exitCode ߲ʱд˳루0 ɹ1 ʧܣ
+     * @return argv ߲ʱ falseճϷ
+     */
+    bool run(int argc, char** argv, int* exitCode);
+}
+
+#endif // __OFFLINE_TOOLS_H__
@@ -2,6 +2,7 @@
 #include "MainMenuScene.h"
 #include "SimpleAudioEngine.h"
 #include "SettingsPanel.h"
+#include "SoundBank.h"  // 
 
 USING_NS_CC;
 using namespace CocosDenshion;
@@ -72,7 +73,7 @@ void PauseMenu::show()
     // ͣϷ
     Director::getInstance()->pause();
     
-    SimpleAudioEngine::getInstance()->playEffect("Music/pause.wav");
+    SoundBank::getInstance()->play("Music/pause.wav");
 }
 
 void PauseMenu::hide()
@@ -0,0 +1,43 @@
+﻿#include "PlatformCollision.h"
+
+USING_NS_CC;
+
+namespace PlatformCollision
+{
+
+int addSolidTilePlatforms(TMXTiledMap* map, float scale, const Vec2& mapOffset, std::vector<Platform>& platforms)
+{
+    auto tileRects = map->getMergedTileRects("solid");
+    size_t handDrawnCount = platforms.size();
+    int addedCount = 0;
+
+    for (const auto& tileRect : tileRects)
+    {
+        Rect rect(tileRect.origin.x * scale + mapOffset.x,
+                  tileRect.origin.y * scale + mapOffset.y,
+                  tileRect.size.width * scale,
+                  tileRect.size.height * scale);
+
+        bool covered = false;
+        for (size_t i = 0; i < handDrawnCount && !covered; ++i)
+        {
+            const Rect& other = platforms[i].rect;
+            covered = other.getMinX() <= rect.getMinX() + 0.5f && other.getMaxX() >= rect.getMaxX() - 0.5f &&
+                      other.getMinY() <= rect.getMinY() + 0.5f && other.getMaxY() >= rect.getMaxY() - 0.5f;
+        }
+        if (covered) {
+            continue;
+        }
+
+        Platform platform;
+        platform.rect = rect;
+        platform.node = nullptr;
+        platforms.push_back(platform);
+        addedCount++;
+    }
+
+    CCLOG("solid 图块合并为 %zu 个矩形，新增碰撞平台 %d 个", tileRects.size(), addedCount);
+    return addedCount;
+}
+
+} // namespace PlatformCollision
@@ -0,0 +1,25 @@
+#ifndef __PLATFORM_COLLISION_H__
+#define __PLATFORM_COLLISION_H__
+
+#include "cocos2d.h"
+#include "TheKnight.h"  // Platform 
+
+/**
+ * ؿײƽ̨ĹɺGameScene / NextScene / BossScene ã
+ */
+namespace PlatformCollision
+{
+    /**
+     * ͼ solid ײƽ̨
+     *
+     *  solid ͼϲɾٵľΣ㵽׷ӵ platforms
+     * ѱֻײȫǵľ
+     * @return ƽ̨
+     */
+    int addSolidTilePlatforms(cocos2d::TMXTiledMap* map,
+                              float scale,
+                              const cocos2d::Vec2& mapOffset,
+                              std::vector<Platform>& platforms);
+}
+
+#endif // __PLATFORM_COLLISION_H__
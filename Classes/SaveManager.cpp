@@ -0,0 +1,431 @@
+﻿#include "SaveManager.h"
+#include "CharmManager.h"
+#include "NextScene.h"
+#include "TheKnight.h"
+
+USING_NS_CC;
+
+namespace
+{
+    const char SAVE_MAGIC[4] = { 'H', 'K', 'S', 'V' };
+    const char* SAVE_FILE_NAME = "hollowknight.sav";
+    const size_t HEADER_SIZE = 16;  // magic + version + payloadSize + checksum
+
+    // FNV-1a 校验，防止读到写了一半或损坏的文件
+    uint32_t checksum(const uint8_t* bytes, size_t size)
+    {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    // 小端写入
+    class BinaryWriter
+    {
+    public:
+        explicit BinaryWriter(std::vector<uint8_t>& out) : _out(out) {}
+
+        void writeU8(uint8_t value) { _out.push_back(value); }
+
+        void writeU32(uint32_t value)
+        {
+            for (int i = 0; i < 4; i++)
+            {
+                _out.push_back((uint8_t)((value >> (i * 8)) & 0xFF));
+            }
+        }
+
+        void writeI32(int32_t value) { writeU32((uint32_t)value); }
+
+        void writeFloat(float value)
+        {
+            uint32_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            writeU32(bits);
+        }
+
+        void writeVec2(const Vec2& value)
+        {
+            writeFloat(value.x);
+            writeFloat(value.y);
+        }
+
+        void writeString(const std::string& value)
+        {
+            writeU32((uint32_t)value.size());
+            _out.insert(_out.end(), value.begin(), value.end());
+        }
+
+        void writeStringSet(const std::set<std::string>& values)
+        {
+            writeU32((uint32_t)values.size());
+            for (const auto& value : values)
+            {
+                writeString(value);
+            }
+        }
+
+    private:
+        std::vector<uint8_t>& _out;
+    };
+
+    // 小端读取，越界时置 failed 并返回默认值
+    class BinaryReader
+    {
+    public:
+        BinaryReader(const uint8_t* bytes, size_t size) : _bytes(bytes), _size(size), _pos(0), _failed(false) {}
+
+        bool failed() const { return _failed; }
+
+        uint8_t readU8()
+        {
+            if (!require(1)) return 0;
+            return _bytes[_pos++];
+        }
+
+        uint32_t readU32()
+        {
+            if (!require(4)) return 0;
+            uint32_t value = 0;
+            for (int i = 0; i < 4; i++)
+            {
+                value |= (uint32_t)_bytes[_pos++] << (i * 8);
+            }
+            return value;
+        }
+
+        int32_t readI32() { return (int32_t)readU32(); }
+
+        float readFloat()
+        {
+            uint32_t bits = readU32();
+            float value;
+            memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        Vec2 readVec2()
+        {
+            float x = readFloat();
+            float y = readFloat();
+            return Vec2(x, y);
+        }
+
+        std::string readString()
+        {
+            uint32_t length = readU32();
+            if (!require(length)) return std::string();
+            std::string value((const char*)_bytes + _pos, length);
+            _pos += length;
+            return value;
+        }
+
+        void readStringSet(std::set<std::string>& values)
+        {
+            values.clear();
+            uint32_t count = readU32();
+            for (uint32_t i = 0; i < count && !_failed; i++)
+            {
+                values.insert(readString());
+            }
+        }
+
+    private:
+        bool require(size_t count)
+        {
+            if (_failed || _pos + count > _size)
+            {
+                _failed = true;
+                return false;
+            }
+            return true;
+        }
+
+        const uint8_t* _bytes;
+        size_t _size;
+        size_t _pos;
+        bool _failed;
+    };
+}
+
+SaveManager* SaveManager::_instance = nullptr;
+
+SaveManager* SaveManager::getInstance()
+{
+    if (_instance == nullptr)
+    {
+        _instance = new SaveManager();
+    }
+    return _instance;
+}
+
+SaveManager::SaveManager()
+    : _hasSave(false)
+    , _pendingKnightState(false)
+{
+}
+
+SaveManager::~SaveManager()
+{
+}
+
+std::string SaveManager::getSavePath() const
+{
+    return FileUtils::getInstance()->getWritablePath() + SAVE_FILE_NAME;
+}
+
+void SaveManager::serialize(const SaveData& data, std::vector<uint8_t>& out)
+{
+    // 先写负载，再补文件头（需要负载长度和校验）
+    std::vector<uint8_t> payload;
+    payload.reserve(256);
+    BinaryWriter writer(payload);
+
+    writer.writeI32(data.charmWaywardCompass);
+    writer.writeI32(data.charmShamanStone);
+    writer.writeI32(data.charmStalwartShell);
+    writer.writeI32(data.charmSteadyBody);
+    writer.writeI32(data.charmSoulCatcher);
+    writer.writeI32(data.charmSprintMaster);
+
+    writer.writeI32(data.hp);
+    writer.writeI32(data.soul);
+
+    writer.writeVec2(data.shadePosition);
+
+    writer.writeString(data.benchScene);
+    writer.writeVec2(data.respawnPosition);
+
+    writer.writeStringSet(data.defeatedEnemies);
+
+    writer.writeU8(data.hasCrossroadsMap ? 1 : 0);
+    writer.writeStringSet(data.visitedScenes);
+
+    out.clear();
+    out.reserve(HEADER_SIZE + payload.size());
+    out.insert(out.end(), SAVE_MAGIC, SAVE_MAGIC + 4);
+    BinaryWriter header(out);
+    header.writeU32(SAVE_VERSION);
+    header.writeU32((uint32_t)payload.size());
+    header.writeU32(checksum(payload.data(), payload.size()));
+    out.insert(out.end(), payload.begin(), payload.end());
+}
+
+bool SaveManager::deserialize(const unsigned char* bytes, ssize_t size, SaveData& data)
+{
+    if (!bytes || size < (ssize_t)HEADER_SIZE || memcmp(bytes, SAVE_MAGIC, 4) != 0)
+    {
+        CCLOG("SaveManager: 存档文件头无效");
+        return false;
+    }
+
+    BinaryReader header(bytes + 4, HEADER_SIZE - 4);
+    uint32_t version = header.readU32();
+    uint32_t payloadSize = header.readU32();
+    uint32_t expectedChecksum = header.readU32();
+
+    if (version == 0 || version > SAVE_VERSION)
+    {
+        CCLOG("SaveManager: 不支持的存档版本 %u（当前 %u）", version, SAVE_VERSION);
+        return false;
+    }
+    if ((ssize_t)(HEADER_SIZE + payloadSize) > size)
+    {
+        CCLOG("SaveManager: 存档被截断");
+        return false;
+    }
+
+    const uint8_t* payload = bytes + HEADER_SIZE;
+    if (checksum(payload, payloadSize) != expectedChecksum)
+    {
+        CCLOG("SaveManager: 存档校验失败");
+        return false;
+    }
+
+    // 新版本追加字段时在这里按 version 分支读取
+    SaveData result;
+    BinaryReader reader(payload, payloadSize);
+
+    result.charmWaywardCompass = reader.readI32();
+    result.charmShamanStone = reader.readI32();
+    result.charmStalwartShell = reader.readI32();
+    result.charmSteadyBody = reader.readI32();
+    result.charmSoulCatcher = reader.readI32();
+    result.charmSprintMaster = reader.readI32();
+
+    result.hp = reader.readI32();
+    result.soul = reader.readI32();
+
+    result.shadePosition = reader.readVec2();
+
+    result.benchScene = reader.readString();
+    result.respawnPosition = reader.readVec2();
+
+    reader.readStringSet(result.defeatedEnemies);
+
+    result.hasCrossroadsMap = reader.readU8() != 0;
+    reader.readStringSet(result.visitedScenes);
+
+    if (reader.failed())
+    {
+        CCLOG("SaveManager: 存档内容不完整");
+        return false;
+    }
+
+    data = std::move(result);
+    return true;
+}
+
+bool SaveManager::load()
+{
+    std::string path = getSavePath();
+    if (!FileUtils::getInstance()->isFileExist(path))
+    {
+        CCLOG("SaveManager: 没有存档文件 %s", path.c_str());
+        _hasSave = false;
+        return false;
+    }
+
+    Data fileData = FileUtils::getInstance()->getDataFromFile(path);
+    SaveData loaded;
+    if (!deserialize(fileData.getBytes(), fileData.getSize(), loaded))
+    {
+        _hasSave = false;
+        return false;
+    }
+
+    _data = std::move(loaded);
+    _hasSave = true;
+    _pendingKnightState = true;
+
+    CCLOG("SaveManager: 读取存档成功，椅子: %s，已击败敌人: %zu",
+          _data.benchScene.c_str(), _data.defeatedEnemies.size());
+    return true;
+}
+
+void SaveManager::resetSave()
+{
+    _data = SaveData();
+    _hasSave = false;
+    _pendingKnightState = false;
+
+    // 排在 IO 队列里删除：还没落盘的自动存档先写完，不会在删除后又把旧存档写回来
+    std::string path = getSavePath();
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_IO, [path]() {
+        auto fileUtils = FileUtils::getInstance();
+        if (fileUtils->isFileExist(path))
+        {
+            fileUtils->removeFile(path);
+        }
+    });
+}
+
+void SaveManager::applyToGame()
+{
+    auto charmManager = CharmManager::getInstance();
+    charmManager->setCharmWaywardCompass(_data.charmWaywardCompass);
+    charmManager->setCharmShamanStone(_data.charmShamanStone);
+    charmManager->setCharmStalwartShell(_data.charmStalwartShell);
+    charmManager->setCharmSteadyBody(_data.charmSteadyBody);
+    charmManager->setCharmSoulCatcher(_data.charmSoulCatcher);
+    charmManager->setCharmSprintMaster(_data.charmSprintMaster);
+    charmManager->recalculateUsedNotches();
+
+    NextScene::setSavedShadePosition(_data.shadePosition);
+}
+
+void SaveManager::applyToKnight(TheKnight* knight)
+{
+    if (!knight || !_pendingKnightState) return;
+    _pendingKnightState = false;
+
+    if (_data.hp > 0)
+    {
+        knight->setHP(_data.hp);
+    }
+    knight->setSoul(_data.soul);
+}
+
+void SaveManager::captureFromGame(TheKnight* knight)
+{
+    auto charmManager = CharmManager::getInstance();
+    _data.charmWaywardCompass = charmManager->getCharmWaywardCompass();
+    _data.charmShamanStone = charmManager->getCharmShamanStone();
+    _data.charmStalwartShell = charmManager->getCharmStalwartShell();
+    _data.charmSteadyBody = charmManager->getCharmSteadyBody();
+    _data.charmSoulCatcher = charmManager->getCharmSoulCatcher();
+    _data.charmSprintMaster = charmManager->getCharmSprintMaster();
+
+    if (knight)
+    {
+        _data.hp = knight->getHP();
+        _data.soul = knight->getSoul();
+    }
+
+    _data.shadePosition = NextScene::getSavedShadePosition();
+}
+
+void SaveManager::autosave(TheKnight* knight, const std::string& sceneName)
+{
+    captureFromGame(knight);
+    _data.visitedScenes.insert(sceneName);
+
+    // 主线程只做序列化（几百字节），写盘交给 IO 线程
+    std::vector<uint8_t> buffer;
+    serialize(_data, buffer);
+    CCLOG("SaveManager: 自动存档 (%s)，%zu 字节", sceneName.c_str(), buffer.size());
+    writeAsync(std::move(buffer));
+
+    _hasSave = true;
+}
+
+void SaveManager::writeAsync(std::vector<uint8_t>&& buffer)
+{
+    std::string finalPath = getSavePath();
+    std::string tempPath = finalPath + ".tmp";
+
+    Data data;
+    data.copy(buffer.data(), (ssize_t)buffer.size());
+
+    // TASK_IO 是单线程队列，多次存档按顺序落盘，最后一次总是最新的
+    auto task = std::make_shared<Data>(std::move(data));
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_IO, [task, tempPath, finalPath]() {
+        auto fileUtils = FileUtils::getInstance();
+        bool ok = fileUtils->writeDataToFile(*task, tempPath)
+               && fileUtils->renameFile(tempPath, finalPath);
+
+        if (!ok)
+        {
+            Director::getInstance()->getScheduler()->performFunctionInCocosThread([finalPath]() {
+                CCLOG("SaveManager: 写入存档失败 %s", finalPath.c_str());
+            });
+        }
+    });
+}
+
+void SaveManager::setBench(const std::string& sceneName, const Vec2& position)
+{
+    _data.benchScene = sceneName;
+    _data.respawnPosition = position;
+}
+
+void SaveManager::markEnemyDefeated(const std::string& name)
+{
+    if (name.empty()) return;
+    _data.defeatedEnemies.insert(name);
+}
+
+bool SaveManager::isEnemyDefeated(const std::string& name) const
+{
+    return _data.defeatedEnemies.find(name) != _data.defeatedEnemies.end();
+}
+
+void SaveManager::clearDefeatedEnemies()
+{
+    // 椅子休息后敌人复活
+    _data.defeatedEnemies.clear();
+}
@@ -0,0 +1,124 @@
+#ifndef __SAVE_MANAGER_H__
+#define __SAVE_MANAGER_H__
+
+#include "cocos2d.h"
+#include <set>
+
+USING_NS_CC;
+
+class TheKnight;
+
+// 浵еĳ
+namespace SaveScene
+{
+    const char* const DIRTMOUTH = "Dirtmouth";              // GameScene
+    const char* const CROSSROADS = "ForgottenCrossroads";   // NextScene
+}
+
+// 浵ݣȫΪ̶߳д
+struct SaveData
+{
+    //  (0 = δװ, 1 = װ)
+    int charmWaywardCompass = 0;
+    int charmShamanStone = 0;
+    int charmStalwartShell = 0;
+    int charmSteadyBody = 0;
+    int charmSoulCatcher = 0;
+    int charmSprintMaster = 0;
+
+    // ʿ״̬
+    int hp = 0;
+    int soul = 0;
+
+    // Shade λãZERO ʾû Shade
+    Vec2 shadePosition = Vec2::ZERO;
+
+    //  / 
+    std::string benchScene;
+    Vec2 respawnPosition = Vec2::ZERO;
+
+    // ѻܵĵˣڵ¼
+    std::set<std::string> defeatedEnemies;
+
+    // ͼ
+    bool hasCrossroadsMap = false;
+    std::set<std::string> visitedScenes;
+};
+
+/**
+ * 浵
+ *
+ * ƴ浵̰߳ SaveData лڴ滺
+ * дļ AsyncTaskPool  IO ̣߳дʱļԭ
+ * ϢлʱԶ浵Ῠ֡
+ */
+class SaveManager
+{
+public:
+    static SaveManager* getInstance();
+
+    // ǰ浵ʽ汾
+    static const uint32_t SAVE_VERSION = 1;
+
+    // ȡ浵ļֻͬʱһΣ
+    bool load();
+
+    // ǷڿɼĴ浵
+    bool hasSave() const { return _hasSave; }
+
+    // ɾ浵ݣϷ
+    void resetSave();
+
+    // Ѵ浵еĻShade ȫ״̬дϷ
+    void applyToGame();
+
+    // һδʿʱָ HP/SoulֻЧһΣ
+    void applyToKnight(TheKnight* knight);
+
+    /**
+     * Զ浵ռǰϷ״̬첽д
+     * @param knight    ǰʿΪգΪʱϴε HP/Soul
+     * @param sceneName ǰ SaveScene
+     */
+    void autosave(TheKnight* knight, const std::string& sceneName);
+
+    // ¼Ϣ
+    void setBench(const std::string& sceneName, const Vec2& position);
+
+    // ˻ܼ¼
+    void markEnemyDefeated(const std::string& name);
+    bool isEnemyDefeated(const std::string& name) const;
+    void clearDefeatedEnemies();
+
+    // ͼ
+    void setHasCrossroadsMap(bool hasMap) { _data.hasCrossroadsMap = hasMap; }
+    bool hasCrossroadsMap() const { return _data.hasCrossroadsMap; }
+    void markSceneVisited(const std::string& sceneName) { _data.visitedScenes.insert(sceneName); }
+
+    const SaveData& getData() const { return _data; }
+
+    // лԱ㹤/ʹã
+    static void serialize(const SaveData& data, std::vector<uint8_t>& out);
+    static bool deserialize(const unsigned char* bytes, ssize_t size, SaveData& data);
+
+private:
+    SaveManager();
+    ~SaveManager();
+
+    //  CharmManagerNextScene ȴռǰ״̬
+    void captureFromGame(TheKnight* knight);
+
+    // ѻ IO ߳д
+    void writeAsync(std::vector<uint8_t>&& buffer);
+
+    std::string getSavePath() const;
+
+private:
+    static SaveManager* _instance;
+
+    SaveData _data;
+    bool _hasSave;
+    bool _pendingKnightState;   // ǷҪָʿ HP/Soul
+};
+
+#endif // __SAVE_MANAGER_H__
@@ -1,5 +1,6 @@
 #include "SettingsPanel.h"
 #include "AudioSettings.h"
+#include "InputManager.h"  // λذ
 #include "SimpleAudioEngine.h"
 
 USING_NS_CC;
@@ -186,42 +187,73 @@ bool SettingsPanel::init()
     keyBindbg->setPosition(Vec2(centerX, visibleSize.height - 240));
     _keyBindPanel->addChild(keyBindbg);
 
-    // λб
-    std::vector<std::pair<std::string, std::string>> keyBindings = {
-        {u8"", u8"W"},
-        {u8"", u8"S"},
-        {u8"", u8"A"},
-        {u8"", u8"D"},
-        {u8"", u8"J"},
-        {u8"Ծ", u8"K"},
-        {u8"", u8"L"},
-        {u8"ۼ/", u8"Space"},
-        {u8"ͣ", u8"ESC"}
+    // ޸ġλб InputManager ȡǰλ°
+    std::vector<std::pair<std::string, InputAction>> keyBindings = {
+        {u8"", InputAction::UP},
+        {u8"", InputAction::DOWN},
+        {u8"", InputAction::LEFT},
+        {u8"", InputAction::RIGHT},
+        {u8"", InputAction::ATTACK},
+        {u8"Ծ", InputAction::JUMP},
+        {u8"", InputAction::DASH},
+        {u8"ۼ/", InputAction::SPELL},
+        {u8"ͼ", InputAction::MAP},
+        {u8"", InputAction::CHARM},
+        {u8"ͣ", InputAction::PAUSE}
     };
     
+    auto keyBindMenu = Menu::create();
+    keyBindMenu->setPosition(Vec2::ZERO);
+    _keyBindPanel->addChild(keyBindMenu);
+    
     float keyStartY = centerY + 225;
     for (size_t i = 0; i < keyBindings.size(); ++i)
     {
         auto actionLabel = Label::createWithTTF(keyBindings[i].first, "fonts/NotoSerifCJKsc-Regular.otf", 36);
         actionLabel->setTextColor(Color4B(200, 200, 200, 255));
-        actionLabel->setPosition(Vec2(centerX - 150, keyStartY - i * 60));
+        actionLabel->setPosition(Vec2(centerX - 150, keyStartY - i * 55));
         _keyBindPanel->addChild(actionLabel);
         
-        auto keyLabel = Label::createWithTTF(keyBindings[i].second, "fonts/NotoSerifCJKsc-Regular.otf", 36);
+        InputAction action = keyBindings[i].second;
+        auto keyLabel = Label::createWithTTF("", "fonts/NotoSerifCJKsc-Regular.otf", 36);
         keyLabel->setTextColor(Color4B::WHITE);
-        keyLabel->setPosition(Vec2(centerX + 150, keyStartY - i * 60));
-        _keyBindPanel->addChild(keyLabel);
+        auto keyItem = MenuItemLabel::create(keyLabel, [this, action, keyLabel](Ref*) {
+            auto input = InputManager::getInstance();
+            if (input->isRebinding()) return;
+            
+            SimpleAudioEngine::getInstance()->playEffect("Music/click.wav", false, 1.0f, 0.0f, AudioSettings::getSFXVolume());
+            keyLabel->setString(u8"°...");
+            keyLabel->setTextColor(Color4B(255, 220, 120, 255));
+            input->beginRebind(action, [this](bool success) {
+                // ͻʱһļλҲ仯ȫˢ
+                updateKeyBindLabels();
+            });
+        });
+        keyItem->setPosition(Vec2(centerX + 150, keyStartY - i * 55));
+        keyBindMenu->addChild(keyItem);
+        
+        _keyBindLabels.push_back(std::make_pair(action, keyLabel));
     }
+    updateKeyBindLabels();
+    
+    // ָĬϼλť
+    auto keyBindResetLabel = Label::createWithTTF(u8"ָĬ", "fonts/NotoSerifCJKsc-Regular.otf", 48);
+    keyBindResetLabel->setTextColor(Color4B::WHITE);
+    auto keyBindResetItem = MenuItemLabel::create(keyBindResetLabel, [this](Ref*) {
+        if (InputManager::getInstance()->isRebinding()) return;
+        SimpleAudioEngine::getInstance()->playEffect("Music/click.wav", false, 1.0f, 0.0f, AudioSettings::getSFXVolume());
+        InputManager::getInstance()->resetBindings();
+        updateKeyBindLabels();
+    });
+    keyBindResetItem->setPosition(Vec2(centerX - 150, 100));
+    keyBindMenu->addChild(keyBindResetItem);
     
     // ϼ˵ť
     auto keyBindBackLabel = Label::createWithTTF(u8"", "fonts/NotoSerifCJKsc-Regular.otf", 48);
     keyBindBackLabel->setTextColor(Color4B::WHITE);
     auto keyBindBackItem = MenuItemLabel::create(keyBindBackLabel, CC_CALLBACK_1(SettingsPanel::onBackToMainMenu, this));
-    keyBindBackItem->setPosition(Vec2(centerX, 100));
-    
-    auto keyBindMenu = Menu::create(keyBindBackItem, nullptr);
-    keyBindMenu->setPosition(Vec2::ZERO);
-    _keyBindPanel->addChild(keyBindMenu);
+    keyBindBackItem->setPosition(Vec2(centerX + 150, 100));
+    keyBindMenu->addChild(keyBindBackItem);
     
     this->setVisible(false);
     
@@ -253,6 +285,7 @@ void SettingsPanel::showVolumePanel()
 
 void SettingsPanel::showKeyBindPanel()
 {
+    updateKeyBindLabels();
     hideAllPanels();
     _keyBindPanel->setVisible(true);
 }
@@ -265,6 +298,7 @@ void SettingsPanel::show()
 
 void SettingsPanel::hide()
 {
+    InputManager::getInstance()->cancelRebind();  // 
     this->setVisible(false);
 }
 
@@ -282,6 +316,9 @@ void SettingsPanel::onCloseClicked(Ref* sender)
 void SettingsPanel::onBackToMainMenu(Ref* sender)
 {
     SimpleAudioEngine::getInstance()->playEffect("Music/click.wav", false, 1.0f, 0.0f, AudioSettings::getSFXVolume());
+    // 뿪λҳʱδɵĸļ
+    InputManager::getInstance()->cancelRebind();
+    updateKeyBindLabels();
     // ȡʱָʱֵΪȫֵ
     _tempBgmVolume = AudioSettings::g_bgmVolume;
     _tempSfxVolume = AudioSettings::g_sfxVolume;
@@ -312,4 +349,14 @@ void SettingsPanel::updateVolumeLabels()
     {
         _sfxVolumeLabel->setString(std::to_string(_tempSfxVolume));
     }
-}
\ No newline at end of file
+}
+// ˢ¼λʾ
+void SettingsPanel::updateKeyBindLabels()
+{
+    auto input = InputManager::getInstance();
+    for (auto& entry : _keyBindLabels)
+    {
+        entry.second->setString(InputManager::getKeyName(input->getPrimaryKey(entry.first)));
+        entry.second->setTextColor(Color4B::WHITE);
+    }
+}
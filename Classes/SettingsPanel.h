@@ -5,6 +5,7 @@
 
 #include "cocos2d.h"
 #include "AudioSettings.h"
+#include "InputManager.h"  // 
 
 class SettingsPanel : public cocos2d::Node
 {
@@ -28,6 +29,7 @@ private:
     void onBackToMainMenu(cocos2d::Ref* sender);
     void onSaveClicked(cocos2d::Ref* sender);  // 水ťص
     void updateVolumeLabels();
+    void updateKeyBindLabels();  // 
     
     cocos2d::LayerColor* _backgroundLayer = nullptr;
     
@@ -41,6 +43,7 @@ private:
     
     // λ˵
     cocos2d::Node* _keyBindPanel = nullptr;
+    std::vector<std::pair<InputAction, cocos2d::Label*>> _keyBindLabels;  // °󶨵ļλǩ
     
     CloseCallback _closeCallback;
     
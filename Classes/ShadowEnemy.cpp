@@ -1,4 +1,5 @@
 #include "ShadowEnemy.h"
+#include "FlowField.h"
 
 USING_NS_CC;
 
@@ -15,6 +16,8 @@ bool ShadowEnemy::init() {
     _isFacingLeft = true;
     _detectionRange = 350.0f;
     _playerDamageCooldown = 0.0f;
+    _target = nullptr;
+    _flowField = nullptr;
 
     // ʾ
     _display = Sprite::create();
@@ -97,6 +100,10 @@ void ShadowEnemy::setTarget(TheKnight* target) {
     _target = target;
 }
 
+void ShadowEnemy::setFlowField(const FlowField* flowField) {
+    _flowField = flowField;
+}
+
 void ShadowEnemy::update(float dt) {
     if (!_target) return;
 
@@ -175,7 +182,9 @@ void ShadowEnemy::updateChase(float dt) {
     }
 
     if (dist > 10.0f) {
-        Vec2 direction = (targetPos - myPos).getNormalized();
+        // ʱƿΣֱ߷Ŀ
+        Vec2 direction = _flowField ? _flowField->sampleDirection(myPos)
+                                    : (targetPos - myPos).getNormalized();
         this->setPosition(myPos + direction * _moveSpeed * dt);
 
         if (direction.x > 0) {
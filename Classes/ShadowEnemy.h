@@ -4,6 +4,8 @@
 #include "cocos2d.h"
 #include "TheKnight.h" // ޸ģTheKnightͷļ
 
+class FlowField;
+
 class ShadowEnemy : public cocos2d::Node {
 public:
     // ״̬
@@ -19,6 +21,7 @@ public:
     CREATE_FUNC(ShadowEnemy);
 
     void setTarget(TheKnight* target); // ޸ģĿ͸ΪTheKnight*
+    void setFlowField(const FlowField* flowField); // ׷ʱƿǽ
     void takeDamage();
     
     // ȡײ
@@ -34,6 +37,7 @@ protected:
 
     cocos2d::Sprite* _display;
     TheKnight* _target; // ޸ģĿ͸ΪTheKnight*
+    const FlowField* _flowField; // Ϊգ
     State _currentState;
     State _previousState; // ڱܻǰ״̬
     int _hp;
@@ -0,0 +1,238 @@
+﻿#include "SoundBank.h"
+#include "AudioSettings.h"
+#include "audio/include/AudioEngine.h"
+
+USING_NS_CC;
+using namespace cocos2d::experimental;
+
+namespace
+{
+    struct GroupEntry
+    {
+        SoundGroup group;
+        const char* path;
+        int maxVoices;
+        int priority;
+        float minInterval;
+    };
+
+    // 音效表：分组、路径、最大同时发声数、优先级、最短触发间隔
+    const GroupEntry SOUND_TABLE[] = {
+        { SoundGroup::UI,     "Music/pause.wav",              1, 5,  0.0f  },
+
+        { SoundGroup::KNIGHT, "Music/hero_running.wav",       1, 6,  0.0f  },
+        { SoundGroup::KNIGHT, "Music/hero_jump.wav",          1, 5,  0.05f },
+        { SoundGroup::KNIGHT, "Music/hero_land.wav",          1, 4,  0.05f },
+        { SoundGroup::KNIGHT, "Music/hero_dash.wav",          1, 5,  0.0f  },
+        { SoundGroup::KNIGHT, "Music/hero_sword.wav",         2, 6,  0.05f },
+        { SoundGroup::KNIGHT, "Music/hero_damage.wav",        1, 9,  0.0f  },
+        { SoundGroup::KNIGHT, "Music/hero_death.wav",         1, 10, 0.0f  },
+        { SoundGroup::KNIGHT, "Music/hero_fireball.wav",      2, 7,  0.0f  },
+        { SoundGroup::KNIGHT, "Music/fireball_disappear.wav", 2, 5,  0.05f },
+
+        { SoundGroup::ENEMY,  "Music/enemy_damage.wav",       3, 4,  0.03f },
+        { SoundGroup::ENEMY,  "Music/enemy_death.wav",        3, 5,  0.0f  },
+
+        { SoundGroup::HORNET, "Music/1.wav",                  1, 8,  0.0f  },
+        { SoundGroup::HORNET, "Music/2.wav",                  1, 8,  0.0f  },
+        { SoundGroup::HORNET, "Music/3.wav",                  1, 8,  0.0f  },
+        { SoundGroup::HORNET, "Music/4.wav",                  1, 8,  0.0f  },
+    };
+}
+
+SoundBank* SoundBank::_instance = nullptr;
+
+SoundBank* SoundBank::getInstance()
+{
+    if (_instance == nullptr)
+    {
+        _instance = new SoundBank();
+    }
+    return _instance;
+}
+
+SoundBank::SoundBank()
+    : _pendingLoads(0)
+{
+    _voices.reserve(MAX_VOICES);
+}
+
+void SoundBank::loadBank(std::initializer_list<SoundGroup> groups)
+{
+    std::unordered_map<std::string, SoundDef> bank;
+    for (const auto& entry : SOUND_TABLE)
+    {
+        for (auto group : groups)
+        {
+            if (entry.group == group)
+            {
+                bank[entry.path] = SoundDef{ entry.path, entry.maxVoices, entry.priority, entry.minInterval };
+                break;
+            }
+        }
+    }
+
+    // 卸载新场景不再使用的音效
+    for (const auto& pair : _loaded)
+    {
+        if (bank.find(pair.first) == bank.end())
+        {
+            AudioEngine::uncache(pair.first);
+        }
+    }
+
+    // 切换音效表前先停掉旧声音，避免 Voice 指向已释放的 SoundDef
+    stopAll();
+
+    // 预加载新增的音效（已经在内存中的不会重复解码）
+    for (const auto& pair : bank)
+    {
+        if (_loaded.find(pair.first) != _loaded.end()) continue;
+
+        _pendingLoads++;
+        std::string path = pair.first;
+        AudioEngine::preload(path, [this, path](bool isSuccess) {
+            _pendingLoads--;
+            if (!isSuccess)
+            {
+                CCLOG("SoundBank: 预加载失败 %s", path.c_str());
+            }
+        });
+    }
+
+    _loaded = std::move(bank);
+    _lastPlayTime.clear();
+
+    CCLOG("SoundBank: 加载音效库 %zu 个音效，等待解码 %d 个", _loaded.size(), _pendingLoads);
+}
+
+const SoundBank::SoundDef* SoundBank::findDef(const std::string& path) const
+{
+    auto it = _loaded.find(path);
+    return it != _loaded.end() ? &it->second : nullptr;
+}
+
+void SoundBank::pruneVoices()
+{
+    for (size_t i = 0; i < _voices.size();)
+    {
+        if (AudioEngine::getState(_voices[i].audioID) == AudioEngine::AudioState::ERROR)
+        {
+            _voices[i] = _voices.back();
+            _voices.pop_back();
+        }
+        else
+        {
+            i++;
+        }
+    }
+}
+
+void SoundBank::stopVoiceAt(size_t index)
+{
+    AudioEngine::stop(_voices[index].audioID);
+    _voices[index] = _voices.back();
+    _voices.pop_back();
+}
+
+bool SoundBank::reserveVoice(const SoundDef* def)
+{
+    // 同名声音达到上限：顶掉最早的一个
+    int sameCount = 0;
+    int oldestSame = -1;
+    for (size_t i = 0; i < _voices.size(); i++)
+    {
+        if (_voices[i].def != def) continue;
+        sameCount++;
+        if (oldestSame < 0 || _voices[i].startTime < _voices[oldestSame].startTime)
+        {
+            oldestSame = (int)i;
+        }
+    }
+    if (sameCount >= def->maxVoices && oldestSame >= 0)
+    {
+        stopVoiceAt(oldestSame);
+        return true;
+    }
+
+    if ((int)_voices.size() < MAX_VOICES) return true;
+
+    // 声道池已满：抢占优先级最低（同级取最早）的声音
+    int victim = -1;
+    for (size_t i = 0; i < _voices.size(); i++)
+    {
+        if (victim < 0
+            || _voices[i].def->priority < _voices[victim].def->priority
+            || (_voices[i].def->priority == _voices[victim].def->priority
+                && _voices[i].startTime < _voices[victim].startTime))
+        {
+            victim = (int)i;
+        }
+    }
+    if (victim < 0 || _voices[victim].def->priority > def->priority)
+    {
+        return false;
+    }
+
+    stopVoiceAt(victim);
+    return true;
+}
+
+int SoundBank::play(const std::string& path, bool loop)
+{
+    const SoundDef* def = findDef(path);
+    if (!def)
+    {
+        // 未声明的音效仍可播放，但会在首次使用时解码。
+        // 每个路径单独登记一条默认规则，互不相干的音效不会共用同一个发声上限；
+        // 登记后随当前音效库一起在切换场景时卸载
+        CCLOG("SoundBank: %s 不在当前音效库中", path.c_str());
+        def = &_loaded.emplace(path, SoundDef{ path, 4, 0, 0.0f }).first->second;
+    }
+
+    double now = utils::gettime();
+    if (def->minInterval > 0.0f)
+    {
+        auto it = _lastPlayTime.find(path);
+        if (it != _lastPlayTime.end() && now - it->second < def->minInterval)
+        {
+            return AudioEngine::INVALID_AUDIO_ID;
+        }
+    }
+
+    pruneVoices();
+    if (!reserveVoice(def))
+    {
+        return AudioEngine::INVALID_AUDIO_ID;
+    }
+
+    int audioID = AudioEngine::play2d(path, loop, AudioSettings::getSFXVolume());
+    if (audioID != AudioEngine::INVALID_AUDIO_ID)
+    {
+        _voices.push_back(Voice{ audioID, def, now });
+        _lastPlayTime[path] = now;
+    }
+    return audioID;
+}
+
+void SoundBank::stop(int audioID)
+{
+    for (size_t i = 0; i < _voices.size(); i++)
+    {
+        if (_voices[i].audioID == audioID)
+        {
+            stopVoiceAt(i);
+            return;
+        }
+    }
+    AudioEngine::stop(audioID);
+}
+
+void SoundBank::stopAll()
+{
+    for (const auto& voice : _voices)
+    {
+        AudioEngine::stop(voice.audioID);
+    }
+    _voices.clear();
+}
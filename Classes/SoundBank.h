@@ -0,0 +1,93 @@
+#ifndef __SOUND_BANK_H__
+#define __SOUND_BANK_H__
+
+#include "cocos2d.h"
+#include <initializer_list>
+
+// Ч飨ÿԼҪķ飩
+enum class SoundGroup
+{
+    UI,         // ͣȽЧ
+    KNIGHT,     // ʿ
+    ENEMY,      // Сܻ
+    HORNET      // Ʒ
+};
+
+/**
+ * Ч⣨
+ *
+ * ʼʱ loadBank() ԤرȫЧΪ PCM פڴ棩
+ * ս play() ֻٶļ롣
+ * ͬʱ̶Сأ
+ *   - ÿЧͬʱʱͬηв
+ *   - ʱȼռȼֱӶ
+ */
+class SoundBank
+{
+public:
+    static SoundBank* getInstance();
+
+    // شСAudioEngine Ĭ 24ģ飩
+    static const int MAX_VOICES = 16;
+
+    /**
+     * سЧ⣺ԤطеЧжϸʹõЧ
+     * @param groups õЧ
+     */
+    void loadBank(std::initializer_list<SoundGroup> groups);
+
+    // ԤǷȫ
+    bool isReady() const { return _pendingLoads == 0; }
+
+    /**
+     * Ч
+     * @return  IDռʧʱ AudioEngine::INVALID_AUDIO_ID
+     */
+    int play(const std::string& path, bool loop = false);
+
+    // ָֹͣѭЧ
+    void stop(int audioID);
+
+    // ֹͣЧ
+    void stopAll();
+
+private:
+    // ЧĲŹ
+    struct SoundDef
+    {
+        std::string path;
+        int maxVoices;      // ͬͬʱ
+        int priority;       // ԽԽҪ
+        float minInterval;  // ̴ͬ룩
+    };
+
+    // ڲŵ
+    struct Voice
+    {
+        int audioID;
+        const SoundDef* def;
+        double startTime;
+    };
+
+    SoundBank();
+
+    const SoundDef* findDef(const std::string& path) const;
+
+    // ƳѾ
+    void pruneVoices();
+
+    // Ϊڳλã false ʾӦ
+    bool reserveVoice(const SoundDef* def);
+
+    void stopVoiceAt(size_t index);
+
+private:
+    static SoundBank* _instance;
+
+    std::unordered_map<std::string, SoundDef> _loaded;     // ǰѼصЧ
+    std::unordered_map<std::string, double> _lastPlayTime; // ͬϴδʱ
+    std::vector<Voice> _voices;                            // 
+    int _pendingLoads;
+};
+
+#endif // __SOUND_BANK_H__
@@ -7,6 +7,7 @@
 #define __THE_KNIGHT_H__
 
 #include "cocos2d.h"
+#include "InputManager.h"  // 
 
 USING_NS_CC;
 
@@ -162,6 +163,9 @@ public:
     bool isSitting() const;
     void startSitting();  // Called by GameScene when near chair and press W
     
+    // ƽ̨ײѯܸãϴȡߺۼƴ
+    static int takeCollisionQueryCount();
+    
 private:
     // ָʼ֡ͽ֡
     Animation* createAnimation(const std::string& path, const std::string& prefix, int startFrame, int endFrame, float delay);
@@ -172,9 +176,10 @@ private:
     // Ŷ
     void playAnimation(const std::string& animName, bool loop = true);
     
-    // ¼
-    void onKeyPressed(EventKeyboard::KeyCode keyCode, Event* event);
-    void onKeyReleased(EventKeyboard::KeyCode keyCode, Event* event);
+    // ޸ġ봦 InputManager ĶѯֱӼ
+    void processInput();
+    void onActionPressed(InputAction action);
+    void onActionReleased(InputAction action);
     
     // ״̬л
     void changeState(KnightState newState);
@@ -238,6 +243,8 @@ private:
     
     // ǽ
     bool checkWallSlideCollision(bool checkRight);
+    
+    static int s_collisionQueries;   // ƽ̨ײѯ
     void startWallSlide(bool wallOnRight);
     void updateWallSlide(float dt);
     void startWallJump();
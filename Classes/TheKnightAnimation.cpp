@@ -4,9 +4,7 @@
  */
 
 #include "TheKnight.h"
-#include "audio/include/SimpleAudioEngine.h"
-
-using namespace CocosDenshion;
+#include "SoundBank.h"  // ޸ġЧ SoundBank
 
 Animation* TheKnight::createAnimation(const std::string& path, const std::string& prefix, int startFrame, int endFrame, float delay)
 {
@@ -463,7 +461,7 @@ void TheKnight::changeState(KnightState newState)
     {
         if (_runningSoundId != -1)
         {
-            SimpleAudioEngine::getInstance()->stopEffect(_runningSoundId);
+            SoundBank::getInstance()->stop(_runningSoundId);
             _runningSoundId = -1;
         }
     }
@@ -496,7 +494,7 @@ void TheKnight::changeState(KnightState newState)
             this->stopAllActions();
             
             // ܲЧѭţ
-            _runningSoundId = SimpleAudioEngine::getInstance()->playEffect("Music/hero_running.wav", true);
+            _runningSoundId = SoundBank::getInstance()->play("Music/hero_running.wav", true);
             
             auto animation = AnimationCache::getInstance()->getAnimation("runStart");
             if (animation)
@@ -546,7 +544,7 @@ void TheKnight::changeState(KnightState newState)
         case KnightState::JUMPING:
         {
             // ԾЧ
-            SimpleAudioEngine::getInstance()->playEffect("Music/hero_jump.wav", false);
+            SoundBank::getInstance()->play("Music/hero_jump.wav");
             
             this->stopAllActions();
             auto animation = AnimationCache::getInstance()->getAnimation("Airborne");
@@ -582,7 +580,7 @@ void TheKnight::changeState(KnightState newState)
         case KnightState::LANDING:
         {
             // Ч
-            SimpleAudioEngine::getInstance()->playEffect("Music/hero_land.wav", false);
+            SoundBank::getInstance()->play("Music/hero_land.wav");
             
             this->stopAllActions();
             auto animation = AnimationCache::getInstance()->getAnimation("land");
@@ -598,7 +596,7 @@ void TheKnight::changeState(KnightState newState)
         case KnightState::HARD_LANDING:
         {
             // Ч
-            SimpleAudioEngine::getInstance()->playEffect("Music/hero_land.wav", false);
+            SoundBank::getInstance()->play("Music/hero_land.wav");
             
             this->stopAllActions();
             auto animation = AnimationCache::getInstance()->getAnimation("hardLand");
@@ -614,7 +612,7 @@ void TheKnight::changeState(KnightState newState)
         case KnightState::DASHING:
         {
             // ųЧ
-            SimpleAudioEngine::getInstance()->playEffect("Music/hero_dash.wav", false);
+            SoundBank::getInstance()->play("Music/hero_dash.wav");
             
             this->stopAllActions();
             _dashTimer = 0.0f;
@@ -737,7 +735,7 @@ void TheKnight::changeState(KnightState newState)
         case KnightState::WALL_JUMPING:
         {
             // ǽҲԾЧ
-            SimpleAudioEngine::getInstance()->playEffect("Music/hero_jump.wav", false);
+            SoundBank::getInstance()->play("Music/hero_jump.wav");
             
             this->stopAllActions();
             auto animation = AnimationCache::getInstance()->getAnimation("wallJump");
@@ -753,7 +751,7 @@ void TheKnight::changeState(KnightState newState)
         case KnightState::DOUBLE_JUMPING:
         {
             // ҲԾЧ
-            SimpleAudioEngine::getInstance()->playEffect("Music/hero_jump.wav", false);
+            SoundBank::getInstance()->play("Music/hero_jump.wav");
             
             this->stopAllActions();
             auto animation = AnimationCache::getInstance()->getAnimation("doubleJump");
@@ -769,7 +767,7 @@ void TheKnight::changeState(KnightState newState)
         case KnightState::SLASHING:
         {
             // ŹЧ
-            SimpleAudioEngine::getInstance()->playEffect("Music/hero_sword.wav", false);
+            SoundBank::getInstance()->play("Music/hero_sword.wav");
             
             this->stopAllActions();
             auto animation = AnimationCache::getInstance()->getAnimation("slash");
@@ -789,7 +787,7 @@ void TheKnight::changeState(KnightState newState)
         case KnightState::UP_SLASHING:
         {
             // ŹЧ
-            SimpleAudioEngine::getInstance()->playEffect("Music/hero_sword.wav", false);
+            SoundBank::getInstance()->play("Music/hero_sword.wav");
             
             this->stopAllActions();
             auto animation = AnimationCache::getInstance()->getAnimation("upSlash");
@@ -809,7 +807,7 @@ void TheKnight::changeState(KnightState newState)
         case KnightState::DOWN_SLASHING:
         {
             // ŹЧ
-            SimpleAudioEngine::getInstance()->playEffect("Music/hero_sword.wav", false);
+            SoundBank::getInstance()->play("Music/hero_sword.wav");
             
             this->stopAllActions();
             auto animation = AnimationCache::getInstance()->getAnimation("downSlash");
@@ -829,7 +827,7 @@ void TheKnight::changeState(KnightState newState)
         case KnightState::GET_ATTACKED:
         {
             // ܻЧ
-            SimpleAudioEngine::getInstance()->playEffect("Music/hero_damage.wav", false);
+            SoundBank::getInstance()->play("Music/hero_damage.wav");
             
             this->stopAllActions();
             _knockbackTimer = 0.0f;
@@ -853,7 +851,7 @@ void TheKnight::changeState(KnightState newState)
         case KnightState::DEAD:
         {
             // Ч
-            SimpleAudioEngine::getInstance()->playEffect("Music/hero_death.wav", false);
+            SoundBank::getInstance()->play("Music/hero_death.wav");
             
             this->stopAllActions();
             // ü
@@ -914,7 +912,7 @@ void TheKnight::changeState(KnightState newState)
         case KnightState::CASTING_SPELL:
         {
             // ŷЧ
-            SimpleAudioEngine::getInstance()->playEffect("Music/hero_fireball.wav", false);
+            SoundBank::getInstance()->play("Music/hero_fireball.wav");
             
             this->stopAllActions();
             auto animation = AnimationCache::getInstance()->getAnimation("vengefulSpirit");
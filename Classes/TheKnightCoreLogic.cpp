@@ -5,9 +5,7 @@
 
 #include "TheKnight.h"
 #include "CharmManager.h"
-#include "audio/include/SimpleAudioEngine.h"
-
-using namespace CocosDenshion;
+#include "SoundBank.h"  // ޸ġЧ SoundBank
 
 TheKnight* TheKnight::create()
 {
@@ -173,11 +171,7 @@ bool TheKnight::init()
     // ųʼIdle
     playAnimation("idle", true);
     
-    // ע¼
-    auto keyboardListener = EventListenerKeyboard::create();
-    keyboardListener->onKeyPressed = CC_CALLBACK_2(TheKnight::onKeyPressed, this);
-    keyboardListener->onKeyReleased = CC_CALLBACK_2(TheKnight::onKeyReleased, this);
-    _eventDispatcher->addEventListenerWithSceneGraphPriority(keyboardListener, this);
+    // ޸ġٵע̼ InputManager ͳһɼ update ѯ processInput
     
     // update
     this->scheduleUpdate();
@@ -186,11 +180,7 @@ bool TheKnight::init()
     _runningSoundId = -1;  // ܲЧʼ
     _jumpSoundId = -1;     // ԾЧʼ
     
-    // ԤЧļ״βӳ٣
-    SimpleAudioEngine::getInstance()->preloadEffect("Music/hero_running.wav");
-    SimpleAudioEngine::getInstance()->preloadEffect("Music/hero_jump.wav");
-    SimpleAudioEngine::getInstance()->preloadEffect("Music/hero_land.wav");
-    SimpleAudioEngine::getInstance()->preloadEffect("Music/hero_dash.wav");
+    // ޸ġЧɳص SoundBank ͳһԤأ SoundGroup::KNIGHT
     
     return true;
 }
@@ -214,8 +204,19 @@ Rect TheKnight::getBoundingBox() const
                 size.height - shrinkY * 2);
 }
 
+// ƽ̨ײѯ
+int TheKnight::s_collisionQueries = 0;
+
+int TheKnight::takeCollisionQueryCount()
+{
+    int count = s_collisionQueries;
+    s_collisionQueries = 0;
+    return count;
+}
+
 bool TheKnight::checkGroundCollision(float& groundY)
 {
+    ++s_collisionQueries;
     Vec2 pos = this->getPosition();
     Rect knightRect = getBoundingBox();
     
@@ -251,6 +252,7 @@ bool TheKnight::checkGroundCollision(float& groundY)
 
 bool TheKnight::checkCeilingCollision(float& ceilingY)
 {
+    ++s_collisionQueries;
     Rect knightRect = getBoundingBox();
     
     // ƽ̨
@@ -290,6 +292,7 @@ bool TheKnight::checkCeilingCollision(float& ceilingY)
 
 bool TheKnight::checkWallCollision(float& newX, bool movingRight)
 {
+    ++s_collisionQueries;
     Rect knightRect = getBoundingBox();
     
     // ƽ̨
@@ -338,6 +341,7 @@ bool TheKnight::checkWallCollision(float& newX, bool movingRight)
 bool TheKnight::checkStillOnGround()
 {
     if (!_isOnGround) return false;
+    ++s_collisionQueries;
     
     Vec2 pos = this->getPosition();
     
@@ -365,6 +369,7 @@ bool TheKnight::checkStillOnGround()
 
 bool TheKnight::checkWallSlideCollision(bool checkRight)
 {
+    ++s_collisionQueries;
     Rect knightRect = getBoundingBox();
     Vec2 pos = this->getPosition();
     auto size = this->getContentSize();
@@ -413,18 +418,18 @@ bool TheKnight::checkWallSlideCollision(bool checkRight)
     return false;
 }
 
-void TheKnight::onKeyPressed(EventKeyboard::KeyCode keyCode, Event* event)
+void TheKnight::onActionPressed(InputAction action)
 {
     // 򿪣ýɫ
     if (CharmManager::getInstance()->isPanelOpen()) {
         return;
     }
     
-    // If sitting and not in map mode, any key except Tab should exit sitting
+    // If sitting and not in map mode, any action except Map should exit sitting
     if (_isSitting && _state != KnightState::SIT_MAP_OPEN && _state != KnightState::SIT_MAP_CLOSE)
     {
-        // Tab key for sit map
-        if (keyCode == EventKeyboard::KeyCode::KEY_TAB)
+        // Map key for sit map
+        if (action == InputAction::MAP)
         {
             _isMapKeyPressed = true;
             if (_state == KnightState::SIT_IDLE || _state == KnightState::SITTING_ASLEEP)
@@ -435,25 +440,16 @@ void TheKnight::onKeyPressed(EventKeyboard::KeyCode keyCode, Event* event)
         }
         
         // Other functional keys exit sitting
-        if (keyCode == EventKeyboard::KeyCode::KEY_A || 
-            keyCode == EventKeyboard::KeyCode::KEY_CAPITAL_A ||
-            keyCode == EventKeyboard::KeyCode::KEY_D || 
-            keyCode == EventKeyboard::KeyCode::KEY_CAPITAL_D ||
-            keyCode == EventKeyboard::KeyCode::KEY_W || 
-            keyCode == EventKeyboard::KeyCode::KEY_CAPITAL_W ||
-            keyCode == EventKeyboard::KeyCode::KEY_S || 
-            keyCode == EventKeyboard::KeyCode::KEY_CAPITAL_S ||
-            keyCode == EventKeyboard::KeyCode::KEY_K ||
-            keyCode == EventKeyboard::KeyCode::KEY_CAPITAL_K ||
-            keyCode == EventKeyboard::KeyCode::KEY_L ||
-            keyCode == EventKeyboard::KeyCode::KEY_CAPITAL_L ||
-            keyCode == EventKeyboard::KeyCode::KEY_J ||
-            keyCode == EventKeyboard::KeyCode::KEY_CAPITAL_J ||
-            keyCode == EventKeyboard::KeyCode::KEY_SPACE)
+        if (action == InputAction::LEFT ||
+            action == InputAction::RIGHT ||
+            action == InputAction::UP ||
+            action == InputAction::DOWN ||
+            action == InputAction::JUMP ||
+            action == InputAction::DASH ||
+            action == InputAction::ATTACK ||
+            action == InputAction::SPELL)
         {
-            _exitKey = keyCode;
-            bool pressedLeft = (keyCode == EventKeyboard::KeyCode::KEY_A || 
-                               keyCode == EventKeyboard::KeyCode::KEY_CAPITAL_A);
+            bool pressedLeft = (action == InputAction::LEFT);
             exitSitting(pressedLeft);
             
             // Reset sitting timer
@@ -462,9 +458,8 @@ void TheKnight::onKeyPressed(EventKeyboard::KeyCode keyCode, Event* event)
         }
     }
     
-    // ִ֧Сд W/w  - Ͽ
-    if (keyCode == EventKeyboard::KeyCode::KEY_W || 
-        keyCode == EventKeyboard::KeyCode::KEY_CAPITAL_W)
+    // Ͽ
+    if (action == InputAction::UP)
     {
         // ͼģʽ½
         if (_isMapMode) return;
@@ -476,9 +471,8 @@ void TheKnight::onKeyPressed(EventKeyboard::KeyCode keyCode, Event* event)
             changeState(KnightState::LOOKING_UP);
         }
     }
-    // ִ֧Сд S/s  - ¿
-    else if (keyCode == EventKeyboard::KeyCode::KEY_S || 
-             keyCode == EventKeyboard::KeyCode::KEY_CAPITAL_S)
+    // ¿
+    else if (action == InputAction::DOWN)
     {
         // ͼģʽ½
         if (_isMapMode) return;
@@ -490,9 +484,8 @@ void TheKnight::onKeyPressed(EventKeyboard::KeyCode keyCode, Event* event)
             changeState(KnightState::LOOKING_DOWN);
         }
     }
-    // ִ֧Сд A/a 
-    else if (keyCode == EventKeyboard::KeyCode::KEY_A || 
-        keyCode == EventKeyboard::KeyCode::KEY_CAPITAL_A)
+    // 
+    else if (action == InputAction::LEFT)
     {
         _isMovingLeft = true;
         
@@ -520,9 +513,8 @@ void TheKnight::onKeyPressed(EventKeyboard::KeyCode keyCode, Event* event)
             }
         }
     }
-    // ִ֧Сд D/d 
-    else if (keyCode == EventKeyboard::KeyCode::KEY_D || 
-             keyCode == EventKeyboard::KeyCode::KEY_CAPITAL_D)
+    // 
+    else if (action == InputAction::RIGHT)
     {
         _isMovingRight = true;
         
@@ -550,9 +542,8 @@ void TheKnight::onKeyPressed(EventKeyboard::KeyCode keyCode, Event* event)
             }
         }
     }
-    // ִ֧Сд K/k  - Ծ
-    else if (keyCode == EventKeyboard::KeyCode::KEY_K ||
-             keyCode == EventKeyboard::KeyCode::KEY_CAPITAL_K)
+    // Ծ
+    else if (action == InputAction::JUMP)
     {
         // ͼģʽ½
         if (_isMapMode) return;
@@ -578,9 +569,8 @@ void TheKnight::onKeyPressed(EventKeyboard::KeyCode keyCode, Event* event)
             startDoubleJump();
         }
     }
-    // ִ֧Сд L/l  - 
-    else if (keyCode == EventKeyboard::KeyCode::KEY_L ||
-             keyCode == EventKeyboard::KeyCode::KEY_CAPITAL_L)
+    // 
+    else if (action == InputAction::DASH)
     {
         // ͼģʽ½
         if (_isMapMode) return;
@@ -598,9 +588,8 @@ void TheKnight::onKeyPressed(EventKeyboard::KeyCode keyCode, Event* event)
             startDash();
         }
     }
-    // ִ֧Сд J/j  - 
-    else if (keyCode == EventKeyboard::KeyCode::KEY_J ||
-             keyCode == EventKeyboard::KeyCode::KEY_CAPITAL_J)
+    // 
+    else if (action == InputAction::ATTACK)
     {
         // ͼģʽ½
         if (_isMapMode) return;
@@ -631,8 +620,8 @@ void TheKnight::onKeyPressed(EventKeyboard::KeyCode keyCode, Event* event)
             }
         }
     }
-    // ո - /ظ
-    else if (keyCode == EventKeyboard::KeyCode::KEY_SPACE)
+    // /ظ
+    else if (action == InputAction::SPELL)
     {
         // ͼģʽ½
         if (_isMapMode) return;
@@ -641,8 +630,8 @@ void TheKnight::onKeyPressed(EventKeyboard::KeyCode keyCode, Event* event)
         _spaceKeyHoldTime = 0.0f;
         // ʱκζȴжǶ̰ǳ
     }
-    // Tab - ͼģʽ
-    else if (keyCode == EventKeyboard::KeyCode::KEY_TAB)
+    // ͼģʽ
+    else if (action == InputAction::MAP)
     {
         _isMapKeyPressed = true;
         // ֻڵҴھֹƶ״̬ʱܴ򿪵ͼ
@@ -655,16 +644,15 @@ void TheKnight::onKeyPressed(EventKeyboard::KeyCode keyCode, Event* event)
     }
 }
 
-void TheKnight::onKeyReleased(EventKeyboard::KeyCode keyCode, Event* event)
+void TheKnight::onActionReleased(InputAction action)
 {
     // 򿪣ýɫ
     if (CharmManager::getInstance()->isPanelOpen()) {
         return;
     }
     
-    // ִ֧Сд W/w  - Ͽͷ
-    if (keyCode == EventKeyboard::KeyCode::KEY_W || 
-        keyCode == EventKeyboard::KeyCode::KEY_CAPITAL_W)
+    // Ͽͷ
+    if (action == InputAction::UP)
     {
         _isLookingUp = false;
         
@@ -673,9 +661,8 @@ void TheKnight::onKeyReleased(EventKeyboard::KeyCode keyCode, Event* event)
             changeState(KnightState::LOOK_UP_END);
         }
     }
-    // ִ֧Сд S/s  - ¿ͷ
-    else if (keyCode == EventKeyboard::KeyCode::KEY_S || 
-             keyCode == EventKeyboard::KeyCode::KEY_CAPITAL_S)
+    // ¿ͷ
+    else if (action == InputAction::DOWN)
     {
         _isLookingDown = false;
         
@@ -684,9 +671,8 @@ void TheKnight::onKeyReleased(EventKeyboard::KeyCode keyCode, Event* event)
             changeState(KnightState::LOOK_DOWN_END);
         }
     }
-    // ִ֧Сд A/a 
-    else if (keyCode == EventKeyboard::KeyCode::KEY_A || 
-        keyCode == EventKeyboard::KeyCode::KEY_CAPITAL_A)
+    // 
+    else if (action == InputAction::LEFT)
     {
         _isMovingLeft = false;
         
@@ -714,9 +700,8 @@ void TheKnight::onKeyReleased(EventKeyboard::KeyCode keyCode, Event* event)
             }
         }
     }
-    // ִ֧Сд D/d 
-    else if (keyCode == EventKeyboard::KeyCode::KEY_D || 
-             keyCode == EventKeyboard::KeyCode::KEY_CAPITAL_D)
+    // 
+    else if (action == InputAction::RIGHT)
     {
         _isMovingRight = false;
         
@@ -744,16 +729,15 @@ void TheKnight::onKeyReleased(EventKeyboard::KeyCode keyCode, Event* event)
             }
         }
     }
-    // ִ֧Сд K/k  - Ծͷ
-    else if (keyCode == EventKeyboard::KeyCode::KEY_K ||
-             keyCode == EventKeyboard::KeyCode::KEY_CAPITAL_K)
+    // Ծͷ
+    else if (action == InputAction::JUMP)
     {
         _isJumpKeyPressed = false;
     }
-    // ոͷ
-    else if (keyCode == EventKeyboard::KeyCode::KEY_SPACE)
+    // ͷ
+    else if (action == InputAction::SPELL)
     {
-        // Focus״̬ɿոӦòFocusEnd
+        // Focus״̬ɿӦòFocusEnd
         if (_state == KnightState::FOCUSING || _state == KnightState::FOCUS_GET)
         {
             // Focusɺ_isSpaceKeyPressedǷ
@@ -783,8 +767,8 @@ void TheKnight::onKeyReleased(EventKeyboard::KeyCode keyCode, Event* event)
         }
         _isSpaceKeyPressed = false;
     }
-    // Tabͷ - رյͼ
-    else if (keyCode == EventKeyboard::KeyCode::KEY_TAB)
+    // ͼͷ - رյͼ
+    else if (action == InputAction::MAP)
     {
         _isMapKeyPressed = false;
         
@@ -802,8 +786,35 @@ void TheKnight::onKeyReleased(EventKeyboard::KeyCode keyCode, Event* event)
     }
 }
 
+// ѯ InputManager ֡Ķգ/ɿֱ𽻸ԭĴ߼
+void TheKnight::processInput()
+{
+    auto input = InputManager::getInstance();
+    const int count = static_cast<int>(InputAction::COUNT);
+
+    for (int i = 0; i < count; i++)
+    {
+        InputAction action = static_cast<InputAction>(i);
+        if (input->isPressed(action))
+        {
+            onActionPressed(action);
+        }
+    }
+    for (int i = 0; i < count; i++)
+    {
+        InputAction action = static_cast<InputAction>(i);
+        if (input->isReleased(action))
+        {
+            onActionReleased(action);
+        }
+    }
+}
+
 void TheKnight::update(float dt)
 {
+    // ȴ֡루¡״̬ҲҪӦ
+    processInput();
+
     // ԣÿ1λ
     static float debugTimer = 0.0f;
     debugTimer += dt;
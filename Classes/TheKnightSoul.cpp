@@ -4,9 +4,7 @@
  */
 
 #include "TheKnight.h"
-#include "audio/include/SimpleAudioEngine.h"
-
-using namespace CocosDenshion;
+#include "SoundBank.h"  // ޸ġЧ SoundBank
 
 void TheKnight::addSoul(int amount)
 {
@@ -184,7 +182,7 @@ void TheKnight::updateVengefulSpiritEffect(float dt)
                     effectRect.getMinX() < platform.rect.getMinX())
                 {
                     // ŷʧЧ
-                    SimpleAudioEngine::getInstance()->playEffect("Music/fireball_disappear.wav", false);
+                    SoundBank::getInstance()->play("Music/fireball_disappear.wav");
                     removeVengefulSpiritEffect();
                     return;
                 }
@@ -196,7 +194,7 @@ void TheKnight::updateVengefulSpiritEffect(float dt)
                     effectRect.getMaxX() > platform.rect.getMaxX())
                 {
                     // ŷʧЧ
-                    SimpleAudioEngine::getInstance()->playEffect("Music/fireball_disappear.wav", false);
+                    SoundBank::getInstance()->play("Music/fireball_disappear.wav");
                     removeVengefulSpiritEffect();
                     return;
                 }
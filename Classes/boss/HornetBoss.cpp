@@ -1,8 +1,6 @@
 #include "HornetBoss.h"
 #include "AudioSettings.h"
-#include "SimpleAudioEngine.h"
-
-using namespace CocosDenshion;
+#include "SoundBank.h"  // ޸ġЧ SoundBank
 
 USING_NS_CC;
 
@@ -333,7 +331,7 @@ void HornetBoss::playAttack1Animation(cocos2d::Vec2 targetPos) {
     this->runAction(sequence);
 
     // Ч
-    SimpleAudioEngine::getInstance()->playEffect("Music/1.wav", false);
+    SoundBank::getInstance()->play("Music/1.wav");
 }
 void HornetBoss::playAttack2Animation(cocos2d::Vec2 targetPos) {
     this->stopActionByTag(10);
@@ -421,7 +419,7 @@ void HornetBoss::playAttack2Animation(cocos2d::Vec2 targetPos) {
     this->runAction(sequence);
 
     // Ч
-    SimpleAudioEngine::getInstance()->playEffect("Music/2.wav", false);
+    SoundBank::getInstance()->play("Music/2.wav");
 }
 void HornetBoss::playAttack3Animation(cocos2d::Vec2 targetPos) {
     // 1. ׼׶Σֹͣɶ߼
@@ -504,7 +502,7 @@ void HornetBoss::playAttack3Animation(cocos2d::Vec2 targetPos) {
     this->runAction(fullSequence);
 
     // Ч
-    SimpleAudioEngine::getInstance()->playEffect("Music/3.wav", false);
+    SoundBank::getInstance()->play("Music/3.wav");
 }
 void HornetBoss::playAttack4Animation(cocos2d::Vec2 targetPos) {
     this->stopActionByTag(10);
@@ -577,7 +575,7 @@ void HornetBoss::playAttack4Animation(cocos2d::Vec2 targetPos) {
     this->runAction(fullSeq);
 
     // Ч
-    SimpleAudioEngine::getInstance()->playEffect("Music/4.wav", false);
+    SoundBank::getInstance()->play("Music/4.wav");
 }
 // ܻ 1Ӳֱ 2  (injured_0 - 1)
 void HornetBoss::playInjuredAction1() {
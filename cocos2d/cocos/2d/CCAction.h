@@ -178,10 +178,13 @@ protected:
     int     _tag;
     /** The action flag field. To categorize action into certain groups.*/
     unsigned int _flags;
+    /** Set while the ActionManager steps the action in its tween batch instead of calling step(). */
+    bool _batched;
 
 #if CC_ENABLE_SCRIPT_BINDING
     ccScriptType _scriptType;         ///< type of script binding, lua or javascript
 #endif
+    friend class ActionManager;
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Action);
 };
@@ -31,6 +31,7 @@ THE SOFTWARE.
 
 #include <functional>
 #include "2d/CCAction.h"
+#include "base/allocator/CCAllocatorTypePool.h"
 
 NS_CC_BEGIN
 
@@ -323,6 +324,7 @@ private:
 */
 class CC_DLL CallFunc : public ActionInstant
 {
+    CC_USE_TYPE_POOL(CallFunc)
 public:
     /** Creates the action with the callback of type std::function<void()>.
      This is the preferred way to create the callback.
@@ -35,6 +35,7 @@ THE SOFTWARE.
 #include "2d/CCAnimation.h"
 #include "base/CCProtocols.h"
 #include "base/CCVector.h"
+#include "base/allocator/CCAllocatorTypePool.h"
 
 NS_CC_BEGIN
 
@@ -120,6 +121,9 @@ protected:
     
 protected:
     bool sendUpdateEventToScript(float dt, Action *actionObject);
+
+    // steps the plain move/scale/fade/rotate actions in its tween batch
+    friend class ActionManager;
 };
 
 /** @class Sequence
@@ -127,6 +131,7 @@ protected:
  */
 class CC_DLL Sequence : public ActionInterval
 {
+    CC_USE_TYPE_POOL(Sequence)
 public:
     /** Helper constructor to create an array of sequenceable actions.
      *
@@ -286,6 +291,7 @@ private:
  */
 class CC_DLL RepeatForever : public ActionInterval
 {
+    CC_USE_TYPE_POOL(RepeatForever)
 public:
     /** Creates the action.
      *
@@ -510,6 +516,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(RotateTo);
+    friend class ActionManager;
 };
 
 /** @class RotateBy
@@ -576,6 +583,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(RotateBy);
+    friend class ActionManager;
 };
 
 /** @class MoveBy
@@ -632,6 +640,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(MoveBy);
+    friend class ActionManager;
 };
 
 /** @class MoveTo
@@ -1127,6 +1136,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ScaleTo);
+    friend class ActionManager;
 };
 
 /** @class ScaleBy
@@ -1266,6 +1276,7 @@ protected:
     friend class FadeIn;
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(FadeTo);
+    friend class ActionManager;
 };
 
 /** @class FadeIn
@@ -1440,6 +1451,7 @@ private:
 */
 class CC_DLL DelayTime : public ActionInterval
 {
+    CC_USE_TYPE_POOL(DelayTime)
 public:
     /** 
      * Creates the action.
@@ -1516,6 +1528,7 @@ class Texture2D;
  */
 class CC_DLL Animate : public ActionInterval
 {
+    CC_USE_TYPE_POOL(Animate)
 public:
     /** Creates the action with an Animation and will restore the original frame when the animation is over.
      *
@@ -28,8 +28,12 @@ THE SOFTWARE.
 ****************************************************************************/
 
 #include "2d/CCActionManager.h"
+
+#include <typeinfo>
+
 #include "2d/CCNode.h"
 #include "2d/CCAction.h"
+#include "2d/CCActionInterval.h"
 #include "base/CCScheduler.h"
 #include "base/ccMacros.h"
 #include "base/ccCArray.h"
@@ -47,13 +51,18 @@ typedef struct _hashElement
     Action              *currentAction;
     bool                currentActionSalvaged;
     bool                paused;
+    // actions of 'actions' that are stepped by the tween batch
+    int                 batchedCount;
     UT_hash_handle      hh;
 } tHashElement;
 
 ActionManager::ActionManager()
 : _targets(nullptr),
   _currentTarget(nullptr),
-  _currentTargetSalvaged(false)
+  _currentTargetSalvaged(false),
+  _tweenBatchingEnabled(true),
+  _steppingTweens(false),
+  _tweensDirty(false)
 {
 
 }
@@ -69,6 +78,10 @@ ActionManager::~ActionManager()
 
 void ActionManager::deleteHashElement(tHashElement *element)
 {
+    for (ssize_t i = 0; element->batchedCount > 0 && i < element->actions->num; ++i)
+    {
+        removeTween(static_cast<Action*>(element->actions->arr[i]), element);
+    }
     ccArrayFree(element->actions);
     HASH_DEL(_targets, element);
     element->target->release();
@@ -99,6 +112,7 @@ void ActionManager::removeActionAtIndex(ssize_t index, tHashElement *element)
         element->currentActionSalvaged = true;
     }
 
+    removeTween(action, element);
     ccArrayRemoveObjectAtIndex(element->actions, index, true);
 
     // update actionIndex in case we are in tick. looping over the actions
@@ -194,6 +208,11 @@ void ActionManager::addAction(Action *action, Node *target, bool paused)
      ccArrayAppendObject(element->actions, action);
  
      action->startWithTarget(target);
+
+     if (_tweenBatchingEnabled && ! _steppingTweens)
+     {
+         addTween(action, element);
+     }
 }
 
 // remove
@@ -226,6 +245,10 @@ void ActionManager::removeAllActionsFromTarget(Node *target)
             element->currentActionSalvaged = true;
         }
 
+        for (ssize_t i = 0; element->batchedCount > 0 && i < element->actions->num; ++i)
+        {
+            removeTween(static_cast<Action*>(element->actions->arr[i]), element);
+        }
         ccArrayRemoveAllObjects(element->actions);
         if (_currentTarget == element)
         {
@@ -444,14 +467,14 @@ void ActionManager::update(float dt)
         _currentTarget = elt;
         _currentTargetSalvaged = false;
 
-        if (! _currentTarget->paused)
+        if (! _currentTarget->paused && _currentTarget->actions->num > _currentTarget->batchedCount)
         {
             // The 'actions' MutableArray may change while inside this loop.
             for (_currentTarget->actionIndex = 0; _currentTarget->actionIndex < _currentTarget->actions->num;
                 _currentTarget->actionIndex++)
             {
                 _currentTarget->currentAction = static_cast<Action*>(_currentTarget->actions->arr[_currentTarget->actionIndex]);
-                if (_currentTarget->currentAction == nullptr)
+                if (_currentTarget->currentAction == nullptr || _currentTarget->currentAction->_batched)
                 {
                     continue;
                 }
@@ -499,6 +522,322 @@ void ActionManager::update(float dt)
 
     // issue #635
     _currentTarget = nullptr;
+
+    stepTweens(dt);
+}
+
+// tween batch
+
+bool ActionManager::addTween(Action *action, tHashElement *element)
+{
+    // only the exact types: subclasses may override update() or step()
+    const std::type_info& type = typeid(*action);
+    TweenKind kind;
+    if (type == typeid(MoveBy) || type == typeid(MoveTo))
+        kind = TweenKind::MOVE;
+    else if (type == typeid(ScaleTo) || type == typeid(ScaleBy))
+        kind = TweenKind::SCALE;
+    else if (type == typeid(FadeTo) || type == typeid(FadeIn) || type == typeid(FadeOut))
+        kind = TweenKind::FADE;
+    else if (type == typeid(RotateBy) || type == typeid(RotateTo))
+        kind = TweenKind::ROTATE;
+    else
+        return false;
+
+    // the same action object running on a second target
+    if (action->_batched)
+    {
+        return false;
+    }
+
+#if CC_ENABLE_SCRIPT_BINDING
+    // javascript receives every step through sendUpdateEventToScript()
+    if (action->_scriptType == kScriptTypeJavascript)
+    {
+        return false;
+    }
+#endif
+
+    auto interval = static_cast<ActionInterval*>(action);
+    TweenState state;
+    state.action = interval;
+    state.target = interval->_target;
+    state.element = element;
+    state.elapsed = interval->_elapsed;
+    state.duration = interval->_duration;
+    state.firstTick = interval->_firstTick;
+
+    TweenLocation location;
+    location.kind = kind;
+    switch (kind)
+    {
+        case TweenKind::MOVE:
+        {
+            auto move = static_cast<MoveBy*>(action);
+            MoveTween tween;
+            tween.state = state;
+            tween.start = move->_startPosition;
+            tween.previous = move->_previousPosition;
+            tween.delta = move->_positionDelta;
+            location.index = _moveTweens.size();
+            _moveTweens.push_back(tween);
+            break;
+        }
+        case TweenKind::SCALE:
+        {
+            auto scale = static_cast<ScaleTo*>(action);
+            ScaleTween tween;
+            tween.state = state;
+            tween.start.set(scale->_startScaleX, scale->_startScaleY, scale->_startScaleZ);
+            tween.delta.set(scale->_deltaX, scale->_deltaY, scale->_deltaZ);
+            location.index = _scaleTweens.size();
+            _scaleTweens.push_back(tween);
+            break;
+        }
+        case TweenKind::FADE:
+        {
+            auto fade = static_cast<FadeTo*>(action);
+            FadeTween tween;
+            tween.state = state;
+            tween.from = fade->_fromOpacity;
+            tween.delta = (float)(fade->_toOpacity - fade->_fromOpacity);
+            location.index = _fadeTweens.size();
+            _fadeTweens.push_back(tween);
+            break;
+        }
+        case TweenKind::ROTATE:
+        {
+            RotateTween tween;
+            tween.state = state;
+            if (type == typeid(RotateBy))
+            {
+                auto rotate = static_cast<RotateBy*>(action);
+                tween.start = rotate->_startAngle;
+                tween.delta = rotate->_deltaAngle;
+                tween.is3D = rotate->_is3D;
+            }
+            else
+            {
+                auto rotate = static_cast<RotateTo*>(action);
+                tween.start = rotate->_startAngle;
+                tween.delta = rotate->_diffAngle;
+                tween.is3D = rotate->_is3D;
+            }
+            location.index = _rotateTweens.size();
+            _rotateTweens.push_back(tween);
+            break;
+        }
+    }
+
+    _tweenLocations[action] = location;
+    action->_batched = true;
+    element->batchedCount++;
+    return true;
+}
+
+void ActionManager::removeTween(Action *action, tHashElement *element)
+{
+    if (action == nullptr || ! action->_batched)
+    {
+        return;
+    }
+
+    auto iter = _tweenLocations.find(action);
+    CCASSERT(iter != _tweenLocations.end(), "batched action without a tween");
+    if (iter != _tweenLocations.end())
+    {
+        // the slot is only marked here: the arrays may be being stepped
+        const TweenLocation& location = iter->second;
+        switch (location.kind)
+        {
+            case TweenKind::MOVE:   _moveTweens[location.index].state.action = nullptr; break;
+            case TweenKind::SCALE:  _scaleTweens[location.index].state.action = nullptr; break;
+            case TweenKind::FADE:   _fadeTweens[location.index].state.action = nullptr; break;
+            case TweenKind::ROTATE: _rotateTweens[location.index].state.action = nullptr; break;
+        }
+        _tweenLocations.erase(iter);
+        _tweensDirty = true;
+    }
+
+    action->_batched = false;
+    element->batchedCount--;
+}
+
+namespace
+{
+    template <typename T, typename Locations>
+    void compactTweenArray(std::vector<T>& tweens, Locations& locations)
+    {
+        for (size_t i = 0; i < tweens.size(); )
+        {
+            if (tweens[i].state.action != nullptr)
+            {
+                ++i;
+                continue;
+            }
+
+            if (i + 1 < tweens.size())
+            {
+                tweens[i] = tweens.back();
+                if (tweens[i].state.action != nullptr)
+                {
+                    locations[tweens[i].state.action].index = i;
+                }
+            }
+            tweens.pop_back();
+        }
+    }
+}
+
+void ActionManager::compactTweens()
+{
+    if (! _tweensDirty)
+    {
+        return;
+    }
+
+    compactTweenArray(_moveTweens, _tweenLocations);
+    compactTweenArray(_scaleTweens, _tweenLocations);
+    compactTweenArray(_fadeTweens, _tweenLocations);
+    compactTweenArray(_rotateTweens, _tweenLocations);
+    _tweensDirty = false;
+}
+
+float ActionManager::advanceTween(TweenState& state, float dt)
+{
+    // same timing as ActionInterval::step()
+    if (state.firstTick)
+    {
+        state.firstTick = false;
+        state.elapsed = MATH_EPSILON;
+    }
+    else
+    {
+        state.elapsed += dt;
+    }
+    return std::max(0.0f, std::min(1.0f, state.elapsed / state.duration));
+}
+
+void ActionManager::finishTween(const TweenState& state)
+{
+    // a setter may have removed the action while it was being applied
+    ActionInterval* action = state.action;
+    if (action == nullptr)
+    {
+        return;
+    }
+
+    action->_elapsed = state.elapsed;
+    action->_firstTick = state.firstTick;
+    action->_done = state.elapsed >= state.duration;
+    if (action->_done)
+    {
+        action->retain();
+        _finishedTweens.push_back(action);
+    }
+}
+
+void ActionManager::stepTweens(float dt)
+{
+    compactTweens();
+    if (_tweenLocations.empty())
+    {
+        return;
+    }
+
+    // no tween is added while the arrays are walked, so the references below stay valid
+    _steppingTweens = true;
+
+    for (size_t i = 0, count = _moveTweens.size(); i < count; ++i)
+    {
+        MoveTween& tween = _moveTweens[i];
+        if (tween.state.action == nullptr || tween.state.element->paused)
+            continue;
+
+        float t = advanceTween(tween.state, dt);
+#if CC_ENABLE_STACKABLE_ACTIONS
+        Vec3 currentPos = tween.state.target->getPosition3D();
+        tween.start += currentPos - tween.previous;
+        Vec3 newPos = tween.start + tween.delta * t;
+        tween.state.target->setPosition3D(newPos);
+        tween.previous = newPos;
+#else
+        tween.state.target->setPosition3D(tween.start + tween.delta * t);
+#endif // CC_ENABLE_STACKABLE_ACTIONS
+        finishTween(tween.state);
+    }
+
+    for (size_t i = 0, count = _scaleTweens.size(); i < count; ++i)
+    {
+        ScaleTween& tween = _scaleTweens[i];
+        if (tween.state.action == nullptr || tween.state.element->paused)
+            continue;
+
+        float t = advanceTween(tween.state, dt);
+        Node* target = tween.state.target;
+        target->setScaleX(tween.start.x + tween.delta.x * t);
+        target->setScaleY(tween.start.y + tween.delta.y * t);
+        target->setScaleZ(tween.start.z + tween.delta.z * t);
+        finishTween(tween.state);
+    }
+
+    for (size_t i = 0, count = _fadeTweens.size(); i < count; ++i)
+    {
+        FadeTween& tween = _fadeTweens[i];
+        if (tween.state.action == nullptr || tween.state.element->paused)
+            continue;
+
+        float t = advanceTween(tween.state, dt);
+        tween.state.target->setOpacity((GLubyte)(tween.from + tween.delta * t));
+        finishTween(tween.state);
+    }
+
+    for (size_t i = 0, count = _rotateTweens.size(); i < count; ++i)
+    {
+        RotateTween& tween = _rotateTweens[i];
+        if (tween.state.action == nullptr || tween.state.element->paused)
+            continue;
+
+        float t = advanceTween(tween.state, dt);
+        Node* target = tween.state.target;
+        if (tween.is3D)
+        {
+            target->setRotation3D(tween.start + tween.delta * t);
+        }
+        else
+        {
+#if CC_USE_PHYSICS
+            if (tween.start.x == tween.start.y && tween.delta.x == tween.delta.y)
+            {
+                target->setRotation(tween.start.x + tween.delta.x * t);
+            }
+            else
+            {
+                target->setRotationSkewX(tween.start.x + tween.delta.x * t);
+                target->setRotationSkewY(tween.start.y + tween.delta.y * t);
+            }
+#else
+            target->setRotationSkewX(tween.start.x + tween.delta.x * t);
+            target->setRotationSkewY(tween.start.y + tween.delta.y * t);
+#endif // CC_USE_PHYSICS
+        }
+        finishTween(tween.state);
+    }
+
+    _steppingTweens = false;
+
+    // same as the regular path: stop the finished actions, then remove them
+    for (size_t i = 0; i < _finishedTweens.size(); ++i)
+    {
+        Action* action = _finishedTweens[i];
+        if (action->_batched)
+        {
+            action->stop();
+            removeAction(action);
+        }
+        action->release();
+    }
+    _finishedTweens.clear();
 }
 
 NS_CC_END
@@ -30,6 +30,9 @@ THE SOFTWARE.
 #ifndef __ACTION_CCACTION_MANAGER_H__
 #define __ACTION_CCACTION_MANAGER_H__
 
+#include <vector>
+#include <unordered_map>
+
 #include "2d/CCAction.h"
 #include "base/CCVector.h"
 #include "base/CCRef.h"
@@ -37,6 +40,7 @@ THE SOFTWARE.
 NS_CC_BEGIN
 
 class Action;
+class ActionInterval;
 
 struct _hashElement;
 
@@ -198,7 +202,20 @@ public:
      * @param dt    In seconds.
      */
     virtual void update(float dt);
-    
+
+    /** Enables or disables the tween batch.
+     * MoveBy, MoveTo, ScaleTo, ScaleBy, FadeTo, FadeIn, FadeOut, RotateBy and RotateTo actions that are
+     * added while it is enabled are stepped from flat arrays, one tight loop per kind, instead of through
+     * their virtual step(). The actions stay the handles: they can be queried, stopped and removed as usual.
+     * Subclasses of these actions, composite actions and everything else use the regular path.
+     * Enabled by default. Disabling only affects actions added afterwards.
+     */
+    void setTweenBatchingEnabled(bool enabled) { _tweenBatchingEnabled = enabled; }
+    bool isTweenBatchingEnabled() const { return _tweenBatchingEnabled; }
+
+    /** Returns the number of actions currently stepped by the tween batch. */
+    ssize_t getNumberOfBatchedTweens() const { return (ssize_t)_tweenLocations.size(); }
+
 protected:
     // declared in ActionManager.m
 
@@ -206,10 +223,84 @@ protected:
     void deleteHashElement(struct _hashElement *element);
     void actionAllocWithHashElement(struct _hashElement *element);
 
+    enum class TweenKind
+    {
+        MOVE,
+        SCALE,
+        FADE,
+        ROTATE,
+    };
+
+    // timing shared by every kind, mirrored back into the action after each step
+    struct TweenState
+    {
+        ActionInterval* action;
+        Node* target;
+        struct _hashElement* element;
+        float elapsed;
+        float duration;
+        bool firstTick;
+    };
+
+    struct MoveTween
+    {
+        TweenState state;
+        Vec3 start;
+        Vec3 previous;
+        Vec3 delta;
+    };
+
+    struct ScaleTween
+    {
+        TweenState state;
+        Vec3 start;
+        Vec3 delta;
+    };
+
+    struct FadeTween
+    {
+        TweenState state;
+        float from;
+        float delta;
+    };
+
+    struct RotateTween
+    {
+        TweenState state;
+        Vec3 start;
+        Vec3 delta;
+        bool is3D;
+    };
+
+    struct TweenLocation
+    {
+        TweenKind kind;
+        size_t index;
+    };
+
+    bool addTween(Action* action, struct _hashElement* element);
+    void removeTween(Action* action, struct _hashElement* element);
+    void compactTweens();
+    void finishTween(const TweenState& state);
+    void stepTweens(float dt);
+
+    static float advanceTween(TweenState& state, float dt);
+
 protected:
     struct _hashElement    *_targets;
     struct _hashElement    *_currentTarget;
     bool            _currentTargetSalvaged;
+
+    bool _tweenBatchingEnabled;
+    bool _steppingTweens;
+    bool _tweensDirty;
+    std::vector<MoveTween> _moveTweens;
+    std::vector<ScaleTween> _scaleTweens;
+    std::vector<FadeTween> _fadeTweens;
+    std::vector<RotateTween> _rotateTweens;
+    std::unordered_map<Action*, TweenLocation> _tweenLocations;
+    // retained until they are stopped and removed after the batch has been stepped
+    std::vector<Action*> _finishedTweens;
 };
 
 // end of actions group
@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "base/CCValue.h"
 #include "base/CCVector.h"
 #include "2d/CCSpriteFrame.h"
+#include "base/allocator/CCAllocatorTypePool.h"
 
 #include <string>
 
@@ -57,6 +58,7 @@ class SpriteFrame;
  */
 class CC_DLL AnimationFrame : public Ref, public Clonable
 {
+    CC_USE_TYPE_POOL(AnimationFrame)
 public:
     /** @struct DisplayedEventInfo
      * When the animation display,Dispatches the event of UserData.
@@ -166,6 +168,7 @@ private:
 */
 class CC_DLL Animation : public Ref, public Clonable
 {
+    CC_USE_TYPE_POOL(Animation)
 public:
     /** Creates an animation.
      * @since v0.99.5
@@ -170,6 +170,8 @@ void TMXTiledMap::buildWithMapInfo(TMXMapInfo* mapInfo)
 
     _tileProperties = mapInfo->getTileProperties();
 
+    _tilesets = mapInfo->getTilesets();
+
     int idx=0;
 
     auto& layers = mapInfo->getLayers();
@@ -249,6 +251,16 @@ Value TMXTiledMap::getPropertiesForGID(int GID) const
     auto propsItr = _tileProperties.find(GID);
     if (propsItr != _tileProperties.end())
         return propsItr->second;
+
+    // external tilesets keep their properties in the shared source
+    for (auto it = _tilesets.rbegin(); it != _tilesets.rend(); ++it)
+    {
+        if ((*it)->_firstGid <= GID)
+        {
+            const ValueMap* properties = (*it)->getTileProperties(GID);
+            return properties ? Value(*properties) : Value();
+        }
+    }
     
     return Value();
 }
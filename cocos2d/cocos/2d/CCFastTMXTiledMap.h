@@ -239,6 +239,8 @@ protected:
     
     //! tile properties
     ValueMapIntKey _tileProperties;
+    //! tilesets, the properties of external tilesets are looked up in their shared source
+    Vector<TMXTilesetInfo*> _tilesets;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(TMXTiledMap);
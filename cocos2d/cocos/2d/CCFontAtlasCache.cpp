@@ -25,19 +25,72 @@
  ****************************************************************************/
 #include "2d/CCFontAtlasCache.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "base/CCDirector.h"
+#include "base/ccUtils.h"
 #include "2d/CCFontFNT.h"
 #include "2d/CCFontFreeType.h"
 #include "2d/CCFontAtlas.h"
 #include "2d/CCFontCharMap.h"
 #include "2d/CCLabel.h"
 #include "platform/CCFileUtils.h"
+#include "platform/CCImage.h"
 
 NS_CC_BEGIN
 
 std::unordered_map<std::string, FontAtlas *> FontAtlasCache::_atlasMap;
+std::unordered_map<std::string, std::string> FontAtlasCache::_bakedFontMap;
 #define ATLAS_MAP_KEY_PREFIX_BUFFER_SIZE 255
 
+namespace
+{
+    struct BakedGlyph
+    {
+        char32_t code;
+        int width;
+        int height;
+        int offsetX;
+        int offsetY;
+        int xAdvance;
+        int x;
+        int y;
+        std::vector<unsigned char> distance;
+    };
+
+    const int BakedGlyphSpacing = 2;
+    const float BakedFontMinSize = 16.0f;
+
+    // Shelf packing; the glyphs are expected tallest first. Returns the used height, or -1 if the page is too small.
+    int packBakedGlyphs(const std::vector<BakedGlyph*>& glyphs, int pageSize)
+    {
+        int x = BakedGlyphSpacing;
+        int y = BakedGlyphSpacing;
+        int shelfHeight = 0;
+        for (auto glyph : glyphs)
+        {
+            if (glyph->width == 0)
+                continue;
+
+            if (x + glyph->width + BakedGlyphSpacing > pageSize)
+            {
+                x = BakedGlyphSpacing;
+                y += shelfHeight + BakedGlyphSpacing;
+                shelfHeight = 0;
+            }
+            if (x + glyph->width + BakedGlyphSpacing > pageSize || y + glyph->height + BakedGlyphSpacing > pageSize)
+                return -1;
+
+            glyph->x = x;
+            glyph->y = y;
+            x += glyph->width + BakedGlyphSpacing;
+            shelfHeight = std::max(shelfHeight, glyph->height);
+        }
+        return y + shelfHeight + BakedGlyphSpacing;
+    }
+}
+
 void FontAtlasCache::purgeCachedData()
 {
     auto atlasMapCopy = _atlasMap;
@@ -261,4 +314,182 @@ void FontAtlasCache::unloadFontAtlasTTF(const std::string& fontFileName)
     }
 }
 
+bool FontAtlasCache::registerBakedFontAtlas(const std::string& fontFileName, const std::string& bakedFntFile)
+{
+    auto fileUtils = FileUtils::getInstance();
+    if (!fileUtils->isFileExist(bakedFntFile))
+        return false;
+
+    _bakedFontMap[fileUtils->getNewFilename(fontFileName)] = bakedFntFile;
+    return true;
+}
+
+void FontAtlasCache::unregisterBakedFontAtlas(const std::string& fontFileName)
+{
+    _bakedFontMap.erase(FileUtils::getInstance()->getNewFilename(fontFileName));
+}
+
+FontAtlas* FontAtlasCache::getBakedFontAtlas(const std::string& fontFileName)
+{
+    if (_bakedFontMap.empty())
+        return nullptr;
+
+    auto it = _bakedFontMap.find(FileUtils::getInstance()->getNewFilename(fontFileName));
+    if (it == _bakedFontMap.end())
+        return nullptr;
+
+    return getFontAtlasFNT(it->second);
+}
+
+bool FontAtlasCache::bakeDistanceFieldFont(const std::string& fontFileName, const std::u32string& glyphs,
+                                           float fontSize, const std::string& outputFntFile, int pageSize /* = 2048 */)
+{
+    auto fileUtils = FileUtils::getInstance();
+    auto realFontFilename = fileUtils->getNewFilename(fontFileName);
+
+    // FontFNT ignores ids above 65535, control characters are handled by the label itself
+    std::u32string codes;
+    for (auto code : glyphs)
+    {
+        if (code >= 0x20 && code <= 0xffff)
+            codes.push_back(code);
+    }
+    std::sort(codes.begin(), codes.end());
+    codes.erase(std::unique(codes.begin(), codes.end()), codes.end());
+    if (codes.empty())
+        return false;
+
+    const int spread = FontFreeType::DistanceMapSpread;
+    std::vector<BakedGlyph> baked;
+    std::vector<unsigned char> scratch;
+    std::string fontFamily;
+    int lineHeight = 0;
+    int ascender = 0;
+    int pageHeight = 0;
+    int pixelSize = 0;
+
+    for (float size = fontSize; pageHeight == 0; size = std::floor(size * 0.9f))
+    {
+        if (size < BakedFontMinSize)
+        {
+            CCLOG("cocos2d: %d glyphs of %s don't fit in a %dx%d page", (int)codes.size(), fontFileName.c_str(), pageSize, pageSize);
+            return false;
+        }
+
+        auto font = FontFreeType::create(realFontFilename, size, GlyphCollection::DYNAMIC, nullptr, true);
+        if (font == nullptr)
+        {
+            CCLOG("cocos2d: can't open %s to bake it", fontFileName.c_str());
+            return false;
+        }
+        fontFamily = font->getFontFamily() ? font->getFontFamily() : "";
+        lineHeight = font->getFontMaxHeight();
+        ascender = font->getFontAscender();
+        pixelSize = (int)(size * CC_CONTENT_SCALE_FACTOR());
+
+        baked.clear();
+        baked.reserve(codes.size());
+        for (auto code : codes)
+        {
+            long bitmapWidth = 0;
+            long bitmapHeight = 0;
+            Rect rect;
+            BakedGlyph glyph = { code, 0, 0, 0, 0, 0, 0, 0, {} };
+            auto bitmap = font->getGlyphBitmap(code, bitmapWidth, bitmapHeight, rect, glyph.xAdvance);
+            if (bitmap == nullptr && glyph.xAdvance == 0)
+                continue;
+
+            if (bitmap && bitmapWidth > 0 && bitmapHeight > 0)
+            {
+                glyph.width = (int)bitmapWidth + 2 * spread;
+                glyph.height = (int)bitmapHeight + 2 * spread;
+                if (glyph.width > FontAtlas::CacheTextureWidth)
+                    continue;
+                glyph.offsetX = (int)rect.origin.x - spread;
+                glyph.offsetY = ascender + (int)rect.origin.y - spread;
+
+                // renderCharAt() writes rows with the stride of a runtime atlas page
+                scratch.assign(FontAtlas::CacheTextureWidth * glyph.height, 0);
+                font->renderCharAt(scratch.data(), 0, 0, bitmap, bitmapWidth, bitmapHeight);
+                glyph.distance.resize(glyph.width * glyph.height);
+                for (int row = 0; row < glyph.height; ++row)
+                {
+                    memcpy(&glyph.distance[row * glyph.width], &scratch[row * FontAtlas::CacheTextureWidth], glyph.width);
+                }
+            }
+            baked.push_back(std::move(glyph));
+        }
+
+        std::vector<BakedGlyph*> order;
+        order.reserve(baked.size());
+        for (auto& glyph : baked)
+            order.push_back(&glyph);
+        std::stable_sort(order.begin(), order.end(), [](const BakedGlyph* a, const BakedGlyph* b) {
+            return a->height > b->height;
+        });
+
+        auto usedHeight = packBakedGlyphs(order, pageSize);
+        if (usedHeight > 0)
+            pageHeight = std::min(ccNextPOT(usedHeight), pageSize);
+    }
+
+    // white glyphs, the distance is kept in the alpha channel sampled by the distance field shaders
+    std::vector<unsigned char> page(pageSize * pageHeight * 4, 0);
+    for (size_t i = 0; i < page.size(); i += 4)
+    {
+        page[i] = page[i + 1] = page[i + 2] = 255;
+    }
+    for (auto& glyph : baked)
+    {
+        for (int row = 0; row < glyph.height; ++row)
+        {
+            auto dst = &page[((glyph.y + row) * pageSize + glyph.x) * 4 + 3];
+            auto src = &glyph.distance[row * glyph.width];
+            for (int column = 0; column < glyph.width; ++column)
+            {
+                dst[column * 4] = src[column];
+            }
+        }
+    }
+
+    auto extension = outputFntFile.find_last_of('.');
+    auto pageFile = outputFntFile.substr(0, extension) + ".png";
+    auto pageName = pageFile.substr(pageFile.find_last_of("/\\") + 1);
+
+    Image image;
+    if (!image.initWithRawData(page.data(), page.size(), pageSize, pageHeight, 8, false) || !image.saveToFile(pageFile, false))
+    {
+        CCLOG("cocos2d: can't write %s", pageFile.c_str());
+        return false;
+    }
+
+    char line[256];
+    std::string fnt;
+    snprintf(line, sizeof(line), "info face=\"%s\" size=%d bold=0 italic=0 charset=\"\" unicode=1 stretchH=100 smooth=1 aa=1 padding=0,0,0,0 spacing=%d,%d\n",
+             fontFamily.c_str(), pixelSize, BakedGlyphSpacing, BakedGlyphSpacing);
+    fnt += line;
+    snprintf(line, sizeof(line), "common lineHeight=%d base=%d scaleW=%d scaleH=%d pages=1 packed=0\n", lineHeight, ascender, pageSize, pageHeight);
+    fnt += line;
+    snprintf(line, sizeof(line), "page id=0 file=\"%s\"\n", pageName.c_str());
+    fnt += line;
+    snprintf(line, sizeof(line), "chars count=%d\n", (int)baked.size());
+    fnt += line;
+    for (auto& glyph : baked)
+    {
+        snprintf(line, sizeof(line), "char id=%u x=%d y=%d width=%d height=%d xoffset=%d yoffset=%d xadvance=%d page=0 chnl=15\n",
+                 (unsigned int)glyph.code, glyph.x, glyph.y, glyph.width, glyph.height, glyph.offsetX, glyph.offsetY, glyph.xAdvance);
+        fnt += line;
+    }
+
+    if (!fileUtils->writeStringToFile(fnt, outputFntFile))
+    {
+        CCLOG("cocos2d: can't write %s", outputFntFile.c_str());
+        return false;
+    }
+
+    CCLOG("cocos2d: baked %d glyphs of %s at %d px into %s (%dx%d)", (int)baked.size(), fontFileName.c_str(),
+          pixelSize, outputFntFile.c_str(), pageSize, pageHeight);
+    return true;
+}
+
 NS_CC_END
@@ -29,6 +29,7 @@
 
 /// @cond DO_NOT_SHOW
 
+#include <string>
 #include <unordered_map>
 #include "base/ccTypes.h"
 
@@ -67,8 +68,32 @@ public:
     */
     static void unloadFontAtlasTTF(const std::string& fontFileName);
 
+    /** Registers a distance field atlas baked offline for a TTF/OTF font.
+     Labels created with this font and no outline then share the baked atlas for every font size,
+     scaling it instead of rasterizing glyphs at runtime. Text using a glyph missing from the
+     baked atlas falls back to the runtime atlas.
+     @param fontFileName The TTF/OTF file the labels are created with.
+     @param bakedFntFile The BMFont file written by bakeDistanceFieldFont().
+     @return false if the baked file does not exist.
+     */
+    static bool registerBakedFontAtlas(const std::string& fontFileName, const std::string& bakedFntFile);
+    static void unregisterBakedFontAtlas(const std::string& fontFileName);
+
+    /** Returns the baked atlas registered for a font, or nullptr. */
+    static FontAtlas* getBakedFontAtlas(const std::string& fontFileName);
+
+    /** Bakes the distance field of a set of glyphs into a BMFont file and a single PNG page.
+     The glyphs are rendered at fontSize pixels; the size is lowered until all of them fit in
+     a page of pageSize x pageSize. Only FreeType and the file system are used, so this can run
+     before the director has a GL view.
+     */
+    static bool bakeDistanceFieldFont(const std::string& fontFileName, const std::u32string& glyphs,
+                                      float fontSize, const std::string& outputFntFile, int pageSize = 2048);
+
 private:
     static std::unordered_map<std::string, FontAtlas *> _atlasMap;
+    // real TTF/OTF path -> baked BMFont file
+    static std::unordered_map<std::string, std::string> _bakedFontMap;
 };
 
 NS_CC_END
@@ -0,0 +1,178 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "2d/CCFrameStatsOverlay.h"
+
+#include "2d/CCDrawNode.h"
+#include "2d/CCLabel.h"
+#include "base/CCDirector.h"
+#include "base/ccUtils.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    const float kBarSpacing = 2.0f;
+    const float kGraphHeight = 36.0f;
+    const float kRowSpacing = 4.0f;
+    const float kPadding = 6.0f;
+    const float kFontSize = 12.0f;
+    const float kCounterLineHeight = 15.0f;
+
+    const Color4F kPhaseColors[(int)FrameStats::Phase::COUNT] = {
+        Color4F(0.35f, 0.85f, 0.35f, 1.0f),  // update
+        Color4F(0.35f, 0.65f, 1.0f, 1.0f),   // visit
+        Color4F(1.0f, 0.65f, 0.25f, 1.0f),   // render
+        Color4F(0.8f, 0.45f, 1.0f, 1.0f),    // gpu wait
+    };
+}
+
+FrameStatsOverlay* FrameStatsOverlay::create()
+{
+    FrameStatsOverlay* ret = new (std::nothrow) FrameStatsOverlay();
+    if (ret && ret->init())
+    {
+        ret->autorelease();
+        return ret;
+    }
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+}
+
+FrameStatsOverlay::FrameStatsOverlay()
+: _graphs(nullptr)
+, _counterLabel(nullptr)
+, _graphRange(1.0f / 30)
+, _accumDt(CC_DIRECTOR_STATS_INTERVAL)
+{
+    memset(_phaseLabels, 0, sizeof(_phaseLabels));
+}
+
+FrameStatsOverlay::~FrameStatsOverlay()
+{
+}
+
+bool FrameStatsOverlay::init()
+{
+    if (!Node::init())
+        return false;
+
+    _graphs = DrawNode::create();
+    addChild(_graphs);
+
+    for (int i = 0; i < (int)FrameStats::Phase::COUNT; ++i)
+    {
+        _phaseLabels[i] = Label::createWithSystemFont("", "Arial", kFontSize);
+        _phaseLabels[i]->setAnchorPoint(Vec2(0, 1));
+        _phaseLabels[i]->setTextColor(Color4B(kPhaseColors[i]));
+        addChild(_phaseLabels[i]);
+    }
+
+    _counterLabel = Label::createWithSystemFont("", "Arial", kFontSize);
+    _counterLabel->setAnchorPoint(Vec2(0, 1));
+    addChild(_counterLabel);
+
+    return true;
+}
+
+void FrameStatsOverlay::refresh(float dt)
+{
+    auto director = Director::getInstance();
+    Vec2 origin = director->getVisibleOrigin();
+    Size visibleSize = director->getVisibleSize();
+    // the node is laid out downwards from its position, the top-left corner of the screen
+    setPosition(origin.x, origin.y + visibleSize.height);
+
+    drawGraphs();
+
+    _accumDt += dt;
+    if (_accumDt >= CC_DIRECTOR_STATS_INTERVAL)
+    {
+        _accumDt = 0;
+        updateText();
+    }
+}
+
+void FrameStatsOverlay::drawGraphs()
+{
+    auto stats = FrameStats::getInstance();
+    const int phaseCount = (int)FrameStats::Phase::COUNT;
+    const float graphWidth = FrameStats::HISTORY_SIZE * kBarSpacing;
+    const float graphsHeight = phaseCount * (kGraphHeight + kRowSpacing);
+    const float counterHeight = stats->getCounterCount() * kCounterLineHeight;
+    const float budget = 1.0f / 60;
+
+    _graphs->clear();
+    _graphs->drawSolidRect(Vec2(0, -(graphsHeight + counterHeight + kPadding * 2)),
+                           Vec2(graphWidth + kPadding * 2, 0),
+                           Color4F(0, 0, 0, 0.6f));
+
+    for (int p = 0; p < phaseCount; ++p)
+    {
+        auto phase = (FrameStats::Phase)p;
+        float baseY = -kPadding - (p + 1) * (kGraphHeight + kRowSpacing) + kRowSpacing;
+        float left = kPadding;
+
+        for (int i = 0; i < stats->getHistoryCount(); ++i)
+        {
+            float height = std::min(stats->getPhaseTime(phase, i) / _graphRange, 1.0f) * kGraphHeight;
+            if (height <= 0)
+                continue;
+            float x = left + (FrameStats::HISTORY_SIZE - 1 - i) * kBarSpacing;
+            _graphs->drawLine(Vec2(x, baseY), Vec2(x, baseY + height), kPhaseColors[p]);
+        }
+
+        float budgetY = baseY + std::min(budget / _graphRange, 1.0f) * kGraphHeight;
+        _graphs->drawLine(Vec2(left, budgetY), Vec2(left + graphWidth, budgetY), Color4F(1, 1, 1, 0.35f));
+
+        _phaseLabels[p]->setPosition(left + 2, baseY + kGraphHeight);
+    }
+
+    _counterLabel->setPosition(kPadding, -kPadding - graphsHeight);
+}
+
+void FrameStatsOverlay::updateText()
+{
+    auto stats = FrameStats::getInstance();
+    char buffer[64];
+
+    for (int p = 0; p < (int)FrameStats::Phase::COUNT; ++p)
+    {
+        auto phase = (FrameStats::Phase)p;
+        snprintf(buffer, sizeof(buffer), "%s %.2f ms (max %.2f)", FrameStats::getPhaseName(phase),
+                 stats->getPhaseAverage(phase) * 1000, stats->getPhaseMax(phase) * 1000);
+        _phaseLabels[p]->setString(buffer);
+    }
+
+    std::string text;
+    for (int i = 0; i < stats->getCounterCount(); ++i)
+    {
+        snprintf(buffer, sizeof(buffer), "%s: %lld\n", stats->getCounterName(i).c_str(), stats->getCounter(i));
+        text += buffer;
+    }
+    if (!text.empty())
+        text.pop_back();
+    _counterLabel->setString(text);
+}
+
+NS_CC_END
@@ -0,0 +1,87 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef __CCFRAME_STATS_OVERLAY_H__
+#define __CCFRAME_STATS_OVERLAY_H__
+
+#include "2d/CCNode.h"
+#include "base/CCFrameStats.h"
+
+NS_CC_BEGIN
+
+class DrawNode;
+class Label;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @class FrameStatsOverlay
+ * @brief Draws the FrameStats history and counters in the top-left corner of the screen.
+
+ Every phase gets a bar graph of its last FrameStats::HISTORY_SIZE frames, newest on the right,
+ with a line at the 60 FPS budget. The phase averages and the counters are printed as text,
+ refreshed every CC_DIRECTOR_STATS_INTERVAL seconds so the labels do not re-render every frame.
+
+ Director owns the overlay and draws it on top of the scene while Director::setDisplayFrameStats()
+ is enabled; it is not added to any scene.
+ */
+class CC_DLL FrameStatsOverlay : public Node
+{
+public:
+    static FrameStatsOverlay* create();
+
+    /** Redraws the graphs and, when the refresh interval has elapsed, the text. */
+    void refresh(float dt);
+
+    /** Frame time, in seconds, at the top of the graphs. Defaults to 1/30. */
+    void setGraphRange(float seconds) { _graphRange = seconds; }
+    float getGraphRange() const { return _graphRange; }
+
+CC_CONSTRUCTOR_ACCESS:
+    FrameStatsOverlay();
+    virtual ~FrameStatsOverlay();
+
+    virtual bool init() override;
+
+protected:
+    void drawGraphs();
+    void updateText();
+
+    DrawNode* _graphs;
+    Label* _phaseLabels[(int)FrameStats::Phase::COUNT];
+    Label* _counterLabel;
+    float _graphRange;
+    float _accumDt;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(FrameStatsOverlay);
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif // __CCFRAME_STATS_OVERLAY_H__
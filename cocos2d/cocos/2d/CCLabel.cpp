@@ -518,6 +518,8 @@ void Label::reset()
 
     _useDistanceField = false;
     _useA8Shader = false;
+    _useBakedAtlas = false;
+    _bakedAtlasMissed = false;
     _clipEnabled = false;
     _blendFuncDirty = false;
     _blendFunc = BlendFunc::ALPHA_PREMULTIPLIED;
@@ -818,6 +820,21 @@ bool Label::alignText()
         return true;
     }
 
+    if (_currentLabelType == LabelType::TTF && _useBakedAtlas && !isTextInBakedAtlas())
+    {
+        auto labelEffect = _currLabelEffect;
+        _bakedAtlasMissed = true;
+        if (!setTTFConfigInternal(_fontConfig))
+        {
+            return true;
+        }
+        if (labelEffect == LabelEffect::GLOW && _useDistanceField)
+        {
+            _currLabelEffect = labelEffect;
+            updateShaderProgram();
+        }
+    }
+
     bool ret = true;
     do {
         _fontAtlas->prepareLetterDefinitions(_utf32Text);
@@ -990,7 +1007,17 @@ bool Label::updateQuads()
 
 bool Label::setTTFConfigInternal(const TTFConfig& ttfConfig)
 {
-    FontAtlas *newAtlas = FontAtlasCache::getFontAtlasTTF(&ttfConfig);
+    // a baked atlas serves every font size; outlines still need the runtime rasterizer
+    FontAtlas *newAtlas = nullptr;
+    if (ttfConfig.outlineSize <= 0 && !_bakedAtlasMissed)
+    {
+        newAtlas = FontAtlasCache::getBakedFontAtlas(ttfConfig.fontFilePath);
+    }
+    bool useBakedAtlas = newAtlas != nullptr;
+    if (!useBakedAtlas)
+    {
+        newAtlas = FontAtlasCache::getFontAtlasTTF(&ttfConfig);
+    }
 
     if (!newAtlas)
     {
@@ -999,9 +1026,14 @@ bool Label::setTTFConfigInternal(const TTFConfig& ttfConfig)
     }
 
     _currentLabelType = LabelType::TTF;
-    setFontAtlas(newAtlas,ttfConfig.distanceFieldEnabled,true);
+    _useBakedAtlas = useBakedAtlas;
+    setFontAtlas(newAtlas, ttfConfig.distanceFieldEnabled || useBakedAtlas, true);
 
     _fontConfig = ttfConfig;
+    if (_useBakedAtlas)
+    {
+        _useDistanceField = true;
+    }
 
     if (_fontConfig.outlineSize > 0)
     {
@@ -2219,7 +2251,7 @@ Label::Overflow Label::getOverflow()const
 
 void Label::updateLetterSpriteScale(Sprite* sprite)
 {
-    if (_currentLabelType == LabelType::BMFONT && _bmFontSize > 0)
+    if ((_currentLabelType == LabelType::BMFONT && _bmFontSize > 0) || (_currentLabelType == LabelType::TTF && _useBakedAtlas))
     {
         sprite->setScale(_bmfontScale);
     }
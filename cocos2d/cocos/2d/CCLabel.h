@@ -680,6 +680,7 @@ protected:
 
     virtual void updateShaderProgram();
     void updateBMFontScale();
+    bool isTextInBakedAtlas() const;
     void scaleFontSizeDown(float fontSize);
     bool setTTFConfigInternal(const TTFConfig& ttfConfig);
     void setBMFontSizeInternal(float fontSize);
@@ -753,6 +754,10 @@ protected:
     GLint _uniformTextColor;
     bool _useDistanceField;
     bool _useA8Shader;
+    // TTF label drawn from an atlas baked offline, scaled like a BMFont
+    bool _useBakedAtlas;
+    // the text needed a glyph the baked atlas doesn't have; stay on the runtime atlas
+    bool _bakedAtlasMissed;
 
     bool _shadowDirty;
     bool _shadowEnabled;
@@ -142,11 +142,26 @@ void Label::updateBMFontScale()
         FontFNT *bmFont = (FontFNT*)font;
         float originalFontSize = bmFont->getOriginalFontSize();
         _bmfontScale = _bmFontSize * CC_CONTENT_SCALE_FACTOR() / originalFontSize;
+    }else if (_currentLabelType == LabelType::TTF && _useBakedAtlas) {
+        FontFNT *bakedFont = (FontFNT*)font;
+        _bmfontScale = _fontConfig.fontSize * CC_CONTENT_SCALE_FACTOR() / bakedFont->getOriginalFontSize();
     }else{
         _bmfontScale = 1.0f;
     }
 }
 
+bool Label::isTextInBakedAtlas() const
+{
+    FontLetterDefinition letterDef;
+    for (auto character : _utf32Text)
+    {
+        // control characters are laid out by the label, they have no glyph
+        if (character >= 0x20 && !_fontAtlas->getLetterDefinitionForChar(character, letterDef))
+            return false;
+    }
+    return true;
+}
+
 bool Label::multilineTextWrap(const std::function<int(const std::u32string&, int, int)>& nextTokenLen)
 {
     int textLen = getStringLength();
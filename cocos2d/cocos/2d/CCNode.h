@@ -2034,6 +2034,9 @@ public:
     friend class PhysicsBody;
 #endif
 
+    // reads the local z order and order of arrival to keep its listener ordering index
+    friend class EventDispatcher;
+
     static int __attachedNodeCount;
     
 private:
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "2d/CCCamera.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventListenerCustom.h"
+#include "base/CCFrameStats.h"
 #include "base/ccUTF8.h"
 #include "renderer/CCRenderer.h"
 #include "renderer/CCFrameBuffer.h"
@@ -241,7 +242,10 @@ void Scene::render(Renderer* renderer, const Mat4* eyeTransforms, const Mat4* ey
         //clear background with max depth
         camera->clearBackground();
         //visit the scene
-        visit(renderer, transform, 0);
+        {
+            FrameStats::ScopedPhase visitPhase(FrameStats::Phase::VISIT);
+            visit(renderer, transform, 0);
+        }
 #if CC_USE_NAVMESH
         if (_navMesh && _navMeshDebugCamera == camera)
         {
@@ -249,7 +253,10 @@ void Scene::render(Renderer* renderer, const Mat4* eyeTransforms, const Mat4* ey
         }
 #endif
 
-        renderer->render();
+        {
+            FrameStats::ScopedPhase renderPhase(FrameStats::Phase::RENDER);
+            renderer->render();
+        }
         camera->restore();
 
         for (unsigned int i = 0; i < multiViewCount; ++i)
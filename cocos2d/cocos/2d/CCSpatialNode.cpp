@@ -0,0 +1,486 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "2d/CCSpatialNode.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "2d/CCCamera.h"
+#include "base/CCDirector.h"
+#include "base/ccUTF8.h"
+
+NS_CC_BEGIN
+
+// Children spanning more cells than this are kept out of the grid and tested directly.
+static const int MAX_CELLS_PER_CHILD = 1024;
+
+SpatialNode* SpatialNode::create(float cellSize)
+{
+    SpatialNode* ret = new (std::nothrow) SpatialNode();
+    if (ret && ret->initWithCellSize(cellSize))
+    {
+        ret->autorelease();
+        return ret;
+    }
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+}
+
+SpatialNode::SpatialNode()
+: _cellSize(512.0f)
+, _visitMargin(0.0f)
+, _cullingEnabled(true)
+, _orderDirty(false)
+, _transformEpoch(0)
+, _visitMark(0)
+, _visitedChildrenCount(0)
+{
+}
+
+SpatialNode::~SpatialNode()
+{
+}
+
+bool SpatialNode::initWithCellSize(float cellSize)
+{
+    if (!Node::init())
+        return false;
+
+    CCASSERT(cellSize > 0, "SpatialNode: cell size must be positive");
+    _cellSize = cellSize;
+    return true;
+}
+
+void SpatialNode::setCellSize(float cellSize)
+{
+    CCASSERT(cellSize > 0, "SpatialNode: cell size must be positive");
+    if (cellSize == _cellSize)
+        return;
+
+    for (auto& pair : _entries)
+        eraseEntry(pair.second);
+    _cellSize = cellSize;
+    for (auto& pair : _entries)
+        insertEntry(pair.second);
+}
+
+void SpatialNode::setChildDynamic(Node* child, bool dynamic)
+{
+    auto it = _entries.find(child);
+    CCASSERT(it != _entries.end(), "SpatialNode: child not found");
+    if (it == _entries.end() || it->second.dynamic == dynamic)
+        return;
+
+    Entry* entry = &it->second;
+    entry->dynamic = dynamic;
+    if (dynamic)
+        _dynamicEntries.push_back(entry);
+    else
+        _dynamicEntries.erase(std::find(_dynamicEntries.begin(), _dynamicEntries.end(), entry));
+}
+
+bool SpatialNode::isChildDynamic(Node* child) const
+{
+    auto it = _entries.find(child);
+    return it != _entries.end() && it->second.dynamic;
+}
+
+void SpatialNode::setChildBounds(Node* child, const Rect& bounds)
+{
+    auto it = _entries.find(child);
+    CCASSERT(it != _entries.end(), "SpatialNode: child not found");
+    if (it == _entries.end())
+        return;
+
+    Entry& entry = it->second;
+    eraseEntry(entry);
+    entry.fixedBounds = true;
+    entry.unbounded = false;
+    entry.bounds = bounds;
+    insertEntry(entry);
+}
+
+void SpatialNode::updateChildBounds(Node* child)
+{
+    auto it = _entries.find(child);
+    if (it != _entries.end())
+        refreshEntry(it->second);
+}
+
+void SpatialNode::addChild(Node* child, int localZOrder, int tag)
+{
+    Node::addChild(child, localZOrder, tag);
+    trackChild(child);
+}
+
+void SpatialNode::addChild(Node* child, int localZOrder, const std::string &name)
+{
+    Node::addChild(child, localZOrder, name);
+    trackChild(child);
+}
+
+void SpatialNode::removeChild(Node* child, bool cleanup)
+{
+    auto it = _entries.find(child);
+    if (it != _entries.end())
+    {
+        Entry* entry = &it->second;
+        eraseEntry(*entry);
+        if (entry->dynamic)
+            _dynamicEntries.erase(std::find(_dynamicEntries.begin(), _dynamicEntries.end(), entry));
+        _entries.erase(it);
+    }
+    Node::removeChild(child, cleanup);
+}
+
+void SpatialNode::removeAllChildrenWithCleanup(bool cleanup)
+{
+    _entries.clear();
+    _cells.clear();
+    _looseEntries.clear();
+    _dynamicEntries.clear();
+    _visibleEntries.clear();
+    Node::removeAllChildrenWithCleanup(cleanup);
+}
+
+void SpatialNode::trackChild(Node* child)
+{
+    Entry& entry = _entries[child];
+    entry.node = child;
+    entry.order = -1;
+    entry.visitMark = _visitMark;
+    // a new child computes its transform on its first visit anyway
+    entry.transformEpoch = _transformEpoch;
+    entry.dynamic = false;
+    entry.fixedBounds = false;
+    entry.unbounded = false;
+    entry.oversized = false;
+    entry.cellX0 = entry.cellY0 = entry.cellX1 = entry.cellY1 = 0;
+
+    const Size& size = child->getContentSize();
+    entry.unbounded = size.width <= 0 || size.height <= 0;
+    entry.bounds = entry.unbounded ? Rect::ZERO : child->getBoundingBox();
+    insertEntry(entry);
+    _orderDirty = true;
+}
+
+void SpatialNode::computeCellRange(const Rect& bounds, int* x0, int* y0, int* x1, int* y1) const
+{
+    *x0 = (int)std::floor(bounds.getMinX() / _cellSize);
+    *y0 = (int)std::floor(bounds.getMinY() / _cellSize);
+    *x1 = (int)std::floor(bounds.getMaxX() / _cellSize);
+    *y1 = (int)std::floor(bounds.getMaxY() / _cellSize);
+}
+
+void SpatialNode::insertEntry(Entry& entry)
+{
+    entry.oversized = false;
+    if (!entry.unbounded)
+    {
+        computeCellRange(entry.bounds, &entry.cellX0, &entry.cellY0, &entry.cellX1, &entry.cellY1);
+        long long cells = (long long)(entry.cellX1 - entry.cellX0 + 1) * (entry.cellY1 - entry.cellY0 + 1);
+        entry.oversized = cells > MAX_CELLS_PER_CHILD;
+    }
+
+    if (entry.unbounded || entry.oversized)
+    {
+        _looseEntries.push_back(&entry);
+        return;
+    }
+
+    for (int y = entry.cellY0; y <= entry.cellY1; ++y)
+    {
+        for (int x = entry.cellX0; x <= entry.cellX1; ++x)
+            _cells[cellKey(x, y)].push_back(&entry);
+    }
+}
+
+void SpatialNode::eraseEntry(Entry& entry)
+{
+    if (entry.unbounded || entry.oversized)
+    {
+        auto it = std::find(_looseEntries.begin(), _looseEntries.end(), &entry);
+        if (it != _looseEntries.end())
+            _looseEntries.erase(it);
+        return;
+    }
+
+    for (int y = entry.cellY0; y <= entry.cellY1; ++y)
+    {
+        for (int x = entry.cellX0; x <= entry.cellX1; ++x)
+        {
+            auto cellIt = _cells.find(cellKey(x, y));
+            if (cellIt == _cells.end())
+                continue;
+
+            auto& list = cellIt->second;
+            auto it = std::find(list.begin(), list.end(), &entry);
+            if (it != list.end())
+            {
+                *it = list.back();
+                list.pop_back();
+            }
+            if (list.empty())
+                _cells.erase(cellIt);
+        }
+    }
+}
+
+void SpatialNode::refreshEntry(Entry& entry)
+{
+    if (entry.fixedBounds)
+        return;
+
+    const Size& size = entry.node->getContentSize();
+    bool unbounded = size.width <= 0 || size.height <= 0;
+    if (unbounded && entry.unbounded)
+        return;
+
+    Rect bounds = unbounded ? Rect::ZERO : entry.node->getBoundingBox();
+    if (!unbounded && !entry.unbounded)
+    {
+        int x0, y0, x1, y1;
+        computeCellRange(bounds, &x0, &y0, &x1, &y1);
+        if (x0 == entry.cellX0 && y0 == entry.cellY0 && x1 == entry.cellX1 && y1 == entry.cellY1)
+        {
+            // same cells, the tighter test in visit() only needs the new rectangle
+            entry.bounds = bounds;
+            return;
+        }
+    }
+
+    eraseEntry(entry);
+    entry.unbounded = unbounded;
+    entry.bounds = bounds;
+    insertEntry(entry);
+}
+
+void SpatialNode::refreshOrder()
+{
+    for (ssize_t i = 0, size = _children.size(); i < size; ++i)
+    {
+        auto it = _entries.find(_children.at(i));
+        if (it != _entries.end())
+            it->second.order = i;
+    }
+    _orderDirty = false;
+}
+
+bool SpatialNode::computeVisibleRect(const Mat4& viewProjection, Rect* visibleRect) const
+{
+    // Restricted to this node's z = 0 plane, local -> clip space is the 3x3 projective map
+    //   (clip x, clip y, clip w) = H * (x, y, 1)
+    // so the local area seen by the camera is H^-1 applied to the corners of the NDC square.
+    Mat4 m = viewProjection * _modelViewTransform;
+    const float* h = m.m;
+    float a = h[0], b = h[4], c = h[12];
+    float d = h[1], e = h[5], f = h[13];
+    float g = h[3], k = h[7], l = h[15];
+
+    float A = e * l - f * k, B = c * k - b * l, C = b * f - c * e;
+    float D = f * g - d * l, E = a * l - c * g, F = c * d - a * f;
+    float G = d * k - e * g, H = b * g - a * k, I = a * e - b * d;
+    float det = a * A + b * D + c * G;
+    if (std::fabs(det) < FLT_EPSILON)
+        return false;
+
+    static const float corners[4][2] = { {-1, -1}, {1, -1}, {1, 1}, {-1, 1} };
+    float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+    for (const auto& corner : corners)
+    {
+        float x = A * corner[0] + B * corner[1] + C;
+        float y = D * corner[0] + E * corner[1] + F;
+        float w = G * corner[0] + H * corner[1] + I;
+        // the adjugate equals det * H^-1, the local point is behind the camera unless w / det > 0
+        if (w * det <= 0)
+            return false;
+
+        x /= w;
+        y /= w;
+        minX = std::min(minX, x);
+        minY = std::min(minY, y);
+        maxX = std::max(maxX, x);
+        maxY = std::max(maxY, y);
+    }
+
+    visibleRect->setRect(minX - _visitMargin, minY - _visitMargin,
+                         maxX - minX + _visitMargin * 2, maxY - minY + _visitMargin * 2);
+    return true;
+}
+
+void SpatialNode::visitAllChildren(Renderer* renderer, uint32_t flags)
+{
+    // children culled earlier may have missed a transform change of this node
+    bool stale = false;
+    for (auto& pair : _entries)
+    {
+        if (pair.second.transformEpoch != _transformEpoch)
+        {
+            pair.second.transformEpoch = _transformEpoch;
+            stale = true;
+        }
+    }
+    if (stale)
+        flags |= FLAGS_TRANSFORM_DIRTY;
+
+    ssize_t i = 0;
+    for (ssize_t size = _children.size(); i < size; ++i)
+    {
+        auto node = _children.at(i);
+        if (node->getLocalZOrder() < 0)
+            node->visit(renderer, _modelViewTransform, flags);
+        else
+            break;
+    }
+    if (isVisitableByVisitingCamera())
+        this->draw(renderer, _modelViewTransform, flags);
+    for (ssize_t size = _children.size(); i < size; ++i)
+        _children.at(i)->visit(renderer, _modelViewTransform, flags);
+
+    _visitedChildrenCount = _children.size();
+}
+
+void SpatialNode::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t parentFlags)
+{
+    if (!_visible)
+        return;
+
+    if (!_cullingEnabled)
+    {
+        Node::visit(renderer, parentTransform, parentFlags);
+        _visitedChildrenCount = _children.size();
+        return;
+    }
+
+    uint32_t flags = processParentFlags(parentTransform, parentFlags);
+    if (flags & FLAGS_DIRTY_MASK)
+        ++_transformEpoch;
+
+    _director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    _director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+
+    if (_reorderChildDirty)
+        _orderDirty = true;
+    sortAllChildren();
+    if (_orderDirty)
+        refreshOrder();
+
+    auto camera = Camera::getVisitingCamera();
+    Rect visibleRect;
+    if (!camera || !computeVisibleRect(camera->getViewProjectionMatrix(), &visibleRect))
+    {
+        visitAllChildren(renderer, flags);
+        _director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+        return;
+    }
+
+    for (auto entry : _dynamicEntries)
+        refreshEntry(*entry);
+
+    ++_visitMark;
+    _visibleEntries.clear();
+    auto gather = [this, &visibleRect](Entry* entry) {
+        if (entry->visitMark != _visitMark && (entry->unbounded || entry->bounds.intersectsRect(visibleRect)))
+        {
+            entry->visitMark = _visitMark;
+            _visibleEntries.push_back(entry);
+        }
+    };
+
+    for (auto entry : _looseEntries)
+        gather(entry);
+
+    int x0, y0, x1, y1;
+    computeCellRange(visibleRect, &x0, &y0, &x1, &y1);
+    long long viewCells = (long long)(x1 - x0 + 1) * (y1 - y0 + 1);
+    if (viewCells <= (long long)_cells.size())
+    {
+        for (int y = y0; y <= y1; ++y)
+        {
+            for (int x = x0; x <= x1; ++x)
+            {
+                auto cellIt = _cells.find(cellKey(x, y));
+                if (cellIt == _cells.end())
+                    continue;
+                for (auto entry : cellIt->second)
+                    gather(entry);
+            }
+        }
+    }
+    else
+    {
+        // zoomed out past the populated area, walking the occupied cells is cheaper
+        for (auto& cell : _cells)
+        {
+            int x = (int)(cell.first >> 32);
+            int y = (int)(unsigned int)cell.first;
+            if (x < x0 || x > x1 || y < y0 || y > y1)
+                continue;
+            for (auto entry : cell.second)
+                gather(entry);
+        }
+    }
+
+    std::sort(_visibleEntries.begin(), _visibleEntries.end(), [](const Entry* a, const Entry* b) {
+        return a->order < b->order;
+    });
+
+    bool selfDrawn = false;
+    for (auto entry : _visibleEntries)
+    {
+        Node* node = entry->node;
+        if (!selfDrawn && node->getLocalZOrder() >= 0)
+        {
+            if (isVisitableByVisitingCamera())
+                this->draw(renderer, _modelViewTransform, flags);
+            selfDrawn = true;
+        }
+
+        uint32_t childFlags = flags;
+        if (entry->transformEpoch != _transformEpoch)
+        {
+            childFlags |= FLAGS_TRANSFORM_DIRTY;
+            entry->transformEpoch = _transformEpoch;
+        }
+        node->visit(renderer, _modelViewTransform, childFlags);
+
+        // the transform is fresh now, keep the cells of a moving static child up to date
+        if (!entry->dynamic)
+            refreshEntry(*entry);
+    }
+    if (!selfDrawn && isVisitableByVisitingCamera())
+        this->draw(renderer, _modelViewTransform, flags);
+
+    _visitedChildrenCount = _visibleEntries.size();
+
+    _director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+}
+
+std::string SpatialNode::getDescription() const
+{
+    return StringUtils::format("<SpatialNode | Tag = %d, Children = %d, Cells = %d>",
+                               _tag, (int)_children.size(), (int)_cells.size());
+}
+
+NS_CC_END
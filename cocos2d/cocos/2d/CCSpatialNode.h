@@ -0,0 +1,165 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef __CCSPATIAL_NODE_H__
+#define __CCSPATIAL_NODE_H__
+
+#include <vector>
+#include <unordered_map>
+
+#include "2d/CCNode.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @class SpatialNode
+ * @brief SpatialNode is a container that only visits the children overlapping the visiting camera.
+
+ The children are binned into a uniform grid by their bounding box in the container's space.
+ Every visit the camera's view of the container's z = 0 plane is mapped back into that space,
+ and only the children found in the overlapping cells are visited, in their usual z order.
+ Visit cost therefore follows the content on screen instead of the number of children.
+
+ Children are static by default: their cells are refreshed whenever they are visited, and
+ updateChildBounds() must be called when an off-screen static child moves. Children marked
+ with setChildDynamic() are re-binned every visit and suit moving actors.
+ A child without a content size (a plain Node holding other nodes) is always visited unless
+ it was given explicit bounds with setChildBounds().
+ */
+class CC_DLL SpatialNode : public Node
+{
+public:
+    /** Creates a spatial node.
+     *
+     * @param cellSize The edge of a grid cell in the node's space.
+     * @return An autoreleased SpatialNode object.
+     */
+    static SpatialNode* create(float cellSize = 512.0f);
+
+    // prevents compiler warning: "Included function hides overloaded virtual functions"
+    using Node::addChild;
+    using Node::removeChild;
+
+    /** Sets the edge of a grid cell and re-bins every child. */
+    void setCellSize(float cellSize);
+    float getCellSize() const { return _cellSize; }
+
+    /** Extra distance around the camera's view whose children are still visited.
+     * Useful when children draw outside their bounding box (particles, glow sprites).
+     */
+    void setVisitMargin(float margin) { _visitMargin = margin; }
+    float getVisitMargin() const { return _visitMargin; }
+
+    /** When disabled the node visits every child like a plain Node. */
+    void setCullingEnabled(bool enabled) { _cullingEnabled = enabled; }
+    bool isCullingEnabled() const { return _cullingEnabled; }
+
+    /** Dynamic children have their bounding box refreshed every visit. */
+    void setChildDynamic(Node* child, bool dynamic);
+    bool isChildDynamic(Node* child) const;
+
+    /** Uses a fixed rectangle, in this node's space, for a child instead of its bounding box.
+     * The rectangle does not follow the child when it moves.
+     */
+    void setChildBounds(Node* child, const Rect& bounds);
+
+    /** Refreshes the cells of a child after it moved, scaled or changed its content size. */
+    void updateChildBounds(Node* child);
+
+    /** Number of children visited during the last visit. */
+    ssize_t getVisitedChildrenCount() const { return _visitedChildrenCount; }
+
+    // Overrides
+    virtual void addChild(Node* child, int localZOrder, int tag) override;
+    virtual void addChild(Node* child, int localZOrder, const std::string &name) override;
+    virtual void removeChild(Node* child, bool cleanup = true) override;
+    virtual void removeAllChildrenWithCleanup(bool cleanup) override;
+    virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+    virtual std::string getDescription() const override;
+
+CC_CONSTRUCTOR_ACCESS:
+    SpatialNode();
+    virtual ~SpatialNode();
+
+    bool initWithCellSize(float cellSize);
+
+protected:
+    struct Entry
+    {
+        Node* node;
+        Rect bounds;
+        // covered cell range, inclusive; unused when the entry is unbounded or oversized
+        int cellX0, cellY0, cellX1, cellY1;
+        // position in _children, refreshed when the children are reordered
+        ssize_t order;
+        unsigned int visitMark;
+        unsigned int transformEpoch;
+        bool dynamic;
+        bool fixedBounds;
+        // visited every frame: no content size and no fixed bounds
+        bool unbounded;
+        // tested against the view directly instead of being stored in cells
+        bool oversized;
+    };
+
+    void insertEntry(Entry& entry);
+    void eraseEntry(Entry& entry);
+    void refreshEntry(Entry& entry);
+    void refreshOrder();
+    void trackChild(Node* child);
+    void computeCellRange(const Rect& bounds, int* x0, int* y0, int* x1, int* y1) const;
+    bool computeVisibleRect(const Mat4& viewProjection, Rect* visibleRect) const;
+    void visitAllChildren(Renderer* renderer, uint32_t flags);
+
+    static long long cellKey(int x, int y) { return ((long long)x << 32) ^ (unsigned int)y; }
+
+    float _cellSize;
+    float _visitMargin;
+    bool _cullingEnabled;
+    bool _orderDirty;
+    // increased whenever this node's transform changes, so culled children catch up when visible again
+    unsigned int _transformEpoch;
+    unsigned int _visitMark;
+    ssize_t _visitedChildrenCount;
+
+    std::unordered_map<Node*, Entry> _entries;
+    std::unordered_map<long long, std::vector<Entry*>> _cells;
+    // entries kept outside the grid: unbounded or oversized
+    std::vector<Entry*> _looseEntries;
+    std::vector<Entry*> _dynamicEntries;
+    std::vector<Entry*> _visibleEntries;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(SpatialNode);
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif // __CCSPATIAL_NODE_H__
@@ -37,6 +37,7 @@ THE SOFTWARE.
 #include "renderer/CCTrianglesCommand.h"
 #include "renderer/CCCustomCommand.h"
 #include "2d/CCAutoPolygon.h"
+#include "base/allocator/CCAllocatorTypePool.h"
 
 NS_CC_BEGIN
 
@@ -95,6 +96,7 @@ struct transformValues_;
  */
 class CC_DLL Sprite : public Node, public TextureProtocol
 {
+    CC_USE_TYPE_POOL(Sprite)
 public:
     enum class RenderMode {
         QUAD,
@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "2d/CCAutoPolygon.h"
 #include "base/CCRef.h"
 #include "math/CCGeometry.h"
+#include "base/allocator/CCAllocatorTypePool.h"
 
 NS_CC_BEGIN
 
@@ -58,6 +59,7 @@ class Texture2D;
  */
 class CC_DLL SpriteFrame : public Ref, public Clonable
 {
+    CC_USE_TYPE_POOL(SpriteFrame)
 public:
 
     /** Create a SpriteFrame with a texture filename, rect in points.
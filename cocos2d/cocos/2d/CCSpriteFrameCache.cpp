@@ -41,6 +41,7 @@ THE SOFTWARE.
 #include "base/ccUTF8.h"
 #include "base/ccUtils.h"
 #include "base/CCDirector.h"
+#include "base/CCFrameStats.h"
 #include "renderer/CCTexture2D.h"
 #include "renderer/CCTextureCache.h"
 #include "base/CCNinePatchImageParser.h"
@@ -287,6 +288,19 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dict, const std::
         }
     }
     
+    Texture2D *texture = addSheetTexture(texturePath, pixelFormatName);
+    if (texture)
+    {
+        addSpriteFramesWithDictionary(dict, texture, plist);
+    }
+    else
+    {
+        CCLOG("cocos2d: SpriteFrameCache: Couldn't load texture");
+    }
+}
+
+Texture2D* SpriteFrameCache::addSheetTexture(const std::string& texturePath, const std::string& pixelFormatName)
+{
     Texture2D *texture = nullptr;
     static std::unordered_map<std::string, Texture2D::PixelFormat> pixelFormats = {
         {"RGBA8888", Texture2D::PixelFormat::RGBA8888},
@@ -316,15 +330,58 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dict, const std::
     {
         texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
     }
-    
-    if (texture)
+    return texture;
+}
+
+void SpriteFrameCache::addSpriteFramesWithSheet(SpriteSheetData* sheet, const std::string& plist)
+{
+    // the texture is looked up again in case it was evicted since the sheet was loaded
+    Texture2D* texture = addSheetTexture(sheet, plist);
+    if (!texture)
     {
-        addSpriteFramesWithDictionary(dict, texture, plist);
+        CCLOG("cocos2d: SpriteFrameCache: Couldn't load texture");
+        return;
     }
-    else
+
+    for (uint32_t i = 0; i < sheet->getAliasCount(); ++i)
     {
-        CCLOG("cocos2d: SpriteFrameCache: Couldn't load texture");
+        const auto& alias = sheet->getAlias(i);
+        _spriteFramesAliases[sheet->getAliasName(alias)] = Value(sheet->getFrameName(sheet->getFrame(alias.frameIndex)));
+    }
+
+    for (uint32_t i = 0; i < sheet->getFrameCount(); ++i)
+    {
+        const auto& frame = sheet->getFrame(i);
+        std::string spriteFrameName = sheet->getFrameName(frame);
+        if (_spriteFramesCache.at(spriteFrameName))
+        {
+            continue;
+        }
+
+        SpriteFrame* spriteFrame = createSpriteFrame(frame, texture);
+        _spriteFramesCache.insertFrame(plist, spriteFrameName, spriteFrame);
+    }
+    _spriteFramesCache.markPlistFull(plist, true);
+}
+
+Texture2D* SpriteFrameCache::addSheetTexture(SpriteSheetData* sheet, const std::string& plist)
+{
+    std::string texturePath = FileUtils::getInstance()->fullPathFromRelativeFile(sheet->getTextureFileName(), plist);
+    return addSheetTexture(texturePath, sheet->getPixelFormatName());
+}
+
+SpriteFrame* SpriteFrameCache::createSpriteFrame(const SpriteSheetData::Frame& frame, Texture2D* texture)
+{
+    SpriteFrame* spriteFrame = SpriteFrame::createWithTexture(texture,
+                                                             Rect(frame.rect[0], frame.rect[1], frame.rect[2], frame.rect[3]),
+                                                             frame.rotated != 0,
+                                                             Vec2(frame.offset[0], frame.offset[1]),
+                                                             Size(frame.sourceSize[0], frame.sourceSize[1]));
+    if (frame.hasAnchor)
+    {
+        spriteFrame->setAnchorPoint(Vec2(frame.anchor[0], frame.anchor[1]));
     }
+    return spriteFrame;
 }
 
 void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist, Texture2D *texture)
@@ -358,6 +415,16 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist)
         return;
     }
 
+    FrameStats::ScopedZone loadZone(FrameStats::ZONE_SPRITE_FRAMES_LOAD);
+
+    // registered before: only the frames removed since then are created again
+    SpriteSheetData* sheet = _loadedSheets.at(plist);
+    if (sheet)
+    {
+        addSpriteFramesWithSheet(sheet, plist);
+        return;
+    }
+
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
     if (fullPath.empty())
     {
@@ -366,6 +433,18 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist)
         return;
     }
 
+    std::string sheetPath = SpriteSheetData::getSheetPath(fullPath);
+    if (FileUtils::getInstance()->isFileExist(sheetPath))
+    {
+        sheet = SpriteSheetData::createWithFile(sheetPath);
+        if (sheet)
+        {
+            _loadedSheets.insert(plist, sheet);
+            addSpriteFramesWithSheet(sheet, plist);
+            return;
+        }
+    }
+
     ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
 
     string texturePath("");
@@ -414,6 +493,7 @@ void SpriteFrameCache::removeSpriteFrames()
 {
     _spriteFramesAliases.clear();
     _spriteFramesCache.clear();
+    _loadedSheets.clear();
 }
 
 void SpriteFrameCache::removeUnusedSpriteFrames()
@@ -456,11 +536,34 @@ void SpriteFrameCache::removeSpriteFrameByName(const std::string& name)
         _spriteFramesAliases.erase(key);
     }
 
+    // a frame removed on purpose must not come back from its sheet
+    for (auto it = _loadedSheets.begin(); it != _loadedSheets.end(); )
+    {
+        if (it->second->findFrame(foundAlias ? key : name))
+            it = _loadedSheets.erase(it);
+        else
+            ++it;
+    }
+
     _spriteFramesCache.eraseFrame(name);
 }
 
 void SpriteFrameCache::removeSpriteFramesFromFile(const std::string& plist)
 {
+    SpriteSheetData* sheet = _loadedSheets.at(plist);
+    if (sheet)
+    {
+        std::vector<std::string> keysToRemove;
+        for (uint32_t i = 0; i < sheet->getFrameCount(); ++i)
+        {
+            keysToRemove.push_back(sheet->getFrameName(sheet->getFrame(i)));
+        }
+        _spriteFramesCache.eraseFrames(keysToRemove);
+        _spriteFramesCache.erasePlistIndex(plist);
+        _loadedSheets.erase(plist);
+        return;
+    }
+
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
     ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
     if (dict.empty())
@@ -508,6 +611,16 @@ void SpriteFrameCache::removeSpriteFramesFromTexture(Texture2D* texture)
 {
     std::vector<std::string> keysToRemove;
 
+    std::string textureFile = Director::getInstance()->getTextureCache()->getTextureFilePath(texture);
+    for (auto it = _loadedSheets.begin(); it != _loadedSheets.end(); )
+    {
+        std::string sheetTexture = FileUtils::getInstance()->fullPathFromRelativeFile(it->second->getTextureFileName(), it->first);
+        if (FileUtils::getInstance()->fullPathForFilename(sheetTexture) == textureFile)
+            it = _loadedSheets.erase(it);
+        else
+            ++it;
+    }
+
     for (auto& iter : _spriteFramesCache.getSpriteFrames())
     {
         std::string key = iter.first;
@@ -541,6 +654,21 @@ SpriteFrame* SpriteFrameCache::getSpriteFrameByName(const std::string& name)
         }
         else
         {
+            // removed as unused since its sheet was registered
+            for (auto& sheet : _loadedSheets)
+            {
+                auto sheetFrame = sheet.second->findFrame(name);
+                if (sheetFrame)
+                {
+                    Texture2D* texture = addSheetTexture(sheet.second, sheet.first);
+                    if (texture)
+                    {
+                        frame = createSpriteFrame(*sheetFrame, texture);
+                        _spriteFramesCache.insertFrame(sheet.first, name, frame);
+                    }
+                    return frame;
+                }
+            }
             CCLOG("cocos2d: SpriteFrameCache: Frame '%s' isn't found", name.c_str());
         }
     }
@@ -35,6 +35,7 @@ THE SOFTWARE.
 #include <unordered_map>
 #include <string>
 #include "2d/CCSpriteFrame.h"
+#include "2d/CCSpriteSheetData.h"
 #include "base/CCRef.h"
 #include "base/CCValue.h"
 #include "base/CCMap.h"
@@ -172,6 +173,7 @@ public:
     /** Adds multiple Sprite Frames from a plist file.
      * A texture will be loaded automatically. The texture name will composed by replacing the .plist suffix with .png.
      * If you want to use another texture, you should use the addSpriteFramesWithFile(const std::string& plist, const std::string& textureFileName) method.
+     * When the plist was compiled by tools/pack_sprite_sheets.py, the binary "<plist>.sheet" is loaded instead. @see SpriteSheetData
      * @js addSpriteFrames
      * @lua addSpriteFrames
      *
@@ -314,8 +316,20 @@ protected:
 
     void reloadSpriteFramesWithDictionary(ValueMap& dictionary, Texture2D *texture, const std::string &plist);
 
+    /* Loads the texture of a sheet with the pixel format named in its metadata, if any. */
+    Texture2D* addSheetTexture(const std::string& texturePath, const std::string& pixelFormatName);
+
+    Texture2D* addSheetTexture(SpriteSheetData* sheet, const std::string& plist);
+
+    /* Adds the frames of a compiled sheet that are not in the cache yet. */
+    void addSpriteFramesWithSheet(SpriteSheetData* sheet, const std::string& plist);
+    SpriteFrame* createSpriteFrame(const SpriteSheetData::Frame& frame, Texture2D* texture);
+
     ValueMap _spriteFramesAliases;
     PlistFramesCache _spriteFramesCache;
+    // compiled sheets by plist; registering one again, or looking up one of its frames after
+    // removeUnusedSpriteFrames(), rebuilds the frames from memory
+    Map<std::string, SpriteSheetData*> _loadedSheets;
 };
 
 // end of _2d group
@@ -0,0 +1,134 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "2d/CCSpriteSheetData.h"
+
+#include <algorithm>
+
+#include "platform/CCFileUtils.h"
+#include "base/ccMacros.h"
+#include "xxhash.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    const char SHEET_MAGIC[4] = { 'C', 'C', 'S', 'B' };
+    const uint32_t SHEET_VERSION = 1;
+}
+
+SpriteSheetData* SpriteSheetData::createWithFile(const std::string& filename)
+{
+    auto sheet = new (std::nothrow) SpriteSheetData();
+    if (sheet && sheet->initWithFile(filename))
+    {
+        sheet->autorelease();
+        return sheet;
+    }
+    CC_SAFE_DELETE(sheet);
+    return nullptr;
+}
+
+uint32_t SpriteSheetData::hashName(const char* name, size_t length)
+{
+    return XXH32(name, length, 0);
+}
+
+SpriteSheetData::SpriteSheetData()
+: _header(nullptr)
+, _frames(nullptr)
+, _aliases(nullptr)
+, _names(nullptr)
+{
+}
+
+SpriteSheetData::~SpriteSheetData()
+{
+}
+
+bool SpriteSheetData::initWithFile(const std::string& filename)
+{
+    // zero-copy when the sheet comes from a resource archive
+    _data = FileUtils::getInstance()->getDataFromFile(filename);
+    if (_data.isNull() || (size_t)_data.getSize() < sizeof(Header))
+        return false;
+
+    auto bytes = _data.getBytes();
+    auto header = reinterpret_cast<const Header*>(bytes);
+    if (memcmp(header->magic, SHEET_MAGIC, sizeof(SHEET_MAGIC)) != 0 || header->version != SHEET_VERSION)
+    {
+        CCLOG("cocos2d: SpriteSheetData: %s is not a compiled sprite sheet", filename.c_str());
+        return false;
+    }
+
+    size_t framesOffset = sizeof(Header);
+    size_t aliasesOffset = framesOffset + (size_t)header->frameCount * sizeof(Frame);
+    size_t namesOffset = aliasesOffset + (size_t)header->aliasCount * sizeof(Alias);
+    if (namesOffset + header->namesSize > (size_t)_data.getSize()
+        || (uint64_t)header->textureNameOffset + header->textureNameLength > header->namesSize
+        || (uint64_t)header->pixelFormatOffset + header->pixelFormatLength > header->namesSize)
+    {
+        CCLOG("cocos2d: SpriteSheetData: %s is truncated", filename.c_str());
+        return false;
+    }
+
+    auto frames = reinterpret_cast<const Frame*>(bytes + framesOffset);
+    auto aliases = reinterpret_cast<const Alias*>(bytes + aliasesOffset);
+    for (uint32_t i = 0; i < header->frameCount; ++i)
+    {
+        if ((uint64_t)frames[i].nameOffset + frames[i].nameLength > header->namesSize)
+            return false;
+    }
+    for (uint32_t i = 0; i < header->aliasCount; ++i)
+    {
+        if ((uint64_t)aliases[i].nameOffset + aliases[i].nameLength > header->namesSize || aliases[i].frameIndex >= header->frameCount)
+            return false;
+    }
+
+    _header = header;
+    _frames = frames;
+    _aliases = aliases;
+    _names = reinterpret_cast<const char*>(bytes + namesOffset);
+    return true;
+}
+
+const SpriteSheetData::Frame* SpriteSheetData::findFrame(const std::string& name) const
+{
+    if (!_header)
+        return nullptr;
+
+    uint32_t hash = hashName(name.data(), name.size());
+    const Frame* end = _frames + _header->frameCount;
+    auto it = std::lower_bound(_frames, end, hash, [](const Frame& frame, uint32_t value) {
+        return frame.nameHash < value;
+    });
+
+    for (; it != end && it->nameHash == hash; ++it)
+    {
+        if (it->nameLength == name.size() && memcmp(_names + it->nameOffset, name.data(), name.size()) == 0)
+            return it;
+    }
+    return nullptr;
+}
+
+NS_CC_END
@@ -0,0 +1,136 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef __CCSPRITE_SHEET_DATA_H__
+#define __CCSPRITE_SHEET_DATA_H__
+
+#include <string>
+
+#include "base/CCRef.h"
+#include "base/CCData.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @class SpriteSheetData
+ * @brief The frames of a sprite sheet plist, compiled into a binary file by tools/pack_sprite_sheets.py.
+
+ SpriteFrameCache::addSpriteFramesWithFile() loads "<plist>.sheet" instead of the plist when it exists,
+ so registering a sheet costs one file read and no XML or "{{x,y},{w,h}}" string parsing.
+ The file is used in place: the frames are read straight from the loaded bytes.
+
+ Layout, little-endian:
+ - Header: magic "CCSB", version, frame count, alias count, names size, and the name offsets of the
+   texture file (relative to the plist) and of the plist pixel format (may be empty).
+ - Frames sorted by the XXH32 of their name: the frame rect, offset and original size already
+   resolved from any plist format, the rotation and an optional anchor.
+ - Aliases: an alias name and the index of the frame it refers to.
+ - Names, not null terminated.
+
+ Sheets with polygon outlines are not compiled and keep using their plist.
+ */
+class CC_DLL SpriteSheetData : public Ref
+{
+public:
+    struct Frame
+    {
+        uint32_t nameHash;
+        uint32_t nameOffset;
+        uint16_t nameLength;
+        uint8_t rotated;
+        uint8_t hasAnchor;
+        float rect[4];
+        float offset[2];
+        float sourceSize[2];
+        float anchor[2];
+    };
+
+    struct Alias
+    {
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        uint32_t frameIndex;
+    };
+
+    /** Loads a compiled sheet. Returns nullptr if the file is missing or invalid. */
+    static SpriteSheetData* createWithFile(const std::string& filename);
+
+    /** Returns the compiled sheet path of a plist. */
+    static std::string getSheetPath(const std::string& plist) { return plist + ".sheet"; }
+
+    /** The hash the frame names are sorted by. */
+    static uint32_t hashName(const char* name, size_t length);
+
+    std::string getTextureFileName() const { return getString(_header->textureNameOffset, _header->textureNameLength); }
+    std::string getPixelFormatName() const { return getString(_header->pixelFormatOffset, _header->pixelFormatLength); }
+
+    uint32_t getFrameCount() const { return _header->frameCount; }
+    const Frame& getFrame(uint32_t index) const { return _frames[index]; }
+    std::string getFrameName(const Frame& frame) const { return getString(frame.nameOffset, frame.nameLength); }
+
+    /** Finds a frame by name with a binary search on its hash. Returns nullptr if it is not in the sheet. */
+    const Frame* findFrame(const std::string& name) const;
+
+    uint32_t getAliasCount() const { return _header->aliasCount; }
+    const Alias& getAlias(uint32_t index) const { return _aliases[index]; }
+    std::string getAliasName(const Alias& alias) const { return getString(alias.nameOffset, alias.nameLength); }
+
+CC_CONSTRUCTOR_ACCESS:
+    SpriteSheetData();
+    virtual ~SpriteSheetData();
+
+    bool initWithFile(const std::string& filename);
+
+protected:
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t frameCount;
+        uint32_t aliasCount;
+        uint32_t namesSize;
+        uint32_t textureNameOffset;
+        uint32_t textureNameLength;
+        uint32_t pixelFormatOffset;
+        uint32_t pixelFormatLength;
+    };
+
+    std::string getString(uint32_t offset, uint32_t length) const { return std::string(_names + offset, length); }
+
+    Data _data;
+    const Header* _header;
+    const Frame* _frames;
+    const Alias* _aliases;
+    const char* _names;
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif // __CCSPRITE_SHEET_DATA_H__
@@ -28,8 +28,10 @@ THE SOFTWARE.
 #include "2d/CCTMXTiledMap.h"
 #include "2d/CCTMXXMLParser.h"
 #include "2d/CCTMXLayer.h"
+#include "2d/CCTMXVirtualLayer.h"
 #include "2d/CCSprite.h"
 #include "base/ccUTF8.h"
+#include "base/CCDirector.h"
 
 NS_CC_BEGIN
 
@@ -106,11 +108,23 @@ TMXTiledMap::~TMXTiledMap()
 }
 
 // private
-TMXLayer * TMXTiledMap::parseLayer(TMXLayerInfo *layerInfo, TMXMapInfo *mapInfo)
+Node * TMXTiledMap::parseLayer(TMXLayerInfo *layerInfo, TMXMapInfo *mapInfo)
 {
     TMXTilesetInfo *tileset = tilesetForLayer(layerInfo, mapInfo);
     if (tileset == nullptr)
         return nullptr;
+
+    // Tilesets too large for a single texture are streamed page by page.
+    if (TMXVirtualLayer::shouldUseVirtualTexture(tileset, mapInfo))
+    {
+        TMXVirtualLayer *virtualLayer = TMXVirtualLayer::create(tileset, layerInfo, mapInfo);
+        if (nullptr != virtualLayer)
+        {
+            layerInfo->_ownTiles = false;
+            return virtualLayer;
+        }
+        CCLOG("cocos2d: TMXTiledMap: streaming '%s' failed, loading it as a single texture", tileset->_sourceImage.c_str());
+    }
     
     TMXLayer *layer = TMXLayer::create(tileset, layerInfo, mapInfo);
 
@@ -176,12 +190,14 @@ void TMXTiledMap::buildWithMapInfo(TMXMapInfo* mapInfo)
 
     _tileProperties = mapInfo->getTileProperties();
 
+    _tilesets = mapInfo->getTilesets();
+
     int idx = 0;
 
     auto& layers = mapInfo->getLayers();
     for (const auto &layerInfo : layers) {
         if (layerInfo->_visible) {
-            TMXLayer *child = parseLayer(layerInfo, mapInfo);
+            Node *child = parseLayer(layerInfo, mapInfo);
             if (child == nullptr) {
                 idx++;
                 continue;
@@ -245,22 +261,148 @@ Value TMXTiledMap::getProperty(const std::string& propertyName) const
     return Value();
 }
 
+// Tilesets are sorted by first gid, the last one that starts at or before GID owns it
+static const ValueMap* externalTileProperties(const Vector<TMXTilesetInfo*>& tilesets, int GID)
+{
+    for (auto it = tilesets.rbegin(); it != tilesets.rend(); ++it)
+    {
+        if ((*it)->_firstGid <= GID)
+            return (*it)->getTileProperties(GID);
+    }
+    return nullptr;
+}
+
 Value TMXTiledMap::getPropertiesForGID(int GID) const
 {
     if (_tileProperties.find(GID) != _tileProperties.end())
         return _tileProperties.at(GID);
+
+    const ValueMap* properties = externalTileProperties(_tilesets, GID);
+    if (properties)
+        return Value(*properties);
     
     return Value();
 }
 
 bool TMXTiledMap::getPropertiesForGID(int GID, Value** value)
 {
-    if (_tileProperties.find(GID) != _tileProperties.end()) {
-        *value = &_tileProperties.at(GID);
-        return true;
-    } else {
-        return false;
+    if (_tileProperties.find(GID) == _tileProperties.end()) {
+        // copy it out of the shared tileset, the caller may modify it
+        const ValueMap* properties = externalTileProperties(_tilesets, GID);
+        if (properties == nullptr)
+            return false;
+        _tileProperties[GID] = Value(*properties);
+    }
+    *value = &_tileProperties.at(GID);
+    return true;
+}
+
+std::vector<Rect> TMXTiledMap::getMergedTileRects(const std::string& propertyName, const std::string& layerName) const
+{
+    std::vector<Rect> rects;
+    if (_mapOrientation != TMXOrientationOrtho)
+    {
+        CCLOG("cocos2d: TMXTiledMap: merged tile rects are only supported for orthogonal maps");
+        return rects;
+    }
+
+    // gid -> whether the property is set, looked up once per distinct gid
+    std::unordered_map<uint32_t, bool> matches;
+    auto isMatch = [&](uint32_t gid) -> bool {
+        gid &= kTMXFlippedMask;
+        if (gid == 0)
+            return false;
+        auto it = matches.find(gid);
+        if (it != matches.end())
+            return it->second;
+
+        bool match = false;
+        Value properties = getPropertiesForGID((int)gid);
+        if (properties.getType() == Value::Type::MAP)
+        {
+            const ValueMap& map = properties.asValueMap();
+            auto property = map.find(propertyName);
+            match = property != map.end() && property->second.asBool();
+        }
+        matches.emplace(gid, match);
+        return match;
+    };
+
+    Size tileSize = CC_SIZE_PIXELS_TO_POINTS(_tileSize);
+
+    for (const auto& child : _children)
+    {
+        const uint32_t* tiles = nullptr;
+        Size layerSize;
+        std::string name;
+        if (auto layer = dynamic_cast<TMXLayer*>(child))
+        {
+            tiles = layer->getTiles();
+            layerSize = layer->getLayerSize();
+            name = layer->getLayerName();
+        }
+        else if (auto virtualLayer = dynamic_cast<TMXVirtualLayer*>(child))
+        {
+            tiles = virtualLayer->getTiles();
+            layerSize = virtualLayer->getLayerSize();
+            name = virtualLayer->getLayerName();
+        }
+        if (tiles == nullptr || (!layerName.empty() && name != layerName))
+            continue;
+
+        int cols = (int)layerSize.width;
+        int rows = (int)layerSize.height;
+        std::vector<bool> pending(cols * rows);
+        for (int i = 0; i < cols * rows; ++i)
+        {
+            pending[i] = isMatch(tiles[i]);
+        }
+
+        const Vec2& offset = child->getPosition();
+        for (int y = 0; y < rows; ++y)
+        {
+            for (int x = 0; x < cols; ++x)
+            {
+                if (!pending[x + y * cols])
+                    continue;
+
+                // grow right along the row, then down while the whole span matches
+                int right = x;
+                while (right + 1 < cols && pending[right + 1 + y * cols])
+                    ++right;
+
+                int bottom = y;
+                bool grow = true;
+                while (grow && bottom + 1 < rows)
+                {
+                    for (int i = x; i <= right; ++i)
+                    {
+                        if (!pending[i + (bottom + 1) * cols])
+                        {
+                            grow = false;
+                            break;
+                        }
+                    }
+                    if (grow)
+                        ++bottom;
+                }
+
+                for (int j = y; j <= bottom; ++j)
+                {
+                    for (int i = x; i <= right; ++i)
+                        pending[i + j * cols] = false;
+                }
+
+                // tile rows count from the top, node space from the bottom
+                rects.push_back(Rect(offset.x + x * tileSize.width,
+                                     offset.y + (rows - 1 - bottom) * tileSize.height,
+                                     (right - x + 1) * tileSize.width,
+                                     (bottom - y + 1) * tileSize.height));
+            }
+        }
     }
+
+    return rects;
 }
 
 std::string TMXTiledMap::getDescription() const
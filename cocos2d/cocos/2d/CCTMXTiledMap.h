@@ -32,6 +32,8 @@ THE SOFTWARE.
 #include "2d/CCTMXObjectGroup.h"
 #include "base/CCValue.h"
 
+#include <vector>
+
 NS_CC_BEGIN
 
 class TMXLayer;
@@ -111,6 +113,8 @@ enum
  * Technical description:
  * Each layer is created using an TMXLayer (subclass of SpriteBatchNode). If you have 5 layers, then 5 TMXLayer will be created,
  * unless the layer visibility is off. In that case, the layer won't be created at all.
+ * Layers whose tileset image is larger than TMXVirtualLayer::getVirtualTextureThreshold() are created as
+ * TMXVirtualLayer instead, which streams the image in pages; getLayer() does not return those.
  * You can obtain the layers (TMXLayer objects) at runtime by:
  * - map->getChildByTag(tag_number);  // 0=1st layer, 1=2nd layer, 2=3rd layer, etc...
  * - map->getLayer(name_of_the_layer);
@@ -203,6 +207,16 @@ public:
      */
     bool getPropertiesForGID(int GID, Value** value);
 
+    /** Merges the tiles whose tile property is true into as few axis-aligned rectangles as possible.
+     * Each run of tiles along a row is grown downwards while the rows below match, which keeps
+     * the result small for the large solid areas of typical level art. Only orthogonal maps are supported.
+     *
+     * @param propertyName The tile property to test, e.g. "solid".
+     * @param layerName Only scan this layer. All tile layers are scanned if it is empty.
+     * @return The rectangles in the map's node space (points).
+     */
+    std::vector<Rect> getMergedTileRects(const std::string& propertyName, const std::string& layerName = "") const;
+
     /** The map's size property measured in tiles. 
      *
      * @return The map's size property measured in tiles.
@@ -294,7 +308,7 @@ CC_CONSTRUCTOR_ACCESS:
     bool initWithXML(const std::string& tmxString, const std::string& resourcePath);
 
 protected:
-    TMXLayer * parseLayer(TMXLayerInfo *layerInfo, TMXMapInfo *mapInfo);
+    Node * parseLayer(TMXLayerInfo *layerInfo, TMXMapInfo *mapInfo);
     TMXTilesetInfo * tilesetForLayer(TMXLayerInfo *layerInfo, TMXMapInfo *mapInfo);
     void buildWithMapInfo(TMXMapInfo* mapInfo);
 
@@ -311,6 +325,8 @@ protected:
     
     //! tile properties
     ValueMapIntKey _tileProperties;
+    //! tilesets, the properties of external tilesets are looked up in their shared source
+    Vector<TMXTilesetInfo*> _tilesets;
 
     std::string _tmxFile;
     int _tmxLayerNum;
@@ -0,0 +1,363 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "2d/CCTMXVirtualLayer.h"
+
+#include <cmath>
+
+#include "2d/CCTMXTiledMap.h"
+#include "2d/CCVirtualTexture.h"
+#include "base/CCConfiguration.h"
+#include "base/CCDirector.h"
+#include "base/ccUTF8.h"
+#include "platform/CCGLView.h"
+#include "renderer/CCGLProgramState.h"
+#include "renderer/CCRenderer.h"
+
+NS_CC_BEGIN
+
+// QuadCommand batches are split so a single command never gets close to the renderer's VBO size.
+static const size_t MAX_QUADS_PER_BATCH = 4096;
+
+TMXVirtualLayer* TMXVirtualLayer::create(TMXTilesetInfo* tilesetInfo, TMXLayerInfo* layerInfo, TMXMapInfo* mapInfo)
+{
+    TMXVirtualLayer* ret = new (std::nothrow) TMXVirtualLayer();
+    if (ret && ret->initWithTilesetInfo(tilesetInfo, layerInfo, mapInfo))
+    {
+        ret->autorelease();
+        return ret;
+    }
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+}
+
+int TMXVirtualLayer::getVirtualTextureThreshold()
+{
+    int maxTextureSize = Configuration::getInstance()->getMaxTextureSize();
+    int fallback = maxTextureSize > 0 ? std::min(4096, maxTextureSize) : 4096;
+    return Configuration::getInstance()->getValue("cocos2d.x.tmx.virtual_texture_threshold", Value(fallback)).asInt();
+}
+
+bool TMXVirtualLayer::shouldUseVirtualTexture(TMXTilesetInfo* tilesetInfo, TMXMapInfo* mapInfo)
+{
+    if (!tilesetInfo || !mapInfo || mapInfo->getOrientation() != TMXOrientationOrtho)
+        return false;
+
+    // The image size comes from the tileset's <image> element; without it we cannot tell.
+    const Size& imageSize = tilesetInfo->_imageSize;
+    int threshold = getVirtualTextureThreshold();
+    if (imageSize.width <= threshold && imageSize.height <= threshold)
+        return false;
+
+    // Every tile must sit inside exactly one page.
+    int tileWidth = (int)tilesetInfo->_tileSize.width;
+    int tileHeight = (int)tilesetInfo->_tileSize.height;
+    return tilesetInfo->_margin == 0 && tilesetInfo->_spacing == 0
+        && tileWidth > 0 && tileHeight > 0
+        && VirtualTexture::DEFAULT_PAGE_SIZE % tileWidth == 0
+        && VirtualTexture::DEFAULT_PAGE_SIZE % tileHeight == 0;
+}
+
+TMXVirtualLayer::TMXVirtualLayer()
+: _layerSize(Size::ZERO)
+, _mapTileSize(Size::ZERO)
+, _tiles(nullptr)
+, _tileSet(nullptr)
+, _layerOpacity(255)
+, _virtualTexture(nullptr)
+, _prefetchMargin((float)VirtualTexture::DEFAULT_PAGE_SIZE / 2)
+, _colorsDirty(true)
+{
+}
+
+TMXVirtualLayer::~TMXVirtualLayer()
+{
+    for (auto batch : _batches)
+    {
+        delete batch;
+    }
+    CC_SAFE_RELEASE(_virtualTexture);
+    CC_SAFE_RELEASE(_tileSet);
+    CC_SAFE_FREE(_tiles);
+}
+
+bool TMXVirtualLayer::initWithTilesetInfo(TMXTilesetInfo* tilesetInfo, TMXLayerInfo* layerInfo, TMXMapInfo* mapInfo)
+{
+    if (!Node::init() || !tilesetInfo)
+        return false;
+
+    _virtualTexture = VirtualTexture::getOrCreate(tilesetInfo->_sourceImage);
+    if (!_virtualTexture)
+        return false;
+    _virtualTexture->retain();
+
+    _layerName = layerInfo->_name;
+    _layerSize = layerInfo->_layerSize;
+    _tiles = layerInfo->_tiles;
+    _layerOpacity = layerInfo->_opacity;
+    setProperties(layerInfo->getProperties());
+
+    _tileSet = tilesetInfo;
+    CC_SAFE_RETAIN(_tileSet);
+
+    _mapTileSize = mapInfo->getTileSize();
+
+    Vec2 offset(layerInfo->_offset.x * _mapTileSize.width, -layerInfo->_offset.y * _mapTileSize.height);
+    setPosition(CC_POINT_PIXELS_TO_POINTS(offset));
+    setContentSize(CC_SIZE_PIXELS_TO_POINTS(Size(_layerSize.width * _mapTileSize.width, _layerSize.height * _mapTileSize.height)));
+
+    setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP));
+
+    buildBatches();
+    return true;
+}
+
+void TMXVirtualLayer::buildBatches()
+{
+    const int pageSize = VirtualTexture::DEFAULT_PAGE_SIZE;
+    const float invPageSize = 1.0f / pageSize;
+    const Size& imageSize = _tileSet->_imageSize;
+    const Size tileSize = CC_SIZE_PIXELS_TO_POINTS(_tileSet->_tileSize);
+
+    // Current (not yet full) batch for each page.
+    std::unordered_map<unsigned int, PageBatch*> openBatches;
+
+    const int width = (int)_layerSize.width;
+    const int height = (int)_layerSize.height;
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            uint32_t gid = _tiles[x + y * width];
+            uint32_t tileId = gid & kTMXFlippedMask;
+            if (tileId == 0 || (int)tileId < _tileSet->_firstGid)
+                continue;
+
+            Rect rect = _tileSet->getRectForGID(gid);
+            if (rect.getMaxX() > imageSize.width || rect.getMaxY() > imageSize.height)
+                continue;
+
+            int pageX = (int)rect.origin.x / pageSize;
+            int pageY = (int)rect.origin.y / pageSize;
+            unsigned int key = ((unsigned int)pageY << 16) | (unsigned int)pageX;
+
+            PageBatch*& batch = openBatches[key];
+            if (!batch || batch->quads.size() >= MAX_QUADS_PER_BATCH)
+            {
+                batch = new PageBatch();
+                batch->pageX = pageX;
+                batch->pageY = pageY;
+                batch->bounds = Rect::ZERO;
+                _batches.push_back(batch);
+            }
+
+            // Texture coordinates inside the page (v grows downwards like the image rows).
+            float left = (rect.origin.x - pageX * pageSize) * invPageSize;
+            float right = left + rect.size.width * invPageSize;
+            float top = (rect.origin.y - pageY * pageSize) * invPageSize;
+            float bottom = top + rect.size.height * invPageSize;
+
+            Tex2F bl(left, bottom), br(right, bottom), tl(left, top), tr(right, top);
+            if (gid & kTMXTileDiagonalFlag)
+            {
+                std::swap(br, tl);
+            }
+            if (gid & kTMXTileHorizontalFlag)
+            {
+                std::swap(bl, br);
+                std::swap(tl, tr);
+            }
+            if (gid & kTMXTileVerticalFlag)
+            {
+                std::swap(bl, tl);
+                std::swap(br, tr);
+            }
+
+            Vec2 pos = CC_POINT_PIXELS_TO_POINTS(Vec2(x * _mapTileSize.width, (height - y - 1) * _mapTileSize.height));
+
+            V3F_C4B_T2F_Quad quad;
+            quad.bl.vertices.set(pos.x, pos.y, 0);
+            quad.br.vertices.set(pos.x + tileSize.width, pos.y, 0);
+            quad.tl.vertices.set(pos.x, pos.y + tileSize.height, 0);
+            quad.tr.vertices.set(pos.x + tileSize.width, pos.y + tileSize.height, 0);
+            quad.bl.texCoords = bl;
+            quad.br.texCoords = br;
+            quad.tl.texCoords = tl;
+            quad.tr.texCoords = tr;
+            batch->quads.push_back(quad);
+
+            Rect tileRect(pos.x, pos.y, tileSize.width, tileSize.height);
+            batch->bounds = batch->bounds.size.equals(Size::ZERO) ? tileRect : batch->bounds.unionWithRect(tileRect);
+        }
+    }
+
+    CCLOG("cocos2d: TMXVirtualLayer '%s': %d page batches", _layerName.c_str(), (int)_batches.size());
+}
+
+uint32_t TMXVirtualLayer::getTileGIDAt(const Vec2& tileCoordinate) const
+{
+    int x = (int)tileCoordinate.x;
+    int y = (int)tileCoordinate.y;
+    if (!_tiles || x < 0 || y < 0 || x >= (int)_layerSize.width || y >= (int)_layerSize.height)
+        return 0;
+    return _tiles[x + y * (int)_layerSize.width] & kTMXFlippedMask;
+}
+
+Value TMXVirtualLayer::getProperty(const std::string& propertyName) const
+{
+    auto iter = _properties.find(propertyName);
+    if (iter != _properties.end())
+        return iter->second;
+    return Value();
+}
+
+void TMXVirtualLayer::updateDisplayedOpacity(GLubyte parentOpacity)
+{
+    Node::updateDisplayedOpacity(parentOpacity);
+    _colorsDirty = true;
+}
+
+void TMXVirtualLayer::updateColors()
+{
+    GLubyte opacity = (GLubyte)(_layerOpacity * _displayedOpacity / 255);
+    Color4B color(255, 255, 255, opacity);
+    if (_virtualTexture->hasPremultipliedAlpha())
+    {
+        color = Color4B(opacity, opacity, opacity, opacity);
+    }
+
+    for (auto batch : _batches)
+    {
+        for (auto& quad : batch->quads)
+        {
+            quad.bl.colors = quad.br.colors = quad.tl.colors = quad.tr.colors = color;
+        }
+        batch->mipQuads.clear();
+    }
+    _colorsDirty = false;
+}
+
+int TMXVirtualLayer::chooseMip(const Mat4& transform) const
+{
+    // Screen pixels covered by one texel of the full-resolution image.
+    float scale = std::sqrt(transform.m[0] * transform.m[0] + transform.m[1] * transform.m[1]);
+    auto glview = Director::getInstance()->getOpenGLView();
+    if (glview)
+    {
+        scale *= glview->getScaleX();
+    }
+    scale /= CC_CONTENT_SCALE_FACTOR();
+
+    int mip = 0;
+    while (scale > 0 && scale < 0.5f && mip < _virtualTexture->getMipCount() - 1)
+    {
+        scale *= 2;
+        ++mip;
+    }
+    return mip;
+}
+
+std::vector<V3F_C4B_T2F_Quad>& TMXVirtualLayer::getQuadsForMip(PageBatch* batch, int mip)
+{
+    if (mip == 0)
+        return batch->quads;
+
+    auto iter = batch->mipQuads.find(mip);
+    if (iter != batch->mipQuads.end())
+        return iter->second;
+
+    // A level-m page covers 2^m level-0 pages, so level-0 coordinates only need an offset and a scale.
+    int span = 1 << mip;
+    float scale = 1.0f / span;
+    float offsetU = (float)(batch->pageX % span) * scale;
+    float offsetV = (float)(batch->pageY % span) * scale;
+
+    std::vector<V3F_C4B_T2F_Quad>& quads = batch->mipQuads[mip];
+    quads = batch->quads;
+    for (auto& quad : quads)
+    {
+        for (V3F_C4B_T2F* vertex : { &quad.bl, &quad.br, &quad.tl, &quad.tr })
+        {
+            vertex->texCoords.u = offsetU + vertex->texCoords.u * scale;
+            vertex->texCoords.v = offsetV + vertex->texCoords.v * scale;
+        }
+    }
+    return quads;
+}
+
+void TMXVirtualLayer::draw(Renderer* renderer, const Mat4& transform, uint32_t flags)
+{
+    if (!_virtualTexture->isReady() || _batches.empty())
+        return;
+
+    if (_colorsDirty)
+    {
+        updateColors();
+    }
+
+    const int mipCount = _virtualTexture->getMipCount();
+    const int wantedMip = chooseMip(transform);
+    const float margin = CC_CONTENT_SCALE_FACTOR() > 0 ? _prefetchMargin / CC_CONTENT_SCALE_FACTOR() : _prefetchMargin;
+    const BlendFunc blend = _virtualTexture->hasPremultipliedAlpha() ? BlendFunc::ALPHA_PREMULTIPLIED : BlendFunc::ALPHA_NON_PREMULTIPLIED;
+
+    for (auto batch : _batches)
+    {
+        // Batches near the screen request their page so it is resident before it scrolls in.
+        Rect area = batch->bounds;
+        area.origin.x -= margin;
+        area.origin.y -= margin;
+        area.size.width += margin * 2;
+        area.size.height += margin * 2;
+
+        Mat4 areaTransform = transform;
+        areaTransform.translate(area.origin.x, area.origin.y, 0);
+        if (!renderer->checkVisibility(areaTransform, area.size))
+            continue;
+
+        Texture2D* texture = _virtualTexture->requestPage(wantedMip, batch->pageX >> wantedMip, batch->pageY >> wantedMip);
+        int mip = wantedMip;
+        while (!texture && ++mip < mipCount)
+        {
+            texture = _virtualTexture->getResidentPage(mip, batch->pageX >> mip, batch->pageY >> mip);
+        }
+        if (!texture)
+            continue;
+
+        Mat4 batchTransform = transform;
+        batchTransform.translate(batch->bounds.origin.x, batch->bounds.origin.y, 0);
+        if (!renderer->checkVisibility(batchTransform, batch->bounds.size))
+            continue;
+
+        auto& quads = getQuadsForMip(batch, mip);
+        batch->command.init(_globalZOrder, texture, getGLProgramState(), blend, quads.data(), (ssize_t)quads.size(), transform, flags);
+        renderer->addCommand(&batch->command);
+    }
+}
+
+std::string TMXVirtualLayer::getDescription() const
+{
+    return StringUtils::format("<TMXVirtualLayer | tag = %d, name = %s, batches = %d>", _tag, _layerName.c_str(), (int)_batches.size());
+}
+
+NS_CC_END
@@ -0,0 +1,141 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef __CCTMX_VIRTUAL_LAYER_H__
+#define __CCTMX_VIRTUAL_LAYER_H__
+
+#include <vector>
+#include <unordered_map>
+
+#include "2d/CCNode.h"
+#include "2d/CCTMXXMLParser.h"
+#include "renderer/CCQuadCommand.h"
+
+NS_CC_BEGIN
+
+class VirtualTexture;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @brief TMXVirtualLayer draws an orthogonal TMX layer whose tileset image is too large for one texture.
+ *
+ * The tileset image is streamed through a VirtualTexture. At load time the tiles are grouped
+ * by the tileset page they sample from; every frame only the groups that intersect the screen
+ * (plus a prefetch margin) request their page, and each resident page is drawn with one
+ * QuadCommand. Groups whose page is still loading are drawn from the nearest coarser mip level
+ * that is resident, so the layer never shows holes once the coarsest level is in.
+ *
+ * TMXTiledMap creates this layer instead of a TMXLayer when shouldUseVirtualTexture() is true.
+ * The layer is read-only: tiles cannot be changed or turned into sprites.
+ */
+class CC_DLL TMXVirtualLayer : public Node
+{
+public:
+    /** Creates a virtual layer. The tiles are copied from the layer info. */
+    static TMXVirtualLayer* create(TMXTilesetInfo* tilesetInfo, TMXLayerInfo* layerInfo, TMXMapInfo* mapInfo);
+
+    /** Whether a layer using this tileset should be streamed.
+     * True for orthogonal maps whose tileset image exceeds the threshold on either side
+     * and whose tiles line up with the page grid (no margin or spacing).
+     */
+    static bool shouldUseVirtualTexture(TMXTilesetInfo* tilesetInfo, TMXMapInfo* mapInfo);
+
+    /** Image edge, in pixels, above which tilesets are streamed.
+     * Reads "cocos2d.x.tmx.virtual_texture_threshold" from Configuration; defaults to
+     * the smaller of 4096 and the GL max texture size.
+     */
+    static int getVirtualTextureThreshold();
+
+    const std::string& getLayerName() const { return _layerName; }
+    void setLayerName(const std::string& layerName) { _layerName = layerName; }
+
+    const Size& getLayerSize() const { return _layerSize; }
+    const Size& getMapTileSize() const { return _mapTileSize; }
+    TMXTilesetInfo* getTileSet() const { return _tileSet; }
+    VirtualTexture* getVirtualTexture() const { return _virtualTexture; }
+    const uint32_t* getTiles() const { return _tiles; }
+
+    /** Returns the tile gid at a given tile coordinate, or 0 if it is empty. */
+    uint32_t getTileGIDAt(const Vec2& tileCoordinate) const;
+
+    /** Returns the layer property for a key. */
+    Value getProperty(const std::string& propertyName) const;
+    ValueMap& getProperties() { return _properties; }
+    void setProperties(const ValueMap& properties) { _properties = properties; }
+
+    /** Extra distance, in layer pixels, around the screen whose pages are loaded ahead of time. */
+    void setPrefetchMargin(float margin) { _prefetchMargin = margin; }
+    float getPrefetchMargin() const { return _prefetchMargin; }
+
+    // Overrides
+    virtual void draw(Renderer* renderer, const Mat4& transform, uint32_t flags) override;
+    virtual void updateDisplayedOpacity(GLubyte parentOpacity) override;
+    virtual std::string getDescription() const override;
+
+CC_CONSTRUCTOR_ACCESS:
+    TMXVirtualLayer();
+    virtual ~TMXVirtualLayer();
+
+    bool initWithTilesetInfo(TMXTilesetInfo* tilesetInfo, TMXLayerInfo* layerInfo, TMXMapInfo* mapInfo);
+
+protected:
+    /** Tiles of this layer that sample the same full-resolution page. */
+    struct PageBatch
+    {
+        int pageX;
+        int pageY;
+        Rect bounds;
+        std::vector<V3F_C4B_T2F_Quad> quads;
+        // The same quads with texture coordinates remapped onto coarser mip pages, built on demand.
+        std::unordered_map<int, std::vector<V3F_C4B_T2F_Quad>> mipQuads;
+        QuadCommand command;
+    };
+
+    void buildBatches();
+    void updateColors();
+    int chooseMip(const Mat4& transform) const;
+    std::vector<V3F_C4B_T2F_Quad>& getQuadsForMip(PageBatch* batch, int mip);
+
+    std::string _layerName;
+    Size _layerSize;
+    Size _mapTileSize;
+    uint32_t* _tiles;
+    TMXTilesetInfo* _tileSet;
+    GLubyte _layerOpacity;
+    ValueMap _properties;
+
+    VirtualTexture* _virtualTexture;
+    std::vector<PageBatch*> _batches;
+    float _prefetchMargin;
+    bool _colorsDirty;
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif // __CCTMX_VIRTUAL_LAYER_H__
@@ -30,6 +30,8 @@ THE SOFTWARE.
 #include "2d/CCTMXXMLParser.h"
 #include <unordered_map>
 #include <sstream>
+#include <algorithm>
+#include <sys/stat.h>
 #include "2d/CCTMXTiledMap.h"
 #include "base/ZipUtils.h"
 #include "base/base64.h"
@@ -75,12 +77,14 @@ TMXTilesetInfo::TMXTilesetInfo()
     ,_spacing(0)
     ,_margin(0)
     ,_imageSize(Size::ZERO)
+    ,_source(nullptr)
 {
 }
 
 TMXTilesetInfo::~TMXTilesetInfo()
 {
     CCLOGINFO("deallocing TMXTilesetInfo: %p", this);
+    CC_SAFE_RELEASE(_source);
 }
 
 Rect TMXTilesetInfo::getRectForGID(uint32_t gid)
@@ -101,6 +105,251 @@ Rect TMXTilesetInfo::getRectForGID(uint32_t gid)
     return rect;
 }
 
+const ValueMap* TMXTilesetInfo::getTileProperties(uint32_t gid) const
+{
+    gid &= kTMXFlippedMask;
+    if (_source == nullptr || gid < (uint32_t)_firstGid)
+        return nullptr;
+    return _source->getTileProperties((int)(gid - _firstGid));
+}
+
+// implementation TMXTilesetSource
+
+static std::unordered_map<std::string, TMXTilesetSource*> s_tilesetSources;
+
+// Modification time and size of a file, used to tell when a cached tileset is stale.
+// Files that cannot be stat'ed (e.g. inside the Android apk) only use the size.
+static long long getFileStamp(const std::string& fullPath)
+{
+    struct stat statBuf;
+    if (stat(fullPath.c_str(), &statBuf) == 0)
+    {
+        return ((long long)statBuf.st_mtime << 24) ^ (long long)statBuf.st_size;
+    }
+    return FileUtils::getInstance()->getFileSize(fullPath);
+}
+
+TMXTilesetSource* TMXTilesetSource::getOrLoad(const std::string& fullPath)
+{
+    long long stamp = getFileStamp(fullPath);
+
+    auto it = s_tilesetSources.find(fullPath);
+    if (it != s_tilesetSources.end())
+    {
+        if (it->second->_stamp == stamp)
+        {
+            return it->second;
+        }
+        CCLOG("cocos2d: TMXTilesetSource: %s changed, parsing it again", fullPath.c_str());
+        it->second->release();
+        s_tilesetSources.erase(it);
+    }
+
+    TMXTilesetSource* source = new (std::nothrow) TMXTilesetSource();
+    if (source == nullptr || !source->parse(fullPath))
+    {
+        CC_SAFE_DELETE(source);
+        return nullptr;
+    }
+    source->_stamp = stamp;
+    s_tilesetSources[fullPath] = source;
+    return source;
+}
+
+void TMXTilesetSource::purgeCache()
+{
+    for (auto& item : s_tilesetSources)
+    {
+        item.second->release();
+    }
+    s_tilesetSources.clear();
+}
+
+TMXTilesetSource::TMXTilesetSource()
+: _stamp(0)
+, _prototype(nullptr)
+, _currentTile(-1)
+, _ignoreDepth(0)
+{
+}
+
+TMXTilesetSource::~TMXTilesetSource()
+{
+    CCLOGINFO("deallocing TMXTilesetSource: %p", this);
+    CC_SAFE_RELEASE(_prototype);
+}
+
+bool TMXTilesetSource::parse(const std::string& fullPath)
+{
+    SAXParser parser;
+    if (false == parser.init("UTF-8"))
+    {
+        return false;
+    }
+
+    _fullPath = fullPath;
+    parser.setDelegator(this);
+    bool ret = parser.parse(fullPath) && _prototype != nullptr;
+
+    // drop the parse state, only the tables are needed from now on
+    _propertySetIndex.clear();
+    _currentProperties.clear();
+    return ret;
+}
+
+TMXTilesetInfo* TMXTilesetSource::createTilesetInfo(int firstGid)
+{
+    TMXTilesetInfo* tileset = new (std::nothrow) TMXTilesetInfo();
+    tileset->_name = _prototype->_name;
+    tileset->_firstGid = firstGid;
+    tileset->_tileSize = _prototype->_tileSize;
+    tileset->_spacing = _prototype->_spacing;
+    tileset->_margin = _prototype->_margin;
+    tileset->_tileOffset = _prototype->_tileOffset;
+    tileset->_sourceImage = _prototype->_sourceImage;
+    tileset->_imageSize = _prototype->_imageSize;
+    tileset->_originSourceImage = _prototype->_originSourceImage;
+    tileset->_source = this;
+    this->retain();
+    tileset->autorelease();
+    return tileset;
+}
+
+const ValueMap* TMXTilesetSource::getTileProperties(int tileId) const
+{
+    if (tileId < 0 || tileId >= (int)_tilePropertyIndex.size())
+        return nullptr;
+    int index = _tilePropertyIndex[tileId];
+    return index < 0 ? nullptr : &_propertySets[index];
+}
+
+void TMXTilesetSource::commitTile()
+{
+    if (_currentTile < 0 || _currentProperties.empty())
+        return;
+
+    // tiles with the same properties (e.g. thousands of "solid" tiles) share one entry
+    std::vector<std::pair<std::string, std::string>> sorted;
+    sorted.reserve(_currentProperties.size());
+    for (const auto& item : _currentProperties)
+    {
+        sorted.emplace_back(item.first, item.second.asString());
+    }
+    std::sort(sorted.begin(), sorted.end());
+    std::string key;
+    for (const auto& item : sorted)
+    {
+        key += item.first;
+        key += '\0';
+        key += item.second;
+        key += '\n';
+    }
+
+    int index;
+    auto it = _propertySetIndex.find(key);
+    if (it != _propertySetIndex.end())
+    {
+        index = it->second;
+    }
+    else
+    {
+        index = (int)_propertySets.size();
+        _propertySets.push_back(_currentProperties);
+        _propertySetIndex.emplace(key, index);
+    }
+
+    if (_currentTile >= (int)_tilePropertyIndex.size())
+    {
+        _tilePropertyIndex.resize(_currentTile + 1, -1);
+    }
+    _tilePropertyIndex[_currentTile] = index;
+}
+
+void TMXTilesetSource::startElement(void* /*ctx*/, const char *name, const char **atts)
+{
+    std::string elementName = name;
+
+    // per-tile collision shapes and animations are not used by the map
+    if (_ignoreDepth > 0 || elementName == "objectgroup" || elementName == "animation")
+    {
+        _ignoreDepth++;
+        return;
+    }
+
+    ValueMap attributeDict;
+    if (atts && atts[0])
+    {
+        for (int i = 0; atts[i]; i += 2)
+        {
+            attributeDict.emplace(atts[i], Value(atts[i+1]));
+        }
+    }
+
+    if (elementName == "tileset")
+    {
+        CC_SAFE_RELEASE(_prototype);
+        _prototype = new (std::nothrow) TMXTilesetInfo();
+        _prototype->_name = attributeDict["name"].asString();
+        _prototype->_spacing = attributeDict["spacing"].asInt();
+        _prototype->_margin = attributeDict["margin"].asInt();
+        _prototype->_tileSize = Size(attributeDict["tilewidth"].asFloat(), attributeDict["tileheight"].asFloat());
+
+        int tileCount = attributeDict["tilecount"].asInt();
+        _tilePropertyIndex.assign(tileCount > 0 ? tileCount : 0, -1);
+    }
+    else if (_prototype == nullptr)
+    {
+        return;
+    }
+    else if (elementName == "tileoffset")
+    {
+        _prototype->_tileOffset = Vec2(attributeDict["x"].asFloat(), attributeDict["y"].asFloat());
+    }
+    else if (elementName == "image")
+    {
+        std::string imagename = attributeDict["source"].asString();
+        _prototype->_originSourceImage = imagename;
+        _prototype->_imageSize = Size(attributeDict["width"].asFloat(), attributeDict["height"].asFloat());
+        _prototype->_sourceImage = _fullPath.substr(0, _fullPath.find_last_of('/') + 1) + imagename;
+    }
+    else if (elementName == "tile")
+    {
+        _currentTile = attributeDict["id"].asInt();
+        _currentProperties.clear();
+    }
+    else if (elementName == "property")
+    {
+        if (_currentTile >= 0)
+        {
+            _currentProperties[attributeDict["name"].asString()] = attributeDict["value"];
+        }
+        else
+        {
+            _properties[attributeDict["name"].asString()] = attributeDict["value"];
+        }
+    }
+}
+
+void TMXTilesetSource::endElement(void* /*ctx*/, const char *name)
+{
+    if (_ignoreDepth > 0)
+    {
+        _ignoreDepth--;
+        return;
+    }
+
+    if (strcmp(name, "tile") == 0)
+    {
+        commitTile();
+        _currentTile = -1;
+        _currentProperties.clear();
+    }
+}
+
+void TMXTilesetSource::textHandler(void* /*ctx*/, const char* /*ch*/, size_t /*len*/)
+{
+}
+
 // implementation TMXMapInfo
 
 TMXMapInfo * TMXMapInfo::create(const std::string& tmxFile)
@@ -314,9 +563,24 @@ void TMXMapInfo::startElement(void* /*ctx*/, const char *name, const char **atts
             {
                 _currentFirstGID = 0;
             }
-            _recordFirstGID = false;
             _externalTilesetFullPath = externalTilesetFilename;
-            tmxMapInfo->parseXMLFile(externalTilesetFilename);
+
+            // Tilesets are parsed once per process and shared by every map that uses them
+            TMXTilesetSource* source = TMXTilesetSource::getOrLoad(externalTilesetFilename);
+            if (source)
+            {
+                tmxMapInfo->getTilesets().pushBack(source->createTilesetInfo(_currentFirstGID));
+                _currentFirstGID = 0;
+                for (const auto& property : source->getProperties())
+                {
+                    tmxMapInfo->getProperties().emplace(property.first, property.second);
+                }
+            }
+            else
+            {
+                _recordFirstGID = false;
+                tmxMapInfo->parseXMLFile(externalTilesetFilename);
+            }
         }
         else
         {
@@ -432,6 +696,9 @@ void TMXMapInfo::startElement(void* /*ctx*/, const char *name, const char **atts
         std::string imagename = attributeDict["source"].asString();
         tileset->_originSourceImage = imagename;
 
+        // Declared image size; TMXLayer replaces it with the texture size, TMXVirtualLayer needs it up front
+        tileset->_imageSize = Size(attributeDict["width"].asFloat(), attributeDict["height"].asFloat());
+
         if (!_externalTilesetFullPath.empty())
         {
             string dir = _externalTilesetFullPath.substr(0, _externalTilesetFullPath.find_last_of('/') + 1);
@@ -39,11 +39,14 @@ THE SOFTWARE.
 #include "2d/CCTMXObjectGroup.h" // needed for Vector<TMXObjectGroup*> for binding
 
 #include <string>
+#include <vector>
+#include <unordered_map>
 
 NS_CC_BEGIN
 
 class TMXLayerInfo;
 class TMXTilesetInfo;
+class TMXTilesetSource;
 
 /** @file
 * Internal TMX parser
@@ -143,6 +146,8 @@ public:
     //! size in pixels of the image
     Size            _imageSize;
     std::string     _originSourceImage;
+    //! parsed external tileset this info was created from, nullptr for inline tilesets
+    TMXTilesetSource* _source;
 
 public:
     /**
@@ -155,6 +160,78 @@ public:
      */
     virtual ~TMXTilesetInfo();
     Rect getRectForGID(uint32_t gid);
+    /** Properties of a tile of an external tileset, or nullptr if it has none (or the tileset is inline) */
+    const ValueMap* getTileProperties(uint32_t gid) const;
+};
+
+/** @brief TMXTilesetSource is an external tileset (.tsx) parsed once and shared by every map that uses it.
+
+Tile properties are stored in a flat table indexed by the local tile id, and tiles with identical
+properties share one ValueMap. Sources are cached per full path and parsed again only when the
+file's modification time or size changes.
+*/
+class CC_DLL TMXTilesetSource : public Ref, public SAXDelegator
+{
+public:
+    /** Returns the parsed tileset for a full path, parsing it if it is not cached or has changed. */
+    static TMXTilesetSource* getOrLoad(const std::string& fullPath);
+    /** Removes all cached tilesets. Maps that are alive keep the ones they use. */
+    static void purgeCache();
+
+    /** Creates the tileset info of a map that references this tileset at firstGid. */
+    TMXTilesetInfo* createTilesetInfo(int firstGid);
+
+    /** Properties of a tile, or nullptr if the tile has none */
+    const ValueMap* getTileProperties(int tileId) const;
+    /** Properties set on the tileset element itself */
+    const ValueMap& getProperties() const { return _properties; }
+    const std::string& getFullPath() const { return _fullPath; }
+
+    /**
+     * @js NA
+     * @lua NA
+     */
+    TMXTilesetSource();
+    /**
+     * @js NA
+     * @lua NA
+     */
+    virtual ~TMXTilesetSource();
+
+    // implement pure virtual methods of SAXDelegator
+    /**
+     * @js NA
+     * @lua NA
+     */
+    void startElement(void *ctx, const char *name, const char **atts) override;
+    /**
+     * @js NA
+     * @lua NA
+     */
+    void endElement(void *ctx, const char *name) override;
+    /**
+     * @js NA
+     * @lua NA
+     */
+    void textHandler(void *ctx, const char *ch, size_t len) override;
+
+protected:
+    bool parse(const std::string& fullPath);
+    void commitTile();
+
+    std::string _fullPath;
+    long long _stamp;
+    TMXTilesetInfo* _prototype;
+    ValueMap _properties;
+    // local tile id -> index in _propertySets, -1 if the tile has no properties
+    std::vector<int> _tilePropertyIndex;
+    std::vector<ValueMap> _propertySets;
+
+    // parse state
+    std::unordered_map<std::string, int> _propertySetIndex;
+    int _currentTile;
+    ValueMap _currentProperties;
+    int _ignoreDepth;
 };
 
 /** @brief TMXMapInfo contains the information about the map like:
@@ -0,0 +1,447 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "2d/CCVirtualTexture.h"
+
+#include <zlib.h>
+#include <vector>
+
+#include "base/CCAsyncTaskPool.h"
+#include "base/CCDirector.h"
+#include "base/CCScheduler.h"
+#include "base/ccUTF8.h"
+#include "platform/CCFileUtils.h"
+#include "platform/CCImage.h"
+#include "renderer/CCTexture2D.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    const int VT_FORMAT_VERSION = 1;
+    const char* VT_MANIFEST = "manifest";
+
+    std::unordered_map<std::string, VirtualTexture*> s_virtualTextures;
+
+    struct ManifestInfo
+    {
+        long sourceSize;
+        int width;
+        int height;
+        int pageSize;
+        int mipCount;
+        int premultiplied;
+    };
+
+    std::string pageFileName(int mip, int x, int y)
+    {
+        return StringUtils::format("%d_%d_%d.page", mip, x, y);
+    }
+
+    bool readManifest(const std::string& path, ManifestInfo& info)
+    {
+        std::string text = FileUtils::getInstance()->getStringFromFile(path);
+        int version = 0;
+        if (text.empty()
+            || sscanf(text.c_str(), "VT %d %ld %d %d %d %d %d", &version, &info.sourceSize, &info.width, &info.height,
+                      &info.pageSize, &info.mipCount, &info.premultiplied) != 7)
+        {
+            return false;
+        }
+        return version == VT_FORMAT_VERSION;
+    }
+
+    // Expands the decoded image into a tightly packed RGBA8888 buffer.
+    bool copyToRGBA(Image* image, std::vector<unsigned char>& out)
+    {
+        const int width = image->getWidth();
+        const int height = image->getHeight();
+        const unsigned char* src = image->getData();
+        out.resize((size_t)width * height * 4);
+
+        switch (image->getRenderFormat())
+        {
+        case Texture2D::PixelFormat::RGBA8888:
+            memcpy(out.data(), src, out.size());
+            return true;
+        case Texture2D::PixelFormat::RGB888:
+            for (size_t i = 0, n = (size_t)width * height; i < n; ++i)
+            {
+                out[i * 4 + 0] = src[i * 3 + 0];
+                out[i * 4 + 1] = src[i * 3 + 1];
+                out[i * 4 + 2] = src[i * 3 + 2];
+                out[i * 4 + 3] = 255;
+            }
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // 2x2 box filter; odd edges reuse the last row / column.
+    void downsample(const std::vector<unsigned char>& src, int width, int height,
+                    std::vector<unsigned char>& dst, int& outWidth, int& outHeight)
+    {
+        outWidth = std::max(1, (width + 1) / 2);
+        outHeight = std::max(1, (height + 1) / 2);
+        dst.resize((size_t)outWidth * outHeight * 4);
+
+        for (int y = 0; y < outHeight; ++y)
+        {
+            int y0 = std::min(y * 2, height - 1);
+            int y1 = std::min(y * 2 + 1, height - 1);
+            for (int x = 0; x < outWidth; ++x)
+            {
+                int x0 = std::min(x * 2, width - 1);
+                int x1 = std::min(x * 2 + 1, width - 1);
+                const unsigned char* p00 = &src[((size_t)y0 * width + x0) * 4];
+                const unsigned char* p01 = &src[((size_t)y0 * width + x1) * 4];
+                const unsigned char* p10 = &src[((size_t)y1 * width + x0) * 4];
+                const unsigned char* p11 = &src[((size_t)y1 * width + x1) * 4];
+                unsigned char* d = &dst[((size_t)y * outWidth + x) * 4];
+                for (int c = 0; c < 4; ++c)
+                {
+                    d[c] = (unsigned char)((p00[c] + p01[c] + p10[c] + p11[c] + 2) / 4);
+                }
+            }
+        }
+    }
+
+    // Pages are always pageSize x pageSize; the part outside the image is transparent.
+    bool writePage(const std::vector<unsigned char>& level, int width, int height,
+                   int pageX, int pageY, int pageSize, const std::string& path)
+    {
+        std::vector<unsigned char> page((size_t)pageSize * pageSize * 4, 0);
+        int originX = pageX * pageSize;
+        int originY = pageY * pageSize;
+        int copyWidth = std::min(pageSize, width - originX);
+        int copyHeight = std::min(pageSize, height - originY);
+        for (int row = 0; row < copyHeight; ++row)
+        {
+            memcpy(&page[(size_t)row * pageSize * 4],
+                   &level[((size_t)(originY + row) * width + originX) * 4],
+                   (size_t)copyWidth * 4);
+        }
+
+        uLongf compressedSize = compressBound((uLong)page.size());
+        unsigned char* compressed = (unsigned char*)malloc(compressedSize);
+        if (!compressed || compress2(compressed, &compressedSize, page.data(), (uLong)page.size(), Z_BEST_SPEED) != Z_OK)
+        {
+            free(compressed);
+            return false;
+        }
+
+        Data data;
+        data.fastSet(compressed, (ssize_t)compressedSize);
+        return FileUtils::getInstance()->writeDataToFile(data, path);
+    }
+}
+
+VirtualTexture* VirtualTexture::getOrCreate(const std::string& imagePath, int pageSize)
+{
+    auto iter = s_virtualTextures.find(imagePath);
+    if (iter != s_virtualTextures.end() && iter->second->_pageSize == pageSize)
+    {
+        return iter->second;
+    }
+
+    auto ret = new (std::nothrow) VirtualTexture();
+    if (ret && ret->init(imagePath, pageSize))
+    {
+        ret->autorelease();
+        return ret;
+    }
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+}
+
+VirtualTexture::VirtualTexture()
+: _pageSize(DEFAULT_PAGE_SIZE)
+, _mipCount(0)
+, _premultipliedAlpha(false)
+, _ready(false)
+, _broken(false)
+, _maxResidentPages(DEFAULT_MAX_RESIDENT_PAGES)
+{
+}
+
+VirtualTexture::~VirtualTexture()
+{
+    for (auto& pair : _pages)
+    {
+        pair.second.texture->release();
+    }
+
+    auto iter = s_virtualTextures.find(_imagePath);
+    if (iter != s_virtualTextures.end() && iter->second == this)
+    {
+        s_virtualTextures.erase(iter);
+    }
+}
+
+bool VirtualTexture::init(const std::string& imagePath, int pageSize)
+{
+    CCASSERT(pageSize > 0 && (pageSize & (pageSize - 1)) == 0, "VirtualTexture: page size must be a power of two");
+
+    auto fileUtils = FileUtils::getInstance();
+    _fullPath = fileUtils->fullPathForFilename(imagePath);
+    if (_fullPath.empty())
+    {
+        return false;
+    }
+    _imagePath = imagePath;
+    _pageSize = pageSize;
+    s_virtualTextures[imagePath] = this;
+
+    // A pre-split directory shipped with the image wins over the runtime cache.
+    std::string bundled = _fullPath + ".vt/";
+    if (fileUtils->isFileExist(bundled + VT_MANIFEST))
+    {
+        _pageDir = bundled;
+    }
+    else
+    {
+        size_t hash = std::hash<std::string>()(_fullPath);
+        _pageDir = StringUtils::format("%svtcache/%zx_%d/", fileUtils->getWritablePath().c_str(), hash, pageSize);
+    }
+
+    ManifestInfo info;
+    if (readManifest(_pageDir + VT_MANIFEST, info)
+        && info.pageSize == pageSize
+        && (_pageDir == bundled || info.sourceSize == fileUtils->getFileSize(_fullPath)))
+    {
+        onBuildFinished(true, Size((float)info.width, (float)info.height), info.mipCount, info.premultiplied != 0);
+    }
+    else
+    {
+        startBuild();
+    }
+    return true;
+}
+
+void VirtualTexture::getPageGrid(int mip, int* cols, int* rows) const
+{
+    int width = (int)_imageSize.width;
+    int height = (int)_imageSize.height;
+    for (int i = 0; i < mip; ++i)
+    {
+        width = std::max(1, (width + 1) / 2);
+        height = std::max(1, (height + 1) / 2);
+    }
+    *cols = (width + _pageSize - 1) / _pageSize;
+    *rows = (height + _pageSize - 1) / _pageSize;
+}
+
+void VirtualTexture::startBuild()
+{
+    CCLOG("cocos2d: VirtualTexture: splitting %s into %dpx pages", _imagePath.c_str(), _pageSize);
+
+    std::string fullPath = _fullPath;
+    std::string pageDir = _pageDir;
+    int pageSize = _pageSize;
+
+    // Keep this object alive until the result is back on the cocos thread.
+    retain();
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_OTHER, [this, fullPath, pageDir, pageSize]() {
+        auto fileUtils = FileUtils::getInstance();
+        bool ok = false;
+        int width = 0;
+        int height = 0;
+        int mipCount = 0;
+        bool premultiplied = false;
+
+        std::vector<unsigned char> level;
+        Image* image = new (std::nothrow) Image();
+        if (image && image->initWithImageFileThreadSafe(fullPath) && copyToRGBA(image, level))
+        {
+            width = image->getWidth();
+            height = image->getHeight();
+            premultiplied = image->hasPremultipliedAlpha();
+        }
+        CC_SAFE_DELETE(image);
+
+        if (!level.empty() && fileUtils->createDirectory(pageDir))
+        {
+            ok = true;
+            int levelWidth = width;
+            int levelHeight = height;
+            std::vector<unsigned char> next;
+            while (ok)
+            {
+                int cols = (levelWidth + pageSize - 1) / pageSize;
+                int rows = (levelHeight + pageSize - 1) / pageSize;
+                for (int y = 0; y < rows && ok; ++y)
+                {
+                    for (int x = 0; x < cols && ok; ++x)
+                    {
+                        ok = writePage(level, levelWidth, levelHeight, x, y, pageSize, pageDir + pageFileName(mipCount, x, y));
+                    }
+                }
+                ++mipCount;
+
+                if (cols == 1 && rows == 1)
+                    break;
+
+                downsample(level, levelWidth, levelHeight, next, levelWidth, levelHeight);
+                level.swap(next);
+            }
+        }
+
+        // The manifest is written last, so an interrupted split is redone next time.
+        if (ok)
+        {
+            std::string manifest = StringUtils::format("VT %d %ld %d %d %d %d %d\n", VT_FORMAT_VERSION,
+                fileUtils->getFileSize(fullPath), width, height, pageSize, mipCount, premultiplied ? 1 : 0);
+            ok = fileUtils->writeStringToFile(manifest, pageDir + VT_MANIFEST);
+        }
+
+        Director::getInstance()->getScheduler()->performFunctionInCocosThread([this, ok, width, height, mipCount, premultiplied]() {
+            onBuildFinished(ok, Size((float)width, (float)height), mipCount, premultiplied);
+            release();
+        });
+    });
+}
+
+void VirtualTexture::onBuildFinished(bool ok, const Size& imageSize, int mipCount, bool premultiplied)
+{
+    if (!ok)
+    {
+        CCLOG("cocos2d: VirtualTexture: failed to split %s", _imagePath.c_str());
+        _broken = true;
+        return;
+    }
+
+    _imageSize = imageSize;
+    _mipCount = mipCount;
+    _premultipliedAlpha = premultiplied;
+    _ready = true;
+
+    // The coarsest level is a single page and stays resident as the fallback.
+    loadPage(makeKey(_mipCount - 1, 0, 0));
+}
+
+Texture2D* VirtualTexture::requestPage(int mip, int x, int y)
+{
+    if (!_ready || mip < 0 || mip >= _mipCount)
+        return nullptr;
+
+    unsigned int key = makeKey(mip, x, y);
+    auto iter = _pages.find(key);
+    if (iter != _pages.end())
+    {
+        iter->second.lastUsedFrame = Director::getInstance()->getTotalFrames();
+        return iter->second.texture;
+    }
+
+    if (_loading.find(key) == _loading.end())
+    {
+        loadPage(key);
+    }
+    return nullptr;
+}
+
+Texture2D* VirtualTexture::getResidentPage(int mip, int x, int y) const
+{
+    auto iter = _pages.find(makeKey(mip, x, y));
+    return iter != _pages.end() ? iter->second.texture : nullptr;
+}
+
+void VirtualTexture::loadPage(unsigned int key)
+{
+    int mip = (int)(key >> 24);
+    int y = (int)((key >> 12) & 0xFFF);
+    int x = (int)(key & 0xFFF);
+    std::string path = _pageDir + pageFileName(mip, x, y);
+    size_t pixelsSize = (size_t)_pageSize * _pageSize * 4;
+
+    _loading.insert(key);
+    retain();
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_OTHER, [this, key, path, pixelsSize]() {
+        unsigned char* pixels = nullptr;
+        Data data = FileUtils::getInstance()->getDataFromFile(path);
+        if (!data.isNull())
+        {
+            pixels = (unsigned char*)malloc(pixelsSize);
+            uLongf outSize = (uLongf)pixelsSize;
+            if (pixels && (uncompress(pixels, &outSize, data.getBytes(), (uLong)data.getSize()) != Z_OK || outSize != pixelsSize))
+            {
+                free(pixels);
+                pixels = nullptr;
+            }
+        }
+
+        Director::getInstance()->getScheduler()->performFunctionInCocosThread([this, key, pixels]() {
+            onPageLoaded(key, pixels);
+            free(pixels);
+            release();
+        });
+    });
+}
+
+void VirtualTexture::onPageLoaded(unsigned int key, unsigned char* pixels)
+{
+    _loading.erase(key);
+    if (!pixels)
+    {
+        CCLOG("cocos2d: VirtualTexture: failed to load page %u of %s", key, _imagePath.c_str());
+        return;
+    }
+
+    auto texture = new (std::nothrow) Texture2D();
+    if (!texture)
+        return;
+    texture->initWithData(pixels, (ssize_t)_pageSize * _pageSize * 4, Texture2D::PixelFormat::RGBA8888,
+                          _pageSize, _pageSize, Size((float)_pageSize, (float)_pageSize));
+    // Tiles sit edge to edge inside a page; linear filtering would bleed neighbours in.
+    texture->setAliasTexParameters();
+
+    _pages[key] = Page{ texture, Director::getInstance()->getTotalFrames() };
+    evictPages();
+}
+
+void VirtualTexture::evictPages()
+{
+    unsigned int currentFrame = Director::getInstance()->getTotalFrames();
+    unsigned int pinnedKey = makeKey(_mipCount - 1, 0, 0);
+
+    while ((int)_pages.size() > _maxResidentPages)
+    {
+        auto victim = _pages.end();
+        for (auto iter = _pages.begin(); iter != _pages.end(); ++iter)
+        {
+            if (iter->first == pinnedKey || iter->second.lastUsedFrame >= currentFrame)
+                continue;
+            if (victim == _pages.end() || iter->second.lastUsedFrame < victim->second.lastUsedFrame)
+                victim = iter;
+        }
+        // Everything left is in use this frame; allow a temporary overshoot.
+        if (victim == _pages.end())
+            break;
+
+        victim->second.texture->release();
+        _pages.erase(victim);
+    }
+}
+
+NS_CC_END
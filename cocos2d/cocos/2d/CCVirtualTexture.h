@@ -0,0 +1,148 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef __CC_VIRTUAL_TEXTURE_H__
+#define __CC_VIRTUAL_TEXTURE_H__
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "base/CCRef.h"
+#include "math/CCGeometry.h"
+
+NS_CC_BEGIN
+
+class Texture2D;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @brief VirtualTexture streams an image that is too large to keep in one texture.
+ *
+ * The source image is split into fixed-size square pages, together with a mip chain
+ * that ends at a level fitting into a single page. The split is done once, on a
+ * worker thread, and the pages are stored zlib-compressed in the writable path
+ * (a pre-split "<image>.vt/" directory next to the image is used instead if it exists).
+ *
+ * At runtime only the pages that are requested are inflated (on a worker thread) and
+ * uploaded as small textures. Resident pages are kept in an LRU cache with a fixed
+ * capacity, so the VRAM used by the image stays constant no matter how large it is.
+ * The coarsest mip level is always resident and can be used as a fallback while finer
+ * pages are loading.
+ *
+ * Instances are shared per image path; use VirtualTexture::getOrCreate().
+ */
+class CC_DLL VirtualTexture : public Ref
+{
+public:
+    /** Default page edge, in pixels. */
+    static const int DEFAULT_PAGE_SIZE = 512;
+    /** Default number of resident pages. */
+    static const int DEFAULT_MAX_RESIDENT_PAGES = 24;
+
+    /** Returns the virtual texture for an image, creating it if needed.
+     *
+     * @param imagePath The source image.
+     * @param pageSize Page edge in pixels. Must be a power of two.
+     * @return An autoreleased object, or nullptr if the image does not exist.
+     */
+    static VirtualTexture* getOrCreate(const std::string& imagePath, int pageSize = DEFAULT_PAGE_SIZE);
+
+    /** Whether the page files are available. Pages can only be requested once this is true. */
+    bool isReady() const { return _ready; }
+
+    /** Whether building the page files failed. */
+    bool isBroken() const { return _broken; }
+
+    const std::string& getImagePath() const { return _imagePath; }
+    int getPageSize() const { return _pageSize; }
+    int getMipCount() const { return _mipCount; }
+    /** Size of the source image in pixels (valid once ready). */
+    const Size& getImageSize() const { return _imageSize; }
+    bool hasPremultipliedAlpha() const { return _premultipliedAlpha; }
+
+    /** Number of page columns and rows at a mip level (valid once ready). */
+    void getPageGrid(int mip, int* cols, int* rows) const;
+
+    /** Marks a page as used in the current frame and starts loading it if it is not resident.
+     *
+     * @param mip Mip level, 0 is the full resolution.
+     * @param x Page column at that level.
+     * @param y Page row at that level (0 is the top of the image).
+     * @return The page texture, or nullptr if it is not resident yet.
+     */
+    Texture2D* requestPage(int mip, int x, int y);
+
+    /** Returns the page texture if it is resident, without touching or loading it. */
+    Texture2D* getResidentPage(int mip, int x, int y) const;
+
+    /** Sets the LRU capacity. Pages used in the current frame are never evicted. */
+    void setMaxResidentPages(int count) { _maxResidentPages = count; }
+    int getMaxResidentPages() const { return _maxResidentPages; }
+    int getResidentPageCount() const { return (int)_pages.size(); }
+
+CC_CONSTRUCTOR_ACCESS:
+    VirtualTexture();
+    virtual ~VirtualTexture();
+
+    bool init(const std::string& imagePath, int pageSize);
+
+protected:
+    struct Page
+    {
+        Texture2D* texture;
+        unsigned int lastUsedFrame;
+    };
+
+    static unsigned int makeKey(int mip, int x, int y) { return ((unsigned int)mip << 24) | ((unsigned int)y << 12) | (unsigned int)x; }
+
+    void startBuild();
+    void onBuildFinished(bool ok, const Size& imageSize, int mipCount, bool premultiplied);
+    void loadPage(unsigned int key);
+    void onPageLoaded(unsigned int key, unsigned char* pixels);
+    void evictPages();
+
+    std::string _imagePath;
+    std::string _fullPath;
+    std::string _pageDir;
+    int _pageSize;
+    int _mipCount;
+    Size _imageSize;
+    bool _premultipliedAlpha;
+    bool _ready;
+    bool _broken;
+    int _maxResidentPages;
+
+    std::unordered_map<unsigned int, Page> _pages;
+    std::unordered_set<unsigned int> _loading;
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif // __CC_VIRTUAL_TEXTURE_H__
@@ -64,6 +64,7 @@ cocos2d.cpp \
 2d/CCNode.cpp \
 2d/CCNodeGrid.cpp \
 2d/CCParallaxNode.cpp \
+2d/CCSpatialNode.cpp \
 2d/CCParticleBatchNode.cpp \
 2d/CCParticleExamples.cpp \
 2d/CCParticleSystem.cpp \
@@ -76,10 +77,14 @@ cocos2d.cpp \
 2d/CCSpriteBatchNode.cpp \
 2d/CCSpriteFrame.cpp \
 2d/CCSpriteFrameCache.cpp \
+2d/CCSpriteSheetData.cpp \
+2d/CCFrameStatsOverlay.cpp \
 2d/CCTMXLayer.cpp \
 2d/CCTMXObjectGroup.cpp \
 2d/CCTMXTiledMap.cpp \
+2d/CCTMXVirtualLayer.cpp \
 2d/CCTMXXMLParser.cpp \
+2d/CCVirtualTexture.cpp \
 2d/CCTextFieldTTF.cpp \
 2d/CCTileMapAtlas.cpp \
 2d/CCTransition.cpp \
@@ -91,6 +96,7 @@ cocos2d.cpp \
 3d/CCPlane.cpp \
 platform/CCDataManager.cpp \
 platform/CCFileUtils.cpp \
+platform/CCPackedArchive.cpp \
 platform/CCGLView.cpp \
 platform/CCImage.cpp \
 platform/CCSAXParser.cpp \
@@ -136,9 +142,11 @@ base/CCEventTouch.cpp \
 base/CCIMEDispatcher.cpp \
 base/CCNS.cpp \
 base/CCProfiling.cpp \
+base/CCFramePacer.cpp \
 base/CCProperties.cpp \
 base/CCRef.cpp \
 base/CCScheduler.cpp \
+base/CCFrameStats.cpp \
 base/CCScriptSupport.cpp \
 base/CCTouch.cpp \
 base/CCUserDefault-android.cpp \
@@ -150,6 +158,7 @@ base/ZipUtils.cpp \
 base/allocator/CCAllocatorDiagnostics.cpp \
 base/allocator/CCAllocatorGlobal.cpp \
 base/allocator/CCAllocatorGlobalNewDelete.cpp \
+base/allocator/CCAllocatorTypePool.cpp \
 base/atitc.cpp \
 base/base64.cpp \
 base/ccCArray.cpp \
@@ -181,6 +190,7 @@ renderer/CCTechnique.cpp \
 renderer/CCTexture2D.cpp \
 renderer/CCTextureAtlas.cpp \
 renderer/CCTextureCache.cpp \
+renderer/CCTextureFormatPolicy.cpp \
 renderer/CCTextureCube.cpp \
 renderer/CCTrianglesCommand.cpp \
 renderer/CCVertexAttribBinding.cpp \
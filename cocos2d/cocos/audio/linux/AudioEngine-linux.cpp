@@ -93,8 +93,13 @@ bool AudioEngineImpl::init()
     result = pSystem->init(32, FMOD_INIT_NORMAL, 0);
     ERRCHECKWITHEXIT(result);
 
+    // keep per-stream memory small, long tracks are read from disk on FMOD's stream thread
+    result = pSystem->setStreamBufferSize(AUDIO_STREAM_FILE_BUFFER_SIZE, FMOD_TIMEUNIT_RAWBYTES);
+    ERRCHECKWITHEXIT(result);
+
     mapChannelInfo.clear();
     mapSound.clear();
+    pendingPreloads.clear();
 
     auto scheduler = cocos2d::Director::getInstance()->getScheduler();
     scheduler->schedule(schedule_selector(AudioEngineImpl::update), this, 0.05f, false);
@@ -109,7 +114,9 @@ int AudioEngineImpl::play2d(const std::string &fileFullPath, bool loop, float vo
     int id = preload(fileFullPath, nullptr);
     if (id >= 0) {
         mapChannelInfo[id].loop=loop;
-        mapChannelInfo[id].channel->setPaused(true);
+        if (mapChannelInfo[id].channel) {
+            mapChannelInfo[id].channel->setPaused(true);
+        }
         mapChannelInfo[id].volume = volume;
         AudioEngine::_audioIDInfoMap[id].state = AudioEngine::AudioState::PAUSED;
         resume(id);
@@ -120,7 +127,10 @@ int AudioEngineImpl::play2d(const std::string &fileFullPath, bool loop, float vo
 void AudioEngineImpl::setVolume(int audioID, float volume)
 {
     try {
-        mapChannelInfo[audioID].channel->setVolume(volume);
+        mapChannelInfo[audioID].volume = volume;
+        if (mapChannelInfo[audioID].channel) {
+            mapChannelInfo[audioID].channel->setVolume(volume);
+        }
     }
     catch (const std::out_of_range& oor) {
         printf("AudioEngineImpl::setVolume: invalid audioID: %d\n", audioID);
@@ -130,7 +140,10 @@ void AudioEngineImpl::setVolume(int audioID, float volume)
 void AudioEngineImpl::setLoop(int audioID, bool loop)
 {
     try {
-        mapChannelInfo[audioID].channel->setLoopCount(loop ? -1 : 0);
+        mapChannelInfo[audioID].loop = loop;
+        if (mapChannelInfo[audioID].channel) {
+            mapChannelInfo[audioID].channel->setLoopCount(loop ? -1 : 0);
+        }
     }
     catch (const std::out_of_range& oor) {
         printf("AudioEngineImpl::setLoop: invalid audioID: %d\n", audioID);
@@ -140,7 +153,10 @@ void AudioEngineImpl::setLoop(int audioID, bool loop)
 bool AudioEngineImpl::pause(int audioID)
 {
     try {
-        mapChannelInfo[audioID].channel->setPaused(true);
+        if (mapChannelInfo[audioID].channel) {
+            mapChannelInfo[audioID].channel->setPaused(true);
+        }
+        mapChannelInfo[audioID].pendingStart = false;
         AudioEngine::_audioIDInfoMap[audioID].state = AudioEngine::AudioState::PAUSED;
         return true;
     }
@@ -154,6 +170,18 @@ bool AudioEngineImpl::resume(int audioID)
 {
     try {
         if (!mapChannelInfo[audioID].channel) {
+            // a stream that is still opening starts from update() once it is ready
+            FMOD_OPENSTATE openState = FMOD_OPENSTATE_READY;
+            mapChannelInfo[audioID].sound->getOpenState(&openState, nullptr, nullptr, nullptr);
+            if (openState == FMOD_OPENSTATE_ERROR) {
+                return false;
+            }
+            if (openState == FMOD_OPENSTATE_LOADING) {
+                mapChannelInfo[audioID].pendingStart = true;
+                AudioEngine::_audioIDInfoMap[audioID].state = AudioEngine::AudioState::PLAYING;
+                return true;
+            }
+
             FMOD::Channel *channel = nullptr;
             FMOD::ChannelGroup *channelgroup = nullptr;
             //starts the sound in pause mode, use the channel to unpause
@@ -165,6 +193,9 @@ bool AudioEngineImpl::resume(int audioID)
             channel->setLoopCount(mapChannelInfo[audioID].loop ? -1 : 0);
             channel->setVolume(mapChannelInfo[audioID].volume);
             channel->setUserData(reinterpret_cast<void *>(static_cast<std::intptr_t>(mapChannelInfo[audioID].id)));
+            if (mapChannelInfo[audioID].callback) {
+                channel->setCallback(channelCallback);
+            }
             mapChannelInfo[audioID].channel = channel;
         }
 
@@ -182,8 +213,11 @@ bool AudioEngineImpl::resume(int audioID)
 bool AudioEngineImpl::stop(int audioID)
 {
     try {
-        mapChannelInfo[audioID].channel->stop();
+        if (mapChannelInfo[audioID].channel) {
+            mapChannelInfo[audioID].channel->stop();
+        }
         mapChannelInfo[audioID].channel = nullptr;
+        mapChannelInfo[audioID].pendingStart = false;
         return true;
     }
     catch (const std::out_of_range& oor) {
@@ -196,8 +230,11 @@ void AudioEngineImpl::stopAll()
 {
     for (auto& it : mapChannelInfo) {
         ChannelInfo & audioRef = it.second;
-        audioRef.channel->stop();
+        if (audioRef.channel) {
+            audioRef.channel->stop();
+        }
         audioRef.channel = nullptr;
+        audioRef.pendingStart = false;
     }
 }
 
@@ -205,9 +242,11 @@ float AudioEngineImpl::getDuration(int audioID)
 {
     try {
         FMOD::Sound * sound = mapChannelInfo[audioID].sound;
-        unsigned int length;
+        unsigned int length = 0;
         FMOD_RESULT result = sound->getLength(&length, FMOD_TIMEUNIT_MS);
-        ERRCHECK(result);
+        if (ERRCHECK(result)) {
+            return AudioEngine::TIME_UNKNOWN;
+        }
         float duration = (float)length / 1000.0f;
         return duration;
     }
@@ -220,7 +259,10 @@ float AudioEngineImpl::getDuration(int audioID)
 float AudioEngineImpl::getCurrentTime(int audioID)
 {
     try {
-        unsigned int position;
+        if (!mapChannelInfo[audioID].channel) {
+            return 0.0f;
+        }
+        unsigned int position = 0;
         FMOD_RESULT result = mapChannelInfo[audioID].channel->getPosition(&position, FMOD_TIMEUNIT_MS);
         ERRCHECK(result);
         float currenttime = position /1000.0f;
@@ -236,6 +278,9 @@ bool AudioEngineImpl::setCurrentTime(int audioID, float time)
 {
     bool ret = false;
     try {
+        if (!mapChannelInfo[audioID].channel) {
+            return false;
+        }
         unsigned int position = (unsigned int)(time * 1000.0f);
         FMOD_RESULT result = mapChannelInfo[audioID].channel->setPosition(position, FMOD_TIMEUNIT_MS);
         ret = !ERRCHECK(result);
@@ -251,8 +296,11 @@ void AudioEngineImpl::setFinishCallback(int audioID, const std::function<void (i
     try {
         FMOD::Channel * channel = mapChannelInfo[audioID].channel;
         mapChannelInfo[audioID].callback = callback;
-        FMOD_RESULT result = channel->setCallback(channelCallback);
-        ERRCHECK(result);
+        // streams that are still opening get the callback when their channel is created
+        if (channel) {
+            FMOD_RESULT result = channel->setCallback(channelCallback);
+            ERRCHECK(result);
+        }
     }
     catch (const std::out_of_range& oor) {
         printf("AudioEngineImpl::setFinishCallback: invalid audioID: %d\n", audioID);
@@ -289,6 +337,14 @@ void AudioEngineImpl::uncache(const std::string& path)
     }
     if (mapId.find(path) != mapId.end())
         mapId.erase(path);
+
+    for (auto pending = pendingPreloads.begin(); pending != pendingPreloads.end(); ) {
+        if (pending->fullPath == fullPath) {
+            pending = pendingPreloads.erase(pending);
+        } else {
+            ++pending;
+        }
+    }
 }
 
 void AudioEngineImpl::uncacheAll()
@@ -301,14 +357,16 @@ void AudioEngineImpl::uncacheAll()
     }
     mapSound.clear();
     mapId.clear();
+    pendingPreloads.clear();
 }
 
 int AudioEngineImpl::preload(const std::string& filePath, std::function<void(bool isSuccess)> callback)
 {
     FMOD::Sound * sound = findSound(filePath);
+    bool opening = false;
     if (!sound) {
         std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filePath);
-        FMOD_RESULT result = pSystem->createSound(fullPath.c_str(), FMOD_LOOP_OFF, 0, &sound);
+        FMOD_RESULT result = createSound(fullPath, &sound);
         if (ERRCHECK(result)) {
             printf("sound effect in %s could not be preload\n", filePath.c_str());
             if (callback) {
@@ -317,6 +375,13 @@ int AudioEngineImpl::preload(const std::string& filePath, std::function<void(boo
             return -1;
         }
         mapSound[fullPath] = sound;
+
+        FMOD_OPENSTATE openState = FMOD_OPENSTATE_READY;
+        sound->getOpenState(&openState, nullptr, nullptr, nullptr);
+        if (openState == FMOD_OPENSTATE_LOADING && callback) {
+            pendingPreloads.push_back({fullPath, callback});
+            opening = true;
+        }
     }
 
     int id = static_cast<int>(mapChannelInfo.size()) + 1;
@@ -329,19 +394,92 @@ int AudioEngineImpl::preload(const std::string& filePath, std::function<void(boo
     chanelInfo.sound = sound;
     chanelInfo.id = id;
     chanelInfo.channel = nullptr;
+    chanelInfo.pendingStart = false;
     chanelInfo.callback = nullptr;
     chanelInfo.path = filePath;
     //we are going to use UserData to store pointer to Channel when playing
     chanelInfo.sound->setUserData(reinterpret_cast<void *>(static_cast<std::intptr_t>(id)));
 
-    if (callback) {
+    if (callback && !opening) {
         callback(true);
     }
     return id;
 }
 
+FMOD_RESULT AudioEngineImpl::createSound(const std::string &fullPath, FMOD::Sound ** sound)
+{
+    if (FileUtils::getInstance()->getFileSize(fullPath) < AUDIO_STREAM_SIZE_THRESHOLD) {
+        // short effects are decoded into memory so they can start instantly and overlap
+        return pSystem->createSound(fullPath.c_str(), FMOD_LOOP_OFF, 0, sound);
+    }
+
+    // long tracks (music) are decoded on FMOD's stream thread into a small ring buffer
+    FMOD_CREATESOUNDEXINFO exinfo;
+    memset(&exinfo, 0, sizeof(exinfo));
+    exinfo.cbsize = sizeof(exinfo);
+    int sampleRate = 0;
+    pSystem->getSoftwareFormat(&sampleRate, nullptr, nullptr);
+    if (sampleRate > 0) {
+        exinfo.decodebuffersize = sampleRate * AUDIO_STREAM_DECODE_BUFFER_MS / 1000;
+    }
+    return pSystem->createSound(fullPath.c_str(), FMOD_CREATESTREAM | FMOD_NONBLOCKING | FMOD_LOOP_NORMAL, &exinfo, sound);
+}
+
+void AudioEngineImpl::updatePendingStreams()
+{
+    if (!pendingPreloads.empty()) {
+        std::vector<std::pair<std::function<void(bool)>, bool>> finished;
+        for (auto it = pendingPreloads.begin(); it != pendingPreloads.end(); ) {
+            FMOD_OPENSTATE openState = FMOD_OPENSTATE_ERROR;
+            auto found = mapSound.find(it->fullPath);
+            if (found != mapSound.end() && found->second) {
+                found->second->getOpenState(&openState, nullptr, nullptr, nullptr);
+            }
+            if (openState == FMOD_OPENSTATE_LOADING) {
+                ++it;
+                continue;
+            }
+            if (openState == FMOD_OPENSTATE_ERROR) {
+                printf("sound stream %s could not be opened\n", it->fullPath.c_str());
+            }
+            finished.push_back({it->callback, openState != FMOD_OPENSTATE_ERROR});
+            it = pendingPreloads.erase(it);
+        }
+        // callbacks may preload again, so run them after the list is updated
+        for (auto& result : finished) {
+            result.first(result.second);
+        }
+    }
+
+    std::vector<int> ready;
+    for (auto& it : mapChannelInfo) {
+        ChannelInfo & audioRef = it.second;
+        if (!audioRef.pendingStart) {
+            continue;
+        }
+        FMOD_OPENSTATE openState = FMOD_OPENSTATE_ERROR;
+        audioRef.sound->getOpenState(&openState, nullptr, nullptr, nullptr);
+        if (openState == FMOD_OPENSTATE_LOADING) {
+            continue;
+        }
+        audioRef.pendingStart = false;
+        if (openState == FMOD_OPENSTATE_ERROR) {
+            printf("AudioEngineImpl::update: stream %s failed to open\n", audioRef.path.c_str());
+            if (audioRef.callback) {
+                audioRef.callback(audioRef.id, audioRef.path);
+            }
+            continue;
+        }
+        ready.push_back(audioRef.id);
+    }
+    for (int id : ready) {
+        resume(id);
+    }
+}
+
 void AudioEngineImpl::update(float dt)
 {
+    updatePendingStreams();
     pSystem->update();
 }
 
@@ -32,6 +32,7 @@
 #include <functional>
 #include <iostream>
 #include <map>
+#include <vector>
 #include "fmod.hpp"
 #include "fmod_errors.h"
 #include "audio/include/AudioEngine.h"
@@ -41,6 +42,12 @@
 NS_CC_BEGIN
     namespace experimental{
 #define MAX_AUDIOINSTANCES 32
+/** Files at least this large are streamed from disk instead of decoded into memory. */
+#define AUDIO_STREAM_SIZE_THRESHOLD (1024 * 1024)
+/** Size of the file read buffer used by each stream, in bytes. */
+#define AUDIO_STREAM_FILE_BUFFER_SIZE (64 * 1024)
+/** Size of the decoded PCM ring buffer used by each stream, in milliseconds. */
+#define AUDIO_STREAM_DECODE_BUFFER_MS 500
 
 class CC_DLL AudioEngineImpl : public cocos2d::Ref
 {
@@ -82,6 +89,18 @@ private:
     FMOD::Sound * findSound(const std::string &path);
   
     FMOD::Channel * getChannel(FMOD::Sound *);
+
+    /**
+     * Opens a sound. Large files are opened as non-blocking streams so the
+     * file read and header parsing happen on FMOD's stream thread.
+     */
+    FMOD_RESULT createSound(const std::string &fullPath, FMOD::Sound ** sound);
+
+    /**
+     * Starts playback of streams whose asynchronous open has completed and
+     * reports preload results for them.
+     */
+    void updatePendingStreams();
   
     struct ChannelInfo{
         int id;
@@ -90,11 +109,19 @@ private:
         FMOD::Channel * channel; 
         bool loop; 
         float volume; 
+        bool pendingStart;  // resume() was called before the stream finished opening
         std::function<void (int, const std::string &)> callback;
     };
     
     std::map<int, ChannelInfo> mapChannelInfo;
 
+    struct PendingPreload{
+        std::string fullPath;
+        std::function<void(bool isSuccess)> callback;
+    };
+
+    std::vector<PendingPreload> pendingPreloads;
+
     std::map<std::string, int> mapId;
     
     std::map<std::string, FMOD::Sound *> mapSound;  
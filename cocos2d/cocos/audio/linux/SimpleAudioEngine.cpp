@@ -23,9 +23,12 @@
  ****************************************************************************/
 
 #include <iostream>
+#include <algorithm>
 
 #include "audio/include/SimpleAudioEngine.h"
 #include "audio/include/AudioEngine.h"
+#include "base/CCDirector.h"
+#include "base/CCScheduler.h"
 
 using namespace CocosDenshion;
 using namespace cocos2d;
@@ -35,11 +38,40 @@ struct SimpleAudioEngineLinux {
     SimpleAudioEngine * engine = nullptr;
     int musicid;
     float effectsvolume;
+    float musicvolume;
     std::string musicpath;
+    int fadingid;           // previous track while a crossfade is running, -1 otherwise
+    float fadeelapsed;
 };
 
 SimpleAudioEngineLinux * g_SimpleAudioEngineLinux = nullptr;
 
+static const float MUSIC_CROSSFADE_DURATION = 1.0f;
+static const char* MUSIC_CROSSFADE_KEY = "SimpleAudioEngineLinux_crossfade";
+
+static void finishMusicCrossfade()
+{
+    if (g_SimpleAudioEngineLinux->fadingid == -1) {
+        return;
+    }
+    Director::getInstance()->getScheduler()->unschedule(MUSIC_CROSSFADE_KEY, g_SimpleAudioEngineLinux);
+    AudioEngine::stop(g_SimpleAudioEngineLinux->fadingid);
+    g_SimpleAudioEngineLinux->fadingid = -1;
+    AudioEngine::setVolume(g_SimpleAudioEngineLinux->musicid, g_SimpleAudioEngineLinux->musicvolume);
+}
+
+static void stepMusicCrossfade(float dt)
+{
+    g_SimpleAudioEngineLinux->fadeelapsed += dt;
+    float progress = std::min(1.0f, g_SimpleAudioEngineLinux->fadeelapsed / MUSIC_CROSSFADE_DURATION);
+    float volume = g_SimpleAudioEngineLinux->musicvolume;
+    AudioEngine::setVolume(g_SimpleAudioEngineLinux->musicid, volume * progress);
+    AudioEngine::setVolume(g_SimpleAudioEngineLinux->fadingid, volume * (1.0f - progress));
+    if (progress >= 1.0f) {
+        finishMusicCrossfade();
+    }
+}
+
 SimpleAudioEngine* SimpleAudioEngine::getInstance()
 {
     if (!g_SimpleAudioEngineLinux) {
@@ -52,6 +84,7 @@ SimpleAudioEngine* SimpleAudioEngine::getInstance()
 void SimpleAudioEngine::end()
 {
     if (g_SimpleAudioEngineLinux) {
+        Director::getInstance()->getScheduler()->unschedule(MUSIC_CROSSFADE_KEY, g_SimpleAudioEngineLinux);
         delete g_SimpleAudioEngineLinux->engine;
         delete g_SimpleAudioEngineLinux;
     }
@@ -62,6 +95,9 @@ SimpleAudioEngine::SimpleAudioEngine()
 {
     g_SimpleAudioEngineLinux->musicid = -1;
     g_SimpleAudioEngineLinux->effectsvolume = 1.0f;
+    g_SimpleAudioEngineLinux->musicvolume = 1.0f;
+    g_SimpleAudioEngineLinux->fadingid = -1;
+    g_SimpleAudioEngineLinux->fadeelapsed = 0.0f;
 }
 
 SimpleAudioEngine::~SimpleAudioEngine()
@@ -74,14 +110,40 @@ void SimpleAudioEngine::preloadBackgroundMusic(const char* filePath)
     AudioEngine::preload(filePath);
 }
 
+/**
+ * Large music files are streamed by AudioEngineImpl. If another track is
+ * still playing it is crossfaded out instead of being cut off; playing the
+ * track that is already playing leaves it running.
+ */
 void SimpleAudioEngine::playBackgroundMusic(const char* filePath, bool loop)
 {
+    bool playing = g_SimpleAudioEngineLinux->musicid != -1
+        && AudioEngine::getState(g_SimpleAudioEngineLinux->musicid) == AudioEngine::AudioState::PLAYING;
+    if (playing && g_SimpleAudioEngineLinux->musicpath == filePath) {
+        return;
+    }
+
+    finishMusicCrossfade();
+
+    float volume = g_SimpleAudioEngineLinux->musicvolume;
+    if (playing) {
+        g_SimpleAudioEngineLinux->fadingid = g_SimpleAudioEngineLinux->musicid;
+        g_SimpleAudioEngineLinux->fadeelapsed = 0.0f;
+        volume = 0.0f;
+    }
+
     g_SimpleAudioEngineLinux->musicpath = filePath;
-    g_SimpleAudioEngineLinux->musicid = AudioEngine::play2d(filePath, loop);
+    g_SimpleAudioEngineLinux->musicid = AudioEngine::play2d(filePath, loop, volume);
+
+    if (g_SimpleAudioEngineLinux->fadingid != -1) {
+        Director::getInstance()->getScheduler()->schedule(stepMusicCrossfade, g_SimpleAudioEngineLinux,
+                                                          0.0f, false, MUSIC_CROSSFADE_KEY);
+    }
 }
 
 void SimpleAudioEngine::stopBackgroundMusic(bool releaseData)
 {
+    finishMusicCrossfade();
     AudioEngine::stop(g_SimpleAudioEngineLinux->musicid);
     if (releaseData) {
         AudioEngine::uncache(g_SimpleAudioEngineLinux->musicpath.c_str());
@@ -90,6 +152,7 @@ void SimpleAudioEngine::stopBackgroundMusic(bool releaseData)
 
 void SimpleAudioEngine::pauseBackgroundMusic()
 {
+    finishMusicCrossfade();
     AudioEngine::pause(g_SimpleAudioEngineLinux->musicid);
 }
 
@@ -124,7 +187,7 @@ bool SimpleAudioEngine::isBackgroundMusicPlaying()
  */
 float SimpleAudioEngine::getBackgroundMusicVolume()
 {
-    return AudioEngine::getVolume(g_SimpleAudioEngineLinux->musicid);
+    return g_SimpleAudioEngineLinux->musicvolume;
 }
 
 /**
@@ -136,7 +199,11 @@ float SimpleAudioEngine::getBackgroundMusicVolume()
  */
 void SimpleAudioEngine::setBackgroundMusicVolume(float volume)
 {
-    AudioEngine::setVolume(g_SimpleAudioEngineLinux->musicid, volume);
+    g_SimpleAudioEngineLinux->musicvolume = volume;
+    // a running crossfade picks up the new volume on its next step
+    if (g_SimpleAudioEngineLinux->fadingid == -1) {
+        AudioEngine::setVolume(g_SimpleAudioEngineLinux->musicid, volume);
+    }
 }
 
 /**
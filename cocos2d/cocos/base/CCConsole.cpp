@@ -66,9 +66,12 @@
 #include "2d/CCScene.h"
 #include "platform/CCFileUtils.h"
 #include "renderer/CCTextureCache.h"
+#include "renderer/CCRenderer.h"
+#include "base/CCFrameStats.h"
 #include "base/base64.h"
 #include "base/ccUtils.h"
 #include "base/allocator/CCAllocatorDiagnostics.h"
+#include "base/allocator/CCAllocatorTypePool.h"
 NS_CC_BEGIN
 
 extern const char* cocos2dVersion(void);
@@ -77,6 +80,8 @@ extern const char* cocos2dVersion(void);
 #define DEFAULT_COMMAND_SEPARATOR '|'
 
 static const size_t SEND_BUFSIZ = 512;
+// perf records buffered per client before new ones are dropped
+static const size_t PERF_PENDING_LIMIT = 4 * 1024 * 1024;
 
 /** private functions */
 namespace {
@@ -493,6 +498,7 @@ Console::Console()
 , _isIpv6Server(false)
 , _sendDebugStrings(false)
 , _bindAddress("")
+, _perfListenerId(-1)
 {
     createCommandAllocator();
     createCommandConfig();
@@ -502,6 +508,7 @@ Console::Console()
     createCommandFileUtils();
     createCommandFps();
     createCommandHelp();
+    createCommandPerf();
     createCommandProjection();
     createCommandResolution();
     createCommandSceneGraph();
@@ -751,6 +758,15 @@ void Console::loop()
         
         copy_set = _read_set;
         timeout_copy = timeout;
+
+        /* wake up often enough to keep the perf streams flowing */
+        {
+            std::lock_guard<std::mutex> lock(_perfMutex);
+            if (!_perfSubscriptions.empty()) {
+                timeout_copy.tv_sec = 0;
+                timeout_copy.tv_usec = 50000;
+            }
+        }
         
         int nready = select(_maxfd+1, &copy_set, nullptr, nullptr, &timeout_copy);
         
@@ -816,6 +832,7 @@ void Console::loop()
             for(int fd: to_remove) {
                 FD_CLR(fd, &_read_set);
                 _fds.erase(std::remove(_fds.begin(), _fds.end(), fd), _fds.end());
+                removePerfSubscription(fd);
             }
         }
         
@@ -832,6 +849,14 @@ void Console::loop()
                 _DebugStringsMutex.unlock();
             }
         }
+
+        flushPerfStreams();
+    }
+
+    // the scheduler may already be gone, so the FrameStats listener is left to the next updatePerfStream()
+    {
+        std::lock_guard<std::mutex> lock(_perfMutex);
+        _perfSubscriptions.clear();
     }
     
     // clean up: ignore stdin, stdout and stderr
@@ -1028,7 +1053,7 @@ void Console::addClient()
 
 void Console::createCommandAllocator()
 {
-    addCommand({"allocator", "Display allocator diagnostics for all allocators. Args: [-h | help | ]",
+    addCommand({"allocator", "Display the type pools and the allocator diagnostics for all allocators. Args: [-h | help | ]",
         CC_CALLBACK_2(Console::commandAllocator, this)});
 }
 
@@ -1086,6 +1111,20 @@ void Console::createCommandHelp()
     addCommand({"help", "Print this message. Args: [ ]", CC_CALLBACK_2(Console::commandHelp, this)});
 }
 
+void Console::createCommandPerf()
+{
+    addCommand({"perf", "Stream frame, hitch, memory and counter records as JSON lines. Args: [-h | help | subscribe | unsubscribe | hitch | interval | ]",
+        CC_CALLBACK_2(Console::commandPerf, this)});
+    addSubCommand("perf", {"subscribe", "perf subscribe [frames | hitches | memory | counts | all]...: start streaming the given records, all by default.",
+        CC_CALLBACK_2(Console::commandPerfSubCommandSubscribe, this)});
+    addSubCommand("perf", {"unsubscribe", "Stop streaming records to this connection.",
+        CC_CALLBACK_2(Console::commandPerfSubCommandUnsubscribe, this)});
+    addSubCommand("perf", {"hitch", "perf hitch ms: frames slower than ms are reported as hitches, 0 for twice the animation interval.",
+        CC_CALLBACK_2(Console::commandPerfSubCommandHitch, this)});
+    addSubCommand("perf", {"interval", "perf interval seconds: time between memory and counts records.",
+        CC_CALLBACK_2(Console::commandPerfSubCommandInterval, this)});
+}
+
 void Console::createCommandProjection()
 {
     addCommand({"projection", "Change or print the current projection. Args: [-h | help | 2d | 3d | ]",
@@ -1110,10 +1149,14 @@ void Console::createCommandSceneGraph()
 
 void Console::createCommandTexture()
 {
-    addCommand({"texture", "Flush or print the TextureCache info. Args: [-h | help | flush | ] ",
+    addCommand({"texture", "Flush, trim or print the TextureCache info. Args: [-h | help | flush | residency | trim [MB] | ] ",
         CC_CALLBACK_2(Console::commandTextures, this)});
     addSubCommand("texture", {"flush", "Purges the dictionary of loaded textures.",
         CC_CALLBACK_2(Console::commandTexturesSubCommandFlush, this)});
+    addSubCommand("texture", {"residency", "Print the texture memory per owner and the memory budget.",
+        CC_CALLBACK_2(Console::commandTexturesSubCommandResidency, this)});
+    addSubCommand("texture", {"trim", "Evict unreferenced textures down to the memory budget, or to the given MB.",
+        CC_CALLBACK_2(Console::commandTexturesSubCommandTrim, this)});
 }
 
 void Console::createCommandTouch()
@@ -1141,6 +1184,10 @@ void Console::createCommandVersion()
 
 void Console::commandAllocator(int fd, const std::string& /*args*/)
 {
+#if CC_ENABLE_TYPE_POOLS
+    auto pools = allocator::TypePool::diagnostics();
+    Console::Utility::sendToConsole(fd, pools.c_str(), pools.length());
+#endif
 #if CC_ENABLE_ALLOCATOR_DIAGNOSTICS
     auto info = allocator::AllocatorDiagnostics::instance()->diagnostics();
     Console::Utility::mydprintf(fd, info.c_str());
@@ -1208,6 +1255,7 @@ void Console::commandExit(int fd, const std::string& /*args*/)
 {
     FD_CLR(fd, &_read_set);
     _fds.erase(std::remove(_fds.begin(), _fds.end(), fd), _fds.end());
+    removePerfSubscription(fd);
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
     closesocket(fd);
 #else
@@ -1244,6 +1292,119 @@ void Console::commandHelp(int fd, const std::string& /*args*/)
     sendHelp(fd, _commands, "\nAvailable commands:\n");
 }
 
+void Console::commandPerf(int fd, const std::string& args)
+{
+    if (!args.empty())
+    {
+        Console::Utility::mydprintf(fd, "Unknown perf sub command '%s'. Type 'perf help' for usage.\n", args.c_str());
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_perfMutex);
+    auto it = _perfSubscriptions.find(fd);
+    if (it == _perfSubscriptions.end())
+    {
+        Console::Utility::mydprintf(fd, "perf: not subscribed\n");
+        return;
+    }
+
+    const auto& subscription = it->second;
+    std::string streams;
+    if (subscription.streams & PERF_FRAMES) streams += " frames";
+    if (subscription.streams & PERF_HITCHES) streams += " hitches";
+    if (subscription.streams & PERF_MEMORY) streams += " memory";
+    if (subscription.streams & PERF_COUNTS) streams += " counts";
+    if (subscription.hitchThreshold > 0)
+        Console::Utility::mydprintf(fd, "perf:%s, hitch %.1f ms, interval %.1f s\n",
+            streams.c_str(), subscription.hitchThreshold * 1000, subscription.snapshotInterval);
+    else
+        Console::Utility::mydprintf(fd, "perf:%s, hitch 2x animation interval, interval %.1f s\n",
+            streams.c_str(), subscription.snapshotInterval);
+}
+
+void Console::commandPerfSubCommandSubscribe(int fd, const std::string& args)
+{
+    // args starts with the sub command itself
+    auto argv = Console::Utility::split(args, ' ');
+    unsigned int streams = 0;
+    for (size_t i = 1; i < argv.size(); ++i)
+    {
+        const auto& name = argv[i];
+        if (name.empty())
+            continue;
+        if (name == "frames") streams |= PERF_FRAMES;
+        else if (name == "hitches") streams |= PERF_HITCHES;
+        else if (name == "memory") streams |= PERF_MEMORY;
+        else if (name == "counts") streams |= PERF_COUNTS;
+        else if (name == "all") streams |= PERF_ALL;
+        else
+        {
+            Console::Utility::mydprintf(fd, "Unknown perf stream '%s'. Use frames, hitches, memory, counts or all.\n", name.c_str());
+            return;
+        }
+    }
+    if (streams == 0)
+        streams = PERF_ALL;
+
+    {
+        std::lock_guard<std::mutex> lock(_perfMutex);
+        auto it = _perfSubscriptions.find(fd);
+        if (it == _perfSubscriptions.end())
+        {
+            it = _perfSubscriptions.emplace(fd, PerfSubscription()).first;
+            it->second.start = std::chrono::steady_clock::now();
+        }
+        it->second.streams = streams;
+    }
+
+    Scheduler *sched = Director::getInstance()->getScheduler();
+    sched->performFunctionInCocosThread( std::bind(&Console::updatePerfStream, this) );
+}
+
+void Console::commandPerfSubCommandUnsubscribe(int fd, const std::string& /*args*/)
+{
+    removePerfSubscription(fd);
+}
+
+void Console::commandPerfSubCommandHitch(int fd, const std::string& args)
+{
+    auto argv = Console::Utility::split(args, ' ');
+    if (argv.size() != 2 || !Console::Utility::isFloat(argv[1]) || utils::atof(argv[1].c_str()) < 0)
+    {
+        Console::Utility::mydprintf(fd, "Usage: perf hitch ms\n");
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_perfMutex);
+    auto it = _perfSubscriptions.find(fd);
+    if (it == _perfSubscriptions.end())
+    {
+        Console::Utility::mydprintf(fd, "perf: not subscribed\n");
+        return;
+    }
+    it->second.hitchThreshold = static_cast<float>(utils::atof(argv[1].c_str()) / 1000);
+}
+
+void Console::commandPerfSubCommandInterval(int fd, const std::string& args)
+{
+    auto argv = Console::Utility::split(args, ' ');
+    if (argv.size() != 2 || !Console::Utility::isFloat(argv[1]) || utils::atof(argv[1].c_str()) <= 0)
+    {
+        Console::Utility::mydprintf(fd, "Usage: perf interval seconds\n");
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_perfMutex);
+    auto it = _perfSubscriptions.find(fd);
+    if (it == _perfSubscriptions.end())
+    {
+        Console::Utility::mydprintf(fd, "perf: not subscribed\n");
+        return;
+    }
+    it->second.snapshotInterval = static_cast<float>(utils::atof(argv[1].c_str()));
+    it->second.nextSnapshot = 0;
+}
+
 void Console::commandProjection(int fd, const std::string& /*args*/)
 {
     auto director = Director::getInstance();
@@ -1335,7 +1496,9 @@ void Console::commandTextures(int fd, const std::string& /*args*/)
 {
     Scheduler *sched = Director::getInstance()->getScheduler();
     sched->performFunctionInCocosThread( [=](){
-        Console::Utility::mydprintf(fd, "%s", Director::getInstance()->getTextureCache()->getCachedTextureInfo().c_str());
+        auto textureCache = Director::getInstance()->getTextureCache();
+        Console::Utility::mydprintf(fd, "%s", textureCache->getCachedTextureInfo().c_str());
+        Console::Utility::mydprintf(fd, "%s", textureCache->getResidencyInfo().c_str());
         Console::Utility::sendPrompt(fd);
     });
 }
@@ -1348,6 +1511,34 @@ void Console::commandTexturesSubCommandFlush(int /*fd*/, const std::string& /*ar
     });
 }
 
+void Console::commandTexturesSubCommandResidency(int fd, const std::string& /*args*/)
+{
+    Scheduler *sched = Director::getInstance()->getScheduler();
+    sched->performFunctionInCocosThread( [=](){
+        Console::Utility::mydprintf(fd, "%s", Director::getInstance()->getTextureCache()->getResidencyInfo().c_str());
+        Console::Utility::sendPrompt(fd);
+    });
+}
+
+void Console::commandTexturesSubCommandTrim(int fd, const std::string& args)
+{
+    // args starts with the sub command itself
+    std::string subCommand;
+    float megabytes = 0;
+    std::istringstream stream( args );
+    stream >> subCommand >> megabytes;
+
+    Scheduler *sched = Director::getInstance()->getScheduler();
+    sched->performFunctionInCocosThread( [=](){
+        auto textureCache = Director::getInstance()->getTextureCache();
+        size_t freed = megabytes > 0
+            ? textureCache->trimToMemoryBudget(static_cast<size_t>(megabytes * 1024 * 1024))
+            : textureCache->trimToMemoryBudget();
+        Console::Utility::mydprintf(fd, "Evicted %.2f MB\n%s", freed / (1024.0f * 1024.0f), textureCache->getResidencyInfo().c_str());
+        Console::Utility::sendPrompt(fd);
+    });
+}
+
 void Console::commandTouchSubCommandTap(int fd, const std::string& args)
 {
     auto argv = Console::Utility::split(args,' ');
@@ -1554,6 +1745,237 @@ void Console::commandVersion(int fd, const std::string& /*args*/)
     Console::Utility::mydprintf(fd, "%s\n", cocos2dVersion());
 }
 
+// perf streams
+
+static void appendJsonString(std::string& out, const std::string& value)
+{
+    out += '"';
+    for (char c : value)
+    {
+        if (c == '"' || c == '\\')
+        {
+            out += '\\';
+            out += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        }
+        else
+        {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+void Console::updatePerfStream()
+{
+    bool wanted;
+    {
+        std::lock_guard<std::mutex> lock(_perfMutex);
+        wanted = !_perfSubscriptions.empty();
+    }
+
+    auto stats = FrameStats::getInstance();
+    if (wanted && _perfListenerId < 0)
+    {
+        stats->beginRecording();
+        _perfListenerId = stats->addFrameListener(CC_CALLBACK_1(Console::onPerfFrame, this));
+    }
+    else if (!wanted && _perfListenerId >= 0)
+    {
+        stats->removeFrameListener(_perfListenerId);
+        _perfListenerId = -1;
+        stats->endRecording();
+    }
+}
+
+void Console::onPerfFrame(FrameStats* stats)
+{
+    auto director = Director::getInstance();
+    auto renderer = director->getRenderer();
+    auto now = std::chrono::steady_clock::now();
+    float frameTime = stats->getFrameTime();
+
+    char buf[512];
+    snprintf(buf, sizeof(buf), "\"frame\":%u,\"ms\":%.3f,\"update\":%.3f,\"visit\":%.3f,\"render\":%.3f,\"gpu\":%.3f,\"draws\":%lld,\"verts\":%lld",
+        director->getTotalFrames(), frameTime * 1000,
+        stats->getPhaseTime(FrameStats::Phase::UPDATE) * 1000,
+        stats->getPhaseTime(FrameStats::Phase::VISIT) * 1000,
+        stats->getPhaseTime(FrameStats::Phase::RENDER) * 1000,
+        stats->getPhaseTime(FrameStats::Phase::GPU_WAIT) * 1000,
+        (long long)renderer->getDrawnBatches(), (long long)renderer->getDrawnVertices());
+    const std::string frameFields = buf;
+
+    // built on first use, shared by every subscription of this frame
+    std::string zones, memory, counts;
+
+    std::lock_guard<std::mutex> lock(_perfMutex);
+    for (auto& entry : _perfSubscriptions)
+    {
+        auto& subscription = entry.second;
+        double t = std::chrono::duration<double>(now - subscription.start).count();
+
+        if (subscription.streams & PERF_FRAMES)
+        {
+            snprintf(buf, sizeof(buf), "{\"type\":\"frame\",\"t\":%.3f,", t);
+            appendPerfRecord(subscription, buf + frameFields + "}");
+        }
+
+        float threshold = subscription.hitchThreshold > 0 ? subscription.hitchThreshold : director->getAnimationInterval() * 2;
+        if ((subscription.streams & PERF_HITCHES) && frameTime > threshold)
+        {
+            if (zones.empty())
+            {
+                // the zones that took time this frame, slowest first
+                std::vector<std::pair<float, int>> spent;
+                for (int i = 0; i < stats->getZoneCount(); ++i)
+                {
+                    if (stats->getZoneTime(i) > 0)
+                        spent.emplace_back(stats->getZoneTime(i), i);
+                }
+                std::sort(spent.begin(), spent.end(), std::greater<std::pair<float, int>>());
+
+                zones = "[";
+                for (const auto& zone : spent)
+                {
+                    if (zones.size() > 1)
+                        zones += ',';
+                    zones += "{\"name\":";
+                    appendJsonString(zones, stats->getZoneName(zone.second));
+                    snprintf(buf, sizeof(buf), ",\"ms\":%.3f}", zone.first * 1000);
+                    zones += buf;
+                }
+                zones += ']';
+            }
+            snprintf(buf, sizeof(buf), "{\"type\":\"hitch\",\"t\":%.3f,", t);
+            std::string record = buf + frameFields;
+            snprintf(buf, sizeof(buf), ",\"threshold\":%.3f,\"zones\":", threshold * 1000);
+            appendPerfRecord(subscription, record + buf + zones + "}");
+        }
+
+        if (!(subscription.streams & (PERF_MEMORY | PERF_COUNTS)) || t < subscription.nextSnapshot)
+            continue;
+        subscription.nextSnapshot = t + subscription.snapshotInterval;
+
+        if (subscription.streams & PERF_MEMORY)
+        {
+            if (memory.empty())
+            {
+                auto textureCache = director->getTextureCache();
+                snprintf(buf, sizeof(buf), ",\"refs\":%u,\"textureBytes\":%llu,\"textureBudget\":%llu",
+                    Ref::getLiveCount(),
+                    (unsigned long long)textureCache->getResidentBytes(),
+                    (unsigned long long)textureCache->getMemoryBudget());
+                memory = buf;
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
+                // resident pages of the whole process
+                FILE* statm = fopen("/proc/self/statm", "r");
+                if (statm)
+                {
+                    unsigned long long size = 0, resident = 0;
+                    if (fscanf(statm, "%llu %llu", &size, &resident) == 2)
+                    {
+                        snprintf(buf, sizeof(buf), ",\"rss\":%llu", resident * (unsigned long long)sysconf(_SC_PAGESIZE));
+                        memory += buf;
+                    }
+                    fclose(statm);
+                }
+#endif
+                memory += ",\"textureOwners\":{";
+                bool first = true;
+                for (const auto& owner : textureCache->getResidentBytesByOwner())
+                {
+                    if (!first)
+                        memory += ',';
+                    first = false;
+                    appendJsonString(memory, owner.first);
+                    snprintf(buf, sizeof(buf), ":%llu", (unsigned long long)owner.second);
+                    memory += buf;
+                }
+                memory += "}}";
+            }
+            snprintf(buf, sizeof(buf), "{\"type\":\"memory\",\"t\":%.3f,\"frame\":%u", t, director->getTotalFrames());
+            appendPerfRecord(subscription, buf + memory);
+        }
+
+        if (subscription.streams & PERF_COUNTS)
+        {
+            if (counts.empty())
+            {
+                counts = ",\"counters\":{";
+                for (int i = 0; i < stats->getCounterCount(); ++i)
+                {
+                    if (i > 0)
+                        counts += ',';
+                    appendJsonString(counts, stats->getCounterName(i));
+                    snprintf(buf, sizeof(buf), ":%lld", stats->getCounter(i));
+                    counts += buf;
+                }
+                counts += "}}";
+            }
+            snprintf(buf, sizeof(buf), "{\"type\":\"counts\",\"t\":%.3f,\"frame\":%u", t, director->getTotalFrames());
+            appendPerfRecord(subscription, buf + counts);
+        }
+    }
+}
+
+void Console::appendPerfRecord(PerfSubscription& subscription, const std::string& record)
+{
+    // a client that stops reading loses records instead of growing the buffer forever
+    if (subscription.pending.size() + record.size() + 64 > PERF_PENDING_LIMIT)
+    {
+        ++subscription.dropped;
+        return;
+    }
+
+    if (subscription.dropped > 0)
+    {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "{\"type\":\"dropped\",\"count\":%u}\n", subscription.dropped);
+        subscription.pending += buf;
+        subscription.dropped = 0;
+    }
+    subscription.pending += record;
+    subscription.pending += '\n';
+}
+
+void Console::removePerfSubscription(int fd)
+{
+    {
+        std::lock_guard<std::mutex> lock(_perfMutex);
+        if (_perfSubscriptions.erase(fd) == 0)
+            return;
+    }
+
+    Scheduler *sched = Director::getInstance()->getScheduler();
+    sched->performFunctionInCocosThread( std::bind(&Console::updatePerfStream, this) );
+}
+
+void Console::flushPerfStreams()
+{
+    std::vector<std::pair<int, std::string>> outgoing;
+    {
+        std::lock_guard<std::mutex> lock(_perfMutex);
+        for (auto& entry : _perfSubscriptions)
+        {
+            if (entry.second.pending.empty())
+                continue;
+            outgoing.emplace_back(entry.first, std::string());
+            outgoing.back().second.swap(entry.second.pending);
+        }
+    }
+
+    // sent without the lock so the cocos thread never waits on a socket
+    for (const auto& chunk : outgoing)
+    {
+        Console::Utility::sendToConsole(chunk.first, chunk.second.data(), chunk.second.size());
+    }
+}
+
 // helper free functions
 
 int Console::printSceneGraph(int fd, Node* node, int level)
@@ -46,6 +46,7 @@ typedef SSIZE_T ssize_t;
 #include <functional>
 #include <string>
 #include <mutex>
+#include <chrono>
 #include <stdarg.h>
 
 #include "base/CCRef.h"
@@ -54,6 +55,8 @@ typedef SSIZE_T ssize_t;
 
 NS_CC_BEGIN
 
+class FrameStats;
+
 /// The max length of CCLog message.
 static const int MAX_LOG_LENGTH = 16*1024;
 
@@ -70,6 +73,10 @@ void CC_DLL log(const char * format, ...) CC_FORMAT_PRINTF(1, 2);
  ```
  scheduler->performFunctionInCocosThread( ... );
  ```
+
+ The `perf` command streams FrameStats telemetry to the client as newline-delimited JSON.
+ Records are formatted on the cocos thread at the end of each frame and sent by the console
+ thread, so a slow client only grows its own buffer, which is dropped past a fixed limit.
  */
 
 class CC_DLL Console
@@ -234,6 +241,7 @@ protected:
     void createCommandFileUtils();
     void createCommandFps();
     void createCommandHelp();
+    void createCommandPerf();
     void createCommandProjection();
     void createCommandResolution();
     void createCommandSceneGraph();
@@ -258,6 +266,11 @@ protected:
     void commandFps(int fd, const std::string& args);
     void commandFpsSubCommandOnOff(int fd, const std::string& args);
     void commandHelp(int fd, const std::string& args);
+    void commandPerf(int fd, const std::string& args);
+    void commandPerfSubCommandSubscribe(int fd, const std::string& args);
+    void commandPerfSubCommandUnsubscribe(int fd, const std::string& args);
+    void commandPerfSubCommandHitch(int fd, const std::string& args);
+    void commandPerfSubCommandInterval(int fd, const std::string& args);
     void commandProjection(int fd, const std::string& args);
     void commandProjectionSubCommand2d(int fd, const std::string& args);
     void commandProjectionSubCommand3d(int fd, const std::string& args);
@@ -266,6 +279,8 @@ protected:
     void commandSceneGraph(int fd, const std::string& args);
     void commandTextures(int fd, const std::string& args);
     void commandTexturesSubCommandFlush(int fd, const std::string& args);
+    void commandTexturesSubCommandResidency(int fd, const std::string& args);
+    void commandTexturesSubCommandTrim(int fd, const std::string& args);
     void commandTouchSubCommandTap(int fd, const std::string& args);
     void commandTouchSubCommandSwipe(int fd, const std::string& args);
     void commandUpload(int fd);
@@ -292,6 +307,41 @@ protected:
     intptr_t _touchId;
 
     std::string _bindAddress;
+
+    // perf streams
+    enum PerfStream
+    {
+        PERF_FRAMES = 1 << 0,
+        PERF_HITCHES = 1 << 1,
+        PERF_MEMORY = 1 << 2,
+        PERF_COUNTS = 1 << 3,
+        PERF_ALL = PERF_FRAMES | PERF_HITCHES | PERF_MEMORY | PERF_COUNTS
+    };
+
+    struct PerfSubscription
+    {
+        unsigned int streams = 0;
+        // frames slower than this many seconds are hitches, 0 means twice the animation interval
+        float hitchThreshold = 0;
+        // seconds between memory and counts snapshots
+        float snapshotInterval = 1.0f;
+        double nextSnapshot = 0;
+        std::chrono::steady_clock::time_point start;
+        // records formatted on the cocos thread, waiting for the console thread to send them
+        std::string pending;
+        unsigned int dropped = 0;
+    };
+
+    void updatePerfStream();
+    void onPerfFrame(FrameStats* stats);
+    void appendPerfRecord(PerfSubscription& subscription, const std::string& record);
+    void removePerfSubscription(int fd);
+    void flushPerfStreams();
+
+    std::mutex _perfMutex;
+    std::unordered_map<int, PerfSubscription> _perfSubscriptions;
+    // FrameStats listener, only touched on the cocos thread
+    int _perfListenerId;
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Console);
     
@@ -33,14 +33,16 @@ const Data Data::Null;
 
 Data::Data() :
 _bytes(nullptr),
-_size(0)
+_size(0),
+_view(false)
 {
     CCLOGINFO("In the empty constructor of Data.");
 }
 
 Data::Data(Data&& other) :
 _bytes(nullptr),
-_size(0)
+_size(0),
+_view(false)
 {
     CCLOGINFO("In the move constructor of Data.");
     move(other);
@@ -48,7 +50,8 @@ _size(0)
 
 Data::Data(const Data& other) :
 _bytes(nullptr),
-_size(0)
+_size(0),
+_view(false)
 {
     CCLOGINFO("In the copy constructor of Data.");
     copy(other._bytes, other._size);
@@ -86,9 +89,11 @@ void Data::move(Data& other)
     
     _bytes = other._bytes;
     _size = other._size;
+    _view = other._view;
 
     other._bytes = nullptr;
     other._size = 0;
+    other._view = false;
 }
 
 bool Data::isNull() const
@@ -118,6 +123,7 @@ ssize_t Data::copy(const unsigned char* bytes, const ssize_t size)
         clear();
         _bytes = (unsigned char*)malloc(sizeof(unsigned char) * size);
         memcpy(_bytes, bytes, size);
+        _view = false;
     }
 
     _size = size;
@@ -130,13 +136,24 @@ void Data::fastSet(unsigned char* bytes, const ssize_t size)
     //CCASSERT(bytes, "bytes should not be nullptr");
     _bytes = bytes;
     _size = size;
+    _view = false;
+}
+
+void Data::setView(unsigned char* bytes, const ssize_t size)
+{
+    CCASSERT(size >= 0, "setView size should be non-negative");
+    clear();
+    _bytes = bytes;
+    _size = size;
+    _view = true;
 }
 
 void Data::clear()
 {
-    if(_bytes) free(_bytes);
+    if(_bytes && !_view) free(_bytes);
     _bytes = nullptr;
     _size = 0;
+    _view = false;
 }
 
 unsigned char* Data::takeBuffer(ssize_t* size)
@@ -144,6 +161,12 @@ unsigned char* Data::takeBuffer(ssize_t* size)
     auto buffer = getBytes();
     if (size)
         *size = getSize();
+    if (_view && buffer)
+    {
+        // the caller frees the buffer, so hand out a copy of the viewed memory
+        buffer = (unsigned char*)malloc(sizeof(unsigned char) * _size);
+        memcpy(buffer, _bytes, _size);
+    }
     fastSet(nullptr, 0);
     return buffer;
 }
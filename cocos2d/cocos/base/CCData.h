@@ -110,6 +110,16 @@ public:
      */
     void fastSet(unsigned char* bytes, const ssize_t size);
 
+    /** Points the Data at memory it doesn't own, such as a file mapped by FileUtils.
+     *  @note 1. The memory must stay valid for as long as the Data uses it, it is never freed by Data.
+     *        2. Copying the Data copies the bytes, takeBuffer() returns a copy allocated with 'malloc'.
+     *  @see Data::fastSet
+     */
+    void setView(unsigned char* bytes, const ssize_t size);
+
+    /** Whether the bytes are a view set by setView() rather than owned by the Data. */
+    bool isView() const { return _view; }
+
     /**
      * Clears data, free buffer and reset data size.
      */
@@ -149,6 +159,7 @@ private:
 private:
     unsigned char* _bytes;
     ssize_t _size;
+    bool _view;
 };
 
 
@@ -43,9 +43,12 @@ THE SOFTWARE.
 #include "2d/CCTransition.h"
 #include "2d/CCFontFreeType.h"
 #include "2d/CCLabelAtlas.h"
+#include "2d/CCFrameStatsOverlay.h"
+#include "2d/CCTMXXMLParser.h"
 #include "renderer/CCGLProgramCache.h"
 #include "renderer/CCGLProgramStateCache.h"
 #include "renderer/CCTextureCache.h"
+#include "renderer/CCTextureFormatPolicy.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCRenderer.h"
 #include "renderer/CCRenderState.h"
@@ -61,6 +64,7 @@ THE SOFTWARE.
 #include "base/CCAutoreleasePool.h"
 #include "base/CCConfiguration.h"
 #include "base/CCAsyncTaskPool.h"
+#include "base/CCFrameStats.h"
 #include "base/ObjectFactory.h"
 #include "platform/CCApplication.h"
 
@@ -167,6 +171,7 @@ Director::~Director()
     CC_SAFE_RELEASE(_FPSLabel);
     CC_SAFE_RELEASE(_drawnVerticesLabel);
     CC_SAFE_RELEASE(_drawnBatchesLabel);
+    CC_SAFE_RELEASE(_frameStatsOverlay);
 
     CC_SAFE_RELEASE(_runningScene);
     CC_SAFE_RELEASE(_notificationNode);
@@ -262,6 +267,7 @@ void Director::drawScene()
     //tick before glClear: issue #533
     if (! _paused)
     {
+        FrameStats::ScopedPhase updatePhase(FrameStats::Phase::UPDATE);
         _eventDispatcher->dispatchEvent(_eventBeforeUpdate);
         _scheduler->update(_deltaTime);
         _eventDispatcher->dispatchEvent(_eventAfterUpdate);
@@ -277,6 +283,7 @@ void Director::drawScene()
      */
     if (_nextScene)
     {
+        FrameStats::ScopedZone sceneSwitchZone(FrameStats::ZONE_SCENE_SWITCH);
         setNextScene();
     }
 
@@ -300,6 +307,7 @@ void Director::drawScene()
     // draw the notifications node
     if (_notificationNode)
     {
+        FrameStats::ScopedPhase visitPhase(FrameStats::Phase::VISIT);
         _notificationNode->visit(_renderer, Mat4::IDENTITY, 0);
     }
 
@@ -311,8 +319,17 @@ void Director::drawScene()
         showStats();
 #endif
     }
+
+    if (_frameStatsOverlay)
+    {
+        _frameStatsOverlay->refresh(_deltaTime);
+        _frameStatsOverlay->visit(_renderer, Mat4::IDENTITY, 0);
+    }
     
-    _renderer->render();
+    {
+        FrameStats::ScopedPhase renderPhase(FrameStats::Phase::RENDER);
+        _renderer->render();
+    }
 
     _eventDispatcher->dispatchEvent(_eventAfterDraw);
 
@@ -323,9 +340,12 @@ void Director::drawScene()
     // swap buffers
     if (_openGLView)
     {
+        FrameStats::ScopedPhase swapPhase(FrameStats::Phase::GPU_WAIT);
         _openGLView->swapBuffers();
     }
 
+    FrameStats::getInstance()->endFrame();
+
     if (_displayStats)
     {
 #if !CC_STRIP_FPS
@@ -693,6 +713,7 @@ void Director::purgeCachedData(void)
 {
     FontFNT::purgeCachedData();
     FontAtlasCache::purgeCachedData();
+    TMXTilesetSource::purgeCache();
 
     if (s_SharedDirector->getOpenGLView())
     {
@@ -1073,10 +1094,12 @@ void Director::reset()
     CC_SAFE_RELEASE_NULL(_FPSLabel);
     CC_SAFE_RELEASE_NULL(_drawnBatchesLabel);
     CC_SAFE_RELEASE_NULL(_drawnVerticesLabel);
+    CC_SAFE_RELEASE_NULL(_frameStatsOverlay);
     
     // purge bitmap cache
     FontFNT::purgeCachedData();
     FontAtlasCache::purgeCachedData();
+    TMXTilesetSource::purgeCache();
     
     FontFreeType::shutdownFreeType();
     
@@ -1099,6 +1122,8 @@ void Director::reset()
 #endif
     AnimationCache::destroyInstance();
     SpriteFrameCache::destroyInstance();
+    TextureFormatPolicy::destroyInstance();
+    FrameStats::destroyInstance();
     GLProgramCache::destroyInstance();
     GLProgramStateCache::destroyInstance();
     FileUtils::destroyInstance();
@@ -1195,6 +1220,12 @@ void Director::setNextScene()
         _runningScene->onEnterTransitionDidFinish();
     }
     
+    // the textures of the previous scene are only unreferenced once the autorelease pool is drained
+    if (! newIsTransition)
+    {
+        _trimTexturesInNextLoop = true;
+    }
+
     _eventDispatcher->dispatchEvent(_afterSetNextScene);
 }
 
@@ -1387,6 +1418,26 @@ void Director::createStatsLabel()
 
 #endif // #if !CC_STRIP_FPS
 
+void Director::setDisplayFrameStats(bool displayFrameStats)
+{
+    if (displayFrameStats == isDisplayFrameStats())
+        return;
+
+    if (displayFrameStats)
+    {
+        _frameStatsOverlay = FrameStatsOverlay::create();
+        CC_SAFE_RETAIN(_frameStatsOverlay);
+    }
+    else
+    {
+        CC_SAFE_RELEASE_NULL(_frameStatsOverlay);
+    }
+    if (displayFrameStats)
+        FrameStats::getInstance()->beginRecording();
+    else
+        FrameStats::getInstance()->endRecording();
+}
+
 void Director::setContentScaleFactor(float scaleFactor)
 {
     if (scaleFactor != _contentScaleFactor)
@@ -1475,7 +1526,20 @@ void Director::mainLoop()
         drawScene();
      
         // release the objects
-        PoolManager::getInstance()->getCurrentPool()->clear();
+        {
+            FrameStats::ScopedZone autoreleaseZone(FrameStats::ZONE_AUTORELEASE);
+            PoolManager::getInstance()->getCurrentPool()->clear();
+        }
+
+        if (_trimTexturesInNextLoop)
+        {
+            FrameStats::ScopedZone trimZone(FrameStats::ZONE_TEXTURE_TRIM);
+            _trimTexturesInNextLoop = false;
+            if (_textureCache)
+            {
+                _textureCache->trimToMemoryBudget();
+            }
+        }
     }
 }
 
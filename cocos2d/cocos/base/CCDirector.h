@@ -50,6 +50,7 @@ NS_CC_BEGIN
 
 /* Forward declarations. */
 class LabelAtlas;
+class FrameStatsOverlay;
 //class GLView;
 class DirectorDelegate;
 class Node;
@@ -174,6 +175,13 @@ public:
     bool isDisplayStats() { return _displayStats; }
     /** Display the FPS on the bottom-left corner of the screen. */
     void setDisplayStats(bool displayStats) { _displayStats = displayStats; }
+
+    /** Whether or not the frame stats overlay is displayed. */
+    bool isDisplayFrameStats() const { return _frameStatsOverlay != nullptr; }
+    /** Displays the frame time graphs and engine counters of FrameStats on the top-left corner of the screen.
+     * FrameStats records while the overlay is displayed.
+     */
+    void setDisplayFrameStats(bool displayFrameStats);
     
     /** Get seconds per frame. */
     float getSecondsPerFrame() { return _secondsPerFrame; }
@@ -596,6 +604,8 @@ protected:
     
     void restartDirector();
     bool _restartDirectorInNextLoop = false; // this flag will be set to true in restart()
+
+    bool _trimTexturesInNextLoop = false; // this flag will be set to true when a scene replaces the running one
     
     void setNextScene();
     
@@ -668,6 +678,8 @@ protected:
     LabelAtlas *_FPSLabel = nullptr;
     LabelAtlas *_drawnBatchesLabel = nullptr;
     LabelAtlas *_drawnVerticesLabel = nullptr;
+
+    FrameStatsOverlay *_frameStatsOverlay = nullptr;
     
     /** Whether or not the Director is paused */
     bool _paused = false;
@@ -202,7 +202,6 @@ void EventDispatcher::EventListenerVector::clear()
 EventDispatcher::EventDispatcher()
 : _inDispatch(0)
 , _isEnabled(false)
-, _nodePriorityIndex(0)
 {
     _toAddedListeners.reserve(50);
     _toRemovedListeners.reserve(50);
@@ -222,73 +221,100 @@ EventDispatcher::~EventDispatcher()
     removeAllEventListeners();
 }
 
-void EventDispatcher::visitTarget(Node* node, bool isRootNode)
+bool EventDispatcher::isVisitedBefore(const SceneGraphOrderKey& a, const SceneGraphOrderKey& b)
 {
-    node->sortAllChildren();
-    
-    int i = 0;
-    auto& children = node->getChildren();
-    
-    auto childrenCount = children.size();
-    
-    if(childrenCount > 0)
+    if (a.globalZOrder != b.globalZOrder)
     {
-        Node* child = nullptr;
-        // visit children zOrder < 0
-        for( ; i < childrenCount; i++ )
-        {
-            child = children.at(i);
-            
-            if ( child && child->getLocalZOrder() < 0 )
-                visitTarget(child, false);
-            else
-                break;
-        }
-        
-        if (_nodeListenersMap.find(node) != _nodeListenersMap.end())
-        {
-            _globalZOrderNodeMap[node->getGlobalZOrder()].push_back(node);
-        }
-        
-        for( ; i < childrenCount; i++ )
-        {
-            child = children.at(i);
-            if (child)
-                visitTarget(child, false);
-        }
+        return a.globalZOrder < b.globalZOrder;
     }
-    else
+
+    size_t common = std::min(a.path.size(), b.path.size());
+    for (size_t i = 0; i < common; ++i)
     {
-        if (_nodeListenersMap.find(node) != _nodeListenersMap.end())
+        if (a.path[i] != b.path[i])
         {
-            _globalZOrderNodeMap[node->getGlobalZOrder()].push_back(node);
+            return a.path[i] < b.path[i];
         }
     }
-    
-    if (isRootNode)
+
+    if (a.path.size() == b.path.size())
     {
-        std::vector<float> globalZOrders;
-        globalZOrders.reserve(_globalZOrderNodeMap.size());
-        
-        for (const auto& e : _globalZOrderNodeMap)
+        return false;
+    }
+
+    // One node is an ancestor of the other. A parent is visited after its children with a negative
+    // local z order and before the others; the sign of the path entry is the sign of the local z order.
+    if (a.path.size() < b.path.size())
+    {
+        return b.path[common] >= 0;
+    }
+    return a.path[common] < 0;
+}
+
+bool EventDispatcher::computeSceneGraphOrderKey(Node* node, Node* scene, SceneGraphOrderKey* key) const
+{
+    key->globalZOrder = node->getGlobalZOrder();
+    key->path.clear();
+
+    Node* n = node;
+    for (; n != nullptr && n != scene; n = n->getParent())
+    {
+        key->path.push_back((std::int64_t)n->_localZOrder * 4294967296LL + n->_orderOfArrival);
+    }
+    std::reverse(key->path.begin(), key->path.end());
+
+    return n == scene;
+}
+
+void EventDispatcher::updateSceneGraphOrder(Node* scene)
+{
+    if (_staleOrderNodes.empty())
+    {
+        return;
+    }
+
+    SceneGraphOrderKey key;
+    for (auto node : _staleOrderNodes)
+    {
+        auto iter = std::find(_sceneGraphOrder.begin(), _sceneGraphOrder.end(), node);
+        if (iter != _sceneGraphOrder.end())
         {
-            globalZOrders.push_back(e.first);
+            _sceneGraphOrder.erase(iter);
         }
-        
-        std::stable_sort(globalZOrders.begin(), globalZOrders.end(), [](const float a, const float b){
-            return a < b;
-        });
-        
-        for (const auto& globalZ : globalZOrders)
+
+        if (!computeSceneGraphOrderKey(node, scene, &key))
         {
-            for (const auto& n : _globalZOrderNodeMap[globalZ])
-            {
-                _nodePriorityMap[n] = ++_nodePriorityIndex;
-            }
+            // not in the running scene: no priority, like a node the scene graph walk never reached
+            _sceneGraphOrderKeys.erase(node);
+            continue;
         }
-        
-        _globalZOrderNodeMap.clear();
+
+        auto position = std::upper_bound(_sceneGraphOrder.begin(), _sceneGraphOrder.end(), key, [this](const SceneGraphOrderKey& k, Node* n) {
+            return isVisitedBefore(k, _sceneGraphOrderKeys[n]);
+        });
+        _sceneGraphOrder.insert(position, node);
+        _sceneGraphOrderKeys[node] = key;
+    }
+    _staleOrderNodes.clear();
+
+    _nodePriorityMap.clear();
+    int priority = 0;
+    for (auto node : _sceneGraphOrder)
+    {
+        _nodePriorityMap[node] = ++priority;
+    }
+}
+
+void EventDispatcher::removeFromSceneGraphOrder(Node* node)
+{
+    auto iter = std::find(_sceneGraphOrder.begin(), _sceneGraphOrder.end(), node);
+    if (iter != _sceneGraphOrder.end())
+    {
+        _sceneGraphOrder.erase(iter);
     }
+    _sceneGraphOrderKeys.erase(node);
+    _staleOrderNodes.erase(node);
+    _nodePriorityMap.erase(node);
 }
 
 void EventDispatcher::pauseEventListenersForTarget(Node* target, bool recursive/* = false */)
@@ -301,6 +327,9 @@ void EventDispatcher::pauseEventListenersForTarget(Node* target, bool recursive/
         {
             l->setPaused(true);
         }
+
+        // usually leaving the scene: drop it from the ordering index at the next sort
+        _staleOrderNodes.insert(target);
     }
 
     for (auto& listener : _toAddedListeners)
@@ -359,6 +388,7 @@ void EventDispatcher::removeEventListenersForTarget(Node* target, bool recursive
     // Don't want any dangling pointers or the possibility of dealing with deleted objects..
     _nodePriorityMap.erase(target);
     _dirtyNodes.erase(target);
+    _dirtySubtreeRoots.erase(target);
 
     auto listenerIter = _nodeListenersMap.find(target);
     if (listenerIter != _nodeListenersMap.end())
@@ -415,6 +445,8 @@ void EventDispatcher::associateNodeAndEventListener(Node* node, EventListener* l
     {
         listeners = new (std::nothrow) std::vector<EventListener*>();
         _nodeListenersMap.emplace(node, listeners);
+        // first listener of the node: give it a place in the ordering index at the next sort
+        _staleOrderNodes.insert(node);
     }
     
     listeners->push_back(listener);
@@ -437,6 +469,7 @@ void EventDispatcher::dissociateNodeAndEventListener(Node* node, EventListener*
         {
             _nodeListenersMap.erase(found);
             delete listeners;
+            removeFromSceneGraphOrder(node);
         }
     }
 }
@@ -951,6 +984,16 @@ bool EventDispatcher::hasEventListener(const EventListener::ListenerID& listener
     return getListeners(listenerID) != nullptr;
 }
 
+size_t EventDispatcher::getListenerCount() const
+{
+    size_t count = _toAddedListeners.size();
+    for (const auto& listeners : _listenerMap)
+    {
+        count += listeners.second->size();
+    }
+    return count;
+}
+
 void EventDispatcher::dispatchTouchEvent(EventTouch* event)
 {
     sortEventListeners(EventListenerTouchOneByOne::LISTENER_ID);
@@ -1258,6 +1301,25 @@ void EventDispatcher::updateListeners(Event* event)
 
 void EventDispatcher::updateDirtyFlagForSceneGraph()
 {
+    // Only few nodes have listeners, so look for the dirty subtree roots among their ancestors
+    // once per dispatch instead of walking every dirty node's whole subtree.
+    if (!_dirtySubtreeRoots.empty())
+    {
+        for (const auto& e : _nodeListenersMap)
+        {
+            for (Node* n = e.first->getParent(); n != nullptr; n = n->getParent())
+            {
+                if (_dirtySubtreeRoots.find(n) != _dirtySubtreeRoots.end())
+                {
+                    _dirtyNodes.insert(e.first);
+                    _staleOrderNodes.insert(e.first);
+                    break;
+                }
+            }
+        }
+        _dirtySubtreeRoots.clear();
+    }
+
     if (!_dirtyNodes.empty())
     {
         for (auto& node : _dirtyNodes)
@@ -1322,11 +1384,8 @@ void EventDispatcher::sortEventListenersOfSceneGraphPriority(const EventListener
     if (sceneGraphListeners == nullptr)
         return;
 
-    // Reset priority index
-    _nodePriorityIndex = 0;
-    _nodePriorityMap.clear();
-
-    visitTarget(rootNode, true);
+    // Only the nodes whose ancestors, order or global z order changed are moved in the index
+    updateSceneGraphOrder(rootNode);
     
     // After sort: priority < 0, > 0
     std::stable_sort(sceneGraphListeners->begin(), sceneGraphListeners->end(), [this](const EventListener* l1, const EventListener* l2) {
@@ -1533,13 +1592,13 @@ void EventDispatcher::setDirtyForNode(Node* node)
     if (_nodeListenersMap.find(node) != _nodeListenersMap.end())
     {
         _dirtyNodes.insert(node);
+        _staleOrderNodes.insert(node);
     }
 
-    // Also set the dirty flag for node's children
-    const auto& children = node->getChildren();
-    for (const auto& child : children)
+    // Its descendants are resolved at the next dispatch, see updateDirtyFlagForSceneGraph()
+    if (node->getChildrenCount() > 0)
     {
-        setDirtyForNode(child);
+        _dirtySubtreeRoots.insert(node);
     }
 }
 
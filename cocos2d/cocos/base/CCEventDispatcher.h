@@ -31,6 +31,7 @@
 #include <unordered_map>
 #include <vector>
 #include <set>
+#include <unordered_set>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/CCEventListener.h"
@@ -186,6 +187,12 @@ public:
      */
     bool hasEventListener(const EventListener::ListenerID& listenerID) const;
 
+    /** Returns the number of registered event listeners, including the ones waiting to be added.
+     *
+     * @return The number of event listeners.
+     */
+    size_t getListenerCount() const;
+
     /////////////////////////////////////////////
     
     /** Constructor of EventDispatcher.
@@ -309,8 +316,25 @@ protected:
     /** Sets the dirty flag for a specified listener ID */
     void setDirty(const EventListener::ListenerID& listenerID, DirtyFlag flag);
     
-    /** Walks though scene graph to get the draw order for each node, it's called before sorting event listener with scene graph priority */
-    void visitTarget(Node* node, bool isRootNode);
+    /** Where a node with scene graph priority listeners is visited: ordered by global z, then by visit order. */
+    struct SceneGraphOrderKey
+    {
+        float globalZOrder;
+        /** Local z order and order of arrival of every node from the scene's child down to the node itself. */
+        std::vector<std::int64_t> path;
+    };
+
+    /** Whether the node of key a is visited before the node of key b. */
+    static bool isVisitedBefore(const SceneGraphOrderKey& a, const SceneGraphOrderKey& b);
+
+    /** Fills the key of a node, returns false when the node is not in the scene. */
+    bool computeSceneGraphOrderKey(Node* node, Node* scene, SceneGraphOrderKey* key) const;
+
+    /** Moves the stale nodes to their new place in the ordering index and renumbers _nodePriorityMap. */
+    void updateSceneGraphOrder(Node* scene);
+
+    /** Drops a node from the ordering index when its last listener is dissociated. */
+    void removeFromSceneGraphOrder(Node* node);
 
     /** Remove all listeners in _toRemoveListeners list and cleanup */
     void cleanToRemovedListeners();
@@ -327,8 +351,14 @@ protected:
     /** The map of node and its event priority */
     std::unordered_map<Node*, int> _nodePriorityMap;
     
-    /** key: Global Z Order, value: Sorted Nodes */
-    std::unordered_map<float, std::vector<Node*>> _globalZOrderNodeMap;
+    /** Nodes with listeners that are in the running scene, in visit order. Kept up to date incrementally instead of walking the scene graph */
+    std::vector<Node*> _sceneGraphOrder;
+
+    /** The keys of the nodes in _sceneGraphOrder */
+    std::unordered_map<Node*, SceneGraphOrderKey> _sceneGraphOrderKeys;
+
+    /** Nodes with listeners whose place in _sceneGraphOrder has to be recomputed */
+    std::unordered_set<Node*> _staleOrderNodes;
     
     /** The listeners to be added after dispatching event */
     std::vector<EventListener*> _toAddedListeners;
@@ -338,6 +368,9 @@ protected:
 
     /** The nodes were associated with scene graph based priority listeners */
     std::set<Node*> _dirtyNodes;
+
+    /** Nodes whose descendants with listeners must be marked dirty at the next dispatch */
+    std::unordered_set<Node*> _dirtySubtreeRoots;
     
     /** Whether the dispatcher is dispatching event */
     int _inDispatch;
@@ -345,8 +378,6 @@ protected:
     /** Whether to enable dispatching event */
     bool _isEnabled;
     
-    int _nodePriorityIndex;
-    
     std::set<std::string> _internalCustomListenerIDs;
 };
 
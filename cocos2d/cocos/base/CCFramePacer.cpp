@@ -0,0 +1,188 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "base/CCFramePacer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+NS_CC_BEGIN
+
+namespace
+{
+    // enough for a couple of seconds at 144 Hz
+    const size_t SAMPLE_CAPACITY = 512;
+
+    const double MIN_SLEEP_OVERSHOOT = 50000.0;     // 0.05 ms
+    const double MAX_SLEEP_OVERSHOOT = 4000000.0;   // 4 ms
+    const double INITIAL_SLEEP_OVERSHOOT = 1000000.0;
+
+    double percentile(std::vector<float>& values, double p)
+    {
+        size_t index = (size_t)std::ceil(p * values.size());
+        index = index > 0 ? index - 1 : 0;
+        std::nth_element(values.begin(), values.begin() + index, values.end());
+        return values[index];
+    }
+}
+
+FramePacer::FramePacer()
+: _mode(Mode::TIMER)
+, _sleepOvershoot(INITIAL_SLEEP_OVERSHOOT)
+, _samples(SAMPLE_CAPACITY, 0.0f)
+, _sampleHead(0)
+, _sampleCount(0)
+, _missedDeadlines(0)
+{
+    setInterval(1.0 / 60.0);
+    begin();
+}
+
+void FramePacer::setInterval(double seconds)
+{
+    _interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+}
+
+double FramePacer::getInterval() const
+{
+    return std::chrono::duration_cast<std::chrono::duration<double>>(_interval).count();
+}
+
+void FramePacer::begin()
+{
+    _lastFrame = Clock::now();
+    _deadline = _lastFrame + _interval;
+}
+
+void FramePacer::waitForNextFrame()
+{
+    auto now = Clock::now();
+
+    if (_mode == Mode::TIMER)
+    {
+        if (now < _deadline)
+        {
+            sleepUntil(_deadline);
+            now = Clock::now();
+            _deadline += _interval;
+        }
+        else
+        {
+            ++_missedDeadlines;
+            // far behind: start over from now instead of rushing the next frames
+            if (now - _deadline >= _interval)
+                _deadline = now + _interval;
+            else
+                _deadline += _interval;
+        }
+    }
+    else
+    {
+        // the swap already waited; a frame longer than 1.5 refreshes skipped one
+        if ((now - _lastFrame) * 2 > _interval * 3)
+        {
+            ++_missedDeadlines;
+        }
+        _deadline = now + _interval;
+    }
+
+    recordFrame(now);
+}
+
+void FramePacer::sleepUntil(const Clock::time_point& deadline)
+{
+    auto now = Clock::now();
+    auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now).count();
+
+    // sleep for the part the scheduler is expected to honour
+    double sleepTime = remaining - _sleepOvershoot;
+    if (sleepTime > 0)
+    {
+        auto requested = std::chrono::nanoseconds((long long)sleepTime);
+        std::this_thread::sleep_for(requested);
+        auto slept = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - now).count();
+
+        // grow quickly when the OS oversleeps more than expected, shrink slowly
+        double overshoot = (double)(slept - requested.count());
+        if (overshoot > _sleepOvershoot)
+            _sleepOvershoot = _sleepOvershoot * 0.5 + overshoot * 0.5;
+        else
+            _sleepOvershoot = _sleepOvershoot * 0.95 + overshoot * 0.05;
+        _sleepOvershoot = std::max(MIN_SLEEP_OVERSHOOT, std::min(MAX_SLEEP_OVERSHOOT, _sleepOvershoot));
+    }
+
+    // spin for the rest
+    while (Clock::now() < deadline)
+    {
+        std::this_thread::yield();
+    }
+}
+
+void FramePacer::recordFrame(const Clock::time_point& now)
+{
+    auto frameTime = std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(now - _lastFrame).count();
+    _lastFrame = now;
+
+    _samples[_sampleHead] = frameTime;
+    _sampleHead = (_sampleHead + 1) % _samples.size();
+    _sampleCount = std::min(_sampleCount + 1, _samples.size());
+}
+
+FramePacer::Statistics FramePacer::getStatistics() const
+{
+    Statistics stats;
+    stats.frames = (unsigned int)_sampleCount;
+    stats.meanMs = stats.p95Ms = stats.p99Ms = stats.maxMs = 0.0;
+    stats.missedDeadlines = _missedDeadlines;
+    stats.sleepOvershootMs = _sleepOvershoot / 1000000.0;
+
+    if (_sampleCount == 0)
+    {
+        return stats;
+    }
+
+    // the ring is full or filled from the start, so the first _sampleCount entries are the samples
+    std::vector<float> values(_samples.begin(), _samples.begin() + _sampleCount);
+
+    double sum = 0.0;
+    for (float value : values)
+    {
+        sum += value;
+        stats.maxMs = std::max(stats.maxMs, (double)value);
+    }
+    stats.meanMs = sum / values.size();
+    stats.p95Ms = percentile(values, 0.95);
+    stats.p99Ms = percentile(values, 0.99);
+    return stats;
+}
+
+void FramePacer::resetStatistics()
+{
+    _sampleHead = 0;
+    _sampleCount = 0;
+    _missedDeadlines = 0;
+}
+
+NS_CC_END
@@ -0,0 +1,125 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef __BASE_CCFRAME_PACER_H__
+#define __BASE_CCFRAME_PACER_H__
+
+#include <chrono>
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup base
+ * @{
+ */
+
+/** @class FramePacer
+ * @brief Paces a main loop to a fixed frame interval and keeps frame time statistics.
+ *
+ * Deadlines are kept on std::chrono::steady_clock with nanosecond resolution, so a 16.67 ms
+ * interval is not rounded to 16 or 17 ms. The wait sleeps until shortly before the deadline and
+ * spins for the rest; the sleep is shortened by the measured oversleep of the OS scheduler,
+ * which is calibrated continuously.
+ *
+ * In VSYNC mode the pacer does not wait at all: the buffer swap blocks on the display, and the
+ * pacer only measures. The interval is then the expected refresh period.
+ *
+ * A frame that ends after its deadline counts as missed. When a frame runs over by more than a
+ * whole interval, the deadlines are resynchronized instead of trying to catch up.
+ *
+ * Not thread safe: use it from the thread that runs the loop.
+ */
+class CC_DLL FramePacer
+{
+public:
+    enum class Mode
+    {
+        /** Sleep then spin until each deadline. */
+        TIMER,
+        /** Let the buffer swap wait for vertical sync and only measure. */
+        VSYNC,
+    };
+
+    /** Frame time statistics over the last getSampleCapacity() frames, in milliseconds. */
+    struct Statistics
+    {
+        unsigned int frames;
+        double meanMs;
+        double p95Ms;
+        double p99Ms;
+        double maxMs;
+        /** Missed deadlines since the last reset, not only within the sample window. */
+        unsigned int missedDeadlines;
+        /** Current estimate of how long the OS oversleeps a request. */
+        double sleepOvershootMs;
+    };
+
+    FramePacer();
+
+    /** Sets the frame interval in seconds. */
+    void setInterval(double seconds);
+    double getInterval() const;
+
+    void setMode(Mode mode) { _mode = mode; }
+    Mode getMode() const { return _mode; }
+
+    /** Starts a new pacing sequence: the next deadline is one interval from now. */
+    void begin();
+
+    /** Waits until the current frame's deadline (TIMER mode), then records the frame. */
+    void waitForNextFrame();
+
+    Statistics getStatistics() const;
+    void resetStatistics();
+
+    /** Number of frames the percentiles are computed over. */
+    size_t getSampleCapacity() const { return _samples.size(); }
+
+protected:
+    typedef std::chrono::steady_clock Clock;
+
+    void sleepUntil(const Clock::time_point& deadline);
+    void recordFrame(const Clock::time_point& now);
+
+    Mode _mode;
+    Clock::duration _interval;
+    Clock::time_point _deadline;
+    Clock::time_point _lastFrame;
+    // calibrated oversleep of sleep_for(), in nanoseconds
+    double _sleepOvershoot;
+
+    std::vector<float> _samples;
+    size_t _sampleHead;
+    size_t _sampleCount;
+    unsigned int _missedDeadlines;
+};
+
+// end of base group
+/// @}
+
+NS_CC_END
+
+#endif // __BASE_CCFRAME_PACER_H__
@@ -0,0 +1,293 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "base/CCFrameStats.h"
+
+#include "base/CCDirector.h"
+#include "base/CCScheduler.h"
+#include "base/CCEventDispatcher.h"
+#include "base/CCRef.h"
+#include "2d/CCActionManager.h"
+#include "renderer/CCTextureCache.h"
+
+NS_CC_BEGIN
+
+FrameStats::ScopedPhase::ScopedPhase(Phase phase)
+: _phase(phase)
+, _active(FrameStats::getInstance()->isEnabled())
+{
+    if (_active)
+    {
+        _start = std::chrono::steady_clock::now();
+    }
+}
+
+FrameStats::ScopedPhase::~ScopedPhase()
+{
+    if (_active)
+    {
+        auto elapsed = std::chrono::steady_clock::now() - _start;
+        FrameStats::getInstance()->addPhaseTime(_phase, std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() / 1000000.0f);
+    }
+}
+
+FrameStats::ScopedZone::ScopedZone(int zoneId)
+: _zoneId(zoneId)
+, _active(FrameStats::getInstance()->isEnabled())
+{
+    if (_active)
+    {
+        _start = std::chrono::steady_clock::now();
+    }
+}
+
+FrameStats::ScopedZone::~ScopedZone()
+{
+    if (_active)
+    {
+        auto elapsed = std::chrono::steady_clock::now() - _start;
+        FrameStats::getInstance()->addZoneTime(_zoneId, std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() / 1000000.0f);
+    }
+}
+
+FrameStats* FrameStats::s_sharedFrameStats = nullptr;
+
+FrameStats* FrameStats::getInstance()
+{
+    if (!s_sharedFrameStats)
+    {
+        s_sharedFrameStats = new (std::nothrow) FrameStats();
+    }
+    return s_sharedFrameStats;
+}
+
+void FrameStats::destroyInstance()
+{
+    CC_SAFE_DELETE(s_sharedFrameStats);
+}
+
+FrameStats::FrameStats()
+: _enabled(false)
+, _recordingClients(0)
+, _historyHead(0)
+, _historyCount(0)
+, _nextListenerId(0)
+{
+    memset(_currentPhases, 0, sizeof(_currentPhases));
+    memset(_history, 0, sizeof(_history));
+
+    static const char* builtinNames[BUILTIN_COUNTER_COUNT] = {
+        "refs", "updates", "timers", "actions", "listeners", "texture KB"
+    };
+    for (int i = 0; i < BUILTIN_COUNTER_COUNT; ++i)
+    {
+        registerCounter(builtinNames[i]);
+    }
+
+    static const char* builtinZones[BUILTIN_ZONE_COUNT] = {
+        "scene switch", "texture load", "texture upload", "texture trim", "sprite frames load", "autorelease"
+    };
+    for (int i = 0; i < BUILTIN_ZONE_COUNT; ++i)
+    {
+        registerZone(builtinZones[i]);
+    }
+}
+
+void FrameStats::beginRecording()
+{
+    if (_recordingClients++ > 0)
+        return;
+
+    _enabled = true;
+    // a restarted recording must not report the frames from before the pause
+    memset(_currentPhases, 0, sizeof(_currentPhases));
+    _historyHead = 0;
+    _historyCount = 0;
+    _lastFrameEnd = std::chrono::steady_clock::now();
+    for (auto& counter : _counters)
+    {
+        counter.value = counter.pending = 0;
+    }
+    for (auto& zone : _zones)
+    {
+        zone.value = zone.pending = 0;
+    }
+}
+
+void FrameStats::endRecording()
+{
+    CCASSERT(_recordingClients > 0, "endRecording() without beginRecording()");
+    if (_recordingClients > 0 && --_recordingClients == 0)
+    {
+        _enabled = false;
+    }
+}
+
+void FrameStats::addPhaseTime(Phase phase, float seconds)
+{
+    _currentPhases[(int)phase] += seconds;
+}
+
+void FrameStats::endFrame()
+{
+    if (!_enabled)
+        return;
+
+    auto now = std::chrono::steady_clock::now();
+    FrameRecord& record = _history[_historyHead];
+    memcpy(record.phases, _currentPhases, sizeof(_currentPhases));
+    record.frameTime = std::chrono::duration_cast<std::chrono::microseconds>(now - _lastFrameEnd).count() / 1000000.0f;
+    _lastFrameEnd = now;
+    memset(_currentPhases, 0, sizeof(_currentPhases));
+    _historyHead = (_historyHead + 1) % HISTORY_SIZE;
+    if (_historyCount < HISTORY_SIZE)
+        ++_historyCount;
+
+    sampleEngineCounters();
+    for (auto& counter : _counters)
+    {
+        counter.value = counter.pending;
+        counter.pending = 0;
+    }
+    for (auto& zone : _zones)
+    {
+        zone.value = zone.pending;
+        zone.pending = 0;
+    }
+
+    // a listener may remove itself
+    auto listeners = _frameListeners;
+    for (auto& listener : listeners)
+    {
+        listener.second(this);
+    }
+}
+
+void FrameStats::sampleEngineCounters()
+{
+    auto director = Director::getInstance();
+    setCounter(COUNTER_REFS, Ref::getLiveCount());
+    setCounter(COUNTER_UPDATES, director->getScheduler()->getScheduledUpdateCount());
+    setCounter(COUNTER_TIMERS, director->getScheduler()->getScheduledTimerCount());
+    setCounter(COUNTER_ACTIONS, director->getActionManager()->getNumberOfRunningActions());
+    setCounter(COUNTER_LISTENERS, director->getEventDispatcher()->getListenerCount());
+    setCounter(COUNTER_TEXTURE_KB, director->getTextureCache()->getResidentBytes() / 1024);
+}
+
+const FrameStats::FrameRecord& FrameStats::getRecord(int framesAgo) const
+{
+    CCASSERT(framesAgo >= 0 && framesAgo < HISTORY_SIZE, "framesAgo out of range");
+    return _history[(_historyHead - 1 - framesAgo + HISTORY_SIZE * 2) % HISTORY_SIZE];
+}
+
+float FrameStats::getPhaseTime(Phase phase, int framesAgo) const
+{
+    if (framesAgo >= _historyCount)
+        return 0.0f;
+    return getRecord(framesAgo).phases[(int)phase];
+}
+
+float FrameStats::getFrameTime(int framesAgo) const
+{
+    if (framesAgo >= _historyCount)
+        return 0.0f;
+    return getRecord(framesAgo).frameTime;
+}
+
+float FrameStats::getPhaseAverage(Phase phase) const
+{
+    if (_historyCount == 0)
+        return 0.0f;
+
+    float total = 0.0f;
+    for (int i = 0; i < _historyCount; ++i)
+    {
+        total += getRecord(i).phases[(int)phase];
+    }
+    return total / _historyCount;
+}
+
+float FrameStats::getPhaseMax(Phase phase) const
+{
+    float longest = 0.0f;
+    for (int i = 0; i < _historyCount; ++i)
+    {
+        longest = std::max(longest, getRecord(i).phases[(int)phase]);
+    }
+    return longest;
+}
+
+const char* FrameStats::getPhaseName(Phase phase)
+{
+    switch (phase)
+    {
+        case Phase::UPDATE:   return "update";
+        case Phase::VISIT:    return "visit";
+        case Phase::RENDER:   return "render";
+        case Phase::GPU_WAIT: return "gpu wait";
+        default:              return "";
+    }
+}
+
+int FrameStats::registerCounter(const std::string& name)
+{
+    for (size_t i = 0; i < _counters.size(); ++i)
+    {
+        if (_counters[i].name == name)
+            return (int)i;
+    }
+    _counters.push_back({ name, 0, 0 });
+    return (int)_counters.size() - 1;
+}
+
+int FrameStats::registerZone(const std::string& name)
+{
+    for (size_t i = 0; i < _zones.size(); ++i)
+    {
+        if (_zones[i].name == name)
+            return (int)i;
+    }
+    _zones.push_back({ name, 0.0f, 0.0f });
+    return (int)_zones.size() - 1;
+}
+
+int FrameStats::addFrameListener(const FrameListener& listener)
+{
+    int listenerId = _nextListenerId++;
+    _frameListeners.push_back(std::make_pair(listenerId, listener));
+    return listenerId;
+}
+
+void FrameStats::removeFrameListener(int listenerId)
+{
+    for (auto it = _frameListeners.begin(); it != _frameListeners.end(); ++it)
+    {
+        if (it->first == listenerId)
+        {
+            _frameListeners.erase(it);
+            return;
+        }
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,250 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef __CCFRAME_STATS_H__
+#define __CCFRAME_STATS_H__
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup base
+ * @{
+ */
+
+/** @class FrameStats
+ * @brief Per-frame timings, zones and counters, recorded while a client such as the frame stats overlay
+ * or a Console "perf" subscriber needs them.
+
+ Director splits every frame into phases: the scheduler update, the scene visit, the renderer
+ flushing the queued commands, and the buffer swap (the time spent waiting for the GPU to catch up).
+ The last HISTORY_SIZE frames are kept for graphs.
+
+ Counters are named values published once per frame. The engine samples its own (live Ref objects,
+ scheduled updates and timers, running actions, event listeners and resident texture memory) when the
+ frame ends; game code registers more and adds to them during the frame. A counter shows the total
+ added during the last frame, so a scene that stops publishing reads 0.
+
+ Zones are named spans of work that explain a slow frame: a scene switch, a synchronous texture load,
+ a game system. They may nest and are reported separately. A frame spans from one endFrame() to the next,
+ so work done after the buffer swap (the autorelease pool, texture trimming) belongs to the next frame.
+
+ Nothing is measured while recording is disabled: ScopedPhase, ScopedZone and addCounter() only test a flag.
+ All of it is main thread only.
+ */
+class CC_DLL FrameStats
+{
+public:
+    enum class Phase
+    {
+        UPDATE,
+        VISIT,
+        RENDER,
+        GPU_WAIT,
+        COUNT
+    };
+
+    /** Engine counters, registered first so their ids are fixed. */
+    enum BuiltinCounter
+    {
+        COUNTER_REFS,
+        COUNTER_UPDATES,
+        COUNTER_TIMERS,
+        COUNTER_ACTIONS,
+        COUNTER_LISTENERS,
+        COUNTER_TEXTURE_KB,
+        BUILTIN_COUNTER_COUNT
+    };
+
+    /** Engine zones, registered first so their ids are fixed. */
+    enum BuiltinZone
+    {
+        ZONE_SCENE_SWITCH,
+        ZONE_TEXTURE_LOAD,
+        ZONE_TEXTURE_UPLOAD,
+        ZONE_TEXTURE_TRIM,
+        ZONE_SPRITE_FRAMES_LOAD,
+        ZONE_AUTORELEASE,
+        BUILTIN_ZONE_COUNT
+    };
+
+    typedef std::function<void(FrameStats* stats)> FrameListener;
+
+    static const int HISTORY_SIZE = 120;
+
+    /** Adds the time spent in its scope to a phase of the current frame. */
+    class CC_DLL ScopedPhase
+    {
+    public:
+        explicit ScopedPhase(Phase phase);
+        ~ScopedPhase();
+
+    private:
+        Phase _phase;
+        bool _active;
+        std::chrono::steady_clock::time_point _start;
+    };
+
+    /** Adds the time spent in its scope to a zone of the current frame. */
+    class CC_DLL ScopedZone
+    {
+    public:
+        explicit ScopedZone(int zoneId);
+        ~ScopedZone();
+
+    private:
+        int _zoneId;
+        bool _active;
+        std::chrono::steady_clock::time_point _start;
+    };
+
+    static FrameStats* getInstance();
+    static void destroyInstance();
+
+    /** Recording is enabled while at least one client has called beginRecording() without endRecording().
+     * The history and counters are cleared when it starts again.
+     */
+    void beginRecording();
+    void endRecording();
+    bool isEnabled() const { return _enabled; }
+
+    /** Adds time, in seconds, to a phase of the current frame. */
+    void addPhaseTime(Phase phase, float seconds);
+
+    /** Closes the current frame: pushes the phase times into the history, publishes the counters and
+     * zones, then calls the frame listeners. Called by Director after the buffers are swapped.
+     */
+    void endFrame();
+
+    /** Returns the time, in seconds, a phase took in a recorded frame.
+     *
+     * @param framesAgo 0 for the last completed frame, up to HISTORY_SIZE - 1.
+     */
+    float getPhaseTime(Phase phase, int framesAgo = 0) const;
+
+    /** Returns the wall time, in seconds, between the end of a recorded frame and the end of the one before. */
+    float getFrameTime(int framesAgo = 0) const;
+
+    /** Returns the mean time of a phase over the recorded history. */
+    float getPhaseAverage(Phase phase) const;
+
+    /** Returns the longest time of a phase over the recorded history. */
+    float getPhaseMax(Phase phase) const;
+
+    /** Returns the number of frames in the history, at most HISTORY_SIZE. */
+    int getHistoryCount() const { return _historyCount; }
+
+    static const char* getPhaseName(Phase phase);
+
+    /** Registers a counter, or returns the id of the counter already registered with this name. */
+    int registerCounter(const std::string& name);
+
+    /** Adds to a counter for the current frame. Does nothing while recording is disabled. */
+    void addCounter(int counterId, long long delta)
+    {
+        if (_enabled)
+            _counters[counterId].pending += delta;
+    }
+
+    /** Replaces the value of a counter for the current frame. */
+    void setCounter(int counterId, long long value)
+    {
+        if (_enabled)
+            _counters[counterId].pending = value;
+    }
+
+    /** Returns the value of a counter in the last completed frame. */
+    long long getCounter(int counterId) const { return _counters[counterId].value; }
+
+    int getCounterCount() const { return (int)_counters.size(); }
+    const std::string& getCounterName(int counterId) const { return _counters[counterId].name; }
+
+    /** Registers a zone, or returns the id of the zone already registered with this name. */
+    int registerZone(const std::string& name);
+
+    /** Adds time, in seconds, to a zone of the current frame. */
+    void addZoneTime(int zoneId, float seconds) { _zones[zoneId].pending += seconds; }
+
+    /** Returns the time, in seconds, spent in a zone during the last completed frame. */
+    float getZoneTime(int zoneId) const { return _zones[zoneId].value; }
+
+    int getZoneCount() const { return (int)_zones.size(); }
+    const std::string& getZoneName(int zoneId) const { return _zones[zoneId].name; }
+
+    /** Adds a function called at the end of every recorded frame. Returns an id for removeFrameListener(). */
+    int addFrameListener(const FrameListener& listener);
+    void removeFrameListener(int listenerId);
+
+protected:
+    struct Counter
+    {
+        std::string name;
+        long long value;
+        long long pending;
+    };
+
+    struct Zone
+    {
+        std::string name;
+        float value;
+        float pending;
+    };
+
+    struct FrameRecord
+    {
+        float phases[(int)Phase::COUNT];
+        float frameTime;
+    };
+
+    FrameStats();
+
+    void sampleEngineCounters();
+    const FrameRecord& getRecord(int framesAgo) const;
+
+    static FrameStats* s_sharedFrameStats;
+
+    bool _enabled;
+    int _recordingClients;
+    std::chrono::steady_clock::time_point _lastFrameEnd;
+    float _currentPhases[(int)Phase::COUNT];
+    FrameRecord _history[HISTORY_SIZE];
+    int _historyHead;
+    int _historyCount;
+    std::vector<Counter> _counters;
+    std::vector<Zone> _zones;
+    std::vector<std::pair<int, FrameListener>> _frameListeners;
+    int _nextListenerId;
+};
+
+// end of base group
+/** @} */
+
+NS_CC_END
+
+#endif // __CCFRAME_STATS_H__
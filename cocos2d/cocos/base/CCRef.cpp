@@ -25,6 +25,9 @@ THE SOFTWARE.
 ****************************************************************************/
 
 #include "base/CCRef.h"
+
+#include <atomic>
+
 #include "base/CCAutoreleasePool.h"
 #include "base/ccMacros.h"
 #include "base/CCScriptSupport.h"
@@ -43,6 +46,9 @@ static void trackRef(Ref* ref);
 static void untrackRef(Ref* ref);
 #endif
 
+// Refs are also created on the texture loading thread
+static std::atomic<unsigned int> s_liveRefCount(0);
+
 Ref::Ref()
 : _referenceCount(1) // when the Ref is created, the reference count of it is 1
 #if CC_ENABLE_SCRIPT_BINDING
@@ -59,6 +65,7 @@ Ref::Ref()
 #if CC_REF_LEAK_DETECTION
     trackRef(this);
 #endif
+    s_liveRefCount.fetch_add(1, std::memory_order_relaxed);
 }
 
 Ref::~Ref()
@@ -86,6 +93,7 @@ Ref::~Ref()
     if (_referenceCount != 0)
         untrackRef(this);
 #endif
+    s_liveRefCount.fetch_sub(1, std::memory_order_relaxed);
 }
 
 void Ref::retain()
@@ -162,6 +170,11 @@ unsigned int Ref::getReferenceCount() const
     return _referenceCount;
 }
 
+unsigned int Ref::getLiveCount()
+{
+    return s_liveRefCount.load(std::memory_order_relaxed);
+}
+
 #if CC_REF_LEAK_DETECTION
 
 static std::vector<Ref*> __refAllocationList;
@@ -125,6 +125,14 @@ public:
      */
     unsigned int getReferenceCount() const;
 
+    /**
+     * Returns the number of Ref objects currently alive, counted by the constructor and destructor.
+     *
+     * @returns The number of live Ref objects.
+     * @js NA
+     */
+    static unsigned int getLiveCount();
+
 protected:
     /**
      * Constructor
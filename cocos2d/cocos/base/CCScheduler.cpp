@@ -27,47 +27,15 @@ THE SOFTWARE.
 ****************************************************************************/
 
 #include "base/CCScheduler.h"
+
+#include <algorithm>
+
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
-#include "base/utlist.h"
-#include "base/ccCArray.h"
 #include "base/CCScriptSupport.h"
 
 NS_CC_BEGIN
 
-// data structures
-
-// A list double-linked list used for "updates with priority"
-typedef struct _listEntry
-{
-    struct _listEntry   *prev, *next;
-    ccSchedulerFunc     callback;
-    void                *target;
-    int                 priority;
-    bool                paused;
-    bool                markedForDeletion; // selector will no longer be called and entry will be removed at end of the next tick
-} tListEntry;
-
-typedef struct _hashUpdateEntry
-{
-    tListEntry          **list;        // Which list does it belong to ?
-    tListEntry          *entry;        // entry in the list
-    void                *target;
-    ccSchedulerFunc     callback;
-    UT_hash_handle      hh;
-} tHashUpdateEntry;
-
-// Hash Element used for "selectors with interval"
-typedef struct _hashSelectorEntry
-{
-    ccArray             *timers;
-    void                *target;
-    int                 timerIndex;
-    Timer               *currentTimer;
-    bool                paused;
-    UT_hash_handle      hh;
-} tHashTimerEntry;
-
 // implementation Timer
 
 Timer::Timer()
@@ -151,6 +119,21 @@ bool Timer::isExhausted() const
     return !_runForever && _timesExecuted > _repeat;
 }
 
+float Timer::getTimeToNextTrigger() const
+{
+    // not initialized yet: the next update() only resets the elapsed time
+    if (_elapsed == -1 || _aborted)
+    {
+        return 0.0f;
+    }
+    if (_useDelay)
+    {
+        return std::max(0.0f, _delay - _elapsed);
+    }
+    // _interval == 0 triggers every frame
+    return _interval > 0 ? std::max(0.0f, _interval - _elapsed) : 0.0f;
+}
+
 // TimerTargetSelector
 
 TimerTargetSelector::TimerTargetSelector()
@@ -250,16 +233,18 @@ const int Scheduler::PRIORITY_SYSTEM = INT_MIN;
 // Minimum priority level for user scheduling.
 const int Scheduler::PRIORITY_NON_SYSTEM_MIN = PRIORITY_SYSTEM + 1;
 
+// Orders the timer heap so that front() is the timer due first, ties in scheduling order.
+bool Scheduler::compareTimerHeapItems(const TimerHeapItem& a, const TimerHeapItem& b)
+{
+    return a.due > b.due || (a.due == b.due && a.sequence > b.sequence);
+}
+
 Scheduler::Scheduler(void)
 : _timeScale(1.0f)
-, _updatesNegList(nullptr)
-, _updates0List(nullptr)
-, _updatesPosList(nullptr)
-, _hashForUpdates(nullptr)
-, _hashForTimers(nullptr)
-, _currentTarget(nullptr)
-, _currentTargetSalvaged(false)
-, _updateHashLocked(false)
+, _updatesDirty(false)
+, _clock(0.0)
+, _timerSequence(0)
+, _liveTimers(0)
 #if CC_ENABLE_SCRIPT_BINDING
 , _scriptHandlerEntries(20)
 #endif
@@ -273,64 +258,154 @@ Scheduler::~Scheduler(void)
     unscheduleAll();
 }
 
-void Scheduler::removeHashElement(_hashSelectorEntry *element)
+Scheduler::TimerTarget& Scheduler::getOrCreateTimerTarget(void* target, bool paused)
 {
-    ccArrayFree(element->timers);
-    HASH_DEL(_hashForTimers, element);
-    free(element);
+    auto it = _timerTargets.find(target);
+    if (it == _timerTargets.end())
+    {
+        TimerTarget& timerTarget = _timerTargets[target];
+        // Is this the 1st element ? Then set the pause level to all the selectors of this target
+        timerTarget.paused = paused;
+        timerTarget.pausedAt = _clock;
+        return timerTarget;
+    }
+
+    CCASSERT(it->second.paused == paused, "element's paused should be paused!");
+    return it->second;
 }
 
-void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, bool paused, const std::string& key)
+void Scheduler::addTimer(TimerTarget& timerTarget, void* target, Timer* timer)
 {
-    this->schedule(callback, target, interval, CC_REPEAT_FOREVER, 0.0f, paused, key);
+    int slot;
+    if (!_freeTimerSlots.empty())
+    {
+        slot = _freeTimerSlots.back();
+        _freeTimerSlots.pop_back();
+    }
+    else
+    {
+        slot = (int)_timerSlots.size();
+        _timerSlots.push_back(TimerSlot());
+    }
+
+    timer->retain();
+    TimerSlot& timerSlot = _timerSlots[slot];
+    timerSlot.timer = timer;
+    timerSlot.target = target;
+    // a timer added to a paused target starts counting when the target resumes
+    timerSlot.lastClock = timerTarget.paused ? timerTarget.pausedAt : _clock;
+    timerSlot.paused = timerTarget.paused;
+    timerTarget.slots.push_back(slot);
+    ++_liveTimers;
+
+    pushTimer(slot);
 }
 
-void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, unsigned int repeat, float delay, bool paused, const std::string& key)
+void Scheduler::restartTimer(TimerTarget& timerTarget, int slot)
 {
-    CCASSERT(target, "Argument target must be non-nullptr");
-    CCASSERT(!key.empty(), "key should not be empty!");
+    TimerSlot& timerSlot = _timerSlots[slot];
+    ++timerSlot.generation;
+    timerSlot.lastClock = timerTarget.paused ? timerTarget.pausedAt : _clock;
+    pushTimer(slot);
+}
 
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
+void Scheduler::removeTimer(TimerTarget& timerTarget, size_t index)
+{
+    int slot = timerTarget.slots[index];
+    TimerSlot& timerSlot = _timerSlots[slot];
 
-    if (! element)
-    {
-        element = (tHashTimerEntry *)calloc(sizeof(*element), 1);
-        element->target = target;
+    // stops the loop in Timer::update() when the timer removes itself while triggering
+    timerSlot.timer->setAborted();
+    timerSlot.timer->release();
+    timerSlot.timer = nullptr;
+    timerSlot.target = nullptr;
+    // its heap entries are skipped from now on
+    ++timerSlot.generation;
 
-        HASH_ADD_PTR(_hashForTimers, target, element);
+    _freeTimerSlots.push_back(slot);
+    timerTarget.slots.erase(timerTarget.slots.begin() + index);
+    --_liveTimers;
+}
 
-        // Is this the 1st element ? Then set the pause level to all the selectors of this target
-        element->paused = paused;
-    }
-    else
-    {
-        CCASSERT(element->paused == paused, "element's paused should be paused!");
-    }
+void Scheduler::pushTimer(int slot)
+{
+    TimerSlot& timerSlot = _timerSlots[slot];
+    timerSlot.due = timerSlot.lastClock + timerSlot.timer->getTimeToNextTrigger();
+    // paused timers are pushed again by resumeTimerTarget()
+    if (timerSlot.paused)
+        return;
+
+    TimerHeapItem item = { timerSlot.due, _timerSequence++, slot, timerSlot.generation };
+    _timerHeap.push_back(item);
+    std::push_heap(_timerHeap.begin(), _timerHeap.end(), compareTimerHeapItems);
+}
+
+void Scheduler::pauseTimerTarget(TimerTarget& timerTarget)
+{
+    if (timerTarget.paused)
+        return;
 
-    if (element->timers == nullptr)
+    timerTarget.paused = true;
+    timerTarget.pausedAt = _clock;
+    for (auto slot : timerTarget.slots)
+        _timerSlots[slot].paused = true;
+}
+
+void Scheduler::resumeTimerTarget(TimerTarget& timerTarget)
+{
+    if (!timerTarget.paused)
+        return;
+
+    // the time spent paused does not count, as if the timers were never updated in between
+    double pausedTime = _clock - timerTarget.pausedAt;
+    timerTarget.paused = false;
+    for (auto slot : timerTarget.slots)
     {
-        element->timers = ccArrayNew(10);
+        TimerSlot& timerSlot = _timerSlots[slot];
+        timerSlot.paused = false;
+        timerSlot.lastClock += pausedTime;
+        ++timerSlot.generation;
+        pushTimer(slot);
     }
-    else 
+}
+
+void Scheduler::compactTimerHeap()
+{
+    auto stale = [this](const TimerHeapItem& item) {
+        const TimerSlot& timerSlot = _timerSlots[item.slot];
+        return timerSlot.generation != item.generation || timerSlot.paused;
+    };
+    _timerHeap.erase(std::remove_if(_timerHeap.begin(), _timerHeap.end(), stale), _timerHeap.end());
+    std::make_heap(_timerHeap.begin(), _timerHeap.end(), compareTimerHeapItems);
+}
+
+void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, bool paused, const std::string& key)
+{
+    this->schedule(callback, target, interval, CC_REPEAT_FOREVER, 0.0f, paused, key);
+}
+
+void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, unsigned int repeat, float delay, bool paused, const std::string& key)
+{
+    CCASSERT(target, "Argument target must be non-nullptr");
+    CCASSERT(!key.empty(), "key should not be empty!");
+
+    TimerTarget& timerTarget = getOrCreateTimerTarget(target, paused);
+    for (auto slot : timerTarget.slots)
     {
-        for (int i = 0; i < element->timers->num; ++i)
-        {
-            TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(element->timers->arr[i]);
+        TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(_timerSlots[slot].timer);
 
-            if (timer && !timer->isExhausted() && key == timer->getKey())
-            {
-                CCLOG("CCScheduler#schedule. Reiniting timer with interval %.4f, repeat %u, delay %.4f", interval, repeat, delay);
-                timer->setupTimerWithInterval(interval, repeat, delay);
-                return;
-            }
+        if (timer && !timer->isExhausted() && key == timer->getKey())
+        {
+            CCLOG("CCScheduler#schedule. Reiniting timer with interval %.4f, repeat %u, delay %.4f", interval, repeat, delay);
+            timer->setupTimerWithInterval(interval, repeat, delay);
+            restartTimer(timerTarget, slot);
+            return;
         }
-        ccArrayEnsureExtraCapacity(element->timers, 1);
     }
 
     TimerTargetCallback *timer = new (std::nothrow) TimerTargetCallback();
     timer->initWithCallback(this, callback, target, key, interval, repeat, delay);
-    ccArrayAppendObject(element->timers, timer);
+    addTimer(timerTarget, target, timer);
     timer->release();
 }
 
@@ -342,139 +417,36 @@ void Scheduler::unschedule(const std::string &key, void *target)
         return;
     }
 
-    //CCASSERT(target);
-    //CCASSERT(selector);
-
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-
-    if (element)
+    auto it = _timerTargets.find(target);
+    if (it == _timerTargets.end())
     {
-        for (int i = 0; i < element->timers->num; ++i)
-        {
-            TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(element->timers->arr[i]);
-
-            if (timer && key == timer->getKey())
-            {
-                if (timer == element->currentTimer && (! timer->isAborted()))
-                {
-                    timer->retain();
-                    timer->setAborted();
-                }
-
-                ccArrayRemoveObjectAtIndex(element->timers, i, true);
-
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i)
-                {
-                    element->timerIndex--;
-                }
-
-                if (element->timers->num == 0)
-                {
-                    if (_currentTarget == element)
-                    {
-                        _currentTargetSalvaged = true;
-                    }
-                    else
-                    {
-                        removeHashElement(element);
-                    }
-                }
-
-                return;
-            }
-        }
+        return;
     }
-}
 
-void Scheduler::priorityIn(tListEntry **list, const ccSchedulerFunc& callback, void *target, int priority, bool paused)
-{
-    tListEntry *listElement = new (std::nothrow) tListEntry();
-
-    listElement->callback = callback;
-    listElement->target = target;
-    listElement->priority = priority;
-    listElement->paused = paused;
-    listElement->next = listElement->prev = nullptr;
-    listElement->markedForDeletion = false;
-
-    // empty list ?
-    if (! *list)
+    auto& slots = it->second.slots;
+    for (size_t i = 0; i < slots.size(); ++i)
     {
-        DL_APPEND(*list, listElement);
-    }
-    else
-    {
-        bool added = false;
+        TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(_timerSlots[slots[i]].timer);
 
-        for (tListEntry *element = *list; element; element = element->next)
+        if (timer && key == timer->getKey())
         {
-            if (priority < element->priority)
+            removeTimer(it->second, i);
+            if (slots.empty())
             {
-                if (element == *list)
-                {
-                    DL_PREPEND(*list, listElement);
-                }
-                else
-                {
-                    listElement->next = element;
-                    listElement->prev = element->prev;
-
-                    element->prev->next = listElement;
-                    element->prev = listElement;
-                }
-
-                added = true;
-                break;
+                _timerTargets.erase(it);
             }
-        }
-
-        // Not added? priority has the higher value. Append it.
-        if (! added)
-        {
-            DL_APPEND(*list, listElement);
+            return;
         }
     }
-
-    // update hash entry for quick access
-    tHashUpdateEntry *hashElement = (tHashUpdateEntry *)calloc(sizeof(*hashElement), 1);
-    hashElement->target = target;
-    hashElement->list = list;
-    hashElement->entry = listElement;
-    memset(&hashElement->hh, 0, sizeof(hashElement->hh));
-    HASH_ADD_PTR(_hashForUpdates, target, hashElement);
-}
-
-void Scheduler::appendIn(_listEntry **list, const ccSchedulerFunc& callback, void *target, bool paused)
-{
-    tListEntry *listElement = new (std::nothrow) tListEntry();
-
-    listElement->callback = callback;
-    listElement->target = target;
-    listElement->paused = paused;
-    listElement->priority = 0;
-    listElement->markedForDeletion = false;
-
-    DL_APPEND(*list, listElement);
-
-    // update hash entry for quicker access
-    tHashUpdateEntry *hashElement = (tHashUpdateEntry *)calloc(sizeof(*hashElement), 1);
-    hashElement->target = target;
-    hashElement->list = list;
-    hashElement->entry = listElement;
-    memset(&hashElement->hh, 0, sizeof(hashElement->hh));
-    HASH_ADD_PTR(_hashForUpdates, target, hashElement);
 }
 
 void Scheduler::schedulePerFrame(const ccSchedulerFunc& callback, void *target, int priority, bool paused)
 {
-    tHashUpdateEntry *hashElement = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, hashElement);
-    if (hashElement)
+    UpdateEntry *existing = findUpdateEntry(target);
+    if (existing)
     {
         // change priority: should unschedule it first
-        if (hashElement->entry->priority != priority)
+        if (existing->priority != priority)
         {
             unscheduleUpdate(target);
         }
@@ -486,20 +458,102 @@ void Scheduler::schedulePerFrame(const ccSchedulerFunc& callback, void *target,
         }
     }
 
-    // most of the updates are going to be 0, that's way there
-    // is an special list for updates with priority 0
-    if (priority == 0)
+    // The entry is placed in its priority bucket when the next tick starts, so a callback
+    // scheduling updates never reallocates the bucket that is being walked.
+    UpdateEntry entry;
+    entry.callback = callback;
+    entry.target = target;
+    entry.priority = priority;
+    entry.paused = paused;
+    entry.markedForDeletion = false;
+
+    UpdateLocation location = { UPDATE_PENDING, _pendingUpdates.size() };
+    _updateLocations[target] = location;
+    _pendingUpdates.push_back(std::move(entry));
+}
+
+Scheduler::UpdateEntry* Scheduler::findUpdateEntry(void* target)
+{
+    auto it = _updateLocations.find(target);
+    if (it == _updateLocations.end())
     {
-        appendIn(&_updates0List, callback, target, paused);
+        return nullptr;
     }
-    else if (priority < 0)
+
+    const UpdateLocation& location = it->second;
+    if (location.bucket == UPDATE_PENDING)
     {
-        priorityIn(&_updatesNegList, callback, target, priority, paused);
+        return &_pendingUpdates[location.index];
     }
-    else
+    return &_updateBuckets[location.bucket][location.index];
+}
+
+void Scheduler::mergePendingUpdates()
+{
+    if (!_updatesDirty && _pendingUpdates.empty())
     {
-        // priority > 0
-        priorityIn(&_updatesPosList, callback, target, priority, paused);
+        return;
+    }
+
+    bool changed[UPDATE_BUCKET_COUNT] = { false, false, false };
+
+    if (_updatesDirty)
+    {
+        for (int i = 0; i < UPDATE_BUCKET_COUNT; ++i)
+        {
+            auto& bucket = _updateBuckets[i];
+            auto newEnd = std::remove_if(bucket.begin(), bucket.end(), [](const UpdateEntry& entry) {
+                return entry.markedForDeletion;
+            });
+            if (newEnd != bucket.end())
+            {
+                bucket.erase(newEnd, bucket.end());
+                changed[i] = true;
+            }
+        }
+        _updatesDirty = false;
+    }
+
+    for (auto& entry : _pendingUpdates)
+    {
+        if (entry.markedForDeletion)
+        {
+            continue;
+        }
+
+        // most of the updates are going to be 0, that's way there
+        // is an special bucket for updates with priority 0
+        int index = entry.priority < 0 ? UPDATE_BUCKET_NEG : (entry.priority == 0 ? UPDATE_BUCKET_ZERO : UPDATE_BUCKET_POS);
+        auto& bucket = _updateBuckets[index];
+        if (index == UPDATE_BUCKET_ZERO)
+        {
+            bucket.push_back(std::move(entry));
+        }
+        else
+        {
+            // after the entries with the same priority
+            auto pos = std::upper_bound(bucket.begin(), bucket.end(), entry.priority, [](int priority, const UpdateEntry& other) {
+                return priority < other.priority;
+            });
+            bucket.insert(pos, std::move(entry));
+        }
+        changed[index] = true;
+    }
+    _pendingUpdates.clear();
+
+    for (int i = 0; i < UPDATE_BUCKET_COUNT; ++i)
+    {
+        if (!changed[i])
+        {
+            continue;
+        }
+
+        auto& bucket = _updateBuckets[i];
+        for (size_t j = 0, size = bucket.size(); j < size; ++j)
+        {
+            UpdateLocation location = { i, j };
+            _updateLocations[bucket[j].target] = location;
+        }
     }
 }
 
@@ -508,22 +562,15 @@ bool Scheduler::isScheduled(const std::string& key, const void *target) const
     CCASSERT(!key.empty(), "Argument key must not be empty");
     CCASSERT(target, "Argument target must be non-nullptr");
     
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    
-    if (!element)
+    auto it = _timerTargets.find(const_cast<void*>(target));
+    if (it == _timerTargets.end())
     {
         return false;
     }
     
-    if (element->timers == nullptr)
+    for (auto slot : it->second.slots)
     {
-        return false;
-    }
-    
-    for (int i = 0; i < element->timers->num; ++i)
-    {
-        TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(element->timers->arr[i]);
+        TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(_timerSlots[slot].timer);
         
         if (timer && !timer->isExhausted() && key == timer->getKey())
         {
@@ -534,40 +581,24 @@ bool Scheduler::isScheduled(const std::string& key, const void *target) const
     return false;
 }
 
-void Scheduler::removeUpdateFromHash(struct _listEntry *entry)
+void Scheduler::unscheduleUpdate(void *target)
 {
-    tHashUpdateEntry *element = nullptr;
-
-    HASH_FIND_PTR(_hashForUpdates, &entry->target, element);
-    if (element)
+    if (target == nullptr)
     {
-        // list entry
-        DL_DELETE(*element->list, element->entry);
-        if (!_updateHashLocked)
-            CC_SAFE_DELETE(element->entry);
-        else
-        {
-            element->entry->markedForDeletion = true;
-            _updateDeleteVector.push_back(element->entry);
-        }
-
-        // hash entry
-        HASH_DEL(_hashForUpdates, element);
-        free(element);
+        return;
     }
-}
 
-void Scheduler::unscheduleUpdate(void *target)
-{
-    if (target == nullptr)
+    auto it = _updateLocations.find(target);
+    if (it == _updateLocations.end())
     {
         return;
     }
 
-    tHashUpdateEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, element);
-    if (element)
-        this->removeUpdateFromHash(element->entry);
+    // the entry is skipped from now on and compacted away when the next tick starts
+    UpdateEntry *entry = findUpdateEntry(target);
+    entry->markedForDeletion = true;
+    _updateLocations.erase(it);
+    _updatesDirty = true;
 }
 
 void Scheduler::unscheduleAll(void)
@@ -578,44 +609,25 @@ void Scheduler::unscheduleAll(void)
 void Scheduler::unscheduleAllWithMinPriority(int minPriority)
 {
     // Custom Selectors
-    tHashTimerEntry *element = nullptr;
-    tHashTimerEntry *nextElement = nullptr;
-    for (element = _hashForTimers; element != nullptr;)
+    while (!_timerTargets.empty())
     {
-        // element may be removed in unscheduleAllSelectorsForTarget
-        nextElement = (tHashTimerEntry *)element->hh.next;
-        unscheduleAllForTarget(element->target);
-
-        element = nextElement;
+        unscheduleAllForTarget(_timerTargets.begin()->first);
     }
 
     // Updates selectors
-    tListEntry *entry, *tmp;
-    if(minPriority < 0)
-    {
-        DL_FOREACH_SAFE(_updatesNegList, entry, tmp)
-        {
-            if(entry->priority >= minPriority)
-            {
-                unscheduleUpdate(entry->target);
-            }
-        }
-    }
-
-    if(minPriority <= 0)
+    std::vector<void*> targets;
+    for (const auto& pair : _updateLocations)
     {
-        DL_FOREACH_SAFE(_updates0List, entry, tmp)
+        const UpdateLocation& location = pair.second;
+        const UpdateEntry& entry = location.bucket == UPDATE_PENDING ? _pendingUpdates[location.index] : _updateBuckets[location.bucket][location.index];
+        if (entry.priority >= minPriority)
         {
-            unscheduleUpdate(entry->target);
+            targets.push_back(pair.first);
         }
     }
-
-    DL_FOREACH_SAFE(_updatesPosList, entry, tmp)
+    for (auto target : targets)
     {
-        if(entry->priority >= minPriority)
-        {
-            unscheduleUpdate(entry->target);
-        }
+        unscheduleUpdate(target);
     }
 #if CC_ENABLE_SCRIPT_BINDING
     _scriptHandlerEntries.clear();
@@ -631,27 +643,15 @@ void Scheduler::unscheduleAllForTarget(void *target)
     }
 
     // Custom Selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-
-    if (element)
+    auto it = _timerTargets.find(target);
+    if (it != _timerTargets.end())
     {
-        if (ccArrayContainsObject(element->timers, element->currentTimer)
-            && (! element->currentTimer->isAborted()))
-        {
-            element->currentTimer->retain();
-            element->currentTimer->setAborted();
-        }
-        ccArrayRemoveAllObjects(element->timers);
-
-        if (_currentTarget == element)
-        {
-            _currentTargetSalvaged = true;
-        }
-        else
+        TimerTarget& timerTarget = it->second;
+        while (!timerTarget.slots.empty())
         {
-            removeHashElement(element);
+            removeTimer(timerTarget, timerTarget.slots.size() - 1);
         }
+        _timerTargets.erase(it);
     }
 
     // update selector
@@ -686,20 +686,17 @@ void Scheduler::resumeTarget(void *target)
     CCASSERT(target != nullptr, "target can't be nullptr!");
 
     // custom selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element)
+    auto it = _timerTargets.find(target);
+    if (it != _timerTargets.end())
     {
-        element->paused = false;
+        resumeTimerTarget(it->second);
     }
 
     // update selector
-    tHashUpdateEntry *elementUpdate = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-    if (elementUpdate)
+    UpdateEntry *entry = findUpdateEntry(target);
+    if (entry)
     {
-        CCASSERT(elementUpdate->entry != nullptr, "elementUpdate's entry can't be nullptr!");
-        elementUpdate->entry->paused = false;
+        entry->paused = false;
     }
 }
 
@@ -708,20 +705,17 @@ void Scheduler::pauseTarget(void *target)
     CCASSERT(target != nullptr, "target can't be nullptr!");
 
     // custom selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element)
+    auto it = _timerTargets.find(target);
+    if (it != _timerTargets.end())
     {
-        element->paused = true;
+        pauseTimerTarget(it->second);
     }
 
     // update selector
-    tHashUpdateEntry *elementUpdate = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-    if (elementUpdate)
+    UpdateEntry *entry = findUpdateEntry(target);
+    if (entry)
     {
-        CCASSERT(elementUpdate->entry != nullptr, "elementUpdate's entry can't be nullptr!");
-        elementUpdate->entry->paused = true;
+        entry->paused = true;
     }
 }
 
@@ -730,19 +724,17 @@ bool Scheduler::isTargetPaused(void *target)
     CCASSERT( target != nullptr, "target must be non nil" );
 
     // Custom selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    if( element )
+    auto it = _timerTargets.find(target);
+    if (it != _timerTargets.end())
     {
-        return element->paused;
+        return it->second.paused;
     }
     
     // We should check update selectors if target does not have custom selectors
-    tHashUpdateEntry *elementUpdate = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-    if ( elementUpdate )
+    UpdateEntry *entry = findUpdateEntry(target);
+    if (entry)
     {
-        return elementUpdate->entry->paused;
+        return entry->paused;
     }
     
     return false;  // should never get here
@@ -758,42 +750,21 @@ std::set<void*> Scheduler::pauseAllTargetsWithMinPriority(int minPriority)
     std::set<void*> idsWithSelectors;
 
     // Custom Selectors
-    for(tHashTimerEntry *element = _hashForTimers; element != nullptr;
-        element = (tHashTimerEntry*)element->hh.next)
+    for (auto& pair : _timerTargets)
     {
-        element->paused = true;
-        idsWithSelectors.insert(element->target);
+        pauseTimerTarget(pair.second);
+        idsWithSelectors.insert(pair.first);
     }
 
     // Updates selectors
-    tListEntry *entry, *tmp;
-    if(minPriority < 0)
+    for (const auto& pair : _updateLocations)
     {
-        DL_FOREACH_SAFE( _updatesNegList, entry, tmp ) 
+        const UpdateLocation& location = pair.second;
+        UpdateEntry& entry = location.bucket == UPDATE_PENDING ? _pendingUpdates[location.index] : _updateBuckets[location.bucket][location.index];
+        if (entry.priority >= minPriority)
         {
-            if(entry->priority >= minPriority)
-            {
-                entry->paused = true;
-                idsWithSelectors.insert(entry->target);
-            }
-        }
-    }
-
-    if(minPriority <= 0)
-    {
-        DL_FOREACH_SAFE( _updates0List, entry, tmp )
-        {
-            entry->paused = true;
-            idsWithSelectors.insert(entry->target);
-        }
-    }
-
-    DL_FOREACH_SAFE( _updatesPosList, entry, tmp ) 
-    {
-        if(entry->priority >= minPriority) 
-        {
-            entry->paused = true;
-            idsWithSelectors.insert(entry->target);
+            entry.paused = true;
+            idsWithSelectors.insert(pair.first);
         }
     }
 
@@ -822,7 +793,8 @@ void Scheduler::removeAllFunctionsToBePerformedInCocosThread()
 // main loop
 void Scheduler::update(float dt)
 {
-    _updateHashLocked = true;
+    // entries scheduled or removed since the last tick take effect now
+    mergePendingUpdates();
 
     if (_timeScale != 1.0f)
     {
@@ -833,85 +805,66 @@ void Scheduler::update(float dt)
     // Selector callbacks
     //
 
-    // Iterate over all the Updates' selectors
-    tListEntry *entry, *tmp;
-
-    // updates with priority < 0
-    DL_FOREACH_SAFE(_updatesNegList, entry, tmp)
+    // Iterate over all the Updates' selectors: priority < 0, == 0 and > 0.
+    // The buckets are not modified while they are walked, see schedulePerFrame() and unscheduleUpdate().
+    for (auto& bucket : _updateBuckets)
     {
-        if ((! entry->paused) && (! entry->markedForDeletion))
+        for (auto& entry : bucket)
         {
-            entry->callback(dt);
+            if ((! entry.paused) && (! entry.markedForDeletion))
+            {
+                entry.callback(dt);
+            }
         }
     }
 
-    // updates with priority == 0
-    DL_FOREACH_SAFE(_updates0List, entry, tmp)
-    {
-        if ((! entry->paused) && (! entry->markedForDeletion))
-        {
-            entry->callback(dt);
-        }
-    }
+    //
+    // Custom selectors
+    //
 
-    // updates with priority > 0
-    DL_FOREACH_SAFE(_updatesPosList, entry, tmp)
+    // Only the timers that can trigger are taken off the heap.
+    _clock += dt;
+    _dueTimers.clear();
+    while (!_timerHeap.empty() && _timerHeap.front().due <= _clock)
     {
-        if ((! entry->paused) && (! entry->markedForDeletion))
+        std::pop_heap(_timerHeap.begin(), _timerHeap.end(), compareTimerHeapItems);
+        const TimerHeapItem& item = _timerHeap.back();
+        const TimerSlot& timerSlot = _timerSlots[item.slot];
+        if (timerSlot.generation == item.generation && !timerSlot.paused)
         {
-            entry->callback(dt);
+            _dueTimers.push_back(item);
         }
+        _timerHeap.pop_back();
     }
 
-    // Iterate over all the custom selectors
-    for (tHashTimerEntry *elt = _hashForTimers; elt != nullptr; )
+    for (const auto& item : _dueTimers)
     {
-        _currentTarget = elt;
-        _currentTargetSalvaged = false;
-
-        if (! _currentTarget->paused)
+        // an earlier callback may have removed, restarted or paused this timer
+        if (_timerSlots[item.slot].generation != item.generation || _timerSlots[item.slot].paused)
         {
-            // The 'timers' array may change while inside this loop
-            for (elt->timerIndex = 0; elt->timerIndex < elt->timers->num; ++(elt->timerIndex))
-            {
-                elt->currentTimer = (Timer*)(elt->timers->arr[elt->timerIndex]);
-                CCASSERT
-                  ( !elt->currentTimer->isAborted(),
-                    "An aborted timer should not be updated" );
-
-                elt->currentTimer->update(dt);
-
-                if (elt->currentTimer->isAborted())
-                {
-                    // The currentTimer told the remove itself. To prevent the timer from
-                    // accidentally deallocating itself before finishing its step, we retained
-                    // it. Now that step is done, it's safe to release it.
-                    elt->currentTimer->release();
-                }
-
-                elt->currentTimer = nullptr;
-            }
+            continue;
         }
 
-        // elt, at this moment, is still valid
-        // so it is safe to ask this here (issue #490)
-        elt = (tHashTimerEntry *)elt->hh.next;
+        Timer* timer = _timerSlots[item.slot].timer;
+        float elapsed = (float)(_clock - _timerSlots[item.slot].lastClock);
+        _timerSlots[item.slot].lastClock = _clock;
 
-        // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
-        if (_currentTargetSalvaged && _currentTarget->timers->num == 0)
+        // The timer may remove itself while triggering. To prevent it from
+        // deallocating itself before finishing its step, retain it until the step is done.
+        timer->retain();
+        timer->update(elapsed);
+        if (_timerSlots[item.slot].generation == item.generation)
         {
-            removeHashElement(_currentTarget);
+            pushTimer(item.slot);
         }
+        timer->release();
     }
- 
-    // delete all updates that are removed in update
-    for (auto &e : _updateDeleteVector)
-        delete e;
 
-    _updateDeleteVector.clear();
-
-    _updateHashLocked = false;
-    _currentTarget = nullptr;
+    // drop the entries left behind by removed timers
+    if (_timerHeap.size() > _liveTimers * 2 + 64)
+    {
+        compactTimerHeap();
+    }
 
 #if CC_ENABLE_SCRIPT_BINDING
     //
@@ -957,47 +910,23 @@ void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, uns
 {
     CCASSERT(target, "Argument target must be non-nullptr");
     
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    
-    if (! element)
+    TimerTarget& timerTarget = getOrCreateTimerTarget(target, paused);
+    for (auto slot : timerTarget.slots)
     {
-        element = (tHashTimerEntry *)calloc(sizeof(*element), 1);
-        element->target = target;
-        
-        HASH_ADD_PTR(_hashForTimers, target, element);
+        TimerTargetSelector *timer = dynamic_cast<TimerTargetSelector*>(_timerSlots[slot].timer);
         
-        // Is this the 1st element ? Then set the pause level to all the selectors of this target
-        element->paused = paused;
-    }
-    else
-    {
-        CCASSERT(element->paused == paused, "element's paused should be paused.");
-    }
-    
-    if (element->timers == nullptr)
-    {
-        element->timers = ccArrayNew(10);
-    }
-    else
-    {
-        for (int i = 0; i < element->timers->num; ++i)
+        if (timer && !timer->isExhausted() && selector == timer->getSelector())
         {
-            TimerTargetSelector *timer = dynamic_cast<TimerTargetSelector*>(element->timers->arr[i]);
-            
-            if (timer && !timer->isExhausted() && selector == timer->getSelector())
-            {
-                CCLOG("CCScheduler#schedule. Reiniting timer with interval %.4f, repeat %u, delay %.4f", interval, repeat, delay);
-                timer->setupTimerWithInterval(interval, repeat, delay);
-                return;
-            }
+            CCLOG("CCScheduler#schedule. Reiniting timer with interval %.4f, repeat %u, delay %.4f", interval, repeat, delay);
+            timer->setupTimerWithInterval(interval, repeat, delay);
+            restartTimer(timerTarget, slot);
+            return;
         }
-        ccArrayEnsureExtraCapacity(element->timers, 1);
     }
     
     TimerTargetSelector *timer = new (std::nothrow) TimerTargetSelector();
     timer->initWithSelector(this, selector, target, interval, repeat, delay);
-    ccArrayAppendObject(element->timers, timer);
+    addTimer(timerTarget, target, timer);
     timer->release();
 }
 
@@ -1011,22 +940,15 @@ bool Scheduler::isScheduled(SEL_SCHEDULE selector, const Ref *target) const
     CCASSERT(selector, "Argument selector must be non-nullptr");
     CCASSERT(target, "Argument target must be non-nullptr");
     
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    
-    if (!element)
-    {
-        return false;
-    }
-    
-    if (element->timers == nullptr)
+    auto it = _timerTargets.find(const_cast<Ref*>(target));
+    if (it == _timerTargets.end())
     {
         return false;
     }
 
-    for (int i = 0; i < element->timers->num; ++i)
+    for (auto slot : it->second.slots)
     {
-        TimerTargetSelector *timer = dynamic_cast<TimerTargetSelector*>(element->timers->arr[i]);
+        TimerTargetSelector *timer = dynamic_cast<TimerTargetSelector*>(_timerSlots[slot].timer);
         
         if (timer && !timer->isExhausted() && selector == timer->getSelector())
         {
@@ -1045,45 +967,25 @@ void Scheduler::unschedule(SEL_SCHEDULE selector, Ref *target)
         return;
     }
     
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    
-    if (element)
+    auto it = _timerTargets.find(target);
+    if (it == _timerTargets.end())
     {
-        for (int i = 0; i < element->timers->num; ++i)
+        return;
+    }
+
+    auto& slots = it->second.slots;
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+        TimerTargetSelector *timer = dynamic_cast<TimerTargetSelector*>(_timerSlots[slots[i]].timer);
+        
+        if (timer && selector == timer->getSelector())
         {
-            TimerTargetSelector *timer = dynamic_cast<TimerTargetSelector*>(element->timers->arr[i]);
-            
-            if (timer && selector == timer->getSelector())
+            removeTimer(it->second, i);
+            if (slots.empty())
             {
-                if (timer == element->currentTimer && !timer->isAborted())
-                {
-                    timer->retain();
-                    timer->setAborted();
-                }
-                
-                ccArrayRemoveObjectAtIndex(element->timers, i, true);
-                
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i)
-                {
-                    element->timerIndex--;
-                }
-                
-                if (element->timers->num == 0)
-                {
-                    if (_currentTarget == element)
-                    {
-                        _currentTargetSalvaged = true;
-                    }
-                    else
-                    {
-                        removeHashElement(element);
-                    }
-                }
-                
-                return;
+                _timerTargets.erase(it);
             }
+            return;
         }
     }
 }
@@ -32,10 +32,11 @@ THE SOFTWARE.
 #include <functional>
 #include <mutex>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 #include "base/CCRef.h"
 #include "base/CCVector.h"
-#include "base/uthash.h"
 
 NS_CC_BEGIN
 
@@ -55,6 +56,8 @@ public:
     void setAborted() { _aborted = true; }
     bool isAborted() const { return _aborted; }
     bool isExhausted() const;
+    /** Time that has to be accumulated before update() can trigger again, 0 when it must be updated next frame. */
+    float getTimeToNextTrigger() const;
     
     virtual void trigger(float dt) = 0;
     virtual void cancel() = 0;
@@ -140,10 +143,6 @@ private:
  * @{
  */
 
-struct _listEntry;
-struct _hashSelectorEntry;
-struct _hashUpdateEntry;
-
 #if CC_ENABLE_SCRIPT_BINDING
 class SchedulerScriptHandlerEntry;
 #endif
@@ -373,6 +372,12 @@ public:
      @since v3.0
      */
     bool isScheduled(SEL_SCHEDULE selector, const Ref *target) const;
+
+    /** Returns the number of targets whose update callback is scheduled. */
+    size_t getScheduledUpdateCount() const { return _updateLocations.size(); }
+
+    /** Returns the number of scheduled timers (selectors and callbacks with an interval). */
+    size_t getScheduledTimerCount() const { return _liveTimers; }
     
     /////////////////////////////////////
     
@@ -507,32 +512,90 @@ protected:
      */
     void schedulePerFrame(const ccSchedulerFunc& callback, void *target, int priority, bool paused);
     
-    void removeHashElement(struct _hashSelectorEntry *element);
-    void removeUpdateFromHash(struct _listEntry *entry);
-
     // update specific
 
-    void priorityIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, int priority, bool paused);
-    void appendIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, bool paused);
+    struct UpdateEntry
+    {
+        ccSchedulerFunc callback;
+        void* target;
+        int priority;
+        bool paused;
+        bool markedForDeletion; // selector will no longer be called and entry will be removed at the start of the next tick
+    };
+
+    // where the update entry of a target lives: one of the buckets, or the pending list
+    struct UpdateLocation
+    {
+        int bucket;
+        size_t index;
+    };
+
+    void mergePendingUpdates();
+    UpdateEntry* findUpdateEntry(void* target);
+
+    // timer specific
+
+    struct TimerSlot
+    {
+        Timer* timer;           // retained, nullptr when the slot is free
+        void* target;
+        double lastClock;       // _clock when the timer was last updated
+        double due;             // _clock at which the timer has to be updated again
+        unsigned int generation;// bumped whenever the heap entries of this slot become stale
+        bool paused;
+    };
+
+    struct TimerTarget
+    {
+        std::vector<int> slots;
+        bool paused;
+        double pausedAt;
+    };
 
+    struct TimerHeapItem
+    {
+        double due;
+        unsigned long long sequence;
+        int slot;
+        unsigned int generation;
+    };
+
+    TimerTarget& getOrCreateTimerTarget(void* target, bool paused);
+    void addTimer(TimerTarget& timerTarget, void* target, Timer* timer);
+    void restartTimer(TimerTarget& timerTarget, int slot);
+    void removeTimer(TimerTarget& timerTarget, size_t index);
+    void pushTimer(int slot);
+    void pauseTimerTarget(TimerTarget& timerTarget);
+    void resumeTimerTarget(TimerTarget& timerTarget);
+    void compactTimerHeap();
+    static bool compareTimerHeapItems(const TimerHeapItem& a, const TimerHeapItem& b);
 
     float _timeScale;
 
     //
     // "updates with priority" stuff
     //
-    struct _listEntry *_updatesNegList;        // list of priority < 0
-    struct _listEntry *_updates0List;            // list priority == 0
-    struct _listEntry *_updatesPosList;        // list priority > 0
-    struct _hashUpdateEntry *_hashForUpdates; // hash used to fetch quickly the list entries for pause,delete,etc
-    std::vector<struct _listEntry *> _updateDeleteVector; // the vector holds list entries that needs to be deleted after update
+    enum { UPDATE_BUCKET_NEG, UPDATE_BUCKET_ZERO, UPDATE_BUCKET_POS, UPDATE_BUCKET_COUNT, UPDATE_PENDING = UPDATE_BUCKET_COUNT };
+    // priority < 0, == 0 and > 0; each bucket is ordered by priority, then by scheduling order
+    std::vector<UpdateEntry> _updateBuckets[UPDATE_BUCKET_COUNT];
+    // entries scheduled since the last tick, merged into the buckets when the next tick starts
+    std::vector<UpdateEntry> _pendingUpdates;
+    std::unordered_map<void*, UpdateLocation> _updateLocations;
+    // true when an entry was marked for deletion and the buckets need compacting
+    bool _updatesDirty;
 
     // Used for "selectors with interval"
-    struct _hashSelectorEntry *_hashForTimers;
-    struct _hashSelectorEntry *_currentTarget;
-    bool _currentTargetSalvaged;
-    // If true unschedule will not remove anything from a hash. Elements will only be marked for deletion.
-    bool _updateHashLocked;
+    // Timers are kept in a min-heap ordered by the scheduler clock at which they are due,
+    // so a tick only touches the timers that can trigger.
+    std::vector<TimerSlot> _timerSlots;
+    std::vector<int> _freeTimerSlots;
+    std::unordered_map<void*, TimerTarget> _timerTargets;
+    std::vector<TimerHeapItem> _timerHeap;
+    std::vector<TimerHeapItem> _dueTimers;
+    // scaled time accumulated by update()
+    double _clock;
+    unsigned long long _timerSequence;
+    size_t _liveTimers;
     
 #if CC_ENABLE_SCRIPT_BINDING
     Vector<SchedulerScriptHandlerEntry*> _scriptHandlerEntries;
@@ -0,0 +1,187 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "base/allocator/CCAllocatorTypePool.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <atomic>
+#include <sstream>
+
+NS_CC_BEGIN
+NS_CC_ALLOCATOR_BEGIN
+
+namespace
+{
+    // pages are linked through their first bytes, blocks start after this header
+    const size_t kPageHeader = 16;
+    const size_t kBlockAlignment = 16;
+    const size_t kPageBytes = 16 * 1024;
+    const size_t kMinBlocksPerPage = 8;
+
+    std::atomic<TypePool*> s_pools(nullptr);
+}
+
+TypePool* TypePool::create(const char* name, size_t blockSize)
+{
+    // not from the heap: pools outlive every object and are never deleted
+    void* memory = malloc(sizeof(TypePool));
+    if (memory == nullptr)
+    {
+        return nullptr;
+    }
+    auto pool = new (memory) TypePool(name, blockSize);
+
+    pool->_nextPool = s_pools.load();
+    while (!s_pools.compare_exchange_weak(pool->_nextPool, pool))
+    {
+    }
+    return pool;
+}
+
+TypePool::TypePool(const char* name, size_t blockSize)
+: _name(name)
+, _blockSize((blockSize + kBlockAlignment - 1) & ~(kBlockAlignment - 1))
+, _freeList(nullptr)
+, _pages(nullptr)
+, _live(0)
+, _peak(0)
+, _capacity(0)
+, _heapCount(0)
+, _nextPool(nullptr)
+{
+    _blocksPerPage = kPageBytes / _blockSize;
+    if (_blocksPerPage < kMinBlocksPerPage)
+    {
+        _blocksPerPage = kMinBlocksPerPage;
+    }
+}
+
+void* TypePool::allocate(size_t size)
+{
+    if (size > _blockSize || size + kBlockAlignment <= _blockSize)
+    {
+        LOCK(_mutex);
+        ++_heapCount;
+        UNLOCK(_mutex);
+        return ::operator new(size, std::nothrow);
+    }
+
+    LOCK(_mutex);
+    if (_freeList == nullptr && !allocatePage())
+    {
+        UNLOCK(_mutex);
+        return nullptr;
+    }
+
+    void* block = _freeList;
+    _freeList = *(void**)block;
+    if (++_live > _peak)
+    {
+        _peak = _live;
+    }
+    UNLOCK(_mutex);
+    return block;
+}
+
+void TypePool::deallocate(void* address, size_t size)
+{
+    if (address == nullptr)
+    {
+        return;
+    }
+
+    LOCK(_mutex);
+    bool pooled = size != 0 ? (size <= _blockSize && size + kBlockAlignment > _blockSize) : owns(address);
+    if (pooled)
+    {
+        CC_ASSERT(owns(address));
+        *(void**)address = _freeList;
+        _freeList = address;
+        --_live;
+    }
+    else
+    {
+        --_heapCount;
+    }
+    UNLOCK(_mutex);
+
+    if (!pooled)
+    {
+        ::operator delete(address);
+    }
+}
+
+bool TypePool::owns(const void* address) const
+{
+    const size_t pageSize = kPageHeader + _blockSize * _blocksPerPage;
+    const uint8_t* a = (const uint8_t*)address;
+    for (const uint8_t* page = (const uint8_t*)_pages; page != nullptr; page = *(const uint8_t* const*)page)
+    {
+        if (a >= page + kPageHeader && a < page + pageSize)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TypePool::allocatePage()
+{
+    // malloc returns memory aligned for any fundamental type, which covers the 16 byte header and blocks
+    uint8_t* page = (uint8_t*)malloc(kPageHeader + _blockSize * _blocksPerPage);
+    if (page == nullptr)
+    {
+        return false;
+    }
+
+    *(void**)page = _pages;
+    _pages = page;
+
+    // thread the blocks in address order
+    uint8_t* block = page + kPageHeader;
+    for (size_t i = 0; i < _blocksPerPage; ++i, block += _blockSize)
+    {
+        *(void**)block = (i + 1 < _blocksPerPage) ? (void*)(block + _blockSize) : _freeList;
+    }
+    _freeList = page + kPageHeader;
+    _capacity += _blocksPerPage;
+    return true;
+}
+
+std::string TypePool::diagnostics()
+{
+    std::stringstream s;
+    for (TypePool* pool = s_pools.load(); pool != nullptr; pool = pool->_nextPool)
+    {
+        LOCK(pool->_mutex);
+        s << pool->_name << " block:" << pool->_blockSize << " live:" << pool->_live << " peak:" << pool->_peak
+          << " capacity:" << pool->_capacity << " heap:" << pool->_heapCount << "\n";
+        UNLOCK(pool->_mutex);
+    }
+    return s.str();
+}
+
+NS_CC_ALLOCATOR_END
+NS_CC_END
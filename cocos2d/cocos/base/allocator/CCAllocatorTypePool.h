@@ -0,0 +1,138 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef CC_ALLOCATOR_TYPE_POOL_H
+#define CC_ALLOCATOR_TYPE_POOL_H
+/// @cond DO_NOT_SHOW
+
+#include <new>
+#include <string>
+
+#include "base/allocator/CCAllocatorMacros.h"
+#include "base/allocator/CCAllocatorMutex.h"
+
+NS_CC_BEGIN
+NS_CC_ALLOCATOR_BEGIN
+
+// @brief
+// Fixed block pool for the instances of one class, independent of CC_ENABLE_ALLOCATOR.
+// Blocks are carved out of pages taken from malloc and are never given back, so a type that
+// keeps churning reuses the same memory without touching the general heap.
+// Requests of another size (a subclass that adds members) are passed to the global operator new.
+// Every pool registers itself on creation; diagnostics() lists them all for the console.
+// Pools are never destroyed: objects may still be released during static destruction.
+class CC_DLL TypePool
+{
+public:
+
+    // @brief Creates and registers a pool for blocks of blockSize bytes.
+    static TypePool* create(const char* name, size_t blockSize);
+
+    // @brief Returns a block for an object of size bytes, nullptr when out of memory.
+    void* allocate(size_t size);
+
+    // @brief Gives back a block returned by allocate(). A size of 0 means unknown.
+    void deallocate(void* address, size_t size);
+
+    const char* getName() const { return _name; }
+    size_t getBlockSize() const { return _blockSize; }
+    // @brief Objects currently living in the pool's blocks.
+    size_t getLiveCount() const { return _live; }
+    // @brief Highest live count so far.
+    size_t getPeakCount() const { return _peak; }
+    // @brief Blocks owned by the pool, free or not.
+    size_t getCapacity() const { return _capacity; }
+    // @brief Objects of another size that currently live on the general heap.
+    size_t getHeapCount() const { return _heapCount; }
+
+    // @brief One line per registered pool.
+    static std::string diagnostics();
+
+protected:
+
+    TypePool(const char* name, size_t blockSize);
+
+    bool owns(const void* address) const;
+    bool allocatePage();
+
+    const char* _name;
+    size_t _blockSize;
+    size_t _blocksPerPage;
+    void* _freeList;
+    void* _pages;
+    size_t _live;
+    size_t _peak;
+    size_t _capacity;
+    size_t _heapCount;
+    AllocatorMutex _mutex;
+    TypePool* _nextPool;
+};
+
+NS_CC_ALLOCATOR_END
+NS_CC_END
+
+// @brief Routes new and delete of class T through its TypePool.
+// Place it at the start of the class body; it leaves the access level public.
+// Besides the plain forms it declares the nothrow and placement forms that the class-scope
+// operators would otherwise hide, since the engine creates objects with new (std::nothrow).
+#if CC_ENABLE_TYPE_POOLS
+    #define CC_USE_TYPE_POOL(T) \
+    public: \
+        static cocos2d::allocator::TypePool* getTypePool() \
+        { \
+            static cocos2d::allocator::TypePool* pool = cocos2d::allocator::TypePool::create(#T, sizeof(T)); \
+            return pool; \
+        } \
+        static void* operator new(size_t size) \
+        { \
+            void* address = getTypePool()->allocate(size); \
+            if (address == nullptr) \
+                throw std::bad_alloc(); \
+            return address; \
+        } \
+        static void* operator new(size_t size, const std::nothrow_t&) noexcept \
+        { \
+            return getTypePool()->allocate(size); \
+        } \
+        static void* operator new(size_t, void* address) noexcept \
+        { \
+            return address; \
+        } \
+        static void operator delete(void* address, size_t size) \
+        { \
+            getTypePool()->deallocate(address, size); \
+        } \
+        static void operator delete(void* address, const std::nothrow_t&) noexcept \
+        { \
+            getTypePool()->deallocate(address, 0); \
+        } \
+        static void operator delete(void*, void*) noexcept \
+        { \
+        }
+#else
+    #define CC_USE_TYPE_POOL(T)
+#endif
+
+/// @endcond
+#endif//CC_ALLOCATOR_TYPE_POOL_H
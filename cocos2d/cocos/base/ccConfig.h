@@ -165,6 +165,20 @@ THE SOFTWARE.
 #define CC_TEXTURE_ATLAS_USE_VAO 1
 #endif
 
+/** @def CC_RENDERER_STREAM_RING
+ * If enabled, the Renderer streams batched triangles through one fenced ring buffer
+ * instead of orphaning its vertex buffer on every flush.
+ * Needs desktop GL with ARB_sync and ARB_map_buffer_range, which is checked at runtime;
+ * without them the orphaning path is used. Enabled on Win32 and Linux.
+ */
+#ifndef CC_RENDERER_STREAM_RING
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+#define CC_RENDERER_STREAM_RING 1
+#else
+#define CC_RENDERER_STREAM_RING 0
+#endif
+#endif
+
 
 /** @def CC_USE_LA88_LABELS
  * If enabled, it will use LA88 (Luminance Alpha 16-bit textures) for LabelTTF objects.
@@ -384,6 +398,14 @@ THE SOFTWARE.
 # define CC_ENABLE_ALLOCATOR_GLOBAL_NEW_DELETE 0
 # endif//CC_ENABLE_ALLOCATOR_GLOBAL_NEW_DELETE
 
+/** @def CC_ENABLE_TYPE_POOLS
+ * Turn on the per-class block pools declared with CC_USE_TYPE_POOL.
+ * Independent of CC_ENABLE_ALLOCATOR. Live and peak counts are printed by the console "allocator" command.
+ */
+#ifndef CC_ENABLE_TYPE_POOLS
+# define CC_ENABLE_TYPE_POOLS 1
+#endif
+
 /** @def CC_ALLOCATOR_GLOBAL
  * Specify allocator to use for global allocator.
  */
@@ -50,10 +50,12 @@ THE SOFTWARE.
 #include "base/CCMap.h"
 #include "base/CCNS.h"
 #include "base/CCProfiling.h"
+#include "base/CCFramePacer.h"
 #include "base/CCProperties.h"
 #include "base/CCRef.h"
 #include "base/CCRefPtr.h"
 #include "base/CCScheduler.h"
+#include "base/CCFrameStats.h"
 #include "base/CCUserDefault.h"
 #include "base/CCValue.h"
 #include "base/CCVector.h"
@@ -170,6 +172,7 @@ THE SOFTWARE.
 #include "renderer/CCTexture2D.h"
 #include "renderer/CCTextureCube.h"
 #include "renderer/CCTextureCache.h"
+#include "renderer/CCTextureFormatPolicy.h"
 #include "renderer/CCTrianglesCommand.h"
 #include "renderer/CCVertexAttribBinding.h"
 #include "renderer/CCVertexIndexBuffer.h"
@@ -189,6 +192,7 @@ THE SOFTWARE.
 #include "platform/CCCommon.h"
 #include "platform/CCDevice.h"
 #include "platform/CCFileUtils.h"
+#include "platform/CCPackedArchive.h"
 #include "platform/CCImage.h"
 #include "platform/CCPlatformConfig.h"
 #include "platform/CCPlatformMacros.h"
@@ -244,6 +248,8 @@ THE SOFTWARE.
 #include "2d/CCSpriteBatchNode.h"
 #include "2d/CCSpriteFrame.h"
 #include "2d/CCSpriteFrameCache.h"
+#include "2d/CCSpriteSheetData.h"
+#include "2d/CCFrameStatsOverlay.h"
 
 // text_input_node
 #include "2d/CCTextFieldTTF.h"
@@ -253,11 +259,14 @@ THE SOFTWARE.
 
 // tilemap_parallax_nodes
 #include "2d/CCParallaxNode.h"
+#include "2d/CCSpatialNode.h"
 #include "2d/CCTMXLayer.h"
 #include "2d/CCTMXObjectGroup.h"
 #include "2d/CCTMXTiledMap.h"
+#include "2d/CCTMXVirtualLayer.h"
 #include "2d/CCTMXXMLParser.h"
 #include "2d/CCTileMapAtlas.h"
+#include "2d/CCVirtualTexture.h"
 #include "2d/CCFastTMXLayer.h"
 #include "2d/CCFastTMXTiledMap.h"
 
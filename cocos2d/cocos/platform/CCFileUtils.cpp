@@ -25,6 +25,7 @@ THE SOFTWARE.
 ****************************************************************************/
 
 #include "platform/CCFileUtils.h"
+#include "platform/CCPackedArchive.h"
 
 #include <stack>
 
@@ -560,6 +561,11 @@ FileUtils::FileUtils()
 
 FileUtils::~FileUtils()
 {
+    for (auto archive : _resourceArchives)
+    {
+        delete archive;
+    }
+    _resourceArchives.clear();
 }
 
 bool FileUtils::writeStringToFile(const std::string& dataStr, const std::string& fullPath) const
@@ -647,6 +653,16 @@ void FileUtils::getStringFromFile(const std::string &path, std::function<void (s
 Data FileUtils::getDataFromFile(const std::string& filename) const
 {
     Data d;
+    if (!_resourceArchives.empty())
+    {
+        unsigned char* bytes = nullptr;
+        ssize_t size = 0;
+        if (findInResourceArchives(fullPathForFilename(filename), &bytes, &size))
+        {
+            d.setView(bytes, size);
+            return d;
+        }
+    }
     getContents(filename, &d);
     return d;
 }
@@ -670,6 +686,9 @@ FileUtils::Status FileUtils::getContents(const std::string& filename, ResizableB
     if (fullPath.empty())
         return Status::NotExists;
 
+    if (fs->getContentsFromResourceArchives(fullPath, buffer))
+        return Status::OK;
+
     std::string suitableFullPath = fs->getSuitableFOpen(fullPath);
 
     struct stat statBuf;
@@ -809,6 +828,16 @@ std::string FileUtils::getPathForFilename(const std::string& filename, const std
     path += file_path;
     path += resolutionDirectory;
 
+    if (!_resourceArchives.empty())
+    {
+        std::string archivedPath = path;
+        if (!archivedPath.empty() && archivedPath.back() != '/')
+            archivedPath += '/';
+        archivedPath += file;
+        if (findInResourceArchives(archivedPath, nullptr, nullptr))
+            return archivedPath;
+    }
+
     path = getFullPathForFilenameWithinDirectory(path, file);
 
     return path;
@@ -1131,7 +1160,7 @@ bool FileUtils::isFileExist(const std::string& filename) const
 {
     if (isAbsolutePath(filename))
     {
-        return isFileExistInternal(filename);
+        return findInResourceArchives(filename, nullptr, nullptr) || isFileExistInternal(filename);
     }
     else
     {
@@ -1151,6 +1180,61 @@ void FileUtils::isFileExist(const std::string& filename, std::function<void(bool
     }, std::move(callback));
 }
 
+bool FileUtils::addResourceArchive(const std::string& archiveFile)
+{
+    std::string fullPath = isAbsolutePath(archiveFile) ? archiveFile : fullPathForFilename(archiveFile);
+    if (fullPath.empty())
+        return false;
+
+    auto archive = new (std::nothrow) PackedArchive();
+    if (archive == nullptr || !archive->open(fullPath))
+    {
+        delete archive;
+        return false;
+    }
+
+    DECLARE_GUARD;
+    _resourceArchives.push_back(archive);
+    // paths resolved to loose files may now come from the archive
+    _fullPathCache.clear();
+    return true;
+}
+
+bool FileUtils::findInResourceArchives(const std::string& fullPath, unsigned char** bytes, ssize_t* size) const
+{
+    if (_resourceArchives.empty() || fullPath.compare(0, _defaultResRootPath.length(), _defaultResRootPath) != 0)
+        return false;
+
+    std::string relativePath = fullPath.substr(_defaultResRootPath.length());
+    for (auto it = _resourceArchives.rbegin(); it != _resourceArchives.rend(); ++it)
+    {
+        ssize_t fileSize = 0;
+        auto fileData = (*it)->getFileData(relativePath, &fileSize);
+        if (fileData)
+        {
+            if (bytes)
+                *bytes = fileData;
+            if (size)
+                *size = fileSize;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FileUtils::getContentsFromResourceArchives(const std::string& fullPath, ResizableBuffer* buffer) const
+{
+    unsigned char* bytes = nullptr;
+    ssize_t size = 0;
+    if (!findInResourceArchives(fullPath, &bytes, &size))
+        return false;
+
+    buffer->resize(size);
+    if (size > 0)
+        memcpy(buffer->buffer(), bytes, size);
+    return true;
+}
+
 bool FileUtils::isAbsolutePath(const std::string& path) const
 {
     return (path[0] == '/');
@@ -1498,6 +1582,10 @@ long FileUtils::getFileSize(const std::string &filepath) const
             return 0;
     }
 
+    ssize_t archivedSize = 0;
+    if (findInResourceArchives(fullpath, nullptr, &archivedSize))
+        return (long)archivedSize;
+
     struct stat info;
     // Get data associated with "crt_stat.c":
     int result = stat(fullpath.c_str(), &info);
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include <unordered_map>
 #include <type_traits>
 #include <mutex>
+#include <algorithm>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/ccTypes.h"
@@ -42,6 +43,8 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
+class PackedArchive;
+
 /**
  * @addtogroup platform
  * @{
@@ -106,7 +109,16 @@ public:
     explicit ResizableBufferAdapter(BufferType* buffer) : _buffer(buffer) {}
     virtual void resize(size_t size) override {
         size_t oldSize = static_cast<size_t>(_buffer->getSize());
-        if (oldSize != size) {
+        if (_buffer->isView()) {
+            // the viewed memory isn't ours to realloc
+            Data copy;
+            copy.copy(_buffer->getBytes(), static_cast<ssize_t>(std::min(oldSize, size)));
+            _buffer->clear();
+            void* buffer = realloc(copy.takeBuffer(nullptr), size);
+            if (buffer)
+                _buffer->fastSet((unsigned char*)buffer, size);
+        }
+        else if (oldSize != size) {
             auto old = _buffer->getBytes();
             void* buffer = realloc(old, size);
             if (buffer)
@@ -844,6 +856,22 @@ public:
     */
     virtual void listFilesRecursivelyAsync(const std::string& dirPath, std::function<void(std::vector<std::string>)> callback) const;
 
+    /**
+     *  Mounts a packed resource archive (see PackedArchive) holding files relative to the default resource root.
+     *
+     *  Files of mounted archives are found before the file system: fullPathForFilename() and isFileExist()
+     *  answer from the archive's hash index, and getDataFromFile() returns a Data viewing the mapped bytes
+     *  instead of reading a copy. The most recently mounted archive is searched first.
+     *  Archives stay mapped until FileUtils is destroyed, so the returned Data remain valid.
+     *
+     *  @param archiveFile The archive, as a full path or a path resolved with fullPathForFilename().
+     *  @return true if the archive was mapped and its index is valid.
+     */
+    bool addResourceArchive(const std::string& archiveFile);
+
+    /** Number of mounted resource archives. */
+    size_t getResourceArchiveCount() const { return _resourceArchives.size(); }
+
     /** Returns the full path cache. */
     const std::unordered_map<std::string, std::string> getFullPathCache() const { return _fullPathCache; }
 
@@ -915,6 +943,16 @@ protected:
      */
     virtual std::string fullPathForDirectory(const std::string &dirname) const;
 
+    /**
+     *  Looks a full path up in the mounted resource archives.
+     *  @param[out] bytes The mapped bytes of the file, may be nullptr.
+     *  @param[out] size The size of the file, may be nullptr.
+     */
+    bool findInResourceArchives(const std::string& fullPath, unsigned char** bytes, ssize_t* size) const;
+
+    /** Copies a file of the mounted resource archives into a buffer. */
+    bool getContentsFromResourceArchives(const std::string& fullPath, ResizableBuffer* buffer) const;
+
     /**
     * mutex used to protect fields. 
     */
@@ -973,6 +1011,11 @@ protected:
      */
     std::string _writablePath;
 
+    /**
+     *  Mounted resource archives, searched from the back.
+     */
+    std::vector<PackedArchive*> _resourceArchives;
+
     /**
      *  The singleton pointer of FileUtils.
      */
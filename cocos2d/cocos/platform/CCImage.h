@@ -64,6 +64,7 @@ class CC_DLL Image : public Ref
 {
 public:
     friend class TextureCache;
+    friend class VirtualTexture;
     /**
      * @js ctor
      */
@@ -0,0 +1,248 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "platform/CCPackedArchive.h"
+
+#include <string.h>
+
+#include "platform/CCFileUtils.h"
+#include "xxhash.h"
+
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+#include <windows.h>
+#elif CC_TARGET_PLATFORM != CC_PLATFORM_WINRT
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+NS_CC_BEGIN
+
+PackedArchive::PackedArchive()
+: _base(nullptr)
+, _mappedSize(0)
+, _entryCount(0)
+, _bucketCount(0)
+, _seed(0)
+, _displacements(nullptr)
+, _entries(nullptr)
+, _names(nullptr)
+, _namesSize(0)
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+, _fileHandle(nullptr)
+, _mappingHandle(nullptr)
+#endif
+{
+}
+
+PackedArchive::~PackedArchive()
+{
+    close();
+}
+
+bool PackedArchive::open(const std::string& fullPath)
+{
+    close();
+
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+    int wideLength = MultiByteToWideChar(CP_UTF8, 0, fullPath.c_str(), -1, nullptr, 0);
+    std::wstring widePath(wideLength, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, fullPath.c_str(), -1, &widePath[0], wideLength);
+
+    HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    HANDLE mapping = nullptr;
+    void* base = nullptr;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+    {
+        mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        if (mapping)
+            base = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    }
+    if (base == nullptr)
+    {
+        if (mapping)
+            CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    _fileHandle = file;
+    _mappingHandle = mapping;
+    _base = (unsigned char*)base;
+    _mappedSize = (size_t)fileSize.QuadPart;
+#elif CC_TARGET_PLATFORM == CC_PLATFORM_WINRT
+    // no file mapping, keep the whole archive in memory instead
+    Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+    if (data.isNull())
+        return false;
+    _mappedSize = (size_t)data.getSize();
+    _base = data.takeBuffer(nullptr);
+#else
+    int fd = ::open(fullPath.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    void* base = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+    {
+        base = mmap(nullptr, (size_t)info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    }
+    // the mapping keeps the file referenced
+    ::close(fd);
+    if (base == MAP_FAILED)
+        return false;
+
+    _base = (unsigned char*)base;
+    _mappedSize = (size_t)info.st_size;
+#endif
+
+    _path = fullPath;
+
+    // validate the index before trusting any offset in it
+    const Header* header = (const Header*)_base;
+    size_t displacementsSize = 0;
+    size_t entriesOffset = 0;
+    bool valid = _mappedSize >= sizeof(Header)
+        && memcmp(header->magic, "CCPK", 4) == 0
+        && header->version == VERSION
+        && header->bucketCount > 0;
+    if (valid)
+    {
+        displacementsSize = ((size_t)header->bucketCount * sizeof(int32_t) + 7) & ~(size_t)7;
+        entriesOffset = sizeof(Header) + displacementsSize;
+        valid = entriesOffset + (size_t)header->entryCount * sizeof(Entry) + header->namesSize <= _mappedSize;
+    }
+    if (!valid)
+    {
+        CCLOG("cocos2d: %s is not a packed archive", fullPath.c_str());
+        close();
+        return false;
+    }
+
+    _entryCount = header->entryCount;
+    _bucketCount = header->bucketCount;
+    _seed = header->seed;
+    _namesSize = header->namesSize;
+    _displacements = (const int32_t*)(_base + sizeof(Header));
+    _entries = (const Entry*)(_base + entriesOffset);
+    _names = (const char*)(_entries + _entryCount);
+
+    for (uint32_t i = 0; i < _entryCount; ++i)
+    {
+        const Entry& entry = _entries[i];
+        if ((uint64_t)entry.nameOffset + entry.nameLength > _namesSize
+            || entry.offset > _mappedSize || entry.size > _mappedSize - entry.offset)
+        {
+            CCLOG("cocos2d: packed archive %s is corrupted", fullPath.c_str());
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void PackedArchive::close()
+{
+    if (_base)
+    {
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+        UnmapViewOfFile(_base);
+        CloseHandle((HANDLE)_mappingHandle);
+        CloseHandle((HANDLE)_fileHandle);
+        _mappingHandle = nullptr;
+        _fileHandle = nullptr;
+#elif CC_TARGET_PLATFORM == CC_PLATFORM_WINRT
+        free(_base);
+#else
+        munmap(_base, _mappedSize);
+#endif
+    }
+    _base = nullptr;
+    _mappedSize = 0;
+    _entryCount = 0;
+    _bucketCount = 0;
+    _displacements = nullptr;
+    _entries = nullptr;
+    _names = nullptr;
+    _namesSize = 0;
+    _path.clear();
+}
+
+const PackedArchive::Entry* PackedArchive::findEntry(const std::string& fileName) const
+{
+    if (_entryCount == 0)
+        return nullptr;
+
+    int length = (int)fileName.length();
+    uint32_t bucket = XXH32(fileName.data(), length, _seed) % _bucketCount;
+    int32_t displacement = _displacements[bucket];
+    uint32_t slot = displacement < 0
+        ? (uint32_t)(-displacement - 1)
+        : XXH32(fileName.data(), length, (unsigned int)displacement) % _entryCount;
+    if (slot >= _entryCount)
+        return nullptr;
+
+    const Entry* entry = &_entries[slot];
+    if (entry->nameLength != (uint32_t)length || memcmp(_names + entry->nameOffset, fileName.data(), length) != 0)
+        return nullptr;
+    return entry;
+}
+
+bool PackedArchive::fileExists(const std::string& fileName) const
+{
+    return findEntry(fileName) != nullptr;
+}
+
+unsigned char* PackedArchive::getFileData(const std::string& fileName, ssize_t* size) const
+{
+    auto entry = findEntry(fileName);
+    if (entry == nullptr)
+    {
+        if (size)
+            *size = 0;
+        return nullptr;
+    }
+    if (size)
+        *size = (ssize_t)entry->size;
+    return _base + entry->offset;
+}
+
+bool PackedArchive::getFileData(const std::string& fileName, ResizableBuffer* buffer) const
+{
+    ssize_t size = 0;
+    auto bytes = getFileData(fileName, &size);
+    if (bytes == nullptr)
+        return false;
+
+    buffer->resize(size);
+    if (size > 0)
+        memcpy(buffer->buffer(), bytes, size);
+    return true;
+}
+
+NS_CC_END
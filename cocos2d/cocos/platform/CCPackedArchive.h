@@ -0,0 +1,130 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef __CC_PACKED_ARCHIVE_H__
+#define __CC_PACKED_ARCHIVE_H__
+
+#include <string>
+#include <stdint.h>
+
+#include "platform/CCPlatformMacros.h"
+#include "platform/CCStdC.h"
+
+NS_CC_BEGIN
+
+class ResizableBuffer;
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+
+/** @class PackedArchive
+ * @brief A read-only archive of resource files, mapped into memory and indexed by a minimal perfect hash.
+
+ The archive is a single file, little endian:
+
+     Header        magic "CCPK", version, entry count, bucket count, bucket seed, names size
+     int32         displacement[bucket count], padded to 8 bytes
+     Entry         entries[entry count], stored at the slot their name hashes to
+     char          names[], the relative paths, '/' separated, not null terminated
+     bytes         file contents, each aligned to 16 bytes
+
+ A name is looked up with two XXH32 hashes: the first picks its bucket, the bucket's displacement
+ either seeds the second hash (d >= 0) or is the slot itself (-d - 1). The stored name is then
+ compared, so a lookup costs two hashes and one string compare whatever the number of files.
+
+ The file is mapped copy-on-write, so the bytes returned by getFileData() stay valid, and can be
+ written to, until the archive is destroyed.
+ */
+class CC_DLL PackedArchive
+{
+public:
+    static const uint32_t VERSION = 1;
+
+    PackedArchive();
+    ~PackedArchive();
+
+    /** Maps an archive. The path must be a regular file on disk. */
+    bool open(const std::string& fullPath);
+    void close();
+    bool isOpen() const { return _base != nullptr; }
+
+    const std::string& getPath() const { return _path; }
+    uint32_t getFileCount() const { return _entryCount; }
+    size_t getMappedSize() const { return _mappedSize; }
+
+    /** Checks whether a file, given relative to the archive root, is stored in the archive. */
+    bool fileExists(const std::string& fileName) const;
+
+    /** Returns the mapped bytes of a file without copying them, nullptr if it isn't in the archive. */
+    unsigned char* getFileData(const std::string& fileName, ssize_t* size) const;
+
+    /** Copies a file into a buffer. */
+    bool getFileData(const std::string& fileName, ResizableBuffer* buffer) const;
+
+private:
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t bucketCount;
+        uint32_t seed;
+        uint32_t namesSize;
+    };
+
+    struct Entry
+    {
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    const Entry* findEntry(const std::string& fileName) const;
+
+    std::string _path;
+    unsigned char* _base;
+    size_t _mappedSize;
+    uint32_t _entryCount;
+    uint32_t _bucketCount;
+    uint32_t _seed;
+    const int32_t* _displacements;
+    const Entry* _entries;
+    const char* _names;
+    uint32_t _namesSize;
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+    void* _fileHandle;
+    void* _mappingHandle;
+#endif
+
+    CC_DISALLOW_COPY_AND_ASSIGN(PackedArchive);
+};
+
+// end of platform group
+/// @}
+
+NS_CC_END
+
+#endif // __CC_PACKED_ARCHIVE_H__
@@ -640,6 +640,30 @@ Size GLViewImpl::getMonitorSize() const {
     return Size::ZERO;
 }
 
+int GLViewImpl::getMonitorRefreshRate() const {
+    GLFWmonitor* monitor = _monitor;
+    if (nullptr == monitor) {
+        monitor = glfwGetWindowMonitor(_mainWindow);
+    }
+    if (nullptr == monitor) {
+        monitor = glfwGetPrimaryMonitor();
+    }
+    if (nullptr != monitor) {
+        const GLFWvidmode* videoMode = glfwGetVideoMode(monitor);
+        return videoMode ? videoMode->refreshRate : 0;
+    }
+    return 0;
+}
+
+void GLViewImpl::setSwapInterval(int interval)
+{
+    if (_mainWindow)
+    {
+        glfwMakeContextCurrent(_mainWindow);
+        glfwSwapInterval(interval);
+    }
+}
+
 void GLViewImpl::updateFrameSize()
 {
     if (_screenSize.width > 0 && _screenSize.height > 0)
@@ -88,6 +88,11 @@ public:
     void setWindowed(int width, int height);
     int getMonitorCount() const;
     Size getMonitorSize() const;
+    /** Refresh rate of the monitor the window is on, or of the primary monitor; 0 if unknown. */
+    int getMonitorRefreshRate() const;
+
+    /** Number of vertical syncs swapBuffers() waits for. 0 disables vsync. */
+    void setSwapInterval(int interval);
 
     /* override functions */
     virtual bool isOpenGLReady() override;
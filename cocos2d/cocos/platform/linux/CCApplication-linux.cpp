@@ -29,11 +29,11 @@ THE SOFTWARE.
 
 #include "platform/linux/CCApplication-linux.h"
 #include <unistd.h>
-#include <sys/time.h>
 #include <string>
 #include "base/CCDirector.h"
 #include "base/ccUtils.h"
 #include "platform/CCFileUtils.h"
+#include "platform/desktop/CCGLViewImpl-desktop.h"
 
 NS_CC_BEGIN
 
@@ -41,17 +41,8 @@ NS_CC_BEGIN
 // sharedApplication pointer
 Application * Application::sm_pSharedApplication = nullptr;
 
-static long getCurrentMillSecond() {
-    long lLastTime;
-    struct timeval stCurrentTime;
-
-    gettimeofday(&stCurrentTime,NULL);
-    lLastTime = stCurrentTime.tv_sec*1000+stCurrentTime.tv_usec*0.001; // milliseconds
-    return lLastTime;
-}
-
 Application::Application()
-: _animationInterval(1.0f/60.0f*1000.0f)
+: _animationInterval(1.0 / 60.0)
 {
     CC_ASSERT(! sm_pSharedApplication);
     sm_pSharedApplication = this;
@@ -72,27 +63,53 @@ int Application::run()
         return 0;
     }
 
-    long lastTime = 0L;
-    long curTime = 0L;
-
     auto director = Director::getInstance();
     auto glview = director->getOpenGLView();
+    auto glviewImpl = dynamic_cast<GLViewImpl*>(glview);
 
     // Retain glview to avoid glview being released in the while loop
     glview->retain();
 
-    while (!glview->windowShouldClose())
+    FramePacer::Mode appliedMode = FramePacer::Mode::TIMER;
+    if (glviewImpl)
     {
-        lastTime = getCurrentMillSecond();
+        glviewImpl->setSwapInterval(0);
+    }
+    _framePacer.begin();
 
+    while (!glview->windowShouldClose())
+    {
         director->mainLoop();
-        glview->pollEvents();
+        // Director::drawScene() polls events itself; while the animation is stopped
+        // (e.g. after the window was iconified) it is skipped, so poll here instead
+        // to keep the window restorable.
+        if (!director->isValid())
+        {
+            glview->pollEvents();
+        }
 
-        curTime = getCurrentMillSecond();
-        if (curTime - lastTime < _animationInterval)
+        auto mode = _framePacer.getMode();
+        if (mode != appliedMode && glviewImpl)
         {
-            usleep((_animationInterval - curTime + lastTime)*1000);
+            if (mode == FramePacer::Mode::VSYNC)
+            {
+                int refreshRate = glviewImpl->getMonitorRefreshRate();
+                if (refreshRate > 0)
+                {
+                    _framePacer.setInterval(1.0 / refreshRate);
+                }
+            }
+            else
+            {
+                _framePacer.setInterval(_animationInterval);
+            }
+            glviewImpl->setSwapInterval(mode == FramePacer::Mode::VSYNC ? 1 : 0);
+            appliedMode = mode;
+            _framePacer.begin();
+            continue;
         }
+
+        _framePacer.waitForNextFrame();
     }
     /* Only work on Desktop
     *  Director::mainLoop is really one frame logic
@@ -111,8 +128,12 @@ int Application::run()
 
 void Application::setAnimationInterval(float interval)
 {
-    //TODO do something else
-    _animationInterval = interval*1000.0f;
+    _animationInterval = interval;
+    // with vsync the pacer keeps the display's refresh period
+    if (_framePacer.getMode() == FramePacer::Mode::TIMER)
+    {
+        _framePacer.setInterval(interval);
+    }
 }
 
 void Application::setResourceRootPath(const std::string& rootResDir)
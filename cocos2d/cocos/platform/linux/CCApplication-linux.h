@@ -32,6 +32,7 @@ THE SOFTWARE.
 
 #include "platform/CCCommon.h"
 #include "platform/CCApplicationProtocol.h"
+#include "base/CCFramePacer.h"
 #include <string>
 
 NS_CC_BEGIN
@@ -61,6 +62,13 @@ public:
      */
     int run();
 
+    /**
+     @brief Get the pacer that times the message loop.
+     Its statistics describe the delivered frames. Switch it to FramePacer::Mode::VSYNC to let the
+     buffer swap wait for the display instead; the interval then follows the monitor refresh rate.
+     */
+    FramePacer& getFramePacer() { return _framePacer; }
+
     /**
      @brief Get current application instance.
      @return Current application instance pointer.
@@ -109,7 +117,8 @@ public:
      */
     virtual Platform getTargetPlatform() override;
 protected:
-    long       _animationInterval;  //micro second
+    double     _animationInterval;  // seconds
+    FramePacer _framePacer;
     std::string _resourceRootPath;
     
     static Application * sm_pSharedApplication;
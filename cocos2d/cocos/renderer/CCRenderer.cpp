@@ -48,6 +48,15 @@
 #include "2d/CCCamera.h"
 #include "2d/CCScene.h"
 
+// SIMD paths for batching triangles. MSVC does not define __SSE2__, so check its target macros too.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CC_RENDERER_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CC_RENDERER_NEON 1
+#endif
+
 NS_CC_BEGIN
 
 // helper
@@ -61,6 +70,87 @@ static bool compare3DCommand(RenderCommand* a, RenderCommand* b)
     return  a->getDepth() > b->getDepth();
 }
 
+// Below this size std::stable_sort beats the fixed cost of the radix passes
+static const size_t RADIX_SORT_THRESHOLD = 256;
+
+// Maps a float to an unsigned key with the same ordering
+static inline uint32_t globalOrderKey(float z)
+{
+    uint32_t bits;
+    memcpy(&bits, &z, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+// Stable LSD radix sort on the global order, 8 bits per pass. Passes where every key has
+// the same byte are skipped, which is most of them since scenes use few distinct z values.
+static void radixSortByGlobalOrder(std::vector<RenderCommand*>& commands)
+{
+    static std::vector<RenderCommand*> s_commandScratch;
+    static std::vector<uint32_t> s_keys;
+    static std::vector<uint32_t> s_keyScratch;
+
+    const size_t count = commands.size();
+    s_commandScratch.resize(count);
+    s_keys.resize(count);
+    s_keyScratch.resize(count);
+
+    size_t histogram[4][256] = {};
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t key = globalOrderKey(commands[i]->getGlobalOrder());
+        s_keys[i] = key;
+        ++histogram[0][key & 0xff];
+        ++histogram[1][(key >> 8) & 0xff];
+        ++histogram[2][(key >> 16) & 0xff];
+        ++histogram[3][key >> 24];
+    }
+
+    RenderCommand** src = commands.data();
+    RenderCommand** dst = s_commandScratch.data();
+    uint32_t* srcKeys = s_keys.data();
+    uint32_t* dstKeys = s_keyScratch.data();
+    for (int pass = 0; pass < 4; ++pass)
+    {
+        const int shift = pass * 8;
+        size_t* bucket = histogram[pass];
+        if (bucket[(srcKeys[0] >> shift) & 0xff] == count)
+            continue;
+
+        size_t offset = 0;
+        for (int b = 0; b < 256; ++b)
+        {
+            size_t n = bucket[b];
+            bucket[b] = offset;
+            offset += n;
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            size_t to = bucket[(srcKeys[i] >> shift) & 0xff]++;
+            dst[to] = src[i];
+            dstKeys[to] = srcKeys[i];
+        }
+        std::swap(src, dst);
+        std::swap(srcKeys, dstKeys);
+    }
+
+    if (src != commands.data())
+    {
+        memcpy(commands.data(), src, count * sizeof(RenderCommand*));
+    }
+}
+
+static void sortByGlobalOrder(std::vector<RenderCommand*>& commands)
+{
+    // Most frames keep last frame's order; a stable sort would not change anything then
+    if (std::is_sorted(commands.begin(), commands.end(), compareRenderCommand))
+        return;
+
+    if (commands.size() < RADIX_SORT_THRESHOLD)
+        std::stable_sort(commands.begin(), commands.end(), compareRenderCommand);
+    else
+        radixSortByGlobalOrder(commands);
+}
+
 // queue
 RenderQueue::RenderQueue()
 {
@@ -112,9 +202,11 @@ ssize_t RenderQueue::size() const
 void RenderQueue::sort()
 {
     // Don't sort _queue0, it already comes sorted
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::TRANSPARENT_3D]), std::end(_commands[QUEUE_GROUP::TRANSPARENT_3D]), compare3DCommand);
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_NEG]), std::end(_commands[QUEUE_GROUP::GLOBALZ_NEG]), compareRenderCommand);
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_POS]), std::end(_commands[QUEUE_GROUP::GLOBALZ_POS]), compareRenderCommand);
+    auto& transparent = _commands[QUEUE_GROUP::TRANSPARENT_3D];
+    if (!std::is_sorted(std::begin(transparent), std::end(transparent), compare3DCommand))
+        std::stable_sort(std::begin(transparent), std::end(transparent), compare3DCommand);
+    sortByGlobalOrder(_commands[QUEUE_GROUP::GLOBALZ_NEG]);
+    sortByGlobalOrder(_commands[QUEUE_GROUP::GLOBALZ_POS]);
 }
 
 RenderCommand* RenderQueue::operator[](ssize_t index) const
@@ -198,7 +290,18 @@ static const int DEFAULT_RENDER_QUEUE = 0;
 // constructors, destructor, init
 //
 Renderer::Renderer()
-:_lastBatchedMeshCommand(nullptr)
+:
+#if CC_RENDERER_STREAM_RING
+ _streamEnabled(false)
+,_streamVAO(0)
+,_streamBuffer(0)
+,_streamMapped(nullptr)
+,_streamCapacity(0)
+,_streamHead(0)
+,_streamPendingBegin(0)
+,
+#endif
+ _lastBatchedMeshCommand(nullptr)
 ,_triBatchesToDrawCapacity(-1)
 ,_triBatchesToDraw(nullptr)
 ,_filledVertex(0)
@@ -232,6 +335,9 @@ Renderer::~Renderer()
     _groupCommandManager->release();
     
     glDeleteBuffers(2, _buffersVBO);
+#if CC_RENDERER_STREAM_RING
+    releaseStreamRing();
+#endif
 
     free(_triBatchesToDraw);
 
@@ -266,6 +372,9 @@ void Renderer::setupBuffer()
     if(Configuration::getInstance()->supportsShareableVAO())
     {
         setupVBOAndVAO();
+#if CC_RENDERER_STREAM_RING
+        setupStreamRing();
+#endif
     }
     else
     {
@@ -346,6 +455,181 @@ void Renderer::mapBuffers()
     CHECK_GL_ERROR_DEBUG();
 }
 
+#if CC_RENDERER_STREAM_RING
+void Renderer::setupStreamRing()
+{
+    releaseStreamRing();
+
+    // fences (GL 3.2) and unsynchronized range mapping (GL 3.0) are required
+    if (!GLEW_ARB_sync || !GLEW_ARB_map_buffer_range)
+    {
+        CCLOG("cocos2d: Renderer: ARB_sync or ARB_map_buffer_range missing, batched triangles use buffer orphaning");
+        return;
+    }
+
+    // room for three full flushes, so the CPU never waits on the frame the GPU is drawing
+    _streamCapacity = 3 * (sizeof(_verts[0]) * VBO_SIZE + sizeof(_indices[0]) * INDEX_VBO_SIZE);
+    _streamHead = 0;
+
+    glGenVertexArrays(1, &_streamVAO);
+    GL::bindVAO(_streamVAO);
+
+    glGenBuffers(1, &_streamBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, _streamBuffer);
+
+#if defined(GL_MAP_PERSISTENT_BIT) && defined(GLEW_ARB_buffer_storage)
+    if (GLEW_ARB_buffer_storage)
+    {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, _streamCapacity, nullptr, flags);
+        _streamMapped = static_cast<unsigned char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, _streamCapacity, flags));
+        if (_streamMapped == nullptr)
+        {
+            // the storage is immutable now, start over with a plain buffer
+            glDeleteBuffers(1, &_streamBuffer);
+            glGenBuffers(1, &_streamBuffer);
+            glBindBuffer(GL_ARRAY_BUFFER, _streamBuffer);
+        }
+    }
+#endif
+    if (_streamMapped == nullptr)
+    {
+        glBufferData(GL_ARRAY_BUFFER, _streamCapacity, nullptr, GL_STREAM_DRAW);
+    }
+
+    // the pointers are set per flush, they depend on where the flush lands in the ring
+    glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
+    glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_COLOR);
+    glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORD);
+
+    // vertices and indices share the buffer
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _streamBuffer);
+
+    GL::bindVAO(0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    _streamEnabled = true;
+    CCLOG("cocos2d: Renderer: streaming batched triangles through a %d KB %s ring buffer",
+          (int)(_streamCapacity / 1024), _streamMapped ? "persistently mapped" : "unsynchronized");
+
+    CHECK_GL_ERROR_DEBUG();
+}
+
+void Renderer::releaseStreamRing()
+{
+    for (auto& fence : _streamFences)
+    {
+        glDeleteSync(fence.sync);
+    }
+    _streamFences.clear();
+
+    if (_streamBuffer)
+    {
+        if (_streamMapped)
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, _streamBuffer);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+        glDeleteBuffers(1, &_streamBuffer);
+    }
+    if (_streamVAO)
+    {
+        glDeleteVertexArrays(1, &_streamVAO);
+        GL::bindVAO(0);
+    }
+
+    _streamBuffer = 0;
+    _streamVAO = 0;
+    _streamMapped = nullptr;
+    _streamEnabled = false;
+}
+
+bool Renderer::uploadToStreamRing(GLintptr* indexOffset)
+{
+    const size_t vertexBytes = sizeof(_verts[0]) * _filledVertex;
+    const size_t indexBytes = sizeof(_indices[0]) * _filledIndex;
+    // keep every flush 16-byte aligned
+    const size_t size = (vertexBytes + indexBytes + 15) & ~(size_t)15;
+    if (size > _streamCapacity)
+        return false;
+
+    if (_streamHead + size > _streamCapacity)
+        _streamHead = 0;
+    const size_t begin = _streamHead;
+    const size_t end = begin + size;
+
+    // Fences are pushed in ring order, so only the oldest ones at the front can cover
+    // the range ahead of the head. Wait for the last of those; the GPU finishes in
+    // order, so the ones before it are done too. With three flushes of room this
+    // rarely blocks.
+    size_t overlapping = 0;
+    while (overlapping < _streamFences.size()
+        && _streamFences[overlapping].begin < end && _streamFences[overlapping].end > begin)
+    {
+        ++overlapping;
+    }
+    if (overlapping > 0)
+    {
+        GLsync sync = _streamFences[overlapping - 1].sync;
+        GLenum status;
+        do {
+            status = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+        } while (status == GL_TIMEOUT_EXPIRED);
+
+        for (size_t i = 0; i < overlapping; ++i)
+        {
+            glDeleteSync(_streamFences.front().sync);
+            _streamFences.pop_front();
+        }
+    }
+
+    GL::bindVAO(_streamVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, _streamBuffer);
+
+    if (_streamMapped)
+    {
+        memcpy(_streamMapped + begin, _verts, vertexBytes);
+        memcpy(_streamMapped + begin + vertexBytes, _indices, indexBytes);
+    }
+    else
+    {
+        // the range is known to be idle, so the driver need not synchronize or keep its contents
+        auto buf = static_cast<unsigned char*>(glMapBufferRange(GL_ARRAY_BUFFER, begin, vertexBytes + indexBytes,
+            GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT));
+        if (buf == nullptr)
+        {
+            GL::bindVAO(0);
+            return false;
+        }
+        memcpy(buf, _verts, vertexBytes);
+        memcpy(buf + vertexBytes, _indices, indexBytes);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) (begin + offsetof(V3F_C4B_T2F, vertices)));
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), (GLvoid*) (begin + offsetof(V3F_C4B_T2F, colors)));
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) (begin + offsetof(V3F_C4B_T2F, texCoords)));
+    // the VAO keeps the buffer; later client side arrays must not read from the ring
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    *indexOffset = (GLintptr)(begin + vertexBytes);
+    _streamPendingBegin = begin;
+    _streamHead = end;
+    return true;
+}
+
+void Renderer::fenceStreamRing()
+{
+    StreamFence fence;
+    fence.sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    fence.begin = _streamPendingBegin;
+    fence.end = _streamHead;
+    _streamFences.push_back(fence);
+}
+#endif
+
 void Renderer::addCommand(RenderCommand* command)
 {
     int renderQueueID =_commandGroupStack.top();
@@ -706,23 +990,79 @@ void Renderer::setDepthTest(bool enable)
     CHECK_GL_ERROR_DEBUG();
 }
 
+// Same as Mat4::transformPoint on each position (w = 1, no divide).
+// The SIMD paths keep one matrix column per register, so a vertex costs three multiply-adds
+// instead of nine scalar ones; about half the scalar time per quad on x86.
+static void transformVertexPositions(const Mat4& modelView, V3F_C4B_T2F* verts, ssize_t count)
+{
+    const float* m = modelView.m;
+#if CC_RENDERER_SSE2
+    const __m128 col0 = _mm_loadu_ps(m);
+    const __m128 col1 = _mm_loadu_ps(m + 4);
+    const __m128 col2 = _mm_loadu_ps(m + 8);
+    const __m128 col3 = _mm_loadu_ps(m + 12);
+    for (ssize_t i = 0; i < count; ++i)
+    {
+        Vec3& p = verts[i].vertices;
+        __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(col0, _mm_set1_ps(p.x)), _mm_mul_ps(col1, _mm_set1_ps(p.y))),
+                              _mm_add_ps(_mm_mul_ps(col2, _mm_set1_ps(p.z)), col3));
+        // only x, y, z may be written, the color follows the position
+        _mm_storel_pi(reinterpret_cast<__m64*>(&p.x), r);
+        _mm_store_ss(&p.z, _mm_movehl_ps(r, r));
+    }
+#elif CC_RENDERER_NEON
+    const float32x4_t col0 = vld1q_f32(m);
+    const float32x4_t col1 = vld1q_f32(m + 4);
+    const float32x4_t col2 = vld1q_f32(m + 8);
+    const float32x4_t col3 = vld1q_f32(m + 12);
+    for (ssize_t i = 0; i < count; ++i)
+    {
+        Vec3& p = verts[i].vertices;
+        float32x4_t r = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(col3, col0, p.x), col1, p.y), col2, p.z);
+        vst1_f32(&p.x, vget_low_f32(r));
+        vst1q_lane_f32(&p.z, r, 2);
+    }
+#else
+    for (ssize_t i = 0; i < count; ++i)
+    {
+        modelView.transformPoint(&verts[i].vertices);
+    }
+#endif
+}
+
+// dst[i] = src[i] + offset, eight indices per step where SIMD is available
+static void rebaseIndices(unsigned short* dst, const unsigned short* src, ssize_t count, unsigned short offset)
+{
+    ssize_t i = 0;
+#if CC_RENDERER_SSE2
+    const __m128i step = _mm_set1_epi16((short)offset);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_add_epi16(v, step));
+    }
+#elif CC_RENDERER_NEON
+    const uint16x8_t step = vdupq_n_u16(offset);
+    for (; i + 8 <= count; i += 8)
+    {
+        vst1q_u16(dst + i, vaddq_u16(vld1q_u16(src + i), step));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        dst[i] = offset + src[i];
+    }
+}
+
 void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd)
 {
     memcpy(&_verts[_filledVertex], cmd->getVertices(), sizeof(V3F_C4B_T2F) * cmd->getVertexCount());
 
     // fill vertex, and convert them to world coordinates
-    const Mat4& modelView = cmd->getModelView();
-    for(ssize_t i=0; i < cmd->getVertexCount(); ++i)
-    {
-        modelView.transformPoint(&(_verts[i + _filledVertex].vertices));
-    }
+    transformVertexPositions(cmd->getModelView(), &_verts[_filledVertex], cmd->getVertexCount());
 
     // fill index
-    const unsigned short* indices = cmd->getIndices();
-    for(ssize_t i=0; i< cmd->getIndexCount(); ++i)
-    {
-        _indices[_filledIndex + i] = _filledVertex + indices[i];
-    }
+    rebaseIndices(&_indices[_filledIndex], cmd->getIndices(), cmd->getIndexCount(), (unsigned short)_filledVertex);
 
     _filledVertex += cmd->getVertexCount();
     _filledIndex += cmd->getIndexCount();
@@ -791,7 +1131,17 @@ void Renderer::drawBatchedTriangles()
 
     /************** 2: Copy vertices/indices to GL objects *************/
     auto conf = Configuration::getInstance();
-    if (conf->supportsShareableVAO() && conf->supportsMapBuffer())
+    // byte offset of this flush's indices in the element buffer
+    GLintptr indexOffset = 0;
+    bool streamed = false;
+#if CC_RENDERER_STREAM_RING
+    streamed = _streamEnabled && uploadToStreamRing(&indexOffset);
+#endif
+    if (streamed)
+    {
+        // uploadToStreamRing() bound the ring VAO and pointed it at this flush
+    }
+    else if (conf->supportsShareableVAO() && conf->supportsMapBuffer())
     {
         //Bind VAO
         GL::bindVAO(_buffersVAO);
@@ -846,13 +1196,19 @@ void Renderer::drawBatchedTriangles()
     {
         CC_ASSERT(_triBatchesToDraw[i].cmd && "Invalid batch");
         _triBatchesToDraw[i].cmd->useMaterial();
-        glDrawElements(GL_TRIANGLES, (GLsizei) _triBatchesToDraw[i].indicesToDraw, GL_UNSIGNED_SHORT, (GLvoid*) (_triBatchesToDraw[i].offset*sizeof(_indices[0])) );
+        glDrawElements(GL_TRIANGLES, (GLsizei) _triBatchesToDraw[i].indicesToDraw, GL_UNSIGNED_SHORT, (GLvoid*) (indexOffset + _triBatchesToDraw[i].offset*sizeof(_indices[0])) );
         _drawnBatches++;
         _drawnVertices += _triBatchesToDraw[i].indicesToDraw;
     }
 
     /************** 4: Cleanup *************/
-    if (conf->supportsShareableVAO() && conf->supportsMapBuffer())
+#if CC_RENDERER_STREAM_RING
+    if (streamed)
+    {
+        fenceStreamRing();
+    }
+#endif
+    if (streamed || (conf->supportsShareableVAO() && conf->supportsMapBuffer()))
     {
         //Unbind VAO
         GL::bindVAO(0);
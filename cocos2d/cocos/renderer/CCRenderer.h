@@ -29,8 +29,10 @@
 
 #include <vector>
 #include <stack>
+#include <deque>
 
 #include "platform/CCPlatformMacros.h"
+#include "base/ccConfig.h"
 #include "renderer/CCRenderCommand.h"
 #include "renderer/CCGLProgram.h"
 #include "platform/CCGL.h"
@@ -232,6 +234,30 @@ protected:
 
     void fillVerticesAndIndices(const TrianglesCommand* cmd);
 
+#if CC_RENDERER_STREAM_RING
+    // Ring buffer streaming: each flush appends its vertices and indices to one buffer,
+    // and the range is only written again once the fence placed after its draws has signaled.
+    struct StreamFence {
+        GLsync sync;
+        size_t begin;
+        size_t end;
+    };
+    void setupStreamRing();
+    void releaseStreamRing();
+    bool uploadToStreamRing(GLintptr* indexOffset);
+    void fenceStreamRing();
+
+    bool _streamEnabled;
+    GLuint _streamVAO;
+    GLuint _streamBuffer;
+    // persistently mapped storage, nullptr when every flush maps its range unsynchronized
+    unsigned char* _streamMapped;
+    size_t _streamCapacity;
+    size_t _streamHead;
+    size_t _streamPendingBegin;
+    std::deque<StreamFence> _streamFences;
+#endif
+
 
     /* clear color set outside be used in setGLDefaultValues() */
     Color4F _clearColor;
@@ -548,6 +548,7 @@ protected:
     NinePatchInfo* _ninePatchInfo;
     friend class SpriteFrameCache;
     friend class TextureCache;
+    friend class TextureFormatPolicy;
     friend class ui::Scale9Sprite;
 
     bool _valid;
@@ -32,12 +32,18 @@ THE SOFTWARE.
 #include <stack>
 #include <cctype>
 #include <list>
+#include <map>
+#include <algorithm>
+#include <chrono>
+#include <memory>
 
 #include "renderer/CCTexture2D.h"
+#include "renderer/CCTextureFormatPolicy.h"
 #include "base/ccMacros.h"
 #include "base/ccUTF8.h"
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
+#include "base/CCFrameStats.h"
 #include "platform/CCFileUtils.h"
 #include "base/ccUtils.h"
 #include "base/CCNinePatchImageParser.h"
@@ -68,9 +74,11 @@ TextureCache * TextureCache::getInstance()
 }
 
 TextureCache::TextureCache()
-: _loadingThread(nullptr)
-, _needQuit(false)
+: _needQuit(false)
 , _asyncRefCount(0)
+, _asyncUploadBudget(4.0f)
+, _memoryBudget(0)
+, _useClock(0)
 {
 }
 
@@ -81,7 +89,8 @@ TextureCache::~TextureCache()
     for (auto& texture : _textures)
         texture.second->release();
 
-    CC_SAFE_DELETE(_loadingThread);
+    for (auto& thread : _loadingThreads)
+        CC_SAFE_DELETE(thread);
 }
 
 void TextureCache::destroyInstance()
@@ -97,6 +106,15 @@ void TextureCache::purgeSharedTextureCache()
 {
 }
 
+unsigned int TextureCache::getDecodeThreadCount()
+{
+    unsigned int cores = std::thread::hardware_concurrency();
+    if (cores == 0)
+        cores = 2;
+    // leave one core to the main thread
+    return std::max(1u, std::min(cores - 1, 8u));
+}
+
 std::string TextureCache::getDescription() const
 {
     return StringUtils::format("<TextureCache | Number of textures = %d>", static_cast<int>(_textures.size()));
@@ -107,15 +125,19 @@ struct TextureCache::AsyncStruct
 public:
     AsyncStruct
     ( const std::string& fn,const std::function<void(Texture2D*)>& f,
-      const std::string& key )
-      : filename(fn), callback(f),callbackKey( key ),
-        pixelFormat(Texture2D::getDefaultAlphaPixelFormat()),
+      const std::string& key, const std::function<void()>& done )
+      : filename(fn), callback(f),callbackKey( key ), completion(done),
+        pixelFormat(TextureFormatPolicy::getInstance()->resolve(fn, &sourceFile)),
         loadSuccess(false)
     {}
 
     std::string filename;
+    // the transcoded blob of filename when there is one
+    std::string sourceFile;
     std::function<void(Texture2D*)> callback;
     std::string callbackKey;
+    // not cleared by unbindImageAsync(), so addImages() can still count the request as done
+    std::function<void()> completion;
     Image image;
     Image imageAlpha;
     Texture2D::PixelFormat pixelFormat;
@@ -125,8 +147,8 @@ public:
 /**
  The addImageAsync logic follow the steps:
  - find the image has been add or not, if not add an AsyncStruct to _requestQueue  (GL thread)
- - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load thread)
- - on schedule callback, get AsyncStruct from _responseQueue, convert image to texture, then delete AsyncStruct (GL thread)
+ - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load threads, getDecodeThreadCount() of them)
+ - on schedule callback, get AsyncStruct from _responseQueue, convert image to texture, then delete AsyncStruct (GL thread, within _asyncUploadBudget per frame)
 
  the Critical Area include these members:
  - _requestQueue: locked by _requestMutex
@@ -146,8 +168,12 @@ public:
  - In addImageAsyncCallback, will deduplicate the request to ensure only create one texture.
 
  Does process all response in addImageAsyncCallback consume more time?
- - Convert image to texture faster than load image from disk, so this isn't a
- problem.
+ - Convert image to texture faster than load image from disk, but a large batch
+ decoded in parallel can still finish within one frame, so the upload stops once
+ _asyncUploadBudget is used up and continues on the next frame.
+
+ The images are decoded in parallel, so responses arrive in completion order,
+ not in request order.
 
  Call unbindImageAsync(path) to prevent the call to the callback when the
  texture is loaded.
@@ -160,8 +186,8 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
 /**
  The addImageAsync logic follow the steps:
  - find the image has been add or not, if not add an AsyncStruct to _requestQueue  (GL thread)
- - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load thread)
- - on schedule callback, get AsyncStruct from _responseQueue, convert image to texture, then delete AsyncStruct (GL thread)
+ - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load threads, getDecodeThreadCount() of them)
+ - on schedule callback, get AsyncStruct from _responseQueue, convert image to texture, then delete AsyncStruct (GL thread, within _asyncUploadBudget per frame)
  
  the Critical Area include these members:
  - _requestQueue: locked by _requestMutex
@@ -181,8 +207,12 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
  - In addImageAsyncCallback, will deduplicate the request to ensure only create one texture.
  
  Does process all response in addImageAsyncCallback consume more time?
- - Convert image to texture faster than load image from disk, so this isn't a
- problem.
+ - Convert image to texture faster than load image from disk, but a large batch
+ decoded in parallel can still finish within one frame, so the upload stops once
+ _asyncUploadBudget is used up and continues on the next frame.
+
+ The images are decoded in parallel, so responses arrive in completion order,
+ not in request order.
 
  The callbackKey allows to unbind the callback in cases where the loading of
  path is requested by several sources simultaneously. Each source can then
@@ -190,6 +220,12 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
  unbindImageAsync(path) would be ambiguous.
  */
 void TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, const std::string& callbackKey)
+{
+    queueImageAsync(path, callback, callbackKey, nullptr);
+}
+
+void TextureCache::queueImageAsync(const std::string& path, const std::function<void(Texture2D*)>& callback, const std::string& callbackKey,
+                                   const std::function<void()>& completion)
 {
     Texture2D *texture = nullptr;
 
@@ -201,22 +237,29 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
 
     if (texture != nullptr)
     {
+        touchTexture(fullpath);
         if (callback) callback(texture);
+        if (completion) completion();
         return;
     }
 
     // check if file exists
     if (fullpath.empty() || !FileUtils::getInstance()->isFileExist(fullpath)) {
         if (callback) callback(nullptr);
+        if (completion) completion();
         return;
     }
 
     // lazy init
-    if (_loadingThread == nullptr)
+    if (_loadingThreads.empty())
     {
-        // create a new thread to load images
+        // create the threads to decode images
         _needQuit = false;
-        _loadingThread = new (std::nothrow) std::thread(&TextureCache::loadImage, this);
+        unsigned int count = getDecodeThreadCount();
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            _loadingThreads.push_back(new (std::nothrow) std::thread(&TextureCache::loadImage, this));
+        }
     }
 
     if (0 == _asyncRefCount)
@@ -228,7 +271,7 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
 
     // generate async struct
     AsyncStruct *data =
-      new (std::nothrow) AsyncStruct(fullpath, callback, callbackKey);
+      new (std::nothrow) AsyncStruct(fullpath, callback, callbackKey, completion);
     
     // add async struct into queue
     _asyncStructQueue.push_back(data);
@@ -237,6 +280,42 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
     _sleepCondition.notify_one();
 }
 
+void TextureCache::addImages(const std::vector<std::string>& paths, const std::function<void(const std::vector<Texture2D*>&)>& callback)
+{
+    struct Batch
+    {
+        std::vector<Texture2D*> textures;
+        // keeps the finished textures alive until the whole batch is done
+        Vector<Texture2D*> retained;
+        size_t pending;
+        std::function<void(const std::vector<Texture2D*>&)> callback;
+    };
+
+    auto batch = std::make_shared<Batch>();
+    batch->textures.resize(paths.size(), nullptr);
+    batch->pending = paths.size();
+    batch->callback = callback;
+
+    if (paths.empty())
+    {
+        if (callback) callback(batch->textures);
+        return;
+    }
+
+    // an unbound path leaves its entry nullptr, but still counts towards the batch
+    for (size_t i = 0; i < paths.size(); ++i)
+    {
+        queueImageAsync(paths[i], [batch, i](Texture2D* texture) {
+            batch->textures[i] = texture;
+            if (texture)
+                batch->retained.pushBack(texture);
+        }, paths[i], [batch]() {
+            if (--batch->pending == 0 && batch->callback)
+                batch->callback(batch->textures);
+        });
+    }
+}
+
 void TextureCache::unbindImageAsync(const std::string& callbackKey)
 {
     if (_asyncStructQueue.empty())
@@ -293,7 +372,7 @@ void TextureCache::loadImage()
         ul.unlock();
 
         // load image
-        asyncStruct->loadSuccess = asyncStruct->image.initWithImageFileThreadSafe(asyncStruct->filename);
+        asyncStruct->loadSuccess = asyncStruct->image.initWithImageFileThreadSafe(asyncStruct->sourceFile);
 
         // ETC1 ALPHA supports.
         if (asyncStruct->loadSuccess && asyncStruct->image.getFileType() == Image::Format::ETC && !s_etc1AlphaFileSuffix.empty())
@@ -311,8 +390,10 @@ void TextureCache::loadImage()
 
 void TextureCache::addImageAsyncCallBack(float /*dt*/)
 {
+    FrameStats::ScopedZone uploadZone(FrameStats::ZONE_TEXTURE_UPLOAD);
     Texture2D *texture = nullptr;
     AsyncStruct *asyncStruct = nullptr;
+    auto start = std::chrono::steady_clock::now();
     while (true)
     {
         // pop an AsyncStruct from response queue
@@ -326,9 +407,10 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
             asyncStruct = _responseQueue.front();
             _responseQueue.pop_front();
 
-            // the asyncStruct's sequence order in _asyncStructQueue must equal to the order in _responseQueue
-            CC_ASSERT(asyncStruct == _asyncStructQueue.front());
-            _asyncStructQueue.pop_front();
+            // the decode threads finish out of order, so remove it wherever it is
+            auto queued = std::find(_asyncStructQueue.begin(), _asyncStructQueue.end(), asyncStruct);
+            CC_ASSERT(queued != _asyncStructQueue.end());
+            _asyncStructQueue.erase(queued);
         }
         _responseMutex.unlock();
 
@@ -341,6 +423,7 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
         if (it != _textures.end())
         {
             texture = it->second;
+            touchTexture(asyncStruct->filename);
         }
         else
         {
@@ -356,11 +439,12 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
                 this->parseNinePatchImage(image, texture, asyncStruct->filename);
 #if CC_ENABLE_CACHE_TEXTURE_DATA
                 // cache the texture file name
-                VolatileTextureMgr::addImageTexture(texture, asyncStruct->filename);
+                VolatileTextureMgr::addImageTexture(texture, asyncStruct->sourceFile);
 #endif
                 // cache the texture. retain it, since it is added in the map
                 _textures.emplace(asyncStruct->filename, texture);
                 texture->retain();
+                touchTexture(asyncStruct->filename);
 
                 texture->autorelease();
                 // ETC1 ALPHA supports.
@@ -383,10 +467,21 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
         {
             (asyncStruct->callback)(texture);
         }
+        if (asyncStruct->completion)
+        {
+            (asyncStruct->completion)();
+        }
 
         // release the asyncStruct
         delete asyncStruct;
         --_asyncRefCount;
+
+        // leave the rest for the next frame once the budget is used up
+        float elapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (elapsed >= _asyncUploadBudget)
+        {
+            break;
+        }
     }
 
     if (0 == _asyncRefCount)
@@ -410,29 +505,39 @@ Texture2D * TextureCache::addImage(const std::string &path)
     }
     auto it = _textures.find(fullpath);
     if (it != _textures.end())
+    {
         texture = it->second;
+        touchTexture(fullpath);
+    }
 
     if (!texture)
     {
+        FrameStats::ScopedZone loadZone(FrameStats::ZONE_TEXTURE_LOAD);
+
         // all images are handled by UIImage except PVR extension that is handled by our own handler
         do
         {
+            // the per-asset format, and the transcoded blob to read instead of the image if there is one
+            std::string sourcePath;
+            Texture2D::PixelFormat pixelFormat = TextureFormatPolicy::getInstance()->resolve(fullpath, &sourcePath);
+
             image = new (std::nothrow) Image();
             CC_BREAK_IF(nullptr == image);
 
-            bool bRet = image->initWithImageFile(fullpath);
+            bool bRet = image->initWithImageFile(sourcePath);
             CC_BREAK_IF(!bRet);
 
             texture = new (std::nothrow) Texture2D();
 
-            if (texture && texture->initWithImage(image))
+            if (texture && texture->initWithImage(image, pixelFormat))
             {
 #if CC_ENABLE_CACHE_TEXTURE_DATA
                 // cache the texture file name
-                VolatileTextureMgr::addImageTexture(texture, fullpath);
+                VolatileTextureMgr::addImageTexture(texture, sourcePath);
 #endif
                 // texture already retained, no need to re-retain it
                 _textures.emplace(fullpath, texture);
+                touchTexture(fullpath);
 
                 //-- ANDROID ETC1 ALPHA SUPPORTS.
                 std::string alphaFullPath = path + s_etc1AlphaFileSuffix;
@@ -489,6 +594,7 @@ Texture2D* TextureCache::addImage(Image *image, const std::string &key)
         auto it = _textures.find(key);
         if (it != _textures.end()) {
             texture = it->second;
+            touchTexture(key);
             break;
         }
 
@@ -499,6 +605,7 @@ Texture2D* TextureCache::addImage(Image *image, const std::string &key)
             if (texture->initWithImage(image))
             {
                 _textures.emplace(key, texture);
+                touchTexture(key);
             }
             else
             {
@@ -545,13 +652,16 @@ bool TextureCache::reloadTexture(const std::string& fileName)
     else
     {
         do {
+            std::string sourcePath;
+            Texture2D::PixelFormat pixelFormat = TextureFormatPolicy::getInstance()->resolve(fullpath, &sourcePath);
+
             image = new (std::nothrow) Image();
             CC_BREAK_IF(nullptr == image);
 
-            bool bRet = image->initWithImageFile(fullpath);
+            bool bRet = image->initWithImageFile(sourcePath);
             CC_BREAK_IF(!bRet);
 
-            ret = texture->initWithImage(image);
+            ret = texture->initWithImage(image, pixelFormat);
         } while (0);
     }
 
@@ -568,6 +678,7 @@ void TextureCache::removeAllTextures()
         texture.second->release();
     }
     _textures.clear();
+    _residency.clear();
 }
 
 void TextureCache::removeUnusedTextures()
@@ -578,6 +689,7 @@ void TextureCache::removeUnusedTextures()
             CCLOG("cocos2d: TextureCache: removing unused texture: %s", it->first.c_str());
 
             tex->release();
+            _residency.erase(it->first);
             it = _textures.erase(it);
         }
         else {
@@ -597,6 +709,7 @@ void TextureCache::removeTexture(Texture2D* texture)
     for (auto it = _textures.cbegin(); it != _textures.cend(); /* nothing */) {
         if (it->second == texture) {
             it->second->release();
+            _residency.erase(it->first);
             it = _textures.erase(it);
             break;
         }
@@ -617,6 +730,7 @@ void TextureCache::removeTextureForKey(const std::string &textureKeyName)
 
     if (it != _textures.end()) {
         it->second->release();
+        _residency.erase(it->first);
         _textures.erase(it);
     }
 }
@@ -662,9 +776,12 @@ void TextureCache::waitForQuit()
     // notify sub thread to quick
     std::unique_lock<std::mutex> ul(_requestMutex);
     _needQuit = true;
-    _sleepCondition.notify_one();
+    _sleepCondition.notify_all();
     ul.unlock();
-    if (_loadingThread) _loadingThread->join();
+    for (auto& thread : _loadingThreads)
+    {
+        if (thread && thread->joinable()) thread->join();
+    }
 }
 
 std::string TextureCache::getCachedTextureInfo() const
@@ -704,6 +821,183 @@ std::string TextureCache::getCachedTextureInfo() const
     return buffer;
 }
 
+void TextureCache::setOwnerPinned(const std::string& owner, bool pinned)
+{
+    if (pinned)
+        _pinnedOwners.insert(owner);
+    else
+        _pinnedOwners.erase(owner);
+}
+
+void TextureCache::touchTexture(const std::string& key)
+{
+    auto it = _residency.find(key);
+    if (it == _residency.end())
+    {
+        // the first owner keeps the texture, later scenes only refresh its use
+        it = _residency.emplace(key, Residency{_ownerTag, 0}).first;
+    }
+    it->second.lastUse = ++_useClock;
+}
+
+size_t TextureCache::getTextureBytes(Texture2D* texture)
+{
+    if (!texture)
+        return 0;
+
+    // Each texture takes up width * height * bytesPerPixel bytes, a third more with mipmaps.
+    size_t bytes = (size_t)texture->getPixelsWide() * texture->getPixelsHigh() * texture->getBitsPerPixelForFormat() / 8;
+    if (texture->hasMipmaps())
+        bytes += bytes / 3;
+
+    Texture2D* alphaTexture = texture->getAlphaTexture();
+    if (alphaTexture && alphaTexture != texture)
+        bytes += getTextureBytes(alphaTexture);
+
+    return bytes;
+}
+
+size_t TextureCache::getResidentBytes() const
+{
+    size_t bytes = 0;
+    for (auto& texture : _textures)
+        bytes += getTextureBytes(texture.second);
+    return bytes;
+}
+
+std::unordered_map<std::string, size_t> TextureCache::getResidentBytesByOwner() const
+{
+    std::unordered_map<std::string, size_t> owners;
+    for (auto& texture : _textures)
+    {
+        auto it = _residency.find(texture.first);
+        const std::string& owner = (it != _residency.end() && !it->second.owner.empty()) ? it->second.owner : std::string("-");
+        owners[owner] += getTextureBytes(texture.second);
+    }
+    return owners;
+}
+
+size_t TextureCache::trimToMemoryBudget()
+{
+    if (_memoryBudget == 0)
+        return 0;
+    return trimToMemoryBudget(_memoryBudget);
+}
+
+size_t TextureCache::trimToMemoryBudget(size_t budget)
+{
+    struct Candidate
+    {
+        unsigned int lastUse;
+        size_t bytes;
+        const std::string* key;
+    };
+    std::vector<Candidate> candidates;
+
+    size_t resident = 0;
+    ++_useClock;
+    for (auto& texture : _textures)
+    {
+        auto it = _residency.find(texture.first);
+        if (it == _residency.end())
+            it = _residency.emplace(texture.first, Residency{_ownerTag, _useClock}).first;
+
+        // pinned textures stay, and the budget only covers the others
+        if (!_pinnedOwners.empty() && isOwnerPinned(it->second.owner))
+            continue;
+
+        size_t bytes = getTextureBytes(texture.second);
+        resident += bytes;
+
+        if (texture.second->getReferenceCount() > 1)
+        {
+            // still in use: it only starts to age once nothing holds it anymore
+            it->second.lastUse = _useClock;
+        }
+        else
+        {
+            candidates.push_back({it->second.lastUse, bytes, &texture.first});
+        }
+    }
+
+    if (resident <= budget)
+        return 0;
+
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        return a.lastUse < b.lastUse;
+    });
+
+    size_t freed = 0;
+    for (auto& candidate : candidates)
+    {
+        if (resident - freed <= budget)
+            break;
+
+        // copy the key, erasing the entry destroys the string it points to
+        std::string key = *candidate.key;
+        auto it = _textures.find(key);
+        CCLOG("cocos2d: TextureCache: evicting texture: %s (%lu KB)", key.c_str(), (unsigned long)(candidate.bytes / 1024));
+        it->second->release();
+        _textures.erase(it);
+        _residency.erase(key);
+        freed += candidate.bytes;
+    }
+
+    return freed;
+}
+
+std::string TextureCache::getResidencyInfo() const
+{
+    struct OwnerStats
+    {
+        unsigned int count;
+        unsigned int unreferenced;
+        size_t bytes;
+        size_t unreferencedBytes;
+    };
+    std::map<std::string, OwnerStats> owners;
+
+    size_t totalBytes = 0;
+    size_t unreferencedBytes = 0;
+    for (auto& texture : _textures)
+    {
+        auto it = _residency.find(texture.first);
+        const std::string& owner = (it != _residency.end() && !it->second.owner.empty()) ? it->second.owner : std::string("-");
+
+        size_t bytes = getTextureBytes(texture.second);
+        bool unreferenced = texture.second->getReferenceCount() == 1;
+
+        auto& stats = owners[owner];
+        stats.count++;
+        stats.bytes += bytes;
+        totalBytes += bytes;
+        if (unreferenced)
+        {
+            stats.unreferenced++;
+            stats.unreferencedBytes += bytes;
+            unreferencedBytes += bytes;
+        }
+    }
+
+    std::string buffer;
+    for (auto& owner : owners)
+    {
+        buffer += StringUtils::format("%-24s %4u textures %8lu KB, unreferenced %4u / %8lu KB%s\n",
+            owner.first.c_str(),
+            owner.second.count,
+            (unsigned long)(owner.second.bytes / 1024),
+            owner.second.unreferenced,
+            (unsigned long)(owner.second.unreferencedBytes / 1024),
+            isOwnerPinned(owner.first) ? " (pinned)" : "");
+    }
+
+    buffer += StringUtils::format("TextureCache residency: %.2f MB resident, %.2f MB unreferenced, budget %s\n",
+        totalBytes / (1024.0f * 1024.0f),
+        unreferencedBytes / (1024.0f * 1024.0f),
+        _memoryBudget ? StringUtils::format("%.2f MB", _memoryBudget / (1024.0f * 1024.0f)).c_str() : "off");
+    return buffer;
+}
+
 void TextureCache::renameTextureWithKey(const std::string& srcName, const std::string& dstName)
 {
     std::string key = srcName;
@@ -725,8 +1019,10 @@ void TextureCache::renameTextureWithKey(const std::string& srcName, const std::s
             if (ret)
             {
                 tex->initWithImage(image);
-                _textures.emplace(fullpath, tex);
+                _residency.erase(it->first);
                 _textures.erase(it);
+                _textures.emplace(fullpath, tex);
+                touchTexture(fullpath);
             }
             CC_SAFE_DELETE(image);
         }
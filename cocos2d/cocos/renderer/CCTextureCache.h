@@ -35,6 +35,8 @@ THE SOFTWARE.
 #include <queue>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include <functional>
 
 #include "base/CCRef.h"
@@ -127,6 +129,27 @@ public:
     
     void addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, const std::string& callbackKey );
 
+    /** Loads a batch of images on the decode threads and calls the callback once all of them are textures.
+    * The images are decoded in parallel; the textures are created on the main thread, a few per frame
+    * (see setAsyncUploadBudget()). The callback is called from the main thread.
+    * The callback is still called when some of the paths are unbound with unbindImageAsync() or
+    * unbindAllImageAsync(); their entries are nullptr.
+     @param paths The file paths.
+     @param callback Receives one texture per path, in the same order. Images that failed to load or were unbound are nullptr.
+    */
+    void addImages(const std::vector<std::string>& paths, const std::function<void(const std::vector<Texture2D*>&)>& callback);
+
+    /** Sets how long, in milliseconds, the main thread may spend per frame creating textures from
+    * asynchronously decoded images. At least one texture is created per frame. Default is 4 ms.
+    */
+    void setAsyncUploadBudget(float milliseconds) { _asyncUploadBudget = milliseconds; }
+    float getAsyncUploadBudget() const { return _asyncUploadBudget; }
+
+    /** Number of threads that decode images for addImageAsync() and addImages().
+    * One less than the number of cores, between 1 and 8.
+    */
+    static unsigned int getDecodeThreadCount();
+
     /** Unbind a specified bound image asynchronous callback.
      * In the case an object who was bound to an image asynchronous callback was destroyed before the callback is invoked,
      * the object always need to unbind this callback manually.
@@ -219,16 +242,59 @@ public:
     */
     void renameTextureWithKey(const std::string& srcName, const std::string& dstName);
 
+    /** Sets how many bytes of texture memory the cache may keep.
+    * When the cache is over budget, trimToMemoryBudget() evicts the unreferenced textures, least
+    * recently used first. The Director trims after every scene change. 0, the default, disables the budget.
+    * Textures of pinned owners (see setOwnerPinned()) are not counted.
+    */
+    void setMemoryBudget(size_t bytes) { _memoryBudget = bytes; }
+    size_t getMemoryBudget() const { return _memoryBudget; }
+
+    /** Tags the textures loaded from now on with their owner, usually the name of the scene being built.
+    * A texture keeps the tag of the first owner that loaded it. Used by getResidencyInfo().
+    */
+    void setOwnerTag(const std::string& owner) { _ownerTag = owner; }
+    const std::string& getOwnerTag() const { return _ownerTag; }
+
+    /** Pins the textures tagged with an owner, e.g. assets preloaded for the whole session.
+    * trimToMemoryBudget() never evicts them and they do not count against the budget.
+    */
+    void setOwnerPinned(const std::string& owner, bool pinned);
+    bool isOwnerPinned(const std::string& owner) const { return _pinnedOwners.find(owner) != _pinnedOwners.end(); }
+
+    /** Evicts unreferenced textures, least recently used first, until the cache fits in the memory budget.
+    * Textures held by a node, a sprite frame or an animation are never evicted.
+    * @return The number of bytes freed.
+    */
+    size_t trimToMemoryBudget();
+    size_t trimToMemoryBudget(size_t budget);
+
+    /** Returns the texture memory taken by the cached textures, in bytes. */
+    size_t getResidentBytes() const;
+
+    /** Returns the texture memory taken by the cached textures per owner tag, in bytes. Untagged textures count under "-". */
+    std::unordered_map<std::string, size_t> getResidentBytesByOwner() const;
+
+    /** Returns the texture memory per owner tag, the unreferenced part of it, and the budget. */
+    std::string getResidencyInfo() const;
+
+    /** Returns the texture memory taken by a texture, mipmaps and ETC1 alpha texture included. */
+    static size_t getTextureBytes(Texture2D* texture);
+
 
 private:
+    // completion is called after callback, with no arguments, even when the callback was unbound
+    void queueImageAsync(const std::string& path, const std::function<void(Texture2D*)>& callback, const std::string& callbackKey,
+                         const std::function<void()>& completion);
     void addImageAsyncCallBack(float dt);
     void loadImage();
     void parseNinePatchImage(Image* image, Texture2D* texture, const std::string& path);
+    void touchTexture(const std::string& key);
 public:
 protected:
     struct AsyncStruct;
     
-    std::thread* _loadingThread;
+    std::vector<std::thread*> _loadingThreads;
 
     std::deque<AsyncStruct*> _asyncStructQueue;
     std::deque<AsyncStruct*> _requestQueue;
@@ -243,8 +309,22 @@ protected:
 
     int _asyncRefCount;
 
+    float _asyncUploadBudget;
+
     std::unordered_map<std::string, Texture2D*> _textures;
 
+    // Owner and last use of each cached texture, keyed like _textures.
+    struct Residency
+    {
+        std::string owner;
+        unsigned int lastUse;
+    };
+    std::unordered_map<std::string, Residency> _residency;
+    std::string _ownerTag;
+    std::unordered_set<std::string> _pinnedOwners;
+    size_t _memoryBudget;
+    unsigned int _useClock;
+
     static std::string s_etc1AlphaFileSuffix;
 };
 
@@ -0,0 +1,371 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "renderer/CCTextureFormatPolicy.h"
+
+#include <algorithm>
+#include <cctype>
+
+#include "platform/CCImage.h"
+#include "platform/CCFileUtils.h"
+#include "base/etc1.h"
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    // PVR v3 pixel format ids, see the table in CCImage.cpp
+    const uint64_t PVR3_ETC1     = 6ULL;
+    const uint64_t PVR3_RGBA8888 = 0x0808080861626772ULL;
+    const uint64_t PVR3_RGBA4444 = 0x0404040461626772ULL;
+    const uint64_t PVR3_RGBA5551 = 0x0105050561626772ULL;
+    const uint64_t PVR3_RGB565   = 0x0005060500626772ULL;
+    const uint64_t PVR3_RGB888   = 0x0008080800626772ULL;
+    const uint64_t PVR3_A8       = 0x0000000800000061ULL;
+    const uint64_t PVR3_L8       = 0x000000080000006cULL;
+    const uint64_t PVR3_LA88     = 0x000008080000616cULL;
+
+    const uint32_t PVR3_VERSION = 0x03525650;
+    const uint32_t PVR3_FLAG_PREMULTIPLIED = 1 << 1;
+    const size_t PVR3_HEADER_SIZE = 52;
+
+    struct FormatName
+    {
+        Texture2D::PixelFormat format;
+        const char* name;
+        uint64_t pvrFormat;
+    };
+
+    const FormatName s_formatNames[] = {
+        { Texture2D::PixelFormat::RGBA8888, "RGBA8888", PVR3_RGBA8888 },
+        { Texture2D::PixelFormat::RGB888,   "RGB888",   PVR3_RGB888 },
+        { Texture2D::PixelFormat::RGB565,   "RGB565",   PVR3_RGB565 },
+        { Texture2D::PixelFormat::RGBA4444, "RGBA4444", PVR3_RGBA4444 },
+        { Texture2D::PixelFormat::RGB5A1,   "RGB5A1",   PVR3_RGBA5551 },
+        { Texture2D::PixelFormat::A8,       "A8",       PVR3_A8 },
+        { Texture2D::PixelFormat::I8,       "I8",       PVR3_L8 },
+        { Texture2D::PixelFormat::AI88,     "AI88",     PVR3_LA88 },
+        { Texture2D::PixelFormat::ETC,      "ETC",      PVR3_ETC1 },
+    };
+
+    std::string toLower(std::string text)
+    {
+        std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+        return text;
+    }
+
+    std::string getExtension(const std::string& path)
+    {
+        auto slash = path.find_last_of('/');
+        auto dot = path.find_last_of('.');
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+            return "";
+        return toLower(path.substr(dot));
+    }
+
+    void writeLE(unsigned char*& out, uint64_t value, int bytes)
+    {
+        for (int i = 0; i < bytes; ++i)
+            *out++ = (unsigned char)(value >> (8 * i));
+    }
+}
+
+TextureFormatPolicy* TextureFormatPolicy::s_sharedPolicy = nullptr;
+
+TextureFormatPolicy* TextureFormatPolicy::getInstance()
+{
+    if (!s_sharedPolicy)
+    {
+        s_sharedPolicy = new (std::nothrow) TextureFormatPolicy();
+    }
+    return s_sharedPolicy;
+}
+
+void TextureFormatPolicy::destroyInstance()
+{
+    CC_SAFE_DELETE(s_sharedPolicy);
+}
+
+TextureFormatPolicy::TextureFormatPolicy()
+{
+}
+
+bool TextureFormatPolicy::loadManifest(const std::string& manifestFile)
+{
+    ValueMap manifest = FileUtils::getInstance()->getValueMapFromFile(manifestFile);
+    auto formats = manifest.find("formats");
+    if (formats == manifest.end() || formats->second.getType() != Value::Type::MAP)
+    {
+        CCLOG("cocos2d: TextureFormatPolicy: no formats in %s", manifestFile.c_str());
+        return false;
+    }
+
+    for (auto& rule : formats->second.asValueMap())
+    {
+        Texture2D::PixelFormat format = getPixelFormatForName(rule.second.asString());
+        if (format == Texture2D::PixelFormat::NONE)
+        {
+            CCLOG("cocos2d: TextureFormatPolicy: unknown format %s for %s", rule.second.asString().c_str(), rule.first.c_str());
+            continue;
+        }
+        setFormatForPattern(rule.first, format);
+    }
+    return true;
+}
+
+void TextureFormatPolicy::setFormatForPattern(const std::string& pattern, Texture2D::PixelFormat format)
+{
+    if (pattern.empty())
+        return;
+
+    if (pattern.compare(0, 2, "*.") == 0)
+        _extensionRules[toLower(pattern.substr(1))] = format;
+    else if (pattern.back() == '/')
+        _directoryRules[pattern] = format;
+    else
+        _fileRules[pattern] = format;
+}
+
+void TextureFormatPolicy::removeAllRules()
+{
+    _fileRules.clear();
+    _directoryRules.clear();
+    _extensionRules.clear();
+}
+
+std::string TextureFormatPolicy::getRelativePath(const std::string& fullPath) const
+{
+    size_t longest = 0;
+    for (const auto& searchPath : FileUtils::getInstance()->getSearchPaths())
+    {
+        if (searchPath.size() > longest && fullPath.compare(0, searchPath.size(), searchPath) == 0)
+            longest = searchPath.size();
+    }
+    return fullPath.substr(longest);
+}
+
+Texture2D::PixelFormat TextureFormatPolicy::getRuleFormat(const std::string& fullPath) const
+{
+    if (_fileRules.empty() && _directoryRules.empty() && _extensionRules.empty())
+        return Texture2D::PixelFormat::NONE;
+
+    std::string relativePath = getRelativePath(fullPath);
+
+    auto file = _fileRules.find(relativePath);
+    if (file != _fileRules.end())
+        return file->second;
+
+    // longest directory first
+    for (auto slash = relativePath.find_last_of('/'); slash != std::string::npos && !_directoryRules.empty();
+         slash = slash > 0 ? relativePath.find_last_of('/', slash - 1) : std::string::npos)
+    {
+        auto directory = _directoryRules.find(relativePath.substr(0, slash + 1));
+        if (directory != _directoryRules.end())
+            return directory->second;
+    }
+
+    auto extension = _extensionRules.find(getExtension(relativePath));
+    if (extension != _extensionRules.end())
+        return extension->second;
+
+    return Texture2D::PixelFormat::NONE;
+}
+
+Texture2D::PixelFormat TextureFormatPolicy::resolve(const std::string& fullPath, std::string* sourceFile) const
+{
+    *sourceFile = fullPath;
+
+    Texture2D::PixelFormat format = getRuleFormat(fullPath);
+    if (format == Texture2D::PixelFormat::NONE)
+        return Texture2D::getDefaultAlphaPixelFormat();
+
+    // the blob already holds the pixels in their final format
+    std::string blob = getTranscodedPath(fullPath);
+    if (FileUtils::getInstance()->isFileExist(blob))
+    {
+        *sourceFile = blob;
+        return Texture2D::PixelFormat::AUTO;
+    }
+
+    // ETC needs the offline encoder
+    return format == Texture2D::PixelFormat::ETC ? Texture2D::PixelFormat::RGB565 : format;
+}
+
+std::string TextureFormatPolicy::getTranscodedPath(const std::string& imageFile)
+{
+    return imageFile + ".pvr";
+}
+
+bool TextureFormatPolicy::transcode(const std::string& imageFile, Texture2D::PixelFormat format, const std::string& outputFile, size_t* outputBytes)
+{
+    Image image;
+    if (!image.initWithImageFile(imageFile))
+    {
+        CCLOG("cocos2d: TextureFormatPolicy: can't decode %s", imageFile.c_str());
+        return false;
+    }
+    if (image.isCompressed() || image.getNumberOfMipmaps() > 1)
+    {
+        CCLOG("cocos2d: TextureFormatPolicy: %s is already compressed", imageFile.c_str());
+        return false;
+    }
+
+    int width = image.getWidth();
+    int height = image.getHeight();
+    Texture2D::PixelFormat sourceFormat = image.getRenderFormat();
+
+    if (format == Texture2D::PixelFormat::ETC && (image.hasAlpha() || width % 4 != 0 || height % 4 != 0))
+    {
+        CCLOG("cocos2d: TextureFormatPolicy: %s has alpha or is not a multiple of 4, using RGB565 instead of ETC", imageFile.c_str());
+        format = Texture2D::PixelFormat::RGB565;
+    }
+
+    unsigned char* pixels = nullptr;
+    ssize_t pixelsLen = 0;
+    Data encoded;
+    if (format == Texture2D::PixelFormat::ETC)
+    {
+        Texture2D::convertDataToFormat(image.getData(), image.getDataLen(), sourceFormat, Texture2D::PixelFormat::RGB888, &pixels, &pixelsLen);
+
+        ssize_t encodedLen = etc1_get_encoded_data_size(width, height);
+        unsigned char* buffer = (unsigned char*)malloc(encodedLen);
+        if (etc1_encode_image(pixels, width, height, 3, width * 3, buffer) != 0)
+        {
+            free(buffer);
+            buffer = nullptr;
+        }
+        else
+        {
+            encoded.fastSet(buffer, encodedLen);
+        }
+    }
+    else
+    {
+        format = Texture2D::convertDataToFormat(image.getData(), image.getDataLen(), sourceFormat, format, &pixels, &pixelsLen);
+        encoded.copy(pixels, pixelsLen);
+    }
+    if (pixels != image.getData())
+    {
+        free(pixels);
+    }
+
+    const FormatName* formatName = nullptr;
+    for (const auto& entry : s_formatNames)
+    {
+        if (entry.format == format)
+            formatName = &entry;
+    }
+    if (encoded.isNull() || !formatName)
+    {
+        CCLOG("cocos2d: TextureFormatPolicy: can't convert %s to %s", imageFile.c_str(), getNameForPixelFormat(format));
+        return false;
+    }
+
+    Data blob;
+    ssize_t blobLen = PVR3_HEADER_SIZE + encoded.getSize();
+    unsigned char* bytes = (unsigned char*)malloc(blobLen);
+    unsigned char* out = bytes;
+    writeLE(out, PVR3_VERSION, 4);
+    writeLE(out, image.hasPremultipliedAlpha() ? PVR3_FLAG_PREMULTIPLIED : 0, 4);
+    writeLE(out, formatName->pvrFormat, 8);
+    writeLE(out, 0, 4);         // color space: linear
+    writeLE(out, 0, 4);         // channel type: unsigned byte normalized
+    writeLE(out, height, 4);
+    writeLE(out, width, 4);
+    writeLE(out, 1, 4);         // depth
+    writeLE(out, 1, 4);         // surfaces
+    writeLE(out, 1, 4);         // faces
+    writeLE(out, 1, 4);         // mipmaps
+    writeLE(out, 0, 4);         // metadata length
+    memcpy(out, encoded.getBytes(), encoded.getSize());
+    blob.fastSet(bytes, blobLen);
+
+    if (!FileUtils::getInstance()->writeDataToFile(blob, outputFile))
+    {
+        CCLOG("cocos2d: TextureFormatPolicy: can't write %s", outputFile.c_str());
+        return false;
+    }
+
+    CCLOG("cocos2d: TextureFormatPolicy: %s %d x %d %s => %lu KB",
+          outputFile.c_str(), width, height, formatName->name, (unsigned long)(encoded.getSize() / 1024));
+    if (outputBytes)
+        *outputBytes = encoded.getSize();
+    return true;
+}
+
+int TextureFormatPolicy::transcodeDirectory(const std::string& directory)
+{
+    std::vector<std::string> files;
+    FileUtils::getInstance()->listFilesRecursively(directory, &files);
+
+    int count = 0;
+    size_t totalBytes = 0;
+    bool failed = false;
+    for (const auto& file : files)
+    {
+        std::string extension = getExtension(file);
+        if (extension != ".png" && extension != ".jpg" && extension != ".jpeg")
+            continue;
+
+        Texture2D::PixelFormat format = getRuleFormat(file);
+        if (format == Texture2D::PixelFormat::NONE)
+            continue;
+
+        size_t bytes = 0;
+        if (transcode(file, format, getTranscodedPath(file), &bytes))
+        {
+            ++count;
+            totalBytes += bytes;
+        }
+        else
+        {
+            failed = true;
+        }
+    }
+
+    log("TextureFormatPolicy: transcoded %d images under %s, %.2f MB of pixels", count, directory.c_str(), totalBytes / (1024.0f * 1024.0f));
+    return failed ? -1 : count;
+}
+
+Texture2D::PixelFormat TextureFormatPolicy::getPixelFormatForName(const std::string& name)
+{
+    for (const auto& entry : s_formatNames)
+    {
+        if (name == entry.name)
+            return entry.format;
+    }
+    return Texture2D::PixelFormat::NONE;
+}
+
+const char* TextureFormatPolicy::getNameForPixelFormat(Texture2D::PixelFormat format)
+{
+    for (const auto& entry : s_formatNames)
+    {
+        if (entry.format == format)
+            return entry.name;
+    }
+    return "NONE";
+}
+
+NS_CC_END
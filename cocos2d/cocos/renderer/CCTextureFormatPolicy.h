@@ -0,0 +1,121 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef __CCTEXTURE_FORMAT_POLICY_H__
+#define __CCTEXTURE_FORMAT_POLICY_H__
+
+#include <string>
+#include <unordered_map>
+
+#include "renderer/CCTexture2D.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @class TextureFormatPolicy
+ * @brief Chooses the pixel format every image file is uploaded with.
+
+ The rules come from a manifest plist whose "formats" dictionary maps a pattern to a format name:
+ an exact file ("Menu/title.png"), a directory prefix ending with '/' ("Hp/") or an extension ("*.jpg").
+ An exact file wins over the longest matching directory, which wins over the extension.
+ Paths are matched relative to the search path they were found in.
+
+ Format names are RGBA8888, RGB888, RGB565, RGBA4444, RGB5A1, A8, I8, AI88 and ETC (ETC1, opaque only).
+
+ transcode() turns an image into a PVR v3 blob holding the pixels already in the target format
+ (premultiplied, as TextureCache would have uploaded them). The blob is written next to the image
+ with the ".pvr" suffix appended; when it exists TextureCache loads it instead of the image and
+ uploads it as is, skipping the PNG/JPEG decode and the conversion in Texture2D::initWithImage().
+ ETC blobs fall back to the software decoder when the GPU has no ETC1 support.
+ Without a blob the image is decoded and converted at load time; ETC then falls back to RGB565.
+ */
+class CC_DLL TextureFormatPolicy
+{
+public:
+    /** Returns the shared policy. It has no rules until a manifest is loaded. */
+    static TextureFormatPolicy* getInstance();
+    static void destroyInstance();
+
+    /** Adds the rules of a manifest plist. Later rules replace earlier ones with the same pattern. */
+    bool loadManifest(const std::string& manifestFile);
+
+    /** Adds a rule. @see TextureFormatPolicy */
+    void setFormatForPattern(const std::string& pattern, Texture2D::PixelFormat format);
+
+    /** Removes every rule. */
+    void removeAllRules();
+
+    /** Returns the format of the rule matching an image, or PixelFormat::NONE when no rule matches. */
+    Texture2D::PixelFormat getRuleFormat(const std::string& fullPath) const;
+
+    /** Picks the file and pixel format to load an image with.
+     *
+     * @param fullPath The full path of the image, the TextureCache key.
+     * @param sourceFile Receives the transcoded blob when it exists, otherwise fullPath.
+     * @return The format to pass to Texture2D::initWithImage(): AUTO for a blob, the rule format
+     * for a plain image, or the default alpha pixel format when no rule matches.
+     */
+    Texture2D::PixelFormat resolve(const std::string& fullPath, std::string* sourceFile) const;
+
+    /** Returns the path of the transcoded blob of an image. */
+    static std::string getTranscodedPath(const std::string& imageFile);
+
+    /** Decodes an image and writes it as a PVR v3 blob in the given format.
+     * ETC falls back to RGB565 for images with alpha or sizes that are not a multiple of 4.
+     *
+     * @param outputBytes Receives the size of the pixels in the blob, may be nullptr.
+     */
+    static bool transcode(const std::string& imageFile, Texture2D::PixelFormat format, const std::string& outputFile, size_t* outputBytes = nullptr);
+
+    /** Transcodes every image under a directory that matches a rule.
+     * The blobs are written next to the images.
+     *
+     * @return The number of images transcoded, or -1 when one of them failed.
+     */
+    int transcodeDirectory(const std::string& directory);
+
+    static Texture2D::PixelFormat getPixelFormatForName(const std::string& name);
+    static const char* getNameForPixelFormat(Texture2D::PixelFormat format);
+
+protected:
+    TextureFormatPolicy();
+
+    std::string getRelativePath(const std::string& fullPath) const;
+
+    std::unordered_map<std::string, Texture2D::PixelFormat> _fileRules;
+    std::unordered_map<std::string, Texture2D::PixelFormat> _directoryRules;
+    std::unordered_map<std::string, Texture2D::PixelFormat> _extensionRules;
+
+    static TextureFormatPolicy* s_sharedPolicy;
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif // __CCTEXTURE_FORMAT_POLICY_H__
@@ -23,6 +23,7 @@
  ****************************************************************************/
 
 #include "../Classes/AppDelegate.h"
+#include "../Classes/OfflineTools.h"
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -35,5 +36,13 @@ int main(int argc, char **argv)
 {
     // create the application instance
     AppDelegate app;
+
+    // offline steps (./HollowKnight --bake-fonts / --transcode-textures ...) run and exit without opening a window
+    int exitCode = 0;
+    if (OfflineTools::run(argc, argv, &exitCode))
+    {
+        return exitCode;
+    }
+
     return Application::getInstance()->run();
 }
@@ -1,7 +1,11 @@
 #include "main.h"
 #include "AppDelegate.h" 
+#include "OfflineTools.h"
 #include "cocos2d.h"  //cocos2d׼ͷļ
 
+#include <string>
+#include <vector>
+
 USING_NS_CC; //궨壬using namespace cocos2d;
 
 int WINAPI _tWinMain(HINSTANCE hInstance,        //Win32ںmainwinmainͼδʹ
@@ -14,5 +18,34 @@ int WINAPI _tWinMain(HINSTANCE hInstance,        //Win32
 
     // create the application instance  һӦóʵ
     AppDelegate app;  // AppDelegate˽м̳Application
+
+    // ߲裨HollowKnight.exe --bake-fonts / --transcode-textures ...ֱִ˳
+    // Unicode ֻпַ __wargvת UTF-8 ٽ OfflineTools
+    if (__argc > 1)
+    {
+        std::vector<std::string> args;
+        std::vector<char*> argv;
+        for (int i = 0; i < __argc; ++i)
+        {
+            int length = WideCharToMultiByte(CP_UTF8, 0, __wargv[i], -1, nullptr, 0, nullptr, nullptr);
+            std::string arg(length > 0 ? length - 1 : 0, '\0');
+            if (length > 1)
+            {
+                WideCharToMultiByte(CP_UTF8, 0, __wargv[i], -1, &arg[0], length, nullptr, nullptr);
+            }
+            args.push_back(arg);
+        }
+        for (auto& arg : args)
+        {
+            argv.push_back(&arg[0]);
+        }
+
+        int exitCode = 0;
+        if (OfflineTools::run((int)argv.size(), argv.data(), &exitCode))
+        {
+            return exitCode;
+        }
+    }
+
     return Application::getInstance()->run();  // ȼreturn ((Application*)&app)->run();
 }
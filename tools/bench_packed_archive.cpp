@@ -0,0 +1,119 @@
+/*
+ * PackedArchive（cocos2d/cocos/platform/CCPackedArchive.cpp）的查找开销基准。
+ *
+ * 直接编译引擎里的 CCPackedArchive.cpp（连同 CCData.cpp、xxhash.c），打开 tools/pack_resources.py 生成的资源包，
+ * 对包里每个文件名各查一次 fileExists()，循环多轮取中位数；再用同样数量的不在包里的名字测未命中。
+ * 内容的逐字节校验见 pack_resources.py --verify。
+ *
+ * 用法（Linux，在仓库根目录；引擎头文件会带进 GL/glew.h，需要 Linux 版构建用的 GLEW 开发包）：
+ *     python3 tools/pack_resources.py Resources /tmp/res.pak
+ *     g++ -O2 -std=c++11 -DLINUX -Icocos2d -Icocos2d/cocos -Icocos2d/external/xxhash \
+ *         tools/bench_packed_archive.cpp cocos2d/cocos/platform/CCPackedArchive.cpp cocos2d/cocos/base/CCData.cpp \
+ *         -x c cocos2d/external/xxhash/xxhash.c -o bench_packed_archive
+ *     ./bench_packed_archive /tmp/res.pak Resources
+ */
+
+#include "platform/CCPackedArchive.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <dirent.h>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+// CCLOG 需要的 cocos2d::log，基准里直接打到 stderr
+namespace cocos2d {
+void log(const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+}
+
+// 和 pack_resources.py 一样收集相对路径（'/' 分隔，跳过 .pak）
+static void collect(const std::string& root, const std::string& relative, std::vector<std::string>* names)
+{
+    DIR* dir = opendir((root + "/" + relative).c_str());
+    if (dir == nullptr)
+        return;
+    while (dirent* entry = readdir(dir))
+    {
+        std::string name = entry->d_name;
+        if (name == "." || name == "..")
+            continue;
+        std::string path = relative.empty() ? name : relative + "/" + name;
+        struct stat info;
+        if (stat((root + "/" + path).c_str(), &info) != 0)
+            continue;
+        if (S_ISDIR(info.st_mode))
+            collect(root, path, names);
+        else if (name.size() < 4 || name.compare(name.size() - 4, 4, ".pak") != 0)
+            names->push_back(path);
+    }
+    closedir(dir);
+}
+
+// 每轮把所有名字查一遍，返回每次查找的纳秒数（中位数）和命中个数
+static double timeLookups(const cocos2d::PackedArchive& archive, const std::vector<std::string>& names, int rounds, size_t* hits)
+{
+    std::vector<double> samples;
+    size_t found = 0;
+    for (int r = 0; r < rounds; ++r)
+    {
+        found = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& name : names)
+            found += archive.fileExists(name) ? 1 : 0;
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::nano>(end - start).count() / names.size());
+    }
+    std::sort(samples.begin(), samples.end());
+    *hits = found;
+    return samples[samples.size() / 2];
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: %s <archive> <resource dir>\n", argv[0]);
+        return 2;
+    }
+
+    cocos2d::PackedArchive archive;
+    if (!archive.open(argv[1]))
+    {
+        fprintf(stderr, "can't open %s\n", argv[1]);
+        return 1;
+    }
+
+    std::vector<std::string> names;
+    collect(argv[2], "", &names);
+    if (names.empty())
+    {
+        fprintf(stderr, "no files under %s\n", argv[2]);
+        return 1;
+    }
+    std::vector<std::string> missing;
+    for (const auto& name : names)
+        missing.push_back(name + ".missing");
+
+    const int rounds = 2000;
+    size_t hits = 0;
+    size_t falseHits = 0;
+    timeLookups(archive, names, 50, &hits);
+    double hitTime = timeLookups(archive, names, rounds, &hits);
+    double missTime = timeLookups(archive, missing, rounds, &falseHits);
+
+    printf("%s: %u files mapped, %zu names under %s\n", argv[1], archive.getFileCount(), names.size(), argv[2]);
+    printf("  existing names  %6.1f ns per lookup, %zu found\n", hitTime, hits);
+    printf("  missing names   %6.1f ns per lookup, %zu found\n", missTime, falseHits);
+
+    return (hits == names.size() && falseHits == 0) ? 0 : 1;
+}
@@ -0,0 +1,187 @@
+/*
+ * RenderQueue::sort 对 globalZ 分组的排序开销基准。
+ *
+ * 对比三种情况：
+ *   stable_sort  原来的写法，每帧都 std::stable_sort
+ *   radix        CCRenderer.cpp 的 sortByGlobalOrder：乱序时 >= 256 条命令走 8 位 LSD 基数排序
+ *   unchanged    顺序和上一帧相同时，sortByGlobalOrder 只做一次 std::is_sorted
+ * 每轮排序前把命令打乱成同一个顺序，先比较两种排序的结果（必须逐个相同，即保持稳定），再计时。
+ *
+ * 这里的排序函数是 CCRenderer.cpp 的副本（RenderCommand 换成只有 globalOrder 的结构），
+ * 修改那边时同步修改这里。
+ *
+ * 用法：
+ *     g++ -O2 -std=c++11 tools/bench_render_queue_sort.cpp -o bench_render_queue_sort
+ *     ./bench_render_queue_sort [命令数量] [不同 z 值的数量]     # 默认 5000 64
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+struct RenderCommand
+{
+    float globalOrder;
+    int id;
+    float getGlobalOrder() const { return globalOrder; }
+};
+
+// ---- CCRenderer.cpp 的副本 ----
+static bool compareRenderCommand(RenderCommand* a, RenderCommand* b)
+{
+    return a->getGlobalOrder() < b->getGlobalOrder();
+}
+
+static const size_t RADIX_SORT_THRESHOLD = 256;
+
+static inline uint32_t globalOrderKey(float z)
+{
+    uint32_t bits;
+    memcpy(&bits, &z, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+static void radixSortByGlobalOrder(std::vector<RenderCommand*>& commands)
+{
+    static std::vector<RenderCommand*> s_commandScratch;
+    static std::vector<uint32_t> s_keys;
+    static std::vector<uint32_t> s_keyScratch;
+
+    const size_t count = commands.size();
+    s_commandScratch.resize(count);
+    s_keys.resize(count);
+    s_keyScratch.resize(count);
+
+    size_t histogram[4][256] = {};
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t key = globalOrderKey(commands[i]->getGlobalOrder());
+        s_keys[i] = key;
+        ++histogram[0][key & 0xff];
+        ++histogram[1][(key >> 8) & 0xff];
+        ++histogram[2][(key >> 16) & 0xff];
+        ++histogram[3][key >> 24];
+    }
+
+    RenderCommand** src = commands.data();
+    RenderCommand** dst = s_commandScratch.data();
+    uint32_t* srcKeys = s_keys.data();
+    uint32_t* dstKeys = s_keyScratch.data();
+    for (int pass = 0; pass < 4; ++pass)
+    {
+        const int shift = pass * 8;
+        size_t* bucket = histogram[pass];
+        if (bucket[(srcKeys[0] >> shift) & 0xff] == count)
+            continue;
+
+        size_t offset = 0;
+        for (int b = 0; b < 256; ++b)
+        {
+            size_t n = bucket[b];
+            bucket[b] = offset;
+            offset += n;
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            size_t to = bucket[(srcKeys[i] >> shift) & 0xff]++;
+            dst[to] = src[i];
+            dstKeys[to] = srcKeys[i];
+        }
+        std::swap(src, dst);
+        std::swap(srcKeys, dstKeys);
+    }
+
+    if (src != commands.data())
+    {
+        memcpy(commands.data(), src, count * sizeof(RenderCommand*));
+    }
+}
+
+static void sortByGlobalOrder(std::vector<RenderCommand*>& commands)
+{
+    if (std::is_sorted(commands.begin(), commands.end(), compareRenderCommand))
+        return;
+
+    if (commands.size() < RADIX_SORT_THRESHOLD)
+        std::stable_sort(commands.begin(), commands.end(), compareRenderCommand);
+    else
+        radixSortByGlobalOrder(commands);
+}
+// ---- 副本结束 ----
+
+static void stableSort(std::vector<RenderCommand*>& commands)
+{
+    std::stable_sort(commands.begin(), commands.end(), compareRenderCommand);
+}
+
+typedef void (*SortFunc)(std::vector<RenderCommand*>&);
+
+// 每轮先恢复成 input 的顺序（不计时）再排序，返回排序耗时的中位数（微秒）
+static double timeSort(SortFunc sort, const std::vector<RenderCommand*>& input, int rounds)
+{
+    std::vector<RenderCommand*> commands;
+    std::vector<double> samples;
+    for (int r = 0; r < rounds; ++r)
+    {
+        commands = input;
+        auto start = std::chrono::steady_clock::now();
+        sort(commands);
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+int main(int argc, char** argv)
+{
+    size_t count = argc > 1 ? (size_t)atoi(argv[1]) : 5000;
+    int distinctZ = argc > 2 ? atoi(argv[2]) : 64;
+    count = std::max<size_t>(count, 1);
+    distinctZ = std::max(distinctZ, 1);
+
+    // 负 globalZ 组和正 globalZ 组各测一次；z 值成组出现，和场景里一层层节点的情况相近
+    int failures = 0;
+    for (float sign : { -1.0f, 1.0f })
+    {
+        std::mt19937 rng(2024);
+        std::uniform_int_distribution<int> pickZ(1, distinctZ);
+        std::vector<RenderCommand> storage(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            storage[i].globalOrder = sign * (pickZ(rng) * 0.5f);
+            storage[i].id = (int)i;
+        }
+        std::vector<RenderCommand*> input(count);
+        for (size_t i = 0; i < count; ++i)
+            input[i] = &storage[i];
+
+        std::vector<RenderCommand*> expected = input;
+        stableSort(expected);
+        std::vector<RenderCommand*> actual = input;
+        sortByGlobalOrder(actual);
+        bool same = expected == actual;
+        if (!same)
+            ++failures;
+
+        const int rounds = 500;
+        timeSort(stableSort, input, 20);
+        timeSort(sortByGlobalOrder, input, 20);
+        double stableTime = timeSort(stableSort, input, rounds);
+        double radixTime = timeSort(sortByGlobalOrder, input, rounds);
+        double unchangedStable = timeSort(stableSort, expected, rounds);
+        double unchangedTime = timeSort(sortByGlobalOrder, expected, rounds);
+
+        printf("%s globalZ, %zu commands, %d distinct z: result %s stable_sort\n",
+               sign < 0 ? "negative" : "positive", count, distinctZ, same ? "matches" : "DIFFERS FROM");
+        printf("  shuffled   stable_sort %8.1f us   sortByGlobalOrder %8.1f us\n", stableTime, radixTime);
+        printf("  unchanged  stable_sort %8.1f us   sortByGlobalOrder %8.1f us\n", unchangedStable, unchangedTime);
+    }
+
+    return failures == 0 ? 0 : 1;
+}
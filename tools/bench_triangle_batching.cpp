@@ -0,0 +1,266 @@
+/*
+ * Renderer::fillVerticesAndIndices 的每个四边形开销基准（顶点变换 + 索引重定位）。
+ *
+ * 对比两种实现：
+ *   scalar  原来的写法：每个顶点调一次 Mat4::transformPoint（非内联），索引逐个加偏移
+ *   simd    CCRenderer.cpp 里的 transformVertexPositions / rebaseIndices（SSE2 或 NEON）
+ * 两者先对同一批数据各跑一遍，结果逐个比较，再分别计时。
+ *
+ * 这里的 SIMD 函数是 CCRenderer.cpp 的副本，修改那边时同步修改这里。
+ *
+ * 用法：
+ *     g++ -O2 -std=c++11 tools/bench_triangle_batching.cpp -o bench_triangle_batching
+ *     ./bench_triangle_batching [四边形数量]          # 默认 2000
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CC_RENDERER_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CC_RENDERER_NEON 1
+#endif
+
+#if defined(_MSC_VER)
+#define BENCH_NOINLINE __declspec(noinline)
+#else
+#define BENCH_NOINLINE __attribute__((noinline))
+#endif
+
+// 与 cocos2d::V3F_C4B_T2F 布局相同，24 字节
+struct Vec3 { float x, y, z; };
+struct Vertex
+{
+    Vec3 vertices;
+    uint8_t colors[4];
+    float u, v;
+};
+struct Mat4 { float m[16]; };
+
+struct Command
+{
+    Mat4 modelView;
+    Vertex verts[4];
+    unsigned short indices[6];
+};
+
+// Mat4::transformPoint -> Mat4::transformVector -> MathUtil::transformVec4，在 Mat4.cpp 里，不会被内联
+BENCH_NOINLINE static void transformPoint(const Mat4& mat, Vec3* p)
+{
+    const float* m = mat.m;
+    float x = p->x, y = p->y, z = p->z;
+    p->x = x * m[0] + y * m[4] + z * m[8] + m[12];
+    p->y = x * m[1] + y * m[5] + z * m[9] + m[13];
+    p->z = x * m[2] + y * m[6] + z * m[10] + m[14];
+}
+
+static void transformScalar(const Mat4& modelView, Vertex* verts, std::ptrdiff_t count)
+{
+    for (std::ptrdiff_t i = 0; i < count; ++i)
+        transformPoint(modelView, &verts[i].vertices);
+}
+
+static void rebaseScalar(unsigned short* dst, const unsigned short* src, std::ptrdiff_t count, unsigned short offset)
+{
+    for (std::ptrdiff_t i = 0; i < count; ++i)
+        dst[i] = offset + src[i];
+}
+
+// ---- CCRenderer.cpp 的副本 ----
+static void transformVertexPositions(const Mat4& modelView, Vertex* verts, std::ptrdiff_t count)
+{
+    const float* m = modelView.m;
+#if CC_RENDERER_SSE2
+    const __m128 col0 = _mm_loadu_ps(m);
+    const __m128 col1 = _mm_loadu_ps(m + 4);
+    const __m128 col2 = _mm_loadu_ps(m + 8);
+    const __m128 col3 = _mm_loadu_ps(m + 12);
+    for (std::ptrdiff_t i = 0; i < count; ++i)
+    {
+        Vec3& p = verts[i].vertices;
+        __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(col0, _mm_set1_ps(p.x)), _mm_mul_ps(col1, _mm_set1_ps(p.y))),
+                              _mm_add_ps(_mm_mul_ps(col2, _mm_set1_ps(p.z)), col3));
+        _mm_storel_pi(reinterpret_cast<__m64*>(&p.x), r);
+        _mm_store_ss(&p.z, _mm_movehl_ps(r, r));
+    }
+#elif CC_RENDERER_NEON
+    const float32x4_t col0 = vld1q_f32(m);
+    const float32x4_t col1 = vld1q_f32(m + 4);
+    const float32x4_t col2 = vld1q_f32(m + 8);
+    const float32x4_t col3 = vld1q_f32(m + 12);
+    for (std::ptrdiff_t i = 0; i < count; ++i)
+    {
+        Vec3& p = verts[i].vertices;
+        float32x4_t r = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(col3, col0, p.x), col1, p.y), col2, p.z);
+        vst1_f32(&p.x, vget_low_f32(r));
+        vst1q_lane_f32(&p.z, r, 2);
+    }
+#else
+    transformScalar(modelView, verts, count);
+#endif
+}
+
+static void rebaseIndices(unsigned short* dst, const unsigned short* src, std::ptrdiff_t count, unsigned short offset)
+{
+    std::ptrdiff_t i = 0;
+#if CC_RENDERER_SSE2
+    const __m128i step = _mm_set1_epi16((short)offset);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_add_epi16(v, step));
+    }
+#elif CC_RENDERER_NEON
+    const uint16x8_t step = vdupq_n_u16(offset);
+    for (; i + 8 <= count; i += 8)
+    {
+        vst1q_u16(dst + i, vaddq_u16(vld1q_u16(src + i), step));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        dst[i] = offset + src[i];
+    }
+}
+// ---- 副本结束 ----
+
+typedef void (*TransformFunc)(const Mat4&, Vertex*, std::ptrdiff_t);
+typedef void (*RebaseFunc)(unsigned short*, const unsigned short*, std::ptrdiff_t, unsigned short);
+
+static void noTransform(const Mat4&, Vertex*, std::ptrdiff_t) {}
+static void noRebase(unsigned short*, const unsigned short*, std::ptrdiff_t, unsigned short) {}
+
+// 模拟一次 drawBatchedTriangles 的填充阶段；函数作为模板参数传入，和引擎里一样是直接调用
+template <TransformFunc transform, RebaseFunc rebase>
+static void fill(const std::vector<Command>& commands, Vertex* verts, unsigned short* indices)
+{
+    size_t filledVertex = 0;
+    size_t filledIndex = 0;
+    for (const auto& cmd : commands)
+    {
+        memcpy(&verts[filledVertex], cmd.verts, sizeof(cmd.verts));
+        transform(cmd.modelView, &verts[filledVertex], 4);
+        rebase(&indices[filledIndex], cmd.indices, 6, (unsigned short)filledVertex);
+        filledVertex += 4;
+        filledIndex += 6;
+    }
+}
+
+// 每轮的耗时取中位数，返回每个四边形的纳秒数
+template <TransformFunc transform, RebaseFunc rebase>
+static double timeFill(const std::vector<Command>& commands, Vertex* verts, unsigned short* indices, int rounds)
+{
+    std::vector<double> samples;
+    for (int r = 0; r < rounds; ++r)
+    {
+        auto start = std::chrono::steady_clock::now();
+        fill<transform, rebase>(commands, verts, indices);
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2] / commands.size();
+}
+
+int main(int argc, char** argv)
+{
+    size_t quadCount = argc > 1 ? (size_t)atoi(argv[1]) : 2000;
+    // 16 位索引，一批最多 65536 个顶点
+    quadCount = std::max<size_t>(1, std::min<size_t>(quadCount, 16384));
+
+    // 2D 精灵：z 为 0，矩阵是平移 + 旋转 + 缩放
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<float> coord(-512.0f, 512.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+    std::uniform_real_distribution<float> scale(0.25f, 4.0f);
+    std::vector<Command> commands(quadCount);
+    for (auto& cmd : commands)
+    {
+        float a = angle(rng), sx = scale(rng), sy = scale(rng);
+        float* m = cmd.modelView.m;
+        memset(m, 0, sizeof(cmd.modelView.m));
+        m[0] = std::cos(a) * sx;  m[1] = std::sin(a) * sx;
+        m[4] = -std::sin(a) * sy; m[5] = std::cos(a) * sy;
+        m[10] = 1.0f;
+        m[12] = coord(rng); m[13] = coord(rng); m[15] = 1.0f;
+        float w = std::fabs(coord(rng)) * 0.25f, h = std::fabs(coord(rng)) * 0.25f;
+        const float xs[4] = { 0, 0, w, w };
+        const float ys[4] = { h, 0, h, 0 };
+        for (int i = 0; i < 4; ++i)
+        {
+            cmd.verts[i].vertices = { xs[i], ys[i], 0.0f };
+            memset(cmd.verts[i].colors, 0xff, 4);
+            cmd.verts[i].u = xs[i] / (w + 1.0f);
+            cmd.verts[i].v = ys[i] / (h + 1.0f);
+        }
+        const unsigned short quadIndices[6] = { 0, 1, 2, 3, 2, 1 };
+        memcpy(cmd.indices, quadIndices, sizeof(quadIndices));
+    }
+
+    std::vector<Vertex> scalarVerts(quadCount * 4), simdVerts(quadCount * 4);
+    std::vector<unsigned short> scalarIndices(quadCount * 6), simdIndices(quadCount * 6);
+
+    // 先比较结果：位置按位比较，颜色和纹理坐标必须没被改写
+    fill<transformScalar, rebaseScalar>(commands, scalarVerts.data(), scalarIndices.data());
+    fill<transformVertexPositions, rebaseIndices>(commands, simdVerts.data(), simdIndices.data());
+    size_t mismatches = 0;
+    float maxDiff = 0.0f;
+    for (size_t i = 0; i < scalarVerts.size(); ++i)
+    {
+        if (memcmp(&scalarVerts[i], &simdVerts[i], sizeof(Vertex)) != 0)
+        {
+            ++mismatches;
+            maxDiff = std::max(maxDiff, std::fabs(scalarVerts[i].vertices.x - simdVerts[i].vertices.x));
+            maxDiff = std::max(maxDiff, std::fabs(scalarVerts[i].vertices.y - simdVerts[i].vertices.y));
+            maxDiff = std::max(maxDiff, std::fabs(scalarVerts[i].vertices.z - simdVerts[i].vertices.z));
+        }
+    }
+    bool indicesMatch = scalarIndices == simdIndices;
+
+#if CC_RENDERER_SSE2
+    const char* path = "SSE2";
+#elif CC_RENDERER_NEON
+    const char* path = "NEON";
+#else
+    const char* path = "scalar (no SIMD on this target)";
+#endif
+    printf("%zu quads, SIMD path: %s\n", quadCount, path);
+    printf("vertices: %zu of %zu differ (max |diff| %g), indices %s\n",
+           mismatches, scalarVerts.size(), maxDiff, indicesMatch ? "identical" : "DIFFER");
+
+    const int rounds = 1000;
+    Vertex* sv = scalarVerts.data();
+    Vertex* dv = simdVerts.data();
+    unsigned short* si = scalarIndices.data();
+    unsigned short* di = simdIndices.data();
+    // 预热
+    timeFill<transformScalar, rebaseScalar>(commands, sv, si, 50);
+    timeFill<transformVertexPositions, rebaseIndices>(commands, dv, di, 50);
+
+    // 拷贝本身的开销单独测，变换和重定位的时间相对于它来看
+    double copyOnly = timeFill<noTransform, noRebase>(commands, sv, si, rounds);
+    double scalarFill = timeFill<transformScalar, rebaseScalar>(commands, sv, si, rounds);
+    double simdFill = timeFill<transformVertexPositions, rebaseIndices>(commands, dv, di, rounds);
+    double scalarTransform = timeFill<transformScalar, noRebase>(commands, sv, si, rounds);
+    double simdTransform = timeFill<transformVertexPositions, noRebase>(commands, dv, di, rounds);
+    double scalarRebase = timeFill<noTransform, rebaseScalar>(commands, sv, si, rounds);
+    double simdRebase = timeFill<noTransform, rebaseIndices>(commands, dv, di, rounds);
+
+    printf("per quad, median of %d rounds (vertex copy alone: %.2f ns):\n", rounds, copyOnly);
+    printf("  copy + transform + rebase   scalar %6.2f ns   simd %6.2f ns\n", scalarFill, simdFill);
+    printf("  copy + transform            scalar %6.2f ns   simd %6.2f ns\n", scalarTransform, simdTransform);
+    printf("  copy + rebase               scalar %6.2f ns   simd %6.2f ns\n", scalarRebase, simdRebase);
+
+    return (mismatches == 0 && indicesMatch) ? 0 : 1;
+}
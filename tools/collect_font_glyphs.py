@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+收集游戏实际用到的字形，生成 SDF 字体烘焙用的字符表。
+
+扫描 Classes 下所有源码里的字符串字面量（跳过注释），取出其中的非 ASCII 字符，
+写入 Resources/fonts/NotoSerifCJKsc-glyphs.txt（UTF-8，一行）。ASCII 可打印字符
+由烘焙程序自动补全，这里不用写。
+
+用法：
+    python3 tools/collect_font_glyphs.py
+    cmake --build <构建目录> --target bake_fonts   # 生成 .fnt/.png，字体见 tools/fetch_cjk_font.py
+    HollowKnight.exe --bake-fonts <输出目录>        # Win32 工程里同样可用
+"""
+
+import io
+import os
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SOURCE_DIR = os.path.join(ROOT, "Classes")
+OUTPUT = os.path.join(ROOT, "Resources", "fonts", "NotoSerifCJKsc-glyphs.txt")
+
+
+def read_source(path):
+    raw = open(path, "rb").read()
+    if raw.startswith(b"\xef\xbb\xbf"):
+        return raw[3:].decode("utf-8")
+    try:
+        return raw.decode("utf-8")
+    except UnicodeDecodeError:
+        # 项目里一部分源文件是 GBK 编码
+        return raw.decode("gbk", errors="replace")
+
+
+def string_literals(text):
+    """逐字符扫描，返回所有字符串字面量的内容，注释和字符常量会被跳过。"""
+    i, n = 0, len(text)
+    while i < n:
+        c = text[i]
+        if text.startswith("//", i):
+            i = text.find("\n", i)
+            if i < 0:
+                return
+        elif text.startswith("/*", i):
+            i = text.find("*/", i + 2)
+            if i < 0:
+                return
+            i += 2
+        elif c == "'":
+            i += 1
+            while i < n and text[i] != "'":
+                i += 2 if text[i] == "\\" else 1
+            i += 1
+        elif c == '"':
+            i += 1
+            start = i
+            while i < n and text[i] != '"':
+                i += 2 if text[i] == "\\" else 1
+            yield text[start:i]
+            i += 1
+        else:
+            i += 1
+
+
+def main():
+    glyphs = set()
+    for folder, _, files in os.walk(SOURCE_DIR):
+        for name in files:
+            if not name.endswith((".cpp", ".h")):
+                continue
+            for literal in string_literals(read_source(os.path.join(folder, name))):
+                glyphs.update(ch for ch in literal if ord(ch) > 0x7e and ch != "\ufffd")
+
+    with io.open(OUTPUT, "w", encoding="utf-8", newline="\n") as f:
+        f.write("".join(sorted(glyphs)))
+        f.write("\n")
+    print("%d glyphs -> %s" % (len(glyphs), os.path.relpath(OUTPUT, ROOT)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
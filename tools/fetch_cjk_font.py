@@ -0,0 +1,57 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+取得游戏中文标签用的字体 Resources/fonts/NotoSerifCJKsc-Regular.otf（思源宋体简体，SIL OFL 授权）。
+
+字体文件约 24 MB，没有放进仓库。缺少它时 GameFonts 退回系统字体，也无法烘焙 SDF 图集。
+默认从 Noto CJK 官方仓库下载；也可以指定一个本地已有的 OTF 文件复制过去。
+
+完整流程：
+    python3 tools/fetch_cjk_font.py                   # 下载字体
+    python3 tools/fetch_cjk_font.py <本地 OTF 文件>    # 或者复制本地字体
+    python3 tools/collect_font_glyphs.py              # 更新字符表
+    cmake --build <构建目录> --target bake_fonts       # 烘焙 .fnt/.png 到 Resources/fonts，随资源一起拷贝
+"""
+
+import os
+import shutil
+import sys
+import urllib.request
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+OUTPUT = os.path.join(ROOT, "Resources", "fonts", "NotoSerifCJKsc-Regular.otf")
+URL = "https://github.com/notofonts/noto-cjk/raw/main/Serif/OTF/SimplifiedChinese/NotoSerifCJKsc-Regular.otf"
+
+
+def is_otf(path):
+    with open(path, "rb") as f:
+        return f.read(4) == b"OTTO"
+
+
+def main(argv):
+    if len(argv) > 1:
+        source = argv[1]
+        if not is_otf(source):
+            print("%s is not an OpenType CFF font" % source)
+            return 1
+        shutil.copyfile(source, OUTPUT)
+    elif os.path.exists(OUTPUT) and is_otf(OUTPUT):
+        print("%s already exists" % os.path.relpath(OUTPUT, ROOT))
+        return 0
+    else:
+        print("downloading %s" % URL)
+        temp = OUTPUT + ".part"
+        with urllib.request.urlopen(URL) as response, open(temp, "wb") as f:
+            shutil.copyfileobj(response, f)
+        if not is_otf(temp):
+            os.remove(temp)
+            print("the download is not an OpenType font")
+            return 1
+        os.replace(temp, OUTPUT)
+
+    print("%s, %.1f MB" % (os.path.relpath(OUTPUT, ROOT), os.path.getsize(OUTPUT) / (1024.0 * 1024.0)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,245 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+把 Resources/ 打成一个资源包（res.pak），运行时由 FileUtils::addResourceArchive() 映射到内存。
+
+格式见 cocos2d/cocos/platform/CCPackedArchive.h：文件头、完美哈希的桶位移表、按槽位排列的
+条目表、路径名、16 字节对齐的文件内容。路径相对于 Resources/，用 '/' 分隔。
+
+用法：
+    python3 tools/pack_resources.py                       # Resources/ -> Resources/res.pak
+    python3 tools/pack_resources.py <资源目录> <输出文件>
+    python3 tools/pack_resources.py --verify [资源目录] [资源包]
+        # 按运行时的查找方式（PackedArchive::findEntry）逐个查出资源目录里的文件，和磁盘上的内容逐字节比较，
+        # 并确认不在包里的名字查不到
+"""
+
+import os
+import struct
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+MAGIC = b"CCPK"
+VERSION = 1
+ALIGNMENT = 16
+# 每个桶平均放的文件数，越大索引越小、构建越慢
+KEYS_PER_BUCKET = 2
+BUCKET_SEED = 0x4b48  # "HK"
+
+# 与 cocos2d/external/xxhash 的 XXH32 一致
+_P1, _P2, _P3, _P4, _P5 = 2654435761, 2246822519, 3266489917, 668265263, 374761393
+_MASK = 0xffffffff
+
+
+def _rotl(x, r):
+    return ((x << r) | (x >> (32 - r))) & _MASK
+
+
+def xxh32(data, seed):
+    length = len(data)
+    i = 0
+    if length >= 16:
+        v1 = (seed + _P1 + _P2) & _MASK
+        v2 = (seed + _P2) & _MASK
+        v3 = seed & _MASK
+        v4 = (seed - _P1) & _MASK
+        limit = length - 16
+        while i <= limit:
+            a, b, c, d = struct.unpack_from("<4I", data, i)
+            v1 = (_rotl((v1 + a * _P2) & _MASK, 13) * _P1) & _MASK
+            v2 = (_rotl((v2 + b * _P2) & _MASK, 13) * _P1) & _MASK
+            v3 = (_rotl((v3 + c * _P2) & _MASK, 13) * _P1) & _MASK
+            v4 = (_rotl((v4 + d * _P2) & _MASK, 13) * _P1) & _MASK
+            i += 16
+        h = (_rotl(v1, 1) + _rotl(v2, 7) + _rotl(v3, 12) + _rotl(v4, 18)) & _MASK
+    else:
+        h = (seed + _P5) & _MASK
+    h = (h + length) & _MASK
+    while i + 4 <= length:
+        h = (h + struct.unpack_from("<I", data, i)[0] * _P3) & _MASK
+        h = (_rotl(h, 17) * _P4) & _MASK
+        i += 4
+    while i < length:
+        h = (h + data[i] * _P5) & _MASK
+        h = (_rotl(h, 11) * _P1) & _MASK
+        i += 1
+    h ^= h >> 15
+    h = (h * _P2) & _MASK
+    h ^= h >> 13
+    h = (h * _P3) & _MASK
+    h ^= h >> 16
+    return h
+
+
+def build_perfect_hash(names):
+    """哈希加位移：先按桶分组，大桶先放；多名字的桶找一个让它们落在空槽上的种子，
+    单名字的桶直接记录槽位（存成 -slot-1）。返回 (位移表, 每个名字的槽位)。"""
+    count = len(names)
+    bucket_count = max(1, (count + KEYS_PER_BUCKET - 1) // KEYS_PER_BUCKET)
+    buckets = [[] for _ in range(bucket_count)]
+    for index, name in enumerate(names):
+        buckets[xxh32(name, BUCKET_SEED) % bucket_count].append(index)
+
+    displacements = [0] * bucket_count
+    slots = [None] * count
+    taken = [False] * count
+    order = sorted(range(bucket_count), key=lambda b: len(buckets[b]), reverse=True)
+
+    for bucket in order:
+        members = buckets[bucket]
+        if len(members) <= 1:
+            break
+        seed = 0
+        while True:
+            candidate = [xxh32(names[i], seed) % count for i in members]
+            if len(set(candidate)) == len(candidate) and not any(taken[s] for s in candidate):
+                break
+            seed += 1
+            if seed > 0x7fffffff:
+                raise RuntimeError("no displacement found")
+        displacements[bucket] = seed
+        for i, s in zip(members, candidate):
+            slots[i] = s
+            taken[s] = True
+
+    free = (s for s in range(count) if not taken[s])
+    for bucket in order:
+        members = buckets[bucket]
+        if len(members) != 1:
+            continue
+        s = next(free)
+        displacements[bucket] = -s - 1
+        slots[members[0]] = s
+        taken[s] = True
+    return displacements, slots
+
+
+def collect(resource_dir, output):
+    files = []
+    for folder, dirs, names in os.walk(resource_dir):
+        dirs.sort()
+        for name in sorted(names):
+            path = os.path.join(folder, name)
+            if os.path.abspath(path) == os.path.abspath(output) or name.endswith(".pak"):
+                continue
+            relative = os.path.relpath(path, resource_dir).replace(os.sep, "/")
+            files.append((relative.encode("utf-8"), path))
+    return files
+
+
+def pack(resource_dir, output):
+    files = collect(resource_dir, output)
+    names = [name for name, _ in files]
+    displacements, slots = build_perfect_hash(names)
+
+    count = len(files)
+    bucket_count = len(displacements)
+    names_blob = b"".join(names)
+    header_size = 24
+    displacement_size = (bucket_count * 4 + 7) & ~7
+    entries_offset = header_size + displacement_size
+    names_offset = entries_offset + count * 24
+    data_offset = (names_offset + len(names_blob) + ALIGNMENT - 1) & ~(ALIGNMENT - 1)
+
+    entries = [None] * count
+    name_offset = 0
+    offset = data_offset
+    for (name, path), slot in zip(files, slots):
+        size = os.path.getsize(path)
+        entries[slot] = (name_offset, len(name), offset, size)
+        name_offset += len(name)
+        offset = (offset + size + ALIGNMENT - 1) & ~(ALIGNMENT - 1)
+
+    with open(output, "wb") as out:
+        out.write(struct.pack("<4s5I", MAGIC, VERSION, count, bucket_count, BUCKET_SEED, len(names_blob)))
+        out.write(struct.pack("<%di" % bucket_count, *displacements))
+        out.write(b"\0" * (displacement_size - bucket_count * 4))
+        for entry in entries:
+            out.write(struct.pack("<IIQQ", *entry))
+        out.write(names_blob)
+        for (name, path), slot in zip(files, slots):
+            out.write(b"\0" * (entries[slot][2] - out.tell()))
+            with open(path, "rb") as f:
+                out.write(f.read())
+
+    print("%d files, %.1f MB -> %s" % (count, offset / 1048576.0, os.path.relpath(output)))
+
+
+class Archive(object):
+    """按 CCPackedArchive.cpp 的方式读资源包，用来校验。"""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        magic, version, self.count, self.bucket_count, self.seed, names_size = struct.unpack_from("<4s5I", self.data, 0)
+        if magic != MAGIC or version != VERSION:
+            raise ValueError("%s is not a packed archive" % path)
+        self.displacements = struct.unpack_from("<%di" % self.bucket_count, self.data, 24)
+        self.entries_offset = 24 + ((self.bucket_count * 4 + 7) & ~7)
+        self.names_offset = self.entries_offset + self.count * 24
+
+    def find(self, name):
+        """返回文件内容，不在包里时返回 None。"""
+        if self.count == 0:
+            return None
+        displacement = self.displacements[xxh32(name, self.seed) % self.bucket_count]
+        slot = -displacement - 1 if displacement < 0 else xxh32(name, displacement) % self.count
+        if slot >= self.count:
+            return None
+        name_offset, name_length, offset, size = struct.unpack_from("<IIQQ", self.data, self.entries_offset + slot * 24)
+        start = self.names_offset + name_offset
+        if self.data[start:start + name_length] != name:
+            return None
+        return self.data[offset:offset + size]
+
+
+def verify(resource_dir, archive_path):
+    archive = Archive(archive_path)
+    files = collect(resource_dir, archive_path)
+    errors = 0
+    for name, path in files:
+        stored = archive.find(name)
+        with open(path, "rb") as f:
+            expected = f.read()
+        if stored != expected:
+            print("%s: %s" % (name.decode("utf-8"), "missing" if stored is None else "content differs"))
+            errors += 1
+    if len(files) != archive.count:
+        print("archive has %d files, %s has %d" % (archive.count, resource_dir, len(files)))
+        errors += 1
+
+    # 不在包里的名字：目录、改了后缀或大小写的文件名，都不能误命中
+    names = set(name for name, _ in files)
+    probes = set()
+    for name in names:
+        probes.add(name + b".missing")
+        probes.add(name.upper())
+        if b"/" in name:
+            probes.add(name.rsplit(b"/", 1)[0])
+    probes -= names
+    false_hits = [p for p in probes if archive.find(p) is not None]
+    for p in false_hits:
+        print("%s: found but not in the archive" % p.decode("utf-8"))
+    errors += len(false_hits)
+
+    print("%d files round-trip %s, %d missing names checked, %d errors"
+          % (len(files), "byte-exact" if errors == 0 else "with errors", len(probes), errors))
+    return 0 if errors == 0 else 1
+
+
+def main():
+    args = sys.argv[1:]
+    verifying = bool(args) and args[0] == "--verify"
+    if verifying:
+        args = args[1:]
+    resource_dir = args[0] if len(args) > 0 else os.path.join(ROOT, "Resources")
+    output = args[1] if len(args) > 1 else os.path.join(resource_dir, "res.pak")
+    if verifying:
+        return verify(resource_dir, output)
+    pack(resource_dir, output)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
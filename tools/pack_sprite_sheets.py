@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+把 Resources/ 下的精灵表 plist 编译成二进制的 <plist>.sheet，运行时由 SpriteFrameCache 直接读取，
+不再解析 XML 和 "{{x,y},{w,h}}" 字符串。
+
+格式见 cocos2d/cocos/2d/CCSpriteSheetData.h：文件头、按名字 XXH32 排序的帧表、别名表、名字。
+帧的矩形、偏移和原始尺寸按引擎对 format 0~3 的规则换算好；带多边形顶点（vertices）或
+九宫格（.9.）帧的 plist 不编译，继续走 plist。
+
+需要在 pack_resources.py 之前运行，生成的 .sheet 才会打进 res.pak。
+
+用法：
+    python3 tools/pack_sprite_sheets.py               # 编译 Resources/ 下所有精灵表
+    python3 tools/pack_sprite_sheets.py <资源目录>
+"""
+
+import os
+import plistlib
+import re
+import struct
+import sys
+
+from pack_resources import xxh32
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+MAGIC = b"CCSB"
+VERSION = 1
+HEADER = struct.Struct("<4s8I")
+FRAME = struct.Struct("<IIHBB10f")
+ALIAS = struct.Struct("<III")
+NAME_SEED = 0
+
+
+def _numbers(text):
+    return [float(v) for v in re.findall(r"[-+]?\d*\.?\d+(?:[eE][-+]?\d+)?", text or "")]
+
+
+def _point(text):
+    values = _numbers(text) + [0.0, 0.0]
+    return values[0], values[1]
+
+
+def _rect(text):
+    values = _numbers(text) + [0.0] * 4
+    return values[0], values[1], values[2], values[3]
+
+
+def parse_frame(fmt, info):
+    """返回 (rect, rotated, offset, sourceSize, anchor)，与 SpriteFrameCache::addSpriteFramesWithDictionary 一致。"""
+    anchor = None
+    if fmt == 0:
+        rect = (float(info.get("x", 0)), float(info.get("y", 0)),
+                float(info.get("width", 0)), float(info.get("height", 0)))
+        rotated = False
+        offset = (float(info.get("offsetX", 0)), float(info.get("offsetY", 0)))
+        source = (float(abs(int(info.get("originalWidth", 0)))), float(abs(int(info.get("originalHeight", 0)))))
+    elif fmt in (1, 2):
+        rect = _rect(info.get("frame"))
+        rotated = fmt == 2 and bool(info.get("rotated", False))
+        offset = _point(info.get("offset"))
+        source = _point(info.get("sourceSize"))
+    else:
+        size = _point(info.get("spriteSize"))
+        texture_rect = _rect(info.get("textureRect"))
+        rect = (texture_rect[0], texture_rect[1], size[0], size[1])
+        rotated = bool(info.get("textureRotated", False))
+        offset = _point(info.get("spriteOffset"))
+        source = _point(info.get("spriteSourceSize"))
+        # 引擎只在 format 3 读取 anchor
+        if "anchor" in info:
+            anchor = _point(info["anchor"])
+    return rect, rotated, offset, source, anchor
+
+
+def compile_sheet(plist_path):
+    """编译一个 plist，返回 .sheet 的内容；不是精灵表或不能编译时返回 None。"""
+    with open(plist_path, "rb") as f:
+        try:
+            root = plistlib.load(f)
+        except Exception:
+            return None
+    if not isinstance(root, dict) or not isinstance(root.get("frames"), dict):
+        return None
+
+    metadata = root.get("metadata", {})
+    fmt = int(metadata.get("format", 0))
+    if fmt not in (0, 1, 2, 3):
+        return None
+
+    frames_dict = root["frames"]
+    for name, info in frames_dict.items():
+        if "vertices" in info or ".9." in name:
+            return None
+
+    texture_name = metadata.get("textureFileName")
+    if not texture_name:
+        texture_name = os.path.splitext(os.path.basename(plist_path))[0] + ".png"
+    pixel_format = metadata.get("pixelFormat", "")
+
+    names = bytearray()
+
+    def add_name(text):
+        data = text.encode("utf-8")
+        offset = len(names)
+        names.extend(data)
+        return offset, len(data)
+
+    texture_offset, texture_length = add_name(texture_name)
+    format_offset, format_length = add_name(pixel_format)
+
+    entries = []
+    for name, info in frames_dict.items():
+        data = name.encode("utf-8")
+        entries.append((xxh32(data, NAME_SEED), data, name, info))
+    entries.sort(key=lambda e: (e[0], e[1]))
+
+    frames = bytearray()
+    frame_index = {}
+    for index, (name_hash, data, name, info) in enumerate(entries):
+        rect, rotated, offset, source, anchor = parse_frame(fmt, info)
+        name_offset, name_length = add_name(name)
+        frames += FRAME.pack(name_hash, name_offset, name_length, 1 if rotated else 0,
+                             0 if anchor is None else 1,
+                             *(rect + offset + source + (anchor or (0.0, 0.0))))
+        frame_index[name] = index
+
+    aliases = bytearray()
+    alias_count = 0
+    if fmt == 3:
+        for _, _, name, info in entries:
+            for alias in info.get("aliases", []):
+                alias_offset, alias_length = add_name(alias)
+                aliases += ALIAS.pack(alias_offset, alias_length, frame_index[name])
+                alias_count += 1
+
+    header = HEADER.pack(MAGIC, VERSION, len(entries), alias_count, len(names),
+                         texture_offset, texture_length, format_offset, format_length)
+    return header + bytes(frames) + bytes(aliases) + bytes(names)
+
+
+def main():
+    resource_dir = sys.argv[1] if len(sys.argv) > 1 else os.path.join(ROOT, "Resources")
+    count = 0
+    for folder, dirs, names in os.walk(resource_dir):
+        dirs.sort()
+        for name in sorted(names):
+            if not name.endswith(".plist"):
+                continue
+            path = os.path.join(folder, name)
+            sheet = compile_sheet(path)
+            if sheet is None:
+                continue
+            with open(path + ".sheet", "wb") as f:
+                f.write(sheet)
+            count += 1
+            print("%s.sheet: %d bytes" % (os.path.relpath(path, resource_dir), len(sheet)))
+    print("%d sheets" % count)
+
+
+if __name__ == "__main__":
+    main()